@@ -32,7 +32,7 @@ AppConfig::AppConfig(AppUI *ui)
   cachedComponentConfig(SUSCAN_OBJECT_TYPE_OBJECT),
   enabledBandPlans{}
 {
-  this->panSpectrumConfig = ui->panoramicDialog->getConfig();
+  this->panSpectrumConfig = ui->panoramicConfig;
 }
 
 Suscan::Object &&
@@ -53,6 +53,7 @@ AppConfig::serialize(void)
   obj.set("fullScreen", this->fullScreen);
   obj.set("sidePanelRatio", this->sidePanelRatio);
   obj.set("disableHighRateWarning", this->disableHighRateWarning);
+  obj.set("prefetchWindowMs", this->prefetchWindowMs);
   obj.set("loFreq", this->loFreq);
   obj.set("bandwidth", this->bandwidth);
   obj.set("lastLoadedFile", this->lastLoadedFile);
@@ -138,6 +139,7 @@ AppConfig::deserialize(Suscan::Object const &conf)
     TRYSILENT(this->fullScreen = conf.get("fullScreen", this->fullScreen));
     TRYSILENT(this->sidePanelRatio = conf.get("sidePanelRatio", this->sidePanelRatio));
     TRYSILENT(this->disableHighRateWarning = conf.get("disableHighRateWarning", this->disableHighRateWarning));
+    TRYSILENT(this->prefetchWindowMs = conf.get("prefetchWindowMs", this->prefetchWindowMs));
     TRYSILENT(this->loFreq     = conf.get("loFreq", this->loFreq));
     TRYSILENT(this->bandwidth  = conf.get("bandwidth", this->bandwidth));
     TRYSILENT(this->lastLoadedFile = conf.get("lastLoadedFile", this->lastLoadedFile));
@@ -68,14 +68,30 @@ AppUI::AppUI(QMainWindow *owner)
 #endif // __APPLE__
   
   this->spectrum = new MainSpectrum(owner);
-  this->quickConnectDialog = new QuickConnectDialog(owner);
-  this->aboutDialog = new AboutDialog(owner);
-  this->deviceDialog = new DeviceDialog(owner);
-  this->panoramicDialog = new PanoramicDialog(owner);
   this->logDialog = new LogDialog(owner);
   this->backgroundTasksDialog = new BackgroundTasksDialog(owner);
   this->addBookmarkDialog = new AddBookmarkDialog(owner);
-  this->bookmarkManagerDialog = new BookmarkManagerDialog(owner);
+  this->panoramicConfig = new PanoramicDialogConfig();
+
+  this->quickConnectDialog.setFactory([owner] () {
+    return new QuickConnectDialog(owner);
+  });
+
+  this->aboutDialog.setFactory([owner] () {
+    return new AboutDialog(owner);
+  });
+
+  this->deviceDialog.setFactory([owner] () {
+    return new DeviceDialog(owner);
+  });
+
+  this->panoramicDialog.setFactory([this, owner] () {
+    return new PanoramicDialog(owner, this->panoramicConfig);
+  });
+
+  this->bookmarkManagerDialog.setFactory([owner] () {
+    return new BookmarkManagerDialog(owner);
+  });
 }
 
 void
@@ -86,7 +102,10 @@ AppUI::postLoadInit(UIMediator *mediator, QMainWindow *owner)
   // Singleton config has been deserialized. Refresh UI with these changes.
   SigDiggerHelpers::instance()->deserializePalettes();
 
-  this->configDialog = new ConfigDialog(owner);
+  this->configDialog.setFactory([owner] () {
+    return new ConfigDialog(owner);
+  });
+
   this->spectrum->deserializeFATs();
 
   this->spectrum->adjustSizes();
@@ -94,5 +113,9 @@ AppUI::postLoadInit(UIMediator *mediator, QMainWindow *owner)
 
 AppUI::~AppUI(void)
 {
+  // Otherwise, the dialog owns it
+  if (!this->panoramicDialog.isReady())
+    delete this->panoramicConfig;
+
   delete this->main;
 }
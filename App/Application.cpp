@@ -22,6 +22,7 @@
 
 #include "Application.h"
 #include "Scanner.h"
+#include "CapturePrefetcher.h"
 
 #include <QMessageBox>
 #include <SuWidgetsHelpers.h>
@@ -30,6 +31,11 @@
 #include <QDragLeaveEvent>
 #include <QDropEvent>
 #include <QMimeData>
+#include <QFile>
+
+#ifdef __linux__
+#  include <unistd.h>
+#endif // __linux__
 
 #include "MainSpectrum.h"
 
@@ -56,9 +62,12 @@ Application::Application(QWidget *parent) : QMainWindow(parent), m_ui(this)
 {
   Suscan::Singleton *sing = Suscan::Singleton::get_instance();
 
+  m_startupTimer.start();
+
   sing->init_plugins();
 
   m_mediator = new UIMediator(this, &m_ui);
+  m_prefetcher = new CapturePrefetcher(this);
   m_deviceDetectThread = new QThread(this);
   m_deviceDetectWorker = new DeviceDetectWorker();
   m_deviceDetectWorker->moveToThread(m_deviceDetectThread);
@@ -79,6 +88,18 @@ Application::refreshConfig()
   m_mediator->saveUIConfig();
 }
 
+void
+Application::setPrimary(bool primary)
+{
+  m_primary = primary;
+}
+
+bool
+Application::isPrimary() const
+{
+  return m_primary;
+}
+
 void
 Application::updateRecent()
 {
@@ -113,9 +134,62 @@ Application::run(Suscan::Object const &config)
   m_uiTimer.start(100);
   m_cfgTimer.start();
 
+  logStartupStats();
+
   //mediator->notifyStartupErrors();
 }
 
+static QString
+residentSetSize()
+{
+  QString rss = "unknown";
+
+#ifdef __linux__
+  QFile statm("/proc/self/statm");
+
+  if (statm.open(QIODevice::ReadOnly)) {
+    QList<QByteArray> fields = statm.readAll().split(' ');
+    bool ok = false;
+    qint64 pages = fields.size() > 1 ? fields[1].toLongLong(&ok) : 0;
+
+    if (ok)
+      rss = SuWidgetsHelpers::formatBinaryQuantity(
+            pages * sysconf(_SC_PAGESIZE));
+  }
+#endif // __linux__
+
+  return rss;
+}
+
+void
+Application::logStartupStats()
+{
+  QElapsedTimer timer;
+  unsigned int built;
+
+  SU_INFO(
+        "Main window up in %lld ms (RSS: %s). "
+        "%u/%u deferred widgets built so far (%.1f ms)\n",
+        SCAST(long long, m_startupTimer.elapsed()),
+        residentSetSize().toStdString().c_str(),
+        LazyWidgetStats::materialized,
+        LazyWidgetStats::declared,
+        LazyWidgetStats::materializeNs * 1e-6);
+
+  // Opt-in comparison: what startup would have cost without deferring
+  if (qEnvironmentVariableIsSet(SIGDIGGER_LAZY_WIDGET_EAGER_ENV)) {
+    timer.start();
+    built = LazyWidgetBase::materializeAll();
+
+    SU_INFO(
+          "Building the remaining %u deferred widgets eagerly took %lld ms "
+          "(RSS: %s)\n",
+          built,
+          SCAST(long long, timer.elapsed()),
+          residentSetSize().toStdString().c_str());
+  }
+}
+
 
 void
 Application::connectUI()
@@ -156,6 +230,12 @@ Application::connectUI()
         this,
         SLOT(quit()));
 
+  connect(
+        m_mediator,
+        SIGNAL(newWindow()),
+        this,
+        SIGNAL(newWindowRequested()));
+
   connect(
         m_mediator,
         SIGNAL(refreshDevices()),
@@ -448,6 +528,8 @@ Application::startCapture()
       m_analyzer = std::move(analyzer);
 
       connectAnalyzer();
+      refreshPrefetcher(profile);
+      refreshCaptureIndex(profile);
 
       m_mediator->setState(UIMediator::RUNNING, m_analyzer.get());
     }
@@ -463,11 +545,27 @@ Application::startCapture()
   }
 }
 
+void
+Application::logAnalyzerStats()
+{
+  if (m_analyzer == nullptr)
+    return;
+
+  SU_INFO(
+        "Analyzer stopped. %llu tuning and gain commands coalesced, "
+        "%llu seeks superseded, %llu stale spectra dropped\n",
+        SCAST(unsigned long long, m_analyzer->getSkippedCommands()),
+        SCAST(unsigned long long, m_analyzer->getSkippedSeeks()),
+        SCAST(unsigned long long, m_analyzer->getDroppedPSDs()));
+}
+
 void
 Application::orderedHalt()
 {
   m_mediator->setState(UIMediator::HALTING);
+  logAnalyzerStats();
   m_analyzer = nullptr;
+  m_prefetcher->clear();
   m_mediator->setState(UIMediator::HALTED);
 }
 
@@ -634,7 +732,12 @@ void
 Application::quit()
 {
   stopCapture();
-  QApplication::quit();
+
+  // Secondary sessions only close their own window
+  if (m_primary)
+    QApplication::quit();
+  else
+    close();
 }
 
 void
@@ -712,10 +815,85 @@ Application::hotApplyProfile(Suscan::Source::Config const *profile)
   }
 }
 
+void
+Application::refreshPrefetcher(Suscan::Source::Config const &profile)
+{
+  if (profile.isRemote() || profile.isRealTime() || !profile.fileIsValid()) {
+    m_prefetcher->clear();
+    return;
+  }
+
+  m_prefetcher->setWindow(m_mediator->getAppConfig()->prefetchWindowMs);
+
+  if (m_prefetcher->setCapture(
+        profile.getPath(),
+        profile.getStartTime(),
+        profile.getEndTime()))
+    m_prefetcher->setPlayhead(profile.getStartTime(), true);
+}
+
+void
+Application::refreshCaptureIndex(Suscan::Source::Config const &profile)
+{
+  m_captureIndex = CaptureIndex();
+  m_captureRate  = 0;
+
+  if (profile.isRemote() || profile.isRealTime() || !profile.fileIsValid())
+    return;
+
+  if (!m_captureIndex.load(CaptureIndex::pathFor(profile.getPath())))
+    return;
+
+  // An index written for a different rate describes some other file
+  if (SCAST(unsigned, m_captureIndex.sampleRate()) != profile.getSampleRate()) {
+    m_captureIndex = CaptureIndex();
+    return;
+  }
+
+  m_captureStart = profile.getStartTime();
+  m_captureRate  = profile.getSampleRate();
+
+  if (!m_captureIndex.isComplete())
+    SU_WARNING(
+          "%s: recording index is incomplete, seeks near the end of "
+          "the capture may be off\n",
+          profile.getPath().c_str());
+}
+
+// Times picked on the slider are taken as receive times, while the file
+// source places samples back to back from the start time. Both only agree
+// if nothing was dropped while recording.
+struct timeval
+Application::indexedSeekTime(struct timeval const &tv) const
+{
+  struct timeval delta, result;
+  quint64 sample;
+
+  if (!m_captureIndex.isLoaded() || m_captureRate == 0)
+    return tv;
+
+  sample = m_captureIndex.sampleAt(tv);
+
+  delta.tv_sec  = SCAST(time_t, sample / m_captureRate);
+  delta.tv_usec = SCAST(
+        suseconds_t,
+        (sample % m_captureRate) * 1000000ull / m_captureRate);
+
+  timeradd(&m_captureStart, &delta, &result);
+
+  return result;
+}
+
 void
 Application::onSeek(struct timeval tv)
 {
   if (m_mediator->getState() == UIMediator::RUNNING) {
+    tv = indexedSeekTime(tv);
+
+    // Start reading from the new position right away, even if the seek
+    // itself is held back behind the one in flight.
+    m_prefetcher->setPlayhead(tv, true);
+
     try {
       m_analyzer->seek(tv);
     } catch (Suscan::Exception &) {
@@ -945,8 +1123,13 @@ Application::onScannerUpdated()
 void
 Application::onTick()
 {
-  if (m_mediator->getState() == UIMediator::RUNNING)
-    m_mediator->notifyTimeStamp(m_analyzer->getSourceTimeStamp());
+  if (m_mediator->getState() == UIMediator::RUNNING
+      && !m_analyzer->isSeeking()) {
+    struct timeval tv = m_analyzer->getSourceTimeStamp();
+
+    m_prefetcher->setPlayhead(tv);
+    m_mediator->notifyTimeStamp(tv);
+  }
 
   if (m_cfgTimer.hasExpired(SIGDIGGER_AUTOSAVE_INTERVAL_MS)) {
     m_cfgTimer.restart();
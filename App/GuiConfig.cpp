@@ -18,6 +18,7 @@
 //
 
 #include "GuiConfig.h"
+#include "ArenaAllocator.h"
 
 using namespace SigDigger;
 
@@ -41,6 +42,11 @@ GuiConfig::loadDefaults(void)
   this->useMaxBlending = false;
   this->enableMsgTTL   = true;
   this->msgTTL         = 15; // in milliseconds
+  this->adaptivePSD    = true;
+  this->targetLatency  = 500; // in milliseconds
+  this->memoryBudget   = 0;   // in MiB, 0 means unlimited
+  this->hugePages      = ARENA_HUGEPAGES_TRANSPARENT;
+  this->numaNode       = SIGDIGGER_ARENA_ANY_NODE;
   this->infoTextColor  = SIGDIGGER_DEFAULT_INFOTEXT_COLOR;
 }
 
@@ -68,6 +74,11 @@ GuiConfig::serialize(void)
   STORE(useGlInWindows);
   STORE(enableMsgTTL);
   STORE(msgTTL);
+  STORE(adaptivePSD);
+  STORE(targetLatency);
+  STORE(memoryBudget);
+  STORE(hugePages);
+  STORE(numaNode);
   STORE(infoText);
   CCSTORE(infoTextColor);
 
@@ -84,6 +95,11 @@ GuiConfig::deserialize(Suscan::Object const &conf)
   LOAD(useGlInWindows);
   LOAD(enableMsgTTL);
   LOAD(msgTTL);
+  LOAD(adaptivePSD);
+  LOAD(targetLatency);
+  LOAD(memoryBudget);
+  LOAD(hugePages);
+  LOAD(numaNode);
   LOAD(infoText);
   CCLOAD(infoTextColor);
 }
@@ -183,6 +183,13 @@ Loader::getLogText()
 
 Loader::~Loader()
 {
+  // Secondary sessions must go away before the main window does
+  for (auto p : m_sessions) {
+    disconnect(p, nullptr, this, nullptr);
+    delete p;
+  }
+
+  m_sessions.clear();
 }
 
 // Signal handlers
@@ -227,9 +234,65 @@ Loader::handleDone()
         this,
         SLOT(saveConfig()));
 
+  connect(
+        m_app,
+        SIGNAL(newWindowRequested()),
+        this,
+        SLOT(openSession()));
+
   close();
 }
 
+void
+Loader::openSession()
+{
+  Application *session = nullptr;
+  Suscan::Object objConfig;
+
+  // New sessions inherit the current layout of the main window. Only the
+  // main window writes its configuration back to disk.
+  m_app->refreshConfig();
+  objConfig = m_app->getConfig();
+
+  try {
+    session = new Application();
+    session->setPrimary(false);
+    session->setAttribute(Qt::WA_DeleteOnClose);
+
+    m_sessions.push_back(session);
+
+    connect(
+          session,
+          SIGNAL(destroyed(QObject *)),
+          this,
+          SLOT(onSessionDestroyed(QObject *)));
+
+    connect(
+          session,
+          SIGNAL(newWindowRequested()),
+          this,
+          SLOT(openSession()));
+
+    session->run(objConfig);
+  } catch (Suscan::Exception const &e) {
+    QMessageBox::critical(
+          m_app,
+          "New window",
+          "Failed to open a new SigDigger window: <pre>"
+          + QString::fromStdString(e.what()) + "</pre>",
+          QMessageBox::Close);
+
+    if (session != nullptr)
+      session->deleteLater();
+  }
+}
+
+void
+Loader::onSessionDestroyed(QObject *obj)
+{
+  m_sessions.remove(SCAST(Application *, obj));
+}
+
 // Public methods
 void
 Loader::saveConfig()
@@ -0,0 +1,311 @@
+//
+//    CycloDialog.cpp: Cyclostationary analysis results
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#include "CycloDialog.h"
+#include "ui_CycloDialog.h"
+#include <SuWidgetsHelpers.h>
+#include <QPixmap>
+#include <algorithm>
+#include <cmath>
+
+// Dynamic range of the map, in dB above its median
+#define SIGDIGGER_CYCLO_DIALOG_MAP_RANGE_DB   30.
+#define SIGDIGGER_CYCLO_DIALOG_HARMONIC_TOL   1e-2
+
+using namespace SigDigger;
+
+CycloDialog::CycloDialog(QWidget *parent) :
+  QDialog(parent),
+  ui(new Ui::CycloDialog)
+{
+  ui->setupUi(this);
+  this->setWindowFlags(
+        this->windowFlags() | Qt::Window | Qt::WindowMaximizeButtonHint);
+
+  for (int i = 0; i < 256; ++i)
+    m_gradient[i] = QColor(i, i, i);
+
+  this->connectAll();
+}
+
+CycloDialog::~CycloDialog()
+{
+  delete ui;
+}
+
+void
+CycloDialog::connectAll(void)
+{
+  connect(
+        this->ui->computeButton,
+        SIGNAL(clicked(void)),
+        this,
+        SIGNAL(recompute(void)));
+
+  connect(
+        this->ui->zoomResetButton,
+        SIGNAL(clicked(void)),
+        this,
+        SLOT(onZoomReset(void)));
+}
+
+void
+CycloDialog::renderMap(void)
+{
+  std::vector<SUFLOAT> sorted;
+  SUFLOAT floor, top = 0;
+  unsigned int guard = 0;
+
+  if (m_map.empty())
+    return;
+
+  // In the non-conjugate map, the columns next to alpha = 0 hold the power
+  // spectrum, which would outshine everything else.
+  if (!m_conjugate && m_alphaMax > m_alphaMin)
+    guard = static_cast<unsigned int>(
+          std::ceil(
+            m_fs / (2 * m_channels) / (m_alphaMax - m_alphaMin) * m_mapCols));
+
+  for (unsigned int r = 0; r < m_mapRows; ++r)
+    for (unsigned int c = guard; c < m_mapCols; ++c)
+      top = std::max(top, m_map[r * m_mapCols + c]);
+
+  sorted = m_map;
+  std::nth_element(
+        sorted.begin(),
+        sorted.begin() + static_cast<qint64>(sorted.size() / 2),
+        sorted.end());
+  floor = sorted[sorted.size() / 2];
+
+  if (floor <= 0)
+    floor = top * SU_ASFLOAT(
+          std::pow(10., -SIGDIGGER_CYCLO_DIALOG_MAP_RANGE_DB / 10));
+
+  if (top <= floor)
+    top = floor * 10;
+
+  m_image = QImage(
+        static_cast<int>(m_mapCols),
+        static_cast<int>(m_mapRows),
+        QImage::Format_RGB32);
+
+  // Frequency grows upwards
+  for (unsigned int r = 0; r < m_mapRows; ++r) {
+    QRgb *line = reinterpret_cast<QRgb *>(
+          m_image.scanLine(static_cast<int>(m_mapRows - r - 1)));
+    const SUFLOAT *data = m_map.data() + r * m_mapCols;
+
+    for (unsigned int c = 0; c < m_mapCols; ++c) {
+      qreal t = data[c] > floor
+          ? std::log10(data[c] / floor) / std::log10(top / floor)
+          : 0;
+      int index = static_cast<int>(255 * std::min(1., t));
+
+      line[c] = m_gradient[index].rgb();
+    }
+  }
+
+  this->refreshMap();
+}
+
+void
+CycloDialog::refreshMap(void)
+{
+  if (m_image.isNull())
+    return;
+
+  this->ui->mapLabel->setPixmap(
+        QPixmap::fromImage(m_image).scaled(
+          this->ui->mapLabel->size(),
+          Qt::IgnoreAspectRatio,
+          Qt::SmoothTransformation));
+}
+
+void
+CycloDialog::refreshPeaks(void)
+{
+  int row = 0;
+
+  this->ui->peakTable->setRowCount(static_cast<int>(m_peaks.size()));
+
+  for (auto const &p : m_peaks) {
+    QString interpretation;
+
+    if (m_conjugate) {
+      interpretation =
+          "Carrier candidate at "
+          + SuWidgetsHelpers::formatQuantity(p.alpha / 2, 6, "Hz");
+    } else {
+      interpretation = "Symbol rate candidate";
+
+      // Stronger lines come first. If this one is a multiple of one of
+      // them, it is most likely its harmonic.
+      for (int i = 0; i < row; ++i) {
+        qreal ratio = p.alpha / m_peaks[static_cast<size_t>(i)].alpha;
+        qreal n = std::round(ratio);
+
+        if (n >= 2
+            && std::fabs(ratio - n) < n * SIGDIGGER_CYCLO_DIALOG_HARMONIC_TOL) {
+          interpretation =
+              "Harmonic " + QString::number(static_cast<int>(n))
+              + " of "
+              + SuWidgetsHelpers::formatQuantity(
+                m_peaks[static_cast<size_t>(i)].alpha,
+                6,
+                "Hz");
+          break;
+        }
+      }
+    }
+
+    this->ui->peakTable->setItem(
+          row,
+          0,
+          new QTableWidgetItem(
+            SuWidgetsHelpers::formatQuantityFromDelta(
+              p.alpha,
+              m_alphaStep,
+              "Hz")));
+
+    this->ui->peakTable->setItem(
+          row,
+          1,
+          new QTableWidgetItem(QString::number(p.strength, 'f', 1) + " dB"));
+
+    this->ui->peakTable->setItem(row, 2, new QTableWidgetItem(interpretation));
+    ++row;
+  }
+
+  this->ui->peakTable->resizeColumnsToContents();
+}
+
+void
+CycloDialog::zoomReset(void)
+{
+  this->ui->profileWaveform->zoomVertical(
+        static_cast<qreal>(0.),
+        m_profileMax);
+
+  this->ui->profileWaveform->zoomHorizontalReset();
+  this->ui->profileWaveform->invalidate();
+}
+
+void
+CycloDialog::giveResult(CycloSpectrumTask *task)
+{
+  std::vector<SUFLOAT> profile = std::move(task->takeProfile());
+  qint64 guard = 0;
+
+  m_map       = std::move(task->takeMap());
+  m_peaks     = task->getPeaks();
+  m_mapCols   = task->mapColumns();
+  m_mapRows   = task->mapRows();
+  m_channels  = task->channels();
+  m_conjugate = task->isConjugate();
+  m_fs        = task->sampleRate();
+  m_alphaMin  = task->alphaMin();
+  m_alphaMax  = task->alphaMax();
+  m_alphaStep = task->alphaStep();
+
+  m_profile.resize(profile.size());
+  for (size_t i = 0; i < profile.size(); ++i)
+    m_profile[i] = profile[i];
+
+  // Same as in the map: scale the profile to the cyclic features
+  if (!m_conjugate)
+    guard = static_cast<qint64>(m_fs / (2 * m_channels) / m_alphaStep);
+
+  m_profileMax = 0;
+  for (size_t i = static_cast<size_t>(guard); i < profile.size(); ++i)
+    m_profileMax = std::max(m_profileMax, static_cast<qreal>(profile[i]));
+
+  if (m_profileMax <= 0)
+    m_profileMax = 1;
+
+  this->ui->profileWaveform->setData(&m_profile);
+  this->ui->profileWaveform->setRealComponent(true);
+  this->ui->profileWaveform->setSampleRate(1. / m_alphaStep);
+  this->ui->profileWaveform->setOriginX(m_alphaMin / m_alphaStep);
+
+  this->ui->mapRangeLabel->setText(
+        QString(m_conjugate ? "Conjugate" : "Non-conjugate")
+        + " spectral correlation. Cycle frequency: "
+        + SuWidgetsHelpers::formatQuantity(m_alphaMin, 4, "Hz")
+        + " to "
+        + SuWidgetsHelpers::formatQuantity(m_alphaMax, 4, "Hz")
+        + ", frequency: "
+        + SuWidgetsHelpers::formatQuantity(-m_fs / 2, 4, "Hz")
+        + " to "
+        + SuWidgetsHelpers::formatQuantity(m_fs / 2, 4, "Hz"));
+
+  this->renderMap();
+  this->refreshPeaks();
+  this->zoomReset();
+}
+
+void
+CycloDialog::setPalette(const QColor *gradient)
+{
+  for (int i = 0; i < 256; ++i)
+    m_gradient[i] = gradient[i];
+
+  this->renderMap();
+}
+
+void
+CycloDialog::setColorConfig(ColorConfig const &cfg)
+{
+  this->ui->profileWaveform->setForegroundColor(cfg.spectrumForeground);
+  this->ui->profileWaveform->setBackgroundColor(cfg.spectrumBackground);
+  this->ui->profileWaveform->setTextColor(cfg.spectrumText);
+  this->ui->profileWaveform->setAxesColor(cfg.spectrumAxes);
+}
+
+unsigned int
+CycloDialog::getChannels(void) const
+{
+  return 32u << this->ui->channelsCombo->currentIndex();
+}
+
+bool
+CycloDialog::getConjugate(void) const
+{
+  return this->ui->conjugateCheck->isChecked();
+}
+
+void
+CycloDialog::showEvent(QShowEvent *)
+{
+  this->zoomReset();
+  this->refreshMap();
+}
+
+void
+CycloDialog::resizeEvent(QResizeEvent *event)
+{
+  QDialog::resizeEvent(event);
+  this->refreshMap();
+}
+
+////////////////////////////////// Slots ///////////////////////////////////////
+void
+CycloDialog::onZoomReset(void)
+{
+  this->zoomReset();
+}
@@ -179,17 +179,30 @@ MainSpectrum::addToolWidget(QWidget *widget, QString const &title)
     m_maxToolWidth = widthHint;
 }
 
+void
+MainSpectrum::setFFTProperties(GlobalProperty *fftSize, GlobalProperty *rbw)
+{
+  m_propFftSize = fftSize;
+  m_propRBW     = rbw;
+
+  refreshFFTProperties();
+}
+
 void
 MainSpectrum::refreshFFTProperties()
 {
-  GlobalProperty::lookupProperty("fft_size")->setValue(m_cachedFftSize);
   QString rbwStr = m_cachedFftSize > 0 && m_cachedRate > 0
       ? SuWidgetsHelpers::formatQuantity(
           SCAST(qreal, m_cachedRate) / m_cachedFftSize,
           3,
           "Hz")
       : "N/A";
-  GlobalProperty::lookupProperty("rbw")->setValue(rbwStr);
+
+  if (m_propFftSize != nullptr)
+    m_propFftSize->setValue(m_cachedFftSize);
+
+  if (m_propRBW != nullptr)
+    m_propRBW->setValue(rbwStr);
 }
 
 void
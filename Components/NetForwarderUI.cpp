@@ -30,6 +30,28 @@ NetForwarderUI::connectAll(void)
         SIGNAL(clicked(bool)),
         this,
         SLOT(onForwardStartStop(void)));
+
+  connect(
+        this->ui->socketTypeCombo,
+        SIGNAL(activated(int)),
+        this,
+        SLOT(onTransportChanged(void)));
+}
+
+void
+NetForwarderUI::refreshUi(void)
+{
+  bool shm = this->getTransport() == TRANSPORT_SHM;
+
+  this->ui->label_28->setVisible(!shm);
+  this->ui->hostEdit->setVisible(!shm);
+  this->ui->label->setVisible(!shm);
+  this->ui->portSpin->setVisible(!shm);
+  this->ui->label_2->setVisible(!shm);
+  this->ui->frameLen->setVisible(!shm);
+
+  this->ui->shmNameLabel->setVisible(shm);
+  this->ui->shmNameEdit->setVisible(shm);
 }
 
 NetForwarderUI::NetForwarderUI(QWidget *parent) :
@@ -44,6 +66,7 @@ NetForwarderUI::NetForwarderUI(QWidget *parent) :
   this->ui->spinGrid->addWidget(this->spinner);
 
   this->connectAll();
+  this->refreshUi();
 }
 
 NetForwarderUI::~NetForwarderUI()
@@ -93,6 +116,8 @@ NetForwarderUI::setForwardState(bool state)
   this->ui->hostEdit->setEnabled(!state);
   this->ui->portSpin->setEnabled(!state);
   this->ui->frameLen->setEnabled(!state);
+  this->ui->shmNameEdit->setEnabled(!state);
+  this->ui->socketTypeCombo->setEnabled(!state);
 
   this->ui->udpStartStopButton->setText(state ? "Stop" : "Forward");
 
@@ -134,7 +159,20 @@ NetForwarderUI::setCaptureSize(quint64 size)
 void
 NetForwarderUI::setTcp(bool tcp)
 {
-  this->ui->socketTypeCombo->setCurrentIndex(tcp ? 1 : 0);
+  this->setTransport(tcp ? TRANSPORT_TCP : TRANSPORT_UDP);
+}
+
+void
+NetForwarderUI::setTransport(Transport transport)
+{
+  this->ui->socketTypeCombo->setCurrentIndex(static_cast<int>(transport));
+  this->refreshUi();
+}
+
+void
+NetForwarderUI::setSegment(std::string const &name)
+{
+  this->ui->shmNameEdit->setText(QString::fromStdString(name));
 }
 
 std::string
@@ -164,7 +202,19 @@ NetForwarderUI::getForwardState(void) const
 bool
 NetForwarderUI::getTcp(void) const
 {
-  return this->ui->socketTypeCombo->currentIndex() == 1;
+  return this->getTransport() == TRANSPORT_TCP;
+}
+
+NetForwarderUI::Transport
+NetForwarderUI::getTransport(void) const
+{
+  return static_cast<Transport>(this->ui->socketTypeCombo->currentIndex());
+}
+
+std::string
+NetForwarderUI::getSegment(void) const
+{
+  return this->ui->shmNameEdit->text().toStdString();
 }
 
 ///////////////////////////////// Slots ///////////////////////////////////////
@@ -178,3 +228,9 @@ NetForwarderUI::onForwardStartStop(void)
 
   emit forwardStateChanged(this->ui->udpStartStopButton->isChecked());
 }
+
+void
+NetForwarderUI::onTransportChanged(void)
+{
+  this->refreshUi();
+}
@@ -158,8 +158,11 @@ PanoramicDialogConfig::setGain(
 }
 
 ///////////////////////////// PanoramicDialog //////////////////////////////////
-PanoramicDialog::PanoramicDialog(QWidget *parent) :
+PanoramicDialog::PanoramicDialog(
+    QWidget *parent,
+    PanoramicDialogConfig *config) :
   QDialog(parent),
+  m_dialogConfig(config),
   m_ui(new Ui::PanoramicDialog)
 {
   m_ui->setupUi(static_cast<QDialog *>(this));
@@ -182,10 +185,14 @@ PanoramicDialog::PanoramicDialog(QWidget *parent) :
   m_ui->lnbDoubleSpinBox->setMaximum(300e9);
 
   connectAll();
+
+  MemoryBudget::instance()->add(this);
 }
 
 PanoramicDialog::~PanoramicDialog()
 {
+  MemoryBudget::instance()->remove(this);
+
   if (m_noGainLabel != nullptr)
     m_noGainLabel->deleteLater();
   delete m_ui;
@@ -515,6 +522,8 @@ PanoramicDialog::feed(
     float *data,
     size_t size)
 {
+  size_t savedCapacity = m_saved.data.capacity();
+
   if (m_freqStart != freqStart || m_freqEnd != freqEnd) {
     m_freqStart = freqStart;
     m_freqEnd   = freqEnd;
@@ -526,6 +535,10 @@ PanoramicDialog::feed(
         data,
         size);
 
+  // This runs once per sweep step, only report growth
+  if (m_saved.data.capacity() != savedCapacity)
+    MemoryBudget::instance()->touch(this);
+
   m_ui->exportButton->setEnabled(true);
   m_waterfall->setNewPartialFftData(data, static_cast<int>(size),
       freqStart, freqEnd);
@@ -920,11 +933,26 @@ PanoramicDialog::refreshGains(Suscan::Source::Device &device)
   }
 }
 
+QString
+PanoramicDialog::memoryConsumerName() const
+{
+  return "Panoramic spectrum snapshot";
+}
+
+quint64
+PanoramicDialog::residentBytes() const
+{
+  return m_saved.data.capacity() * sizeof(float);
+}
+
 // Overriden methods
 Suscan::Serializable *
 PanoramicDialog::allocConfig(void)
 {
-  return m_dialogConfig = new PanoramicDialogConfig();
+  if (m_dialogConfig == nullptr)
+    m_dialogConfig = new PanoramicDialogConfig();
+
+  return m_dialogConfig;
 }
 
 void
@@ -26,6 +26,7 @@
 #include <QStyleOptionSlider>
 #include "SigDiggerHelpers.h"
 #include <QProxyStyle>
+#include <PowerOverview.h>
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
 #  define MidButton MiddleButton
@@ -50,6 +51,97 @@ public:
     }
 };
 
+#define SIGDIGGER_TIME_SLIDER_PREVIEW_WIDTH  220
+#define SIGDIGGER_TIME_SLIDER_PREVIEW_HEIGHT 110
+
+namespace SigDigger {
+  //
+  // Floating preview of the spectrum around the hovered position of the
+  // time slider.
+  //
+  class OverviewPreview : public QWidget
+  {
+    QString caption;
+    std::vector<float> spectrum;
+
+  protected:
+    void paintEvent(QPaintEvent *) override;
+
+  public:
+    OverviewPreview(QWidget *parent);
+
+    void setData(QString const &, std::vector<float> const &);
+  };
+}
+
+OverviewPreview::OverviewPreview(QWidget *parent) :
+  QWidget(parent, Qt::ToolTip | Qt::FramelessWindowHint)
+{
+  this->setAttribute(Qt::WA_ShowWithoutActivating);
+  this->setFixedSize(
+        SIGDIGGER_TIME_SLIDER_PREVIEW_WIDTH,
+        SIGDIGGER_TIME_SLIDER_PREVIEW_HEIGHT);
+}
+
+void
+OverviewPreview::setData(
+    QString const &caption,
+    std::vector<float> const &spectrum)
+{
+  this->caption  = caption;
+  this->spectrum = spectrum;
+  this->update();
+}
+
+void
+OverviewPreview::paintEvent(QPaintEvent *)
+{
+  QPainter p(this);
+  QFontMetrics metrics(this->font());
+  QColor fg = this->palette().color(QPalette::ToolTipText);
+  QRectF plot;
+  float min = 0, max = 0;
+  int th = metrics.height();
+
+  p.fillRect(this->rect(), this->palette().color(QPalette::ToolTipBase));
+  p.setPen(fg);
+  p.drawRect(this->rect().adjusted(0, 0, -1, -1));
+  p.drawText(
+        QRect(4, 2, this->width() - 8, th),
+        Qt::AlignLeft | Qt::AlignVCenter,
+        this->caption);
+
+  if (this->spectrum.size() < 2)
+    return;
+
+  plot = QRectF(4, th + 6, this->width() - 8, this->height() - th - 10);
+
+  min = max = this->spectrum[0];
+  for (auto v : this->spectrum) {
+    if (v < min)
+      min = v;
+    if (v > max)
+      max = v;
+  }
+
+  if (max - min < 10)
+    min = max - 10;
+
+  QPolygonF poly;
+  qreal dx = plot.width() / static_cast<qreal>(this->spectrum.size() - 1);
+
+  for (size_t i = 0; i < this->spectrum.size(); ++i)
+    poly.append(
+          QPointF(
+            plot.left() + static_cast<qreal>(i) * dx,
+            plot.bottom()
+            - (this->spectrum[i] - min) / (max - min) * plot.height()));
+
+  p.setRenderHint(QPainter::Antialiasing);
+  p.setPen(QPen(this->palette().color(QPalette::Highlight), 1.5));
+  p.drawPolyline(poly);
+}
+
 QTimeSlider::QTimeSlider(QWidget *parent) : QSlider(parent)
 {
   struct timeval delta = {1, 0};
@@ -76,11 +168,193 @@ QTimeSlider::QTimeSlider(QWidget *parent) : QSlider(parent)
   sizePolicy2.setHeightForWidth(this->sizePolicy().hasHeightForWidth());
 
   this->setSizePolicy(sizePolicy2);
+  this->setMouseTracking(true);
+}
+
+int
+QTimeSlider::bucketAt(int x) const
+{
+  size_t size;
+
+  if (!this->overview || this->width() <= 0)
+    return -1;
+
+  size = this->overview->size();
+  if (size == 0 || x < 0 || x >= this->width())
+    return -1;
+
+  return static_cast<int>(
+        static_cast<qreal>(x) / this->width() * static_cast<qreal>(size));
+}
+
+struct timeval
+QTimeSlider::bucketTime(int bucket) const
+{
+  struct timeval span, offset, tv;
+  qreal spanUsec, fraction;
+  qint64 usec;
+
+  timersub(&this->endTime, &this->startTime, &span);
+
+  spanUsec = static_cast<qreal>(span.tv_sec) * 1e6
+      + static_cast<qreal>(span.tv_usec);
+  fraction = (bucket + .5) / static_cast<qreal>(this->overview->size());
+
+  usec = static_cast<qint64>(fraction * spanUsec);
+  offset.tv_sec  = usec / 1000000;
+  offset.tv_usec = usec % 1000000;
+
+  timeradd(&this->startTime, &offset, &tv);
+
+  return tv;
+}
+
+void
+QTimeSlider::paintOverview(QPainter &p)
+{
+  size_t size = this->overview->size();
+  size_t filled = this->overview->filled();
+  PowerOverviewBucket bucket;
+  QFontMetrics metrics(this->font());
+  QColor color = this->palette().color(QPalette::Highlight);
+  QColor rangeColor = color;
+  qreal top = this->height() / 3.;
+  qreal bottom = this->height() - metrics.height() - 1;
+  float floor = 0, ceiling = 0;
+  bool first = true;
+
+  if (filled == 0 || bottom <= top)
+    return;
+
+  // Common scale for all the buckets computed so far
+  for (size_t i = 0; i < filled; ++i) {
+    if (this->overview->bucket(i, bucket)) {
+      if (first || bucket.min < floor)
+        floor = bucket.min;
+      if (first || bucket.max > ceiling)
+        ceiling = bucket.max;
+      first = false;
+    }
+  }
+
+  if (ceiling - floor < 10)
+    floor = ceiling - 10;
+
+  color.setAlpha(110);
+  rangeColor.setAlpha(50);
+
+  for (int x = 0; x < this->width(); ++x) {
+    size_t b0 = static_cast<size_t>(
+          static_cast<qreal>(x) / this->width() * static_cast<qreal>(size));
+    size_t b1 = static_cast<size_t>(
+          static_cast<qreal>(x + 1) / this->width() * static_cast<qreal>(size));
+    float lo = 0, hi = 0, mean = 0;
+    unsigned int count = 0;
+
+    if (b1 <= b0)
+      b1 = b0 + 1;
+
+    for (size_t b = b0; b < b1 && b < filled; ++b) {
+      if (!this->overview->bucket(b, bucket))
+        continue;
+
+      if (count == 0 || bucket.min < lo)
+        lo = bucket.min;
+      if (count == 0 || bucket.max > hi)
+        hi = bucket.max;
+      if (count == 0 || bucket.mean > mean)
+        mean = bucket.mean;
+      ++count;
+    }
+
+    if (count == 0)
+      continue;
+
+    auto toY = [&] (float dB) {
+      return bottom - (dB - floor) / (ceiling - floor) * (bottom - top);
+    };
+
+    p.setPen(rangeColor);
+    p.drawLine(QLineF(x + .5, toY(lo), x + .5, toY(hi)));
+    p.setPen(color);
+    p.drawLine(QLineF(x + .5, bottom, x + .5, toY(mean)));
+  }
+}
+
+void
+QTimeSlider::mouseMoveEvent(QMouseEvent *ev)
+{
+  int bucket = this->bucketAt(SCAST(int, ev->pos().x()));
+  std::vector<float> spectrum;
+  PowerOverviewBucket levels;
+
+  QSlider::mouseMoveEvent(ev);
+
+  if (bucket < 0
+      || !this->overview->bucket(SCAST(size_t, bucket), levels)
+      || !this->overview->spectrum(SCAST(size_t, bucket), spectrum)) {
+    if (this->preview != nullptr)
+      this->preview->hide();
+    return;
+  }
+
+  if (this->preview == nullptr)
+    this->preview = new OverviewPreview(this);
+
+  {
+    SigDiggerHelpers *hlp = SigDiggerHelpers::instance();
+    struct timeval tv = this->bucketTime(bucket);
+    QDateTime dateTime;
+
+    dateTime.setMSecsSinceEpoch(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+
+    hlp->pushLocalTZ();
+    this->preview->setData(
+          dateTime.toString("hh:mm:ss.zzz")
+          + QString::asprintf(
+            "  %.1f / %.1f dBFS",
+            SCAST(qreal, levels.mean),
+            SCAST(qreal, levels.max)),
+          spectrum);
+    hlp->popTZ();
+  }
+
+  this->preview->move(
+        this->mapToGlobal(
+          QPoint(
+            SCAST(int, ev->pos().x()) - SIGDIGGER_TIME_SLIDER_PREVIEW_WIDTH / 2,
+            -SIGDIGGER_TIME_SLIDER_PREVIEW_HEIGHT - 4)));
+  this->preview->show();
+}
+
+void
+QTimeSlider::leaveEvent(QEvent *ev)
+{
+  if (this->preview != nullptr)
+    this->preview->hide();
+
+  QSlider::leaveEvent(ev);
+}
+
+void
+QTimeSlider::setOverview(std::shared_ptr<PowerOverview> const &overview)
+{
+  this->overview = overview;
+
+  if (!overview && this->preview != nullptr)
+    this->preview->hide();
+
+  this->update();
 }
 
 void
 QTimeSlider::paintEvent(QPaintEvent *ev)
 {
+  if (this->overview) {
+    QPainter p(this);
+    this->paintOverview(p);
+  }
+
   if (timercmp(&this->startTime, &this->endTime, <=)) {
     QPainter p(this);
     QString tickFormat;
@@ -21,8 +21,8 @@
 #include "ui_SamplerDialog.h"
 
 #include <SuWidgetsHelpers.h>
-#include <QMessageBox>
-#include <QFileDialog>
+#include <SigDiggerHelpers.h>
+#include <Suscan/Library.h>
 
 using namespace SigDigger;
 
@@ -173,6 +173,7 @@ SamplerDialog::reset(void)
 {
   ui->symView->clear();
   ui->histogram->reset();
+  m_symbols.clear();
 
   m_minVal = +INFINITY;
   maxVal = -INFINITY;
@@ -188,6 +189,9 @@ SamplerDialog::setColorConfig(ColorConfig const &cfg)
   ui->symView->setBackgroundColor(cfg.symViewBackground);
   ui->symView->setLoColor(cfg.symViewLow);
   ui->symView->setHiColor(cfg.symViewHigh);
+
+  m_loColor = cfg.symViewLow;
+  m_hiColor = cfg.symViewHigh;
 }
 
 void
@@ -224,6 +228,7 @@ SamplerDialog::feedSet(WaveSampleSet const &set)
 
   ui->histogram->feed(set.block, set.len);
   ui->symView->feed(set.symbols, set.len);
+  m_symbols.append(set.symbols, set.len);
 
   refreshHScrollBar();
   refreshVScrollBar();
@@ -414,57 +419,12 @@ SamplerDialog::onHoverSymbol(unsigned int index)
 void
 SamplerDialog::onSaveSymView(void)
 {
-  QFileDialog dialog(ui->symView);
-  QStringList filters;
-  enum SymView::FileFormat fmt = SymView::FILE_FORMAT_TEXT;
-
-  filters << "Text file (*.txt)"
-          << "Binary file (*.bin)"
-          << "C source file (*.c)"
-          << "Microsoft Windows Bitmap (*.bmp)"
-          << "PNG Image (*.png)"
-          << "JPEG Image (*.jpg)"
-          << "Portable Pixel Map (*.ppm)";
-
-  dialog.setFileMode(QFileDialog::AnyFile);
-  dialog.setAcceptMode(QFileDialog::AcceptSave);
-  dialog.setWindowTitle(QString("Save current symbol capture as..."));
-  dialog.setNameFilters(filters);
-
-  if (dialog.exec()) {
-    // This sucks
-    QString filter = dialog.selectedNameFilter();
-    QString path = dialog.selectedFiles().first();
-    QFileInfo fi(path);
-    QString ext = fi.size() > 0
-        ? fi.suffix()
-        : SuWidgetsHelpers::extractFilterExtension(filter);
-
-    if (ext == "txt")
-      fmt = SymView::FILE_FORMAT_TEXT;
-    else if (ext == "bin")
-      fmt = SymView::FILE_FORMAT_RAW;
-    else if (ext == "c" || ext == "h" || ext == "cpp")
-      fmt = SymView::FILE_FORMAT_C_ARRAY;
-    else if (ext == "bmp")
-      fmt = SymView::FILE_FORMAT_BMP;
-    else if (ext == "png")
-      fmt = SymView::FILE_FORMAT_PNG;
-    else if (ext == "jpg" || ext == "jpeg")
-      fmt = SymView::FILE_FORMAT_JPEG;
-    else if (ext == "ppm")
-      fmt = SymView::FILE_FORMAT_PPM;
-
-    try {
-      ui->symView->save(
-            SuWidgetsHelpers::ensureExtension(path, ext),
-            fmt);
-    } catch (std::ios_base::failure const &) {
-      (void) QMessageBox::critical(
-            ui->symView,
-            "Save symbol file",
-            "Failed to save file in the specified location. Please try again.",
-            QMessageBox::Close);
-    }
-  }
+  SigDiggerHelpers::openSaveSymbolsDialog(
+        ui->symView,
+        m_symbols.snapshot(),
+        static_cast<unsigned>(ui->bpsSpin->value()),
+        ui->symView->getStride(),
+        m_loColor,
+        m_hiColor,
+        Suscan::Singleton::get_instance()->getBackgroundTaskController());
 }
@@ -37,7 +37,9 @@
 #include <QuadDemodTask.h>
 #include <AGCTask.h>
 #include <DelayedConjTask.h>
+#include <CycloSpectrumTask.h>
 #include <LPFTask.h>
+#include <ResamplerTask.h>
 
 #include "ui_TimeWindow.h"
 
@@ -104,6 +106,18 @@ TimeWindow::connectTransformWidgets()
         this,
         SLOT(onLPF()));
 
+  connect(
+        ui->resampleApplyButton,
+        SIGNAL(clicked()),
+        this,
+        SLOT(onRateConversion()));
+
+  connect(
+        ui->resampleRateSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onRateConversionChanged()));
+
   connect(
         ui->costasSyncButton,
         SIGNAL(clicked()),
@@ -122,6 +136,12 @@ TimeWindow::connectTransformWidgets()
         this,
         SLOT(onCycloAnalysis()));
 
+  connect(
+        m_cycloDialog,
+        SIGNAL(recompute()),
+        this,
+        SLOT(onCycloAnalysis()));
+
   connect(
         ui->agcButton,
         SIGNAL(clicked()),
@@ -519,6 +539,7 @@ TimeWindow::setColorConfig(ColorConfig const &cfg)
   m_histogramDialog->setColorConfig(cfg);
   m_samplerDialog->setColorConfig(cfg);
   m_dopplerDialog->setColorConfig(cfg);
+  m_cycloDialog->setColorConfig(cfg);
 }
 
 std::string
@@ -731,6 +752,7 @@ TimeWindow::notifyTaskRunning(bool running)
   samplingSetEnabled(!running);
 
   ui->lpfApplyButton->setEnabled(!running);
+  ui->resampleApplyButton->setEnabled(!running);
   ui->agcButton->setEnabled(!running);
   ui->dcmButton->setEnabled(!running);
   ui->cycloButton->setEnabled(!running);
@@ -819,10 +841,9 @@ TimeWindow::refreshMeasures()
   qreal selStart = 0;
   qreal selEnd   = 0;
   qreal deltaT = 1. / ui->realWaveform->getSampleRate();
-  SUCOMPLEX min, max, mean;
-  SUFLOAT rms;
+  SelectionMeasures measures;
   int length = static_cast<int>(getDisplayDataLength());
-  bool selection = false;
+  bool haveMeasures = false;
 
   if (ui->realWaveform->getHorizontalSelectionPresent()) {
     selStart = ui->realWaveform->getHorizontalSelectionStart();
@@ -834,9 +855,7 @@ TimeWindow::refreshMeasures()
       selEnd = length;
   }
 
-  if (selEnd - selStart > 0 && ui->realWaveform->isComplete()) {
-    WaveLimits limits;
-
+  if (selEnd - selStart > 0) {
     qreal period =
         (selEnd - selStart) /
         (ui->periodicSelectionCheck->isChecked()
@@ -845,30 +864,12 @@ TimeWindow::refreshMeasures()
         * deltaT;
     qreal baud = 1 / period;
 
-#if 0
-    const SUCOMPLEX *data = getDisplayData();
-
-    SuWidgetsHelpers::kahanMeanAndRms(
-          &mean,
-          &rms,
-          data + static_cast<qint64>(selStart),
-          SCAST(SUSCOUNT, selEnd - selStart));
-    SuWidgetsHelpers::calcLimits(
-          &min,
-          &max,
-          data + static_cast<qint64>(selStart),
-          SCAST(SUSCOUNT, selEnd - selStart));
-#else
-    ui->realWaveform->computeLimits(selStart, selEnd, limits);
-
-    mean = limits.mean;
-    min  = limits.min;
-    max  = limits.max;
-    rms  = limits.envelope;
-
-    selection = true;
+    // Exact, and cheap enough to follow a selection edge being dragged
+    haveMeasures = m_measures.measure(
+          static_cast<SUSCOUNT>(selStart),
+          static_cast<SUSCOUNT>(selEnd),
+          measures);
 
-#endif
     ui->periodLabel->setText(
           SuWidgetsHelpers::formatQuantityFromDelta(
             period,
@@ -900,10 +901,10 @@ TimeWindow::refreshMeasures()
             "s")
           + " (" + SuWidgetsHelpers::formatReal(selEnd - selStart) + ")");
   } else {
-    min  = ui->realWaveform->getDataMin();
-    max  = ui->realWaveform->getDataMax();
-    mean = ui->realWaveform->getDataMean();
-    rms  = ui->realWaveform->getDataRMS();
+    haveMeasures = m_measures.measure(
+          0,
+          static_cast<SUSCOUNT>(length),
+          measures);
 
     ui->periodLabel->setText("N/A");
     ui->baudLabel->setText("N/A");
@@ -920,27 +921,49 @@ TimeWindow::refreshMeasures()
           deltaT,
           "s"));
 
+  if (!haveMeasures) {
+    ui->minILabel->setText("N/A");
+    ui->maxILabel->setText("N/A");
+    ui->meanILabel->setText("N/A");
+    ui->minQLabel->setText("N/A");
+    ui->maxQLabel->setText("N/A");
+    ui->meanQLabel->setText("N/A");
+    ui->rmsLabel->setText("N/A");
+    ui->peakLabel->setText("N/A");
+    ui->varianceLabel->setText("N/A");
+    ui->energyLabel->setText("N/A");
+    return;
+  }
+
   ui->minILabel->setText(
-        SuWidgetsHelpers::formatScientific(SU_C_REAL(min)));
+        SuWidgetsHelpers::formatScientific(SU_C_REAL(measures.min)));
 
   ui->maxILabel->setText(
-        SuWidgetsHelpers::formatScientific(SU_C_REAL(max)));
+        SuWidgetsHelpers::formatScientific(SU_C_REAL(measures.max)));
 
   ui->meanILabel->setText(
-        SuWidgetsHelpers::formatScientific(SU_C_REAL(mean)));
+        SuWidgetsHelpers::formatScientific(SU_C_REAL(measures.mean)));
 
   ui->minQLabel->setText(
-        SuWidgetsHelpers::formatScientific(SU_C_IMAG(min)));
+        SuWidgetsHelpers::formatScientific(SU_C_IMAG(measures.min)));
 
   ui->maxQLabel->setText(
-        SuWidgetsHelpers::formatScientific(SU_C_IMAG(max)));
+        SuWidgetsHelpers::formatScientific(SU_C_IMAG(measures.max)));
 
   ui->meanQLabel->setText(
-        SuWidgetsHelpers::formatScientific(SU_C_IMAG(mean)));
+        SuWidgetsHelpers::formatScientific(SU_C_IMAG(measures.mean)));
 
   ui->rmsLabel->setText(
-        (selection ? "< " : "") +
-        SuWidgetsHelpers::formatReal(rms));
+        SuWidgetsHelpers::formatReal(measures.rms));
+
+  ui->peakLabel->setText(
+        SuWidgetsHelpers::formatReal(measures.peak));
+
+  ui->varianceLabel->setText(
+        SuWidgetsHelpers::formatScientific(measures.variance));
+
+  ui->energyLabel->setText(
+        SuWidgetsHelpers::formatScientific(measures.energy));
 }
 
 void
@@ -971,6 +994,10 @@ TimeWindow::setDisplayData(
   m_displayDataPtr    = displayData;
   m_displayDataLength = displayLen;
 
+  // Contents may have changed in place (transforms reuse m_processedData)
+  m_measures.rebuild(displayData, displayLen);
+  MemoryBudget::instance()->touch(this);
+
   // This is just a workaround. TODO: fix build method in Waveformview
   setCursor(Qt::WaitCursor);
 
@@ -1004,6 +1031,9 @@ TimeWindow::setData(const SUCOMPLEX *data, size_t size, qreal fs, qreal bw)
     m_fs = fs;
     ui->costasBwSpin->setValue(m_fs / 200);
     ui->pllCutOffSpin->setValue(m_fs / 200);
+    ui->resampleRateSpin->setMaximum(m_fs * SIGDIGGER_RESAMPLER_MAX_FACTOR);
+    ui->resampleRateSpin->setValue(m_fs);
+    onRateConversionChanged();
   }
 
   if (!sufeq(m_bw, bw, 1e-6)) {
@@ -1029,6 +1059,42 @@ TimeWindow::setData(std::vector<SUCOMPLEX> const &data, qreal fs, qreal bw)
   setData(data.data(), data.size(), fs, bw);
 }
 
+void
+TimeWindow::extendData(
+    const SUCOMPLEX *data,
+    size_t size,
+    qreal fs,
+    qreal bw)
+{
+  bool showingData = m_displayDataPtr == m_roDataPtr;
+
+  // A resampled capture is a snapshot with its own rate: keep it until
+  // the caller explicitly sets new data
+  if (!m_resampledData.empty() && m_roDataPtr == m_resampledData.data())
+    return;
+
+  // Not the buffer we were given: start over
+  if (data != m_roDataPtr || size < m_roDataLength) {
+    setData(data, size, fs, bw);
+    return;
+  }
+
+  m_roDataLength = size;
+
+  if (!showingData)
+    return;
+
+  m_displayDataLength = size;
+  m_measures.extend(data, size);
+  MemoryBudget::instance()->touch(this);
+
+  ui->realWaveform->setData(data, size, true, true, true);
+  ui->imagWaveform->setData(data, size, true, true, true);
+
+  refreshUi();
+  refreshMeasures();
+}
+
 void
 TimeWindow::adjustButtonToSize(QPushButton *button, QString text)
 {
@@ -1054,7 +1120,10 @@ TimeWindow::TimeWindow(QWidget *parent) :
 
   m_histogramDialog = new HistogramDialog(this);
   m_samplerDialog   = new SamplerDialog(this);
+
+  MemoryBudget::instance()->add(this);
   m_dopplerDialog   = new DopplerDialog(this);
+  m_cycloDialog     = new CycloDialog(this);
 
   // We can do this because both labels have the same font
   ui->notchWidthLabel->setFixedWidth(
@@ -1114,9 +1183,23 @@ TimeWindow::postLoadInit()
 
 TimeWindow::~TimeWindow()
 {
+  MemoryBudget::instance()->remove(this);
   delete ui;
 }
 
+QString
+TimeWindow::memoryConsumerName() const
+{
+  return "Time window: " + windowTitle();
+}
+
+quint64
+TimeWindow::residentBytes() const
+{
+  return (m_processedData.capacity() + m_resampledData.capacity())
+      * sizeof(SUCOMPLEX) + m_measures.memoryBytes();
+}
+
 //////////////////////////////////// Slots /////////////////////////////////////
 void
 TimeWindow::onHZoom(qint64 min, qint64 max)
@@ -1503,6 +1586,7 @@ TimeWindow::onPaletteChanged(int index)
   if (palette != nullptr) {
     ui->realWaveform->setPalette(palette->getGradient());
     ui->imagWaveform->setPalette(palette->getGradient());
+    m_cycloDialog->setPalette(palette->getGradient());
   }
 
   emit configChanged();
@@ -1604,6 +1688,28 @@ TimeWindow::onTaskDone()
     m_dopplerDialog->giveSpectrum(std::move(spectrum));
     m_dopplerDialog->setMax(dc->getMax());
     m_dopplerDialog->show();
+  } else if (m_taskController.getName() == "cyclo") {
+    CycloSpectrumTask *cs =
+        static_cast<CycloSpectrumTask *>(m_taskController.getTask());
+
+    notifyTaskRunning(false);
+
+    m_cycloDialog->giveResult(cs);
+    m_cycloDialog->show();
+  } else if (m_taskController.getName() == "resample") {
+    ResamplerTask *rt = const_cast<ResamplerTask *>(
+          static_cast<const ResamplerTask *>(m_taskController.getTask()));
+    qreal fs = m_fs * rt->getRatio();
+    qreal bw = qMin(m_bw, 2 * SIGDIGGER_RESAMPLER_PASSBAND * fs);
+
+    // The resampled capture becomes the new dataset of this window
+    m_resampledData = rt->takeOutput();
+    notifyTaskRunning(false);
+
+    setData(m_resampledData, fs, bw);
+    ui->realWaveform->invalidate();
+    ui->imagWaveform->invalidate();
+    onFit();
   } else {
     setDisplayData(getData(), getLength(), true);
     setDisplayData(
@@ -2012,21 +2118,32 @@ TimeWindow::onPLLRecovery()
 void
 TimeWindow::onCycloAnalysis()
 {
-  if (!ui->realWaveform->isComplete())
+  if (!ui->realWaveform->isComplete() || m_taskRunning)
     return;
 
   try {
-    const SUCOMPLEX *orig;
-    SUCOMPLEX *dest;
-    SUSCOUNT len;
+    const SUCOMPLEX *data = getDisplayData();
+    SUSCOUNT len = getDisplayDataLength();
+
+    // This is a read-only analysis, no need to go through the transform
+    // buffer.
+    if (ui->transSelCheck->isChecked()
+        && ui->realWaveform->getHorizontalSelectionPresent()) {
+      qint64 selStart = static_cast<qint64>(
+            ui->realWaveform->getHorizontalSelectionStart());
+      qint64 selEnd = static_cast<qint64>(
+            ui->realWaveform->getHorizontalSelectionEnd());
+
+      data += selStart;
+      len   = static_cast<SUSCOUNT>(selEnd - selStart);
+    }
 
-    getTransformRegion(
-          orig,
-          dest,
+    CycloSpectrumTask *task = new CycloSpectrumTask(
+          data,
           len,
-          ui->transSelCheck->isChecked());
-
-    DelayedConjTask *task = new DelayedConjTask(orig, dest, len, 1);
+          m_fs,
+          m_cycloDialog->getChannels(),
+          m_cycloDialog->getConjugate());
 
     notifyTaskRunning(true);
     m_taskController.process("cyclo", task);
@@ -2147,6 +2264,61 @@ TimeWindow::onLPF()
   }
 }
 
+void
+TimeWindow::onRateConversion()
+{
+  if (!ui->realWaveform->isComplete())
+    return;
+
+  try {
+    const SUCOMPLEX *data = getDisplayData();
+    size_t len = getDisplayDataLength();
+    qreal ratio = ui->resampleRateSpin->value() / m_fs;
+    SUFLOAT cutoff = static_cast<SUFLOAT>(.5 * m_bw / m_fs);
+
+    if (ui->transSelCheck->isChecked()
+        && ui->realWaveform->getHorizontalSelectionPresent()) {
+      qint64 selStart = static_cast<qint64>(
+            ui->realWaveform->getHorizontalSelectionStart());
+      qint64 selEnd = static_cast<qint64>(
+            ui->realWaveform->getHorizontalSelectionEnd());
+
+      data += selStart;
+      len   = static_cast<size_t>(selEnd - selStart);
+    }
+
+    ResamplerTask *task = new ResamplerTask(data, len, ratio, cutoff);
+
+    notifyTaskRunning(true);
+    m_taskController.process("resample", task);
+  } catch (Suscan::Exception &e) {
+    QMessageBox::warning(
+          this,
+          "Resample",
+          "Cannot perform operation: " + QString(e.what()));
+  }
+}
+
+void
+TimeWindow::onRateConversionChanged()
+{
+  unsigned int L, M;
+
+  if (m_fs <= 0 || ui->resampleRateSpin->value() <= 0)
+    return;
+
+  ResamplerTask::rationalize(ui->resampleRateSpin->value() / m_fs, L, M);
+
+  ui->resampleRatioLabel->setText(
+        "Ratio: "
+        + QString::number(L)
+        + " / "
+        + QString::number(M)
+        + " ("
+        + SuWidgetsHelpers::formatQuantity(m_fs * L / M, 4, "sp/s")
+        + ")");
+}
+
 void
 TimeWindow::onDelayedConjugate()
 {
@@ -23,6 +23,7 @@
 #include <AppConfig.h>
 #include <SuWidgetsHelpers.h>
 #include <Suscan/AnalyzerRequestTracker.h>
+#include <Suscan/WatermarkController.h>
 #include <cassert>
 
 using namespace SigDigger;
@@ -55,6 +56,9 @@ AudioProcessor::AudioProcessor(UIMediator *mediator, QObject *parent)
   assertAudioDevice();
 
   m_tracker = new Suscan::AnalyzerRequestTracker(this);
+  m_watermark = new Suscan::WatermarkController(this);
+  m_watermark->setProfile(Suscan::WATERMARK_PROFILE_AUDIO);
+
   connectAll();
 
   m_squelchLevel = 1e-2;
@@ -62,6 +66,9 @@ AudioProcessor::AudioProcessor(UIMediator *mediator, QObject *parent)
 
 AudioProcessor::~AudioProcessor()
 {
+  if (m_analyzer != nullptr)
+    m_analyzer->unsubscribeInspector(this);
+
   if (m_audioCfgTemplate != nullptr)
     suscan_config_destroy(m_audioCfgTemplate);
 
@@ -69,9 +76,31 @@ AudioProcessor::~AudioProcessor()
     delete m_playBack;
 }
 
+void
+AudioProcessor::resetWatermark()
+{
+  Suscan::WatermarkPolicy policy =
+      Suscan::WatermarkPolicy::fromProfile(Suscan::WATERMARK_PROFILE_AUDIO);
+  SUSCOUNT bufSize = PlaybackWorker::calcBufferSizeForRate(m_sampleRate);
+  qreal rate = SCAST(qreal, m_sampleRate);
+
+  // Batches larger than half the playback buffer would cause underruns
+  m_watermark->setLatencyBounds(
+        policy.minLatency,
+        qMin(policy.maxLatency, .5 * SCAST(qreal, bufSize) / rate));
+
+  m_watermark->setInspector(m_audioInspHandle, rate, bufSize / 2);
+}
+
 void
 AudioProcessor::connectAll()
 {
+  connect(
+        m_watermark,
+        SIGNAL(watermarkChanged(quint64, qreal)),
+        this,
+        SIGNAL(watermarkChanged(quint64, qreal)));
+
   connect(
         m_tracker,
         SIGNAL(opened(Suscan::AnalyzerRequest const &)),
@@ -189,6 +218,8 @@ AudioProcessor::closeAudio()
   // Just in case
   stopRecording();
 
+  m_watermark->setInspector(-1);
+
   m_opening = false;
   m_opened  = false;
   m_settingRate = false;
@@ -273,25 +304,10 @@ AudioProcessor::disconnectAnalyzer()
 {
   m_mediator->setUIBusy(false);
 
+  m_analyzer->unsubscribeInspector(this);
   disconnect(m_analyzer, nullptr, this, nullptr);
 }
 
-void
-AudioProcessor::connectAnalyzer()
-{
-  connect(
-        m_analyzer,
-        SIGNAL(inspector_message(const Suscan::InspectorMessage &)),
-        this,
-        SLOT(onInspectorMessage(const Suscan::InspectorMessage &)));
-
-  connect(
-        m_analyzer,
-        SIGNAL(samples_message(const Suscan::SamplesMessage &)),
-        this,
-        SLOT(onInspectorSamples(const Suscan::SamplesMessage &)));
-}
-
 void
 AudioProcessor::connectAudioFileSaver()
 {
@@ -343,13 +359,11 @@ AudioProcessor::setAnalyzer(Suscan::Analyzer *analyzer)
 
   m_analyzer = analyzer;
   m_tracker->setAnalyzer(analyzer);
+  m_watermark->setAnalyzer(analyzer);
 
   // Was audio enabled? Open it back
-  if (m_analyzer != nullptr) {
-    connectAnalyzer();
-    if (m_enabled)
-      openAudio();
-  }
+  if (m_analyzer != nullptr && m_enabled)
+    openAudio();
 }
 
 void
@@ -480,9 +494,7 @@ AudioProcessor::setSampleRate(unsigned rate)
     if (m_audioInspectorOpened) {
       m_settingRate = true;
       setParams();
-      m_analyzer->setInspectorWatermark(
-            m_audioInspHandle,
-            PlaybackWorker::calcBufferSizeForRate(m_sampleRate) / 2);
+      resetWatermark();
     } else {
       m_playBack->setSampleRate(rate);
     }
@@ -597,6 +609,18 @@ AudioProcessor::getSaveSize() const
   return m_audioFileSaver == nullptr ? 0 : m_audioFileSaver->getSize();
 }
 
+quint64
+AudioProcessor::getWatermark() const
+{
+  return m_watermark->getWatermark();
+}
+
+qreal
+AudioProcessor::getWatermarkLatency() const
+{
+  return m_watermark->getLatency();
+}
+
 bool
 AudioProcessor::startRecording(QString path)
 {
@@ -698,10 +722,14 @@ AudioProcessor::onInspectorSamples(Suscan::SamplesMessage const &msg)
     const SUCOMPLEX *samples = msg.getSamples();
     unsigned int count = msg.getCount();
 
+    m_watermark->beginBatch();
+
     m_playBack->write(samples, count);
 
     if (m_audioFileSaver != nullptr)
       m_audioFileSaver->write(samples, count);
+
+    m_watermark->endBatch(count);
   }
 }
 
@@ -738,13 +766,13 @@ AudioProcessor::onOpened(Suscan::AnalyzerRequest const &req)
     m_audioInspId          = req.inspectorId;
     m_audioInspectorOpened = true;
 
+    m_analyzer->unsubscribeInspector(this);
+    m_analyzer->subscribeInspector(m_audioInspId, this);
+
     setTrueBandwidth();
     setTrueLoFreq();
     setParams();
-
-    m_analyzer->setInspectorWatermark(
-          m_audioInspHandle,
-          PlaybackWorker::calcBufferSizeForRate(m_sampleRate) / 2);
+    resetWatermark();
 
     if (m_correctionEnabled)
       m_analyzer->setInspectorDopplerCorrection(m_audioInspHandle, m_orbit);
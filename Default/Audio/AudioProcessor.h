@@ -27,6 +27,7 @@
 namespace Suscan {
   class Analyzer;
   class AnalyzerRequestTracker;
+  class WatermarkController;
   struct AnalyzerRequest;
 };
 
@@ -35,7 +36,7 @@ namespace SigDigger {
   class AudioPlayback;
   class MainSpectrum;
 
-  class AudioProcessor : public QObject
+  class AudioProcessor : public QObject, public Suscan::InspectorListener
   {
     Q_OBJECT
 
@@ -61,6 +62,7 @@ namespace SigDigger {
     QString         m_savedPath;
     AudioPlayback  *m_playBack = nullptr;
     Suscan::AnalyzerRequestTracker *m_tracker = nullptr;
+    Suscan::WatermarkController    *m_watermark = nullptr;
     QString         m_audioError;
     std::string     m_audioDevice;
 
@@ -82,7 +84,6 @@ namespace SigDigger {
     // Private methods
     void connectAll();
     void connectAudioFileSaver();
-    void connectAnalyzer();
     void disconnectAnalyzer();
     bool openAudio();
     bool closeAudio();
@@ -90,6 +91,7 @@ namespace SigDigger {
     void setTrueLoFreq();
     void setTrueBandwidth();
     void assertAudioDevice();
+    void resetWatermark();
 
   public:
     explicit AudioProcessor(UIMediator *, QObject *parent = nullptr);
@@ -123,11 +125,14 @@ namespace SigDigger {
     bool isRecording() const;
     bool isOpened() const;
     size_t getSaveSize() const;
+    quint64 getWatermark() const;
+    qreal getWatermarkLatency() const;
 
   signals:
     void audioClosed();
     void audioOpened();
     void audioError(QString);
+    void watermarkChanged(quint64, qreal);
 
     void recStopped();
     void recSwamped();
@@ -142,8 +147,8 @@ namespace SigDigger {
     bool startRecording(QString);
     void stopRecording(void);
 
-    void onInspectorMessage(Suscan::InspectorMessage const &);
-    void onInspectorSamples(Suscan::SamplesMessage const &);
+    void onInspectorMessage(Suscan::InspectorMessage const &) override;
+    void onInspectorSamples(Suscan::SamplesMessage const &) override;
     void onOpened(Suscan::AnalyzerRequest const &);
     void onCancelled(Suscan::AnalyzerRequest const &);
     void onError(Suscan::AnalyzerRequest const &, std::string const &);
@@ -0,0 +1,284 @@
+//
+//    ChannelBatch.cpp: Batch of narrow inspectors
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "ChannelBatch.h"
+
+#include <Suscan/AnalyzerRequestTracker.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace SigDigger;
+
+ChannelBatch::ChannelBatch(QObject *parent) : QObject(parent)
+{
+  m_tracker = new Suscan::AnalyzerRequestTracker(this);
+
+  connectAll();
+}
+
+ChannelBatch::~ChannelBatch()
+{
+  if (m_analyzer != nullptr)
+    m_analyzer->unsubscribeInspector(this);
+}
+
+void
+ChannelBatch::connectAll()
+{
+  connect(
+        m_tracker,
+        SIGNAL(opened(Suscan::AnalyzerRequest const &)),
+        this,
+        SLOT(onOpened(Suscan::AnalyzerRequest const &)));
+
+  connect(
+        m_tracker,
+        SIGNAL(error(Suscan::AnalyzerRequest const &, const std::string &)),
+        this,
+        SLOT(onError(Suscan::AnalyzerRequest const &, const std::string &)));
+
+  connect(
+        m_tracker,
+        SIGNAL(batchCompleted(quint32, unsigned, unsigned)),
+        this,
+        SLOT(onBatchCompleted(quint32, unsigned, unsigned)));
+}
+
+//////////////////////////////// Setters ///////////////////////////////////////
+void
+ChannelBatch::setAnalyzer(Suscan::Analyzer *analyzer)
+{
+  if (m_analyzer != nullptr)
+    close();
+
+  m_analyzer = analyzer;
+  m_tracker->setAnalyzer(analyzer);
+}
+
+void
+ChannelBatch::setInspectorClass(std::string const &inspClass)
+{
+  m_inspClass = inspClass;
+}
+
+bool
+ChannelBatch::open(std::vector<SUFREQ> const &freqs, SUFREQ bandwidth)
+{
+  std::vector<Suscan::Channel> chans;
+  SUFREQ center, span;
+
+  close();
+
+  if (m_analyzer == nullptr)
+    return false;
+
+  center = m_analyzer->getFrequency();
+  span   = .5 * SIGDIGGER_CHANNEL_BATCH_SPAN_USAGE
+      * SCAST(SUFREQ, m_analyzer->getSampleRate());
+
+  m_failed = 0;
+
+  for (auto freq : freqs) {
+    Suscan::Channel ch;
+    BatchChannel bc;
+
+    // Channels must fit in the current capture span
+    if (std::fabs(freq - center) + .5 * bandwidth > span
+        || m_channels.size() >= SIGDIGGER_CHANNEL_BATCH_MAX_CHANNELS) {
+      ++m_failed;
+      continue;
+    }
+
+    ch.fc    = freq - center;
+    ch.ft    = 0;
+    ch.bw    = bandwidth;
+    ch.fLow  = -.5 * bandwidth;
+    ch.fHigh = +.5 * bandwidth;
+
+    bc.freq      = freq;
+    bc.bandwidth = bandwidth;
+
+    chans.push_back(ch);
+    m_channels.push_back(bc);
+  }
+
+  if (chans.empty()) {
+    emit error("None of the requested channels fits in the current span");
+    return false;
+  }
+
+  m_complete = false;
+  m_batchId  = m_tracker->requestOpenBatch(m_inspClass, chans);
+
+  if (m_batchId == 0) {
+    m_channels.clear();
+    emit error("Internal Suscan error while opening channel batch");
+    return false;
+  }
+
+  return true;
+}
+
+void
+ChannelBatch::close()
+{
+  bool wasOpen = m_batchId != 0;
+
+  // Prevent cancellations from being taken as completions
+  m_batchId = 0;
+
+  if (m_analyzer != nullptr) {
+    m_tracker->cancelAll();
+
+    for (auto &ch : m_channels)
+      if (ch.opened)
+        m_analyzer->closeInspector(ch.handle);
+
+    m_analyzer->unsubscribeInspector(this);
+  }
+
+  m_channels.clear();
+  m_byInspId.clear();
+  m_opened   = 0;
+  m_failed   = 0;
+  m_complete = false;
+
+  if (wasOpen)
+    emit closed();
+}
+
+//////////////////////////////// Getters ///////////////////////////////////////
+bool
+ChannelBatch::isOpening() const
+{
+  return m_batchId != 0 && !m_complete;
+}
+
+bool
+ChannelBatch::isOpen() const
+{
+  return m_batchId != 0 && m_complete;
+}
+
+unsigned int
+ChannelBatch::getOpenedCount() const
+{
+  return m_opened;
+}
+
+unsigned int
+ChannelBatch::getFailedCount() const
+{
+  return m_failed;
+}
+
+std::vector<BatchChannel> const &
+ChannelBatch::getChannels() const
+{
+  return m_channels;
+}
+
+////////////////////////////////// Slots ///////////////////////////////////////
+void
+ChannelBatch::onInspectorSamples(Suscan::SamplesMessage const &msg)
+{
+  auto it = m_byInspId.find(msg.getInspectorId());
+
+  if (it == m_byInspId.end())
+    return;
+
+  BatchChannel &ch = m_channels[*it];
+  const SUCOMPLEX *samples = msg.getSamples();
+  unsigned int count = msg.getCount();
+  SUFLOAT sum = 0;
+
+  if (count == 0)
+    return;
+
+  if (m_inspClass == "power") {
+    for (unsigned int i = 0; i < count; ++i)
+      sum += SU_C_REAL(samples[i]);
+  } else {
+    for (unsigned int i = 0; i < count; ++i)
+      sum += SU_C_REAL(samples[i] * SU_C_CONJ(samples[i]));
+  }
+
+  sum /= SCAST(SUFLOAT, count);
+
+  if (!ch.haveLevel) {
+    ch.level = sum;
+    ch.haveLevel = true;
+  } else {
+    ch.level += SIGDIGGER_CHANNEL_BATCH_LEVEL_ALPHA * (sum - ch.level);
+  }
+}
+
+void
+ChannelBatch::onOpened(Suscan::AnalyzerRequest const &req)
+{
+  if (m_analyzer == nullptr)
+    return;
+
+  // Leftover from a closed batch
+  if (req.batchId == 0 || req.batchId != m_batchId) {
+    m_analyzer->closeInspector(req.handle);
+    return;
+  }
+
+  BatchChannel &ch = m_channels[req.batchIndex];
+
+  ch.handle      = req.handle;
+  ch.inspectorId = req.inspectorId;
+  ch.opened      = true;
+
+  m_byInspId[req.inspectorId] = req.batchIndex;
+  m_analyzer->subscribeInspector(req.inspectorId, this);
+
+  if (m_inspClass == "power") {
+    Suscan::Config cfg(SCAST(const suscan_config_t *, req.config));
+
+    cfg.set(
+          "power.integrate-samples",
+          SCAST(uint64_t, std::max(
+            std::round(
+              SCAST(qreal, req.equivRate)
+              * SIGDIGGER_CHANNEL_BATCH_INTEGRATION),
+            1.)));
+    m_analyzer->setInspectorConfig(req.handle, cfg);
+  }
+}
+
+void
+ChannelBatch::onError(Suscan::AnalyzerRequest const &req, std::string const &)
+{
+  if (req.batchId != 0 && req.batchId == m_batchId)
+    m_channels[req.batchIndex].failed = true;
+}
+
+void
+ChannelBatch::onBatchCompleted(quint32 batchId, unsigned opened, unsigned failed)
+{
+  if (batchId == 0 || batchId != m_batchId)
+    return;
+
+  m_complete = true;
+  m_opened   = opened;
+  m_failed  += failed;
+
+  emit this->opened(m_opened, m_failed);
+}
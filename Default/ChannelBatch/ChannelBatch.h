@@ -0,0 +1,103 @@
+//
+//    ChannelBatch.h: Batch of narrow inspectors
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef CHANNELBATCH_H
+#define CHANNELBATCH_H
+
+#include <QObject>
+#include <QHash>
+#include <Suscan/Analyzer.h>
+#include <vector>
+
+#define SIGDIGGER_CHANNEL_BATCH_MAX_CHANNELS    512
+#define SIGDIGGER_CHANNEL_BATCH_INTEGRATION     10e-3 // s, per power report
+#define SIGDIGGER_CHANNEL_BATCH_LEVEL_ALPHA     .1
+#define SIGDIGGER_CHANNEL_BATCH_SPAN_USAGE      .9
+
+namespace Suscan {
+  class AnalyzerRequestTracker;
+  struct AnalyzerRequest;
+};
+
+namespace SigDigger {
+  struct BatchChannel {
+    SUFREQ         freq = 0;
+    SUFREQ         bandwidth = 0;
+
+    // Inspector state
+    Suscan::Handle handle = -1;
+    uint32_t       inspectorId = 0;
+    bool           opened = false;
+    bool           failed = false;
+    SUFLOAT        level = 0; // Linear power, smoothed
+    bool           haveLevel = false;
+  };
+
+  //
+  // Opens a set of narrow inspectors at once, through a single batch
+  // request, and keeps a smoothed power level for each one of them. Power
+  // inspectors report it directly, for any other class the mean squared
+  // magnitude of the samples is used.
+  //
+  class ChannelBatch : public QObject, public Suscan::InspectorListener
+  {
+    Q_OBJECT
+
+    Suscan::Analyzer *m_analyzer = nullptr;
+    Suscan::AnalyzerRequestTracker *m_tracker = nullptr;
+
+    std::string               m_inspClass = "power";
+    std::vector<BatchChannel> m_channels;
+    QHash<uint32_t, size_t>   m_byInspId;
+    uint32_t                  m_batchId = 0;
+    bool                      m_complete = false;
+    unsigned int              m_opened = 0;
+    unsigned int              m_failed = 0;
+
+    void connectAll();
+
+  public:
+    explicit ChannelBatch(QObject *parent = nullptr);
+    ~ChannelBatch() override;
+
+    void setAnalyzer(Suscan::Analyzer *);
+    void setInspectorClass(std::string const &);
+
+    bool open(std::vector<SUFREQ> const &freqs, SUFREQ bandwidth);
+    void close();
+
+    bool isOpening() const;
+    bool isOpen() const;
+    unsigned int getOpenedCount() const;
+    unsigned int getFailedCount() const;
+    std::vector<BatchChannel> const &getChannels() const;
+
+  signals:
+    void opened(unsigned opened, unsigned failed);
+    void closed();
+    void error(QString);
+
+  public slots:
+    void onInspectorSamples(Suscan::SamplesMessage const &) override;
+    void onOpened(Suscan::AnalyzerRequest const &);
+    void onError(Suscan::AnalyzerRequest const &, std::string const &);
+    void onBatchCompleted(quint32, unsigned, unsigned);
+  };
+}
+
+#endif // CHANNELBATCH_H
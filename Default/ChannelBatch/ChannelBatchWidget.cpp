@@ -0,0 +1,382 @@
+//
+//    Default/ChannelBatch/ChannelBatchWidget.cpp: Channel batch panel
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "ChannelBatchWidgetFactory.h"
+#include "ChannelBatchWidget.h"
+#include "ui_ChannelBatchWidget.h"
+#include <QDynamicPropertyChangeEvent>
+#include <QMessageBox>
+#include <QTimer>
+#include <UIMediator.h>
+#include <MainSpectrum.h>
+#include <SuWidgetsHelpers.h>
+#include <cmath>
+
+#define SIGDIGGER_CHANNEL_BATCH_REFRESH_MS 250
+
+using namespace SigDigger;
+
+#define STRINGFY(x) #x
+#define STORE(field) obj.set(STRINGFY(field), field)
+#define LOAD(field) field = conf.get(STRINGFY(field), field)
+
+void
+ChannelBatchWidgetConfig::deserialize(Suscan::Object const &conf)
+{
+  LOAD(collapsed);
+  LOAD(rangeStart);
+  LOAD(rangeEnd);
+  LOAD(step);
+  LOAD(bandwidth);
+  LOAD(inspClass);
+}
+
+Suscan::Object &&
+ChannelBatchWidgetConfig::serialize()
+{
+  Suscan::Object obj(SUSCAN_OBJECT_TYPE_OBJECT);
+
+  obj.setClass("ChannelBatchWidgetConfig");
+
+  STORE(collapsed);
+  STORE(rangeStart);
+  STORE(rangeEnd);
+  STORE(step);
+  STORE(bandwidth);
+  STORE(inspClass);
+
+  return persist(obj);
+}
+
+////////////////////////////// Channel batch widget ////////////////////////////
+ChannelBatchWidget::ChannelBatchWidget(
+    ChannelBatchWidgetFactory *factory,
+    UIMediator *mediator,
+    QWidget *parent) :
+  ToolWidget(factory, mediator, parent),
+  m_ui(new Ui::ChannelBatchPanel)
+{
+  m_ui->setupUi(this);
+
+  m_batch        = new ChannelBatch(this);
+  m_refreshTimer = new QTimer(this);
+  m_spectrum     = mediator->getMainSpectrum();
+
+  m_ui->startSpin->setMinimum(0);
+  m_ui->startSpin->setMaximum(300e9);
+  m_ui->endSpin->setMinimum(0);
+  m_ui->endSpin->setMaximum(300e9);
+  m_ui->stepSpin->setMinimum(1);
+  m_ui->stepSpin->setMaximum(1e9);
+  m_ui->bandwidthSpin->setMinimum(1);
+  m_ui->bandwidthSpin->setMaximum(1e9);
+
+  m_refreshTimer->setInterval(SIGDIGGER_CHANNEL_BATCH_REFRESH_MS);
+
+  assertConfig();
+  connectAll();
+
+  setProperty("collapsed", m_panelConfig->collapsed);
+}
+
+ChannelBatchWidget::~ChannelBatchWidget()
+{
+  delete m_ui;
+}
+
+// Private methods
+void
+ChannelBatchWidget::connectAll()
+{
+  connect(
+        m_ui->startSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->endSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->stepSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->bandwidthSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->classCombo,
+        SIGNAL(activated(int)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->openButton,
+        SIGNAL(clicked(bool)),
+        this,
+        SLOT(onToggleOpen()));
+
+  connect(
+        m_ui->channelTable,
+        SIGNAL(cellDoubleClicked(int, int)),
+        this,
+        SLOT(onChannelDoubleClicked(int, int)));
+
+  connect(
+        m_refreshTimer,
+        SIGNAL(timeout()),
+        this,
+        SLOT(onRefreshLevels()));
+
+  connect(
+        m_batch,
+        SIGNAL(opened(unsigned, unsigned)),
+        this,
+        SLOT(onBatchOpened(unsigned, unsigned)));
+
+  connect(
+        m_batch,
+        SIGNAL(closed()),
+        this,
+        SLOT(onBatchClosed()));
+
+  connect(
+        m_batch,
+        SIGNAL(error(QString)),
+        this,
+        SLOT(onBatchError(QString)));
+}
+
+void
+ChannelBatchWidget::refreshUi()
+{
+  bool idle = !m_batch->isOpening() && !m_batch->isOpen();
+
+  m_ui->startSpin->setEnabled(idle);
+  m_ui->endSpin->setEnabled(idle);
+  m_ui->stepSpin->setEnabled(idle);
+  m_ui->bandwidthSpin->setEnabled(idle);
+  m_ui->classCombo->setEnabled(idle);
+
+  m_ui->openButton->setEnabled(m_analyzer != nullptr);
+  BLOCKSIG(m_ui->openButton, setChecked(!idle));
+  m_ui->openButton->setText(idle ? "Open" : "Close");
+
+  if (m_batch->isOpening())
+    m_ui->statusLabel->setText("Opening inspectors...");
+  else if (idle)
+    m_ui->statusLabel->setText("Idle");
+}
+
+void
+ChannelBatchWidget::populateTable()
+{
+  auto const &channels = m_batch->getChannels();
+  int row = 0;
+
+  m_ui->channelTable->setRowCount(SCAST(int, channels.size()));
+
+  for (auto const &ch : channels) {
+    m_ui->channelTable->setItem(
+          row,
+          0,
+          new QTableWidgetItem(
+            SuWidgetsHelpers::formatQuantity(ch.freq, 6, "Hz")));
+    m_ui->channelTable->setItem(row, 1, new QTableWidgetItem("N/A"));
+    ++row;
+  }
+}
+
+std::vector<SUFREQ>
+ChannelBatchWidget::makeFrequencyList() const
+{
+  std::vector<SUFREQ> list;
+  SUFREQ start = std::min(m_panelConfig->rangeStart, m_panelConfig->rangeEnd);
+  SUFREQ end   = std::max(m_panelConfig->rangeStart, m_panelConfig->rangeEnd);
+  SUFREQ step  = m_panelConfig->step;
+
+  // The batch caps the channel count anyway, this just bounds the loop
+  for (SUFREQ f = start;
+       f <= end && list.size() <= SIGDIGGER_CHANNEL_BATCH_MAX_CHANNELS;
+       f += step)
+    list.push_back(f);
+
+  return list;
+}
+
+Suscan::Serializable *
+ChannelBatchWidget::allocConfig()
+{
+  return m_panelConfig = new ChannelBatchWidgetConfig();
+}
+
+void
+ChannelBatchWidget::applyConfig()
+{
+  BLOCKSIG(m_ui->startSpin, setValue(m_panelConfig->rangeStart));
+  BLOCKSIG(m_ui->endSpin, setValue(m_panelConfig->rangeEnd));
+  BLOCKSIG(m_ui->stepSpin, setValue(m_panelConfig->step));
+  BLOCKSIG(m_ui->bandwidthSpin, setValue(m_panelConfig->bandwidth));
+  BLOCKSIG(
+        m_ui->classCombo,
+        setCurrentIndex(m_panelConfig->inspClass == "power" ? 0 : 1));
+
+  setProperty("collapsed", m_panelConfig->collapsed);
+
+  m_batch->setInspectorClass(m_panelConfig->inspClass);
+  refreshUi();
+}
+
+bool
+ChannelBatchWidget::event(QEvent *event)
+{
+  if (event->type() == QEvent::DynamicPropertyChange) {
+    QDynamicPropertyChangeEvent *const propEvent =
+        static_cast<QDynamicPropertyChangeEvent*>(event);
+    QString propName = propEvent->propertyName();
+    if (propName == "collapsed")
+      m_panelConfig->collapsed = property("collapsed").value<bool>();
+  }
+
+  return QWidget::event(event);
+}
+
+void
+ChannelBatchWidget::setState(int, Suscan::Analyzer *analyzer)
+{
+  if (m_analyzer != analyzer) {
+    m_analyzer = analyzer;
+    m_batch->setAnalyzer(analyzer);
+  }
+
+  refreshUi();
+}
+
+////////////////////////////////// Slots ///////////////////////////////////////
+void
+ChannelBatchWidget::onParamsChanged()
+{
+  m_panelConfig->rangeStart = m_ui->startSpin->value();
+  m_panelConfig->rangeEnd   = m_ui->endSpin->value();
+  m_panelConfig->step       = m_ui->stepSpin->value();
+  m_panelConfig->bandwidth  = m_ui->bandwidthSpin->value();
+  m_panelConfig->inspClass  =
+      m_ui->classCombo->currentIndex() == 0 ? "power" : "raw";
+
+  m_batch->setInspectorClass(m_panelConfig->inspClass);
+}
+
+void
+ChannelBatchWidget::onToggleOpen()
+{
+  if (m_ui->openButton->isChecked()) {
+    if (m_batch->open(makeFrequencyList(), m_panelConfig->bandwidth))
+      populateTable();
+  } else {
+    m_batch->close();
+  }
+
+  refreshUi();
+}
+
+void
+ChannelBatchWidget::onRefreshLevels()
+{
+  auto const &channels = m_batch->getChannels();
+  int rows = m_ui->channelTable->rowCount();
+  int row = 0;
+
+  for (auto const &ch : channels) {
+    QTableWidgetItem *item;
+    QString text;
+
+    if (row >= rows)
+      break;
+
+    item = m_ui->channelTable->item(row++, 1);
+    if (item == nullptr)
+      continue;
+
+    if (ch.failed)
+      text = "Failed";
+    else if (!ch.haveLevel)
+      text = "N/A";
+    else
+      text = QString::number(
+            SU_POWER_DB(ch.level > 0 ? ch.level : 1e-20f),
+            'f',
+            1);
+
+    if (item->text() != text)
+      item->setText(text);
+  }
+}
+
+void
+ChannelBatchWidget::onChannelDoubleClicked(int row, int)
+{
+  auto const &channels = m_batch->getChannels();
+
+  if (row < 0 || SCAST(size_t, row) >= channels.size())
+    return;
+
+  m_spectrum->setLoFreq(
+        SCAST(qint64, channels[SCAST(size_t, row)].freq)
+        - m_spectrum->getCenterFreq());
+}
+
+void
+ChannelBatchWidget::onBatchOpened(unsigned opened, unsigned failed)
+{
+  m_ui->statusLabel->setText(
+        QString::number(opened)
+        + " channels open, "
+        + QString::number(failed)
+        + " failed");
+
+  m_refreshTimer->start();
+  refreshUi();
+}
+
+void
+ChannelBatchWidget::onBatchClosed()
+{
+  m_refreshTimer->stop();
+  m_ui->channelTable->setRowCount(0);
+  refreshUi();
+}
+
+void
+ChannelBatchWidget::onBatchError(QString error)
+{
+  refreshUi();
+
+  QMessageBox::warning(
+        this,
+        "Channel batch",
+        error,
+        QMessageBox::Ok);
+}
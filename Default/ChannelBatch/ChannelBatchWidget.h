@@ -0,0 +1,97 @@
+//
+//    Default/ChannelBatch/ChannelBatchWidget.h: Channel batch panel
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef CHANNELBATCHWIDGET_H
+#define CHANNELBATCHWIDGET_H
+
+#include <ToolWidgetFactory.h>
+#include "ChannelBatch.h"
+
+class QTimer;
+
+namespace Ui {
+  class ChannelBatchPanel;
+}
+
+namespace SigDigger {
+  class ChannelBatchWidgetFactory;
+  class MainSpectrum;
+
+  class ChannelBatchWidgetConfig : public Suscan::Serializable {
+  public:
+    bool collapsed        = false;
+    SUFREQ rangeStart     = 144e6;
+    SUFREQ rangeEnd       = 146e6;
+    SUFREQ step           = 12.5e3;
+    SUFREQ bandwidth      = 12.5e3;
+    std::string inspClass = "power";
+
+    // Overriden methods
+    void deserialize(Suscan::Object const &conf) override;
+    Suscan::Object &&serialize() override;
+  };
+
+  class ChannelBatchWidget : public ToolWidget
+  {
+    Q_OBJECT
+
+    ChannelBatchWidgetConfig *m_panelConfig = nullptr;
+
+    ChannelBatch     *m_batch = nullptr;
+    Suscan::Analyzer *m_analyzer = nullptr; // Borrowed
+    QTimer           *m_refreshTimer = nullptr;
+
+    // UI members
+    MainSpectrum *m_spectrum = nullptr;
+    Ui::ChannelBatchPanel *m_ui = nullptr;
+
+    // Private methods
+    void connectAll();
+    void refreshUi();
+    void populateTable();
+    std::vector<SUFREQ> makeFrequencyList() const;
+
+  public:
+    ChannelBatchWidget(
+        ChannelBatchWidgetFactory *,
+        UIMediator *,
+        QWidget *parent = nullptr);
+    ~ChannelBatchWidget() override;
+
+    // Configuration methods
+    Suscan::Serializable *allocConfig() override;
+    void applyConfig() override;
+    bool event(QEvent *) override;
+
+    // Overriden methods
+    void setState(int, Suscan::Analyzer *) override;
+
+  public slots:
+    void onParamsChanged();
+    void onToggleOpen();
+    void onRefreshLevels();
+    void onChannelDoubleClicked(int, int);
+
+    // Batch slots
+    void onBatchOpened(unsigned, unsigned);
+    void onBatchClosed();
+    void onBatchError(QString);
+  };
+}
+
+#endif // CHANNELBATCHWIDGET_H
@@ -0,0 +1,49 @@
+//
+//    Default/ChannelBatch/ChannelBatchWidgetFactory.cpp: description
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "ChannelBatchWidgetFactory.h"
+#include "ChannelBatchWidget.h"
+
+using namespace SigDigger;
+
+const char *
+ChannelBatchWidgetFactory::name() const
+{
+  return "ChannelBatchWidget";
+}
+
+ToolWidget *
+ChannelBatchWidgetFactory::make(UIMediator *mediator)
+{
+  return new ChannelBatchWidget(this, mediator);
+}
+
+ChannelBatchWidgetFactory::ChannelBatchWidgetFactory(Suscan::Plugin *plugin) :
+  ToolWidgetFactory(plugin) { }
+
+const char *
+ChannelBatchWidgetFactory::desc() const
+{
+  return "Channel batch";
+}
+
+std::string
+ChannelBatchWidgetFactory::getTitle() const
+{
+  return desc();
+}
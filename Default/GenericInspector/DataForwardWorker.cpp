@@ -0,0 +1,181 @@
+//
+//    DataForwardWorker.cpp: Record and forward inspector output off the GUI thread
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#include "DataForwardWorker.h"
+#include <GenericDataSaver.h>
+#include <QMutexLocker>
+#include <sigutils/sigutils.h>
+
+using namespace SigDigger;
+
+DataForwardWorker::DataForwardWorker(QObject *parent) : QObject(parent)
+{
+}
+
+bool
+DataForwardWorker::pushData(
+    const SUCOMPLEX *data,
+    SUSCOUNT size,
+    DataForwardSettings const &settings)
+{
+  QMutexLocker locker(&m_mutex);
+
+  if (m_pending.size() + size > DATA_FORWARD_MAX_PENDING)
+    return false;
+
+  // Settings apply from the next batch processed on
+  m_settings = settings;
+  m_pending.insert(m_pending.end(), data, data + size);
+
+  return true;
+}
+
+void
+DataForwardWorker::setRecorder(GenericDataSaver *recorder)
+{
+  QMutexLocker locker(&m_sinkMutex);
+
+  m_recorder = recorder;
+}
+
+void
+DataForwardWorker::setForwarder(GenericDataSaver *forwarder)
+{
+  QMutexLocker locker(&m_sinkMutex);
+
+  m_forwarder = forwarder;
+}
+
+void
+DataForwardWorker::reset()
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_pending.clear();
+}
+
+void
+DataForwardWorker::applySettings(DataForwardSettings const &settings)
+{
+  bool all = !m_haveSettings;
+
+  // The decider is only reconfigured when something changed
+  if (all || settings.mode != m_workSettings.mode)
+    m_decider.setDecisionMode(settings.mode);
+
+  if (all || !sufeq(settings.min, m_workSettings.min, 1e-9f))
+    m_decider.setMinimum(settings.min);
+
+  if (all || !sufeq(settings.max, m_workSettings.max, 1e-9f))
+    m_decider.setMaximum(settings.max);
+
+  if (all || settings.bps != m_workSettings.bps)
+    m_decider.setBps(settings.bps);
+
+  m_workSettings = settings;
+  m_haveSettings = true;
+}
+
+// Called with m_sinkMutex held
+template<typename T> void
+DataForwardWorker::deliver(const T *data, size_t size)
+{
+  if (m_recorder != nullptr)
+    m_recorder->write(data, size);
+
+  if (m_forwarder != nullptr)
+    m_forwarder->write(data, size);
+}
+
+///////////////////////////////////// Slots ///////////////////////////////////
+void
+DataForwardWorker::process()
+{
+  DataForwardSettings settings;
+  const SUCOMPLEX *data;
+  size_t size;
+
+  m_mutex.lock();
+  m_work.swap(m_pending);
+  m_pending.clear();
+  settings = m_settings;
+  m_mutex.unlock();
+
+  if (m_work.empty())
+    return;
+
+  applySettings(settings);
+
+  data = m_work.data();
+  size = m_work.size();
+
+  QMutexLocker locker(&m_sinkMutex);
+
+  if (m_recorder == nullptr && m_forwarder == nullptr)
+    return;
+
+  switch (settings.variable) {
+    case SIGDIGGER_INSPECTOR_UI_DECISION_SPACE:
+      m_floats.resize(size);
+
+      switch (settings.mode) {
+        case Decider::MODULUS:
+          for (size_t i = 0; i < size; ++i)
+            m_floats[i] = SU_C_ABS(data[i]);
+          break;
+
+        case Decider::ARGUMENT:
+          for (size_t i = 0; i < size; ++i)
+            m_floats[i] = SU_C_ARG(SU_I * data[i]) / PI;
+          break;
+      }
+
+      // Decision space: deliver floats
+      deliver(m_floats.data(), size);
+      break;
+
+    case SIGDIGGER_INSPECTOR_UI_SOFT_BITS:
+      // Pure softbits: deliver complex I/Q samples
+      deliver(data, size);
+      break;
+
+    case SIGDIGGER_INSPECTOR_UI_SOFT_BITS_I:
+      m_floats.resize(size);
+      for (size_t i = 0; i < size; ++i)
+        m_floats[i] = SU_C_REAL(data[i]);
+
+      deliver(m_floats.data(), size);
+      break;
+
+    case SIGDIGGER_INSPECTOR_UI_SOFT_BITS_Q:
+      m_floats.resize(size);
+      for (size_t i = 0; i < size; ++i)
+        m_floats[i] = SU_C_IMAG(data[i]);
+
+      deliver(m_floats.data(), size);
+      break;
+
+    case SIGDIGGER_INSPECTOR_UI_SYMBOLS:
+      if (settings.bps > 0) {
+        m_decider.feed(data, size);
+        deliver(m_decider.get().data(), m_decider.get().size());
+      }
+      break;
+  }
+}
@@ -0,0 +1,101 @@
+//
+//    DataForwardWorker.h: Record and forward inspector output off the GUI thread
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#ifndef DATAFORWARDWORKER_H
+#define DATAFORWARDWORKER_H
+
+#include <QObject>
+#include <QMutex>
+#include <vector>
+#include <sigutils/types.h>
+#include "Decider.h"
+
+#define SIGDIGGER_INSPECTOR_UI_DECISION_SPACE 0
+#define SIGDIGGER_INSPECTOR_UI_SOFT_BITS      1
+#define SIGDIGGER_INSPECTOR_UI_SOFT_BITS_I    2
+#define SIGDIGGER_INSPECTOR_UI_SOFT_BITS_Q    3
+#define SIGDIGGER_INSPECTOR_UI_SYMBOLS        4
+
+// Samples waiting to be converted. Beyond this, the worker is swamped.
+#define DATA_FORWARD_MAX_PENDING (1 << 22)
+
+namespace SigDigger {
+  class GenericDataSaver;
+
+  // What to deliver, and how to decide symbols
+  struct DataForwardSettings {
+    int                   variable = SIGDIGGER_INSPECTOR_UI_SOFT_BITS;
+    Decider::DecisionMode mode     = Decider::ARGUMENT;
+    SUFLOAT               min      = 0;
+    SUFLOAT               max      = 0;
+    unsigned int          bps      = 0;
+  };
+
+  //
+  // Turns the inspector output into the selected data variable (decision
+  // space, soft bits, symbols...) and writes it to the recorder and the
+  // forwarder. It runs in the processing thread of the inspector, so the
+  // per-sample work of recording and forwarding follows the affinity and
+  // priority of that thread instead of competing with the GUI.
+  //
+  class DataForwardWorker : public QObject
+  {
+    Q_OBJECT
+
+    // Shared with the GUI thread
+    QMutex                 m_mutex;
+    std::vector<SUCOMPLEX> m_pending;
+    DataForwardSettings    m_settings;
+
+    // Held while writing, so sinks can be removed safely
+    QMutex                 m_sinkMutex;
+    GenericDataSaver      *m_recorder  = nullptr;
+    GenericDataSaver      *m_forwarder = nullptr;
+
+    // Worker thread only
+    std::vector<SUCOMPLEX> m_work;
+    std::vector<SUFLOAT>   m_floats;
+    DataForwardSettings    m_workSettings;
+    bool                   m_haveSettings = false;
+    Decider                m_decider;
+
+    void applySettings(DataForwardSettings const &);
+
+    template<typename T> void deliver(const T *data, size_t size);
+
+  public:
+    explicit DataForwardWorker(QObject *parent = nullptr);
+
+    // Called from the GUI thread. False if the worker is swamped.
+    bool pushData(
+        const SUCOMPLEX *data,
+        SUSCOUNT size,
+        DataForwardSettings const &settings);
+
+    // Blocks until any write in progress is done
+    void setRecorder(GenericDataSaver *);
+    void setForwarder(GenericDataSaver *);
+    void reset();
+
+  public slots:
+    void process();
+  };
+}
+
+#endif // DATAFORWARDWORKER_H
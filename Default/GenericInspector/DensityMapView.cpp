@@ -0,0 +1,97 @@
+//
+//    DensityMapView.cpp: Display a constellation density map
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#include "DensityMapView.h"
+#include "DensityMapWorker.h"
+#include <QPainter>
+
+using namespace SigDigger;
+
+DensityMapView::DensityMapView(QWidget *parent) : QWidget(parent)
+{
+  setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void
+DensityMapView::setImage(QImage const &image)
+{
+  m_image = image;
+  update();
+}
+
+void
+DensityMapView::clear()
+{
+  m_image = QImage();
+  update();
+}
+
+void
+DensityMapView::setBackgroundColor(QColor const &color)
+{
+  m_background = color;
+  update();
+}
+
+void
+DensityMapView::setAxesColor(QColor const &color)
+{
+  m_axes = color;
+  update();
+}
+
+void
+DensityMapView::setSizeHint(QSize const &size)
+{
+  m_sizeHint = size;
+  updateGeometry();
+}
+
+QSize
+DensityMapView::sizeHint() const
+{
+  return m_sizeHint;
+}
+
+void
+DensityMapView::paintEvent(QPaintEvent *)
+{
+  QPainter painter(this);
+  QRectF r = rect();
+  qreal unitX = r.width()  / (2 * DENSITY_MAP_RANGE);
+  qreal unitY = r.height() / (2 * DENSITY_MAP_RANGE);
+
+  // Scaled without smoothing, so bins stay sharp
+  if (m_image.isNull())
+    painter.fillRect(r, m_background);
+  else
+    painter.drawImage(r, m_image);
+
+  painter.setPen(QPen(m_axes, 1, Qt::DotLine));
+  painter.drawLine(
+        QPointF(r.left(), r.center().y()),
+        QPointF(r.right(), r.center().y()));
+  painter.drawLine(
+        QPointF(r.center().x(), r.top()),
+        QPointF(r.center().x(), r.bottom()));
+
+  // Unit circle, for reference
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.drawEllipse(r.center(), unitX, unitY);
+}
@@ -0,0 +1,56 @@
+//
+//    DensityMapView.h: Display a constellation density map
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#ifndef DENSITYMAPVIEW_H
+#define DENSITYMAPVIEW_H
+
+#include <QWidget>
+#include <QImage>
+
+namespace SigDigger {
+  //
+  // Draws the images produced by a DensityMapWorker, scaled to the
+  // widget, with the same axes as the point constellation.
+  //
+  class DensityMapView : public QWidget
+  {
+    Q_OBJECT
+
+    QImage m_image;
+    QColor m_background = QColor(0, 0, 0);
+    QColor m_axes       = QColor(128, 128, 128);
+    QSize  m_sizeHint   = QSize(100, 100);
+
+  protected:
+    void paintEvent(QPaintEvent *) override;
+
+  public:
+    explicit DensityMapView(QWidget *parent = nullptr);
+
+    void setImage(QImage const &);
+    void clear();
+    void setBackgroundColor(QColor const &);
+    void setAxesColor(QColor const &);
+    void setSizeHint(QSize const &);
+
+    QSize sizeHint() const override;
+  };
+}
+
+#endif // DENSITYMAPVIEW_H
@@ -0,0 +1,186 @@
+//
+//    DensityMapWorker.cpp: Accumulate constellation density off the GUI thread
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#include "DensityMapWorker.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+
+using namespace SigDigger;
+
+DensityMapWorker::DensityMapWorker(QObject *parent) : QObject(parent)
+{
+  // Grayscale until the inspector tells us its palette
+  for (int i = 0; i < 256; ++i)
+    m_palette[i] = m_workPalette[i] = qRgb(i, i, i);
+
+  m_background = m_workBackground = qRgb(0, 0, 0);
+
+  m_bins.resize(DENSITY_MAP_SIZE * DENSITY_MAP_SIZE);
+}
+
+void
+DensityMapWorker::pushData(const SUCOMPLEX *data, SUSCOUNT size)
+{
+  QMutexLocker locker(&m_mutex);
+
+  if (m_pending.size() + size > DENSITY_MAP_MAX_PENDING)
+    return;
+
+  m_pending.insert(m_pending.end(), data, data + size);
+}
+
+void
+DensityMapWorker::setPalette(const QColor *gradient)
+{
+  QMutexLocker locker(&m_mutex);
+
+  for (int i = 0; i < 256; ++i)
+    m_palette[i] = gradient[i].rgb();
+}
+
+void
+DensityMapWorker::setBackgroundColor(QColor const &color)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_background = color.rgb();
+}
+
+void
+DensityMapWorker::setRate(unsigned int fps)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_rate = std::max(1u, fps);
+}
+
+void
+DensityMapWorker::reset()
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_pending.clear();
+  m_reset = true;
+}
+
+void
+DensityMapWorker::acknowledgeFrame()
+{
+  m_framePending.storeRelease(0);
+}
+
+void
+DensityMapWorker::bin(const SUCOMPLEX *data, SUSCOUNT size)
+{
+  const float scale = DENSITY_MAP_SIZE / (2 * DENSITY_MAP_RANGE);
+  float *bins = m_bins.data();
+
+  for (SUSCOUNT i = 0; i < size; ++i) {
+    float x = (SU_C_REAL(data[i]) + DENSITY_MAP_RANGE) * scale;
+    float y = (DENSITY_MAP_RANGE - SU_C_IMAG(data[i])) * scale;
+
+    // Also rejects NaNs
+    if (x >= 0 && x < DENSITY_MAP_SIZE && y >= 0 && y < DENSITY_MAP_SIZE)
+      bins[static_cast<int>(y) * DENSITY_MAP_SIZE + static_cast<int>(x)] += 1;
+  }
+}
+
+void
+DensityMapWorker::decay(qint64 elapsedMs)
+{
+  float k = static_cast<float>(
+        std::exp(-static_cast<double>(elapsedMs) / DENSITY_MAP_DECAY_MS));
+
+  for (auto &v : m_bins)
+    v *= k;
+}
+
+QImage
+DensityMapWorker::render() const
+{
+  QImage image(DENSITY_MAP_SIZE, DENSITY_MAP_SIZE, QImage::Format_RGB32);
+  float max = *std::max_element(m_bins.begin(), m_bins.end());
+  float norm;
+
+  if (max < 1) {
+    image.fill(m_workBackground);
+    return image;
+  }
+
+  // Log scale: sparse transitions stay visible next to dense clusters
+  norm = 255.f / std::log1p(max);
+
+  for (int j = 0; j < DENSITY_MAP_SIZE; ++j) {
+    QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(j));
+    const float *row = m_bins.data() + j * DENSITY_MAP_SIZE;
+
+    for (int i = 0; i < DENSITY_MAP_SIZE; ++i) {
+      // Less than a sample left: treat as empty
+      if (row[i] < .5f) {
+        line[i] = m_workBackground;
+      } else {
+        int index = static_cast<int>(std::log1p(row[i]) * norm);
+        line[i] = m_workPalette[std::min(index, 255)];
+      }
+    }
+  }
+
+  return image;
+}
+
+///////////////////////////////////// Slots ///////////////////////////////////
+void
+DensityMapWorker::process()
+{
+  qint64 elapsed;
+  unsigned int rate;
+  bool reset;
+
+  m_mutex.lock();
+  m_work.swap(m_pending);
+  m_pending.clear();
+  std::copy(m_palette, m_palette + 256, m_workPalette);
+  m_workBackground = m_background;
+  rate  = m_rate;
+  reset = m_reset;
+  m_reset = false;
+  m_mutex.unlock();
+
+  if (reset || !m_frameTimer.isValid()) {
+    std::fill(m_bins.begin(), m_bins.end(), 0.f);
+    m_frameTimer.start();
+  }
+
+  bin(m_work.data(), m_work.size());
+
+  // Previous image not drawn yet: keep accumulating
+  if (m_framePending.loadAcquire() != 0)
+    return;
+
+  elapsed = m_frameTimer.elapsed();
+  if (elapsed * rate < 1000)
+    return;
+
+  m_frameTimer.restart();
+  decay(elapsed);
+
+  m_framePending.storeRelease(1);
+  emit frame(render());
+}
@@ -0,0 +1,99 @@
+//
+//    DensityMapWorker.h: Accumulate constellation density off the GUI thread
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#ifndef DENSITYMAPWORKER_H
+#define DENSITYMAPWORKER_H
+
+#include <QObject>
+#include <QColor>
+#include <QImage>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <vector>
+#include <sigutils/types.h>
+
+// Side of the (square) density image, in bins
+#define DENSITY_MAP_SIZE          256
+
+// Half-width of the I/Q plane covered by the map. Leaves some headroom
+// over the unit circle the inspector gain control aims at.
+#define DENSITY_MAP_RANGE         1.5f
+
+// Time for the density of a bin to decay to 1/e
+#define DENSITY_MAP_DECAY_MS      250
+
+// Samples waiting to be binned. Beyond this, new samples are dropped
+// until the worker catches up.
+#define DENSITY_MAP_MAX_PENDING   (1 << 22)
+
+#define DENSITY_MAP_DEFAULT_RATE  60
+
+namespace SigDigger {
+  //
+  // 2D histogram of the inspector output. Every sample is binned, no
+  // matter the symbol rate, and the histogram decays exponentially with
+  // time. At most one palette-mapped image of fixed size is emitted per
+  // frame period, and only once the previous one has been acknowledged,
+  // so the GUI cost does not depend on the sample rate.
+  //
+  class DensityMapWorker : public QObject
+  {
+    Q_OBJECT
+
+    // Shared with the GUI thread
+    QMutex                 m_mutex;
+    std::vector<SUCOMPLEX> m_pending;
+    QRgb                   m_palette[256];
+    QRgb                   m_background;
+    unsigned int           m_rate = DENSITY_MAP_DEFAULT_RATE;
+    bool                   m_reset = false;
+    QAtomicInt             m_framePending = 0;
+
+    // Worker thread only
+    std::vector<SUCOMPLEX> m_work;
+    std::vector<float>     m_bins;
+    QRgb                   m_workPalette[256];
+    QRgb                   m_workBackground;
+    QElapsedTimer          m_frameTimer;
+
+    void bin(const SUCOMPLEX *data, SUSCOUNT size);
+    void decay(qint64 elapsedMs);
+    QImage render() const;
+
+  public:
+    explicit DensityMapWorker(QObject *parent = nullptr);
+
+    // Called from the GUI thread
+    void pushData(const SUCOMPLEX *data, SUSCOUNT size);
+    void setPalette(const QColor *gradient);
+    void setBackgroundColor(QColor const &);
+    void setRate(unsigned int fps);
+    void reset();
+    void acknowledgeFrame();
+
+  signals:
+    void frame(QImage);
+
+  public slots:
+    void process();
+  };
+}
+
+#endif // DENSITYMAPWORKER_H
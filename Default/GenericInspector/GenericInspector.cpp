@@ -21,6 +21,13 @@
 #include "GenericInspector.h"
 #include <SuWidgetsHelpers.h>
 #include <UIMediator.h>
+#include <ProcessingThread.h>
+#include <QAction>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QTimer>
+
+#define SIGDIGGER_GENERIC_INSPECTOR_LOAD_INTERVAL_MS 1000
 
 using namespace SigDigger;
 
@@ -38,9 +45,12 @@ GenericInspectorConfig::deserialize(Suscan::Object const &conf)
   LOAD(waveFormContrast);
   LOAD(peakHold);
   LOAD(peakDetect);
+  LOAD(densityMap);
   LOAD(units);
   LOAD(gain);
   LOAD(zeroPoint);
+  LOAD(threadAffinity);
+  LOAD(threadPriority);
 }
 
 Suscan::Object &&
@@ -57,9 +67,12 @@ GenericInspectorConfig::serialize(void)
   STORE(waveFormContrast);
   STORE(peakHold);
   STORE(peakDetect);
+  STORE(densityMap);
   STORE(units);
   STORE(gain);
   STORE(zeroPoint);
+  STORE(threadAffinity);
+  STORE(threadPriority);
 
   return this->persist(obj);
 }
@@ -88,6 +101,36 @@ GenericInspector::GenericInspector(
   this->ui->setBandwidth(static_cast<unsigned int>(request.bandwidth));
   this->ui->setLo(static_cast<int>(request.lo));
 
+  m_watermark = new Suscan::WatermarkController(this);
+  m_watermark->setProfile(m_wmProfile);
+
+  QAction *threadSettings = new QAction("Processing &thread...", this);
+  this->addAction(threadSettings);
+
+  m_loadTimer = new QTimer(this);
+  m_loadTimer->setInterval(SIGDIGGER_GENERIC_INSPECTOR_LOAD_INTERVAL_MS);
+  m_loadTimer->start();
+
+  this->applyThreadConfig();
+
+  connect(
+        m_watermark,
+        SIGNAL(watermarkChanged(quint64, qreal)),
+        this,
+        SLOT(onWatermarkChanged(quint64, qreal)));
+
+  connect(
+        threadSettings,
+        SIGNAL(triggered()),
+        this,
+        SLOT(onChangeThreadSettings()));
+
+  connect(
+        m_loadTimer,
+        SIGNAL(timeout()),
+        this,
+        SLOT(onRefreshThreadLoad()));
+
   this->connect(
         this->ui,
         SIGNAL(configChanged()),
@@ -158,6 +201,12 @@ GenericInspector::attachAnalyzer(Suscan::Analyzer *analyzer)
 {
   this->ui->setState(InspectorUI::ATTACHED);
 
+  // The output rate depends on the inspector class and its sampler
+  // settings, so we let the controller measure it. Backlogs are then
+  // told apart by bursts above the measured rate.
+  m_watermark->setAnalyzer(analyzer);
+  m_watermark->setInspector(this->request().handle);
+
   connect(
         analyzer,
         SIGNAL(source_info_message(Suscan::SourceInfoMessage const &)),
@@ -169,6 +218,8 @@ void
 GenericInspector::detachAnalyzer()
 {
   this->ui->setState(InspectorUI::DETACHED);
+
+  m_watermark->setAnalyzer(nullptr);
 }
 
 
@@ -274,7 +325,11 @@ GenericInspector::inspectorMessage(Suscan::InspectorMessage const &msg)
 void
 GenericInspector::samplesMessage(Suscan::SamplesMessage const &msg)
 {
+  this->refreshWatermarkProfile();
+
+  m_watermark->beginBatch();
   this->feed(msg.getSamples(), msg.getCount());
+  m_watermark->endBatch(msg.getCount());
 }
 
 std::string
@@ -295,6 +350,7 @@ void
 GenericInspector::applyConfig(void)
 {
   this->ui->setAppConfig(*this->mediator()->getAppConfig());
+  this->applyThreadConfig();
 }
 
 ///////////////////////////// Private methods /////////////////////////////////
@@ -318,6 +374,51 @@ GenericInspector::getInspectorTabTitle() const
 }
 
 
+void
+GenericInspector::refreshWatermarkProfile(void)
+{
+  Suscan::WatermarkProfile profile = Suscan::WATERMARK_PROFILE_CONSTELLATION;
+
+  // Recordings tolerate latency, forwarded data does not
+  if (this->ui->isForwarding())
+    profile = Suscan::WATERMARK_PROFILE_FORWARDING;
+  else if (this->ui->isRecording())
+    profile = Suscan::WATERMARK_PROFILE_RECORDING;
+
+  if (profile != m_wmProfile) {
+    m_wmProfile = profile;
+    m_watermark->setProfile(profile);
+  }
+}
+
+bool
+GenericInspector::applyThreadConfig(void)
+{
+  ProcessingThread *thread = this->ui->getProcessingThread();
+  QList<int> cpus;
+  bool ok, prioOk;
+
+  if (thread == nullptr)
+    return true;
+
+  // Stale or hand-edited configs may hold anything here
+  if (m_uiConfig->threadPriority < QThread::IdlePriority
+      || m_uiConfig->threadPriority > QThread::InheritPriority)
+    m_uiConfig->threadPriority = QThread::InheritPriority;
+
+  cpus = ProcessingThread::parseCpuList(
+        QString::fromStdString(m_uiConfig->threadAffinity),
+        &ok);
+
+  if (!ok)
+    cpus.clear();
+
+  prioOk = thread->setProcessingPriority(
+        static_cast<QThread::Priority>(m_uiConfig->threadPriority));
+
+  return thread->setAffinity(cpus) && prioOk;
+}
+
 void
 GenericInspector::feed(const SUCOMPLEX *data, unsigned int size)
 {
@@ -407,6 +508,103 @@ GenericInspector::~GenericInspector()
 }
 
 /////////////////////////////////// Slots /////////////////////////////////////
+void
+GenericInspector::onWatermarkChanged(quint64 samples, qreal latency)
+{
+  this->ui->setBatchInfo(samples, latency);
+}
+
+void
+GenericInspector::onRefreshThreadLoad(void)
+{
+  ProcessingThread *thread = this->ui->getProcessingThread();
+
+  if (thread != nullptr)
+    this->ui->setThreadLoad(thread->load());
+}
+
+void
+GenericInspector::onChangeThreadSettings(void)
+{
+  static const QStringList priorities = {
+    "Inherit",
+    "Idle",
+    "Lowest",
+    "Low",
+    "Normal",
+    "High",
+    "Highest",
+    "Time critical"};
+  static const QThread::Priority values[] = {
+    QThread::InheritPriority,
+    QThread::IdlePriority,
+    QThread::LowestPriority,
+    QThread::LowPriority,
+    QThread::NormalPriority,
+    QThread::HighPriority,
+    QThread::HighestPriority,
+    QThread::TimeCriticalPriority};
+  ProcessingThread *thread = this->ui->getProcessingThread();
+  QString cpuList, priority;
+  QList<int> cpus;
+  int current = 0;
+  bool ok;
+
+  if (thread == nullptr)
+    return;
+
+  cpuList = QInputDialog::getText(
+        this,
+        "Processing thread",
+        "CPUs this inspector may run on (e.g. 0,2-3, empty for any):",
+        QLineEdit::Normal,
+        ProcessingThread::formatCpuList(thread->affinity()),
+        &ok);
+
+  if (!ok)
+    return;
+
+  cpus = ProcessingThread::parseCpuList(cpuList, &ok);
+  if (!ok) {
+    QMessageBox::warning(
+          this,
+          "Processing thread",
+          "Invalid CPU list <b>" + cpuList.toHtmlEscaped() + "</b>",
+          QMessageBox::Ok);
+    return;
+  }
+
+  for (int i = 0; i < priorities.size(); ++i)
+    if (values[i] == thread->processingPriority())
+      current = i;
+
+  priority = QInputDialog::getItem(
+        this,
+        "Processing thread",
+        "Thread priority:",
+        priorities,
+        current,
+        false,
+        &ok);
+
+  if (!ok)
+    return;
+
+  m_uiConfig->threadAffinity =
+      ProcessingThread::formatCpuList(cpus).toStdString();
+  m_uiConfig->threadPriority =
+      static_cast<int>(values[priorities.indexOf(priority)]);
+
+  if (!this->applyThreadConfig())
+    QMessageBox::warning(
+          this,
+          "Processing thread",
+          "Failed to apply the processing thread settings. Make sure the "
+          "requested CPUs exist and are available to SigDigger, and that "
+          "it is allowed to raise thread priorities.",
+          QMessageBox::Ok);
+}
+
 void
 GenericInspector::onConfigChanged(void)
 {
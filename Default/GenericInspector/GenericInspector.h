@@ -21,12 +21,16 @@
 #define GENERICINSPECTOR_H
 
 #include <QWidget>
+#include <QThread>
 #include <Suscan/Analyzer.h>
 #include <Suscan/Config.h>
+#include <Suscan/WatermarkController.h>
 #include "InspectorUI.h"
 
 #include <InspectionWidgetFactory.h>
 
+class QTimer;
+
 namespace SigDigger {
   class AppConfig;
 
@@ -38,9 +42,12 @@ namespace SigDigger {
     int          waveFormContrast  = 1;
     bool         peakHold          = false;
     bool         peakDetect        = false;
+    bool         densityMap        = false;
     std::string  units             = "dBFS";
     float        gain              = 0;
     float        zeroPoint         = 0;
+    std::string  threadAffinity    = "";
+    int          threadPriority    = QThread::InheritPriority;
 
     void deserialize(Suscan::Object const &conf) override;
     Suscan::Object &&serialize() override;
@@ -59,6 +66,14 @@ namespace SigDigger {
       bool adjusted = false;
       qint64 m_tunerFreq;
 
+      // Sample delivery
+      Suscan::WatermarkController *m_watermark = nullptr;
+      Suscan::WatermarkProfile m_wmProfile =
+          Suscan::WATERMARK_PROFILE_CONSTELLATION;
+
+      // Processing thread
+      QTimer *m_loadTimer = nullptr;
+
       QString getInspectorTabTitle() const;
 
       void feed(const SUCOMPLEX *data, unsigned int size);
@@ -70,6 +85,8 @@ namespace SigDigger {
       void updateEstimator(Suscan::EstimatorId id, float val);
       void notifyOrbitReport(Suscan::OrbitReport const &);
       void disableCorrection(void);
+      void refreshWatermarkProfile(void);
+      bool applyThreadConfig(void);
       void setTunerFrequency(SUFREQ freq);
       void setRealTime(bool);
       void setTimeLimits(
@@ -120,6 +137,10 @@ namespace SigDigger {
           qreal bw,
           bool precise);
 
+      void onWatermarkChanged(quint64, qreal);
+      void onRefreshThreadLoad(void);
+      void onChangeThreadSettings(void);
+
       // Analyzer slots
       void onSourceInfoMessage(Suscan::SourceInfoMessage const &);
   };
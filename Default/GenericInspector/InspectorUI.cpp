@@ -214,6 +214,34 @@ InspectorUI::InspectorUI(
   this->tvTab = new TVProcessorTab(this->ui->toolTab, 0);
   this->ui->toolTab->addTab(this->tvTab, "Analog TV");
 
+  // Same cell as the constellation, shown instead of it on demand
+  this->densityMap = new DensityMapView(this->ui->frame_3);
+  this->densityMap->setSizePolicy(this->ui->constellation->sizePolicy());
+  this->densityMap->setMinimumSize(this->ui->constellation->minimumSize());
+  this->densityMap->setSizeHint(this->ui->constellation->sizeHint());
+  this->densityMap->hide();
+  this->ui->gridLayout_4->addWidget(this->densityMap, 1, 1, 3, 1);
+
+  // Binning happens in the processing thread of the inspector
+  this->densityWorker = new DensityMapWorker();
+  this->densityWorker->moveToThread(this->tvTab->processingThread());
+
+  connect(
+        this->tvTab->processingThread(),
+        &QThread::finished,
+        this->densityWorker,
+        &QObject::deleteLater);
+
+  // So do recording and forwarding of the inspector output
+  this->dataWorker = new DataForwardWorker();
+  this->dataWorker->moveToThread(this->tvTab->processingThread());
+
+  connect(
+        this->tvTab->processingThread(),
+        &QThread::finished,
+        this->dataWorker,
+        &QObject::deleteLater);
+
   this->fcDialog = new FrequencyCorrectionDialog(
         owner,
         0,
@@ -267,11 +295,14 @@ InspectorUI::~InspectorUI()
 {
   delete this->ui;
 
+  this->dataWorker->setRecorder(nullptr);
+  this->dataWorker->setForwarder(nullptr);
+
   if (this->dataSaver != nullptr)
     delete this->dataSaver;
 
-  if (this->socketForwarder != nullptr)
-    delete this->socketForwarder;
+  if (this->netForwarder != nullptr)
+    delete this->netForwarder;
 }
 
 void
@@ -422,6 +453,8 @@ InspectorUI::setPalette(std::string const &str)
 
   WATERFALL_CALL(setPalette(
         SigDiggerHelpers::instance()->getPalette(index)->getGradient()));
+  this->densityWorker->setPalette(
+        SigDiggerHelpers::instance()->getPalette(index)->getGradient());
   this->ui->paletteCombo->setCurrentIndex(index);
 
   m_tabConfig->spectrumPalette = str;
@@ -485,6 +518,30 @@ InspectorUI::connectAll()
         this,
         SLOT(onFPSReset()));
 
+  connect(
+        this->ui->densityButton,
+        SIGNAL(clicked(bool)),
+        this,
+        SLOT(onToggleDensityMap()));
+
+  connect(
+        this,
+        SIGNAL(densityMapData()),
+        this->densityWorker,
+        SLOT(process()));
+
+  connect(
+        this->densityWorker,
+        SIGNAL(frame(QImage)),
+        this,
+        SLOT(onDensityMapFrame(QImage)));
+
+  connect(
+        this,
+        SIGNAL(forwardData()),
+        this->dataWorker,
+        SLOT(process()));
+
 
   connect(
         this->ui->paletteCombo,
@@ -621,31 +678,31 @@ void
 InspectorUI::connectNetForwarder()
 {
   connect(
-        this->socketForwarder,
+        this->netForwarder,
         SIGNAL(stopped(void)),
         this,
         SLOT(onNetError(void)));
 
   connect(
-        this->socketForwarder,
+        this->netForwarder,
         SIGNAL(swamped(void)),
         this,
         SLOT(onNetSwamped(void)));
 
   connect(
-        this->socketForwarder,
+        this->netForwarder,
         SIGNAL(dataRate(qreal)),
         this,
         SLOT(onNetRate(qreal)));
 
   connect(
-        this->socketForwarder,
+        this->netForwarder,
         SIGNAL(commit(void)),
         this,
         SLOT(onNetCommit(void)));
 
   connect(
-        this->socketForwarder,
+        this->netForwarder,
         SIGNAL(ready(void)),
         this,
         SLOT(onNetReady(void)));
@@ -678,16 +735,27 @@ InspectorUI::captureFileName(void) const
 bool
 InspectorUI::installNetForwarder(void)
 {
-  if (this->socketForwarder == nullptr) {
-    this->socketForwarder = new SocketForwarder(
-          this->netForwarderUI->getHost(),
-          this->netForwarderUI->getPort(),
-          this->netForwarderUI->getFrameLen(),
-          this->netForwarderUI->getTcp(),
-          this);
+  if (this->netForwarder == nullptr) {
     this->recordingRate = this->getBaudRate();
-    this->socketForwarder->setSampleRate(recordingRate);
+
+    if (this->netForwarderUI->getTransport()
+        == NetForwarderUI::TRANSPORT_SHM)
+      this->netForwarder = new SharedMemoryForwarder(
+            this->netForwarderUI->getSegment(),
+            this->recordingRate,
+            SIGDIGGER_SHMFORWARDER_DEFAULT_CAPACITY,
+            this);
+    else
+      this->netForwarder = new SocketForwarder(
+            this->netForwarderUI->getHost(),
+            this->netForwarderUI->getPort(),
+            this->netForwarderUI->getFrameLen(),
+            this->netForwarderUI->getTcp(),
+            this);
+
+    this->netForwarder->setSampleRate(recordingRate);
     connectNetForwarder();
+    this->dataWorker->setForwarder(this->netForwarder);
 
     return true;
   }
@@ -698,9 +766,11 @@ InspectorUI::installNetForwarder(void)
 void
 InspectorUI::uninstallNetForwarder(void)
 {
-  if (this->socketForwarder)
-    this->socketForwarder->deleteLater();
-  this->socketForwarder = nullptr;
+  this->dataWorker->setForwarder(nullptr);
+
+  if (this->netForwarder)
+    this->netForwarder->deleteLater();
+  this->netForwarder = nullptr;
 }
 
 void
@@ -756,6 +826,7 @@ InspectorUI::installDataSaver(void)
     this->recordingRate = this->getBaudRate();
     this->dataSaver->setSampleRate(recordingRate);
     connectDataSaver();
+    this->dataWorker->setRecorder(this->dataSaver);
 
     return true;
   }
@@ -766,6 +837,8 @@ InspectorUI::installDataSaver(void)
 void
 InspectorUI::uninstallDataSaver(void)
 {
+  this->dataWorker->setRecorder(nullptr);
+
   if (this->dataSaver != nullptr)
     this->dataSaver->deleteLater();
   this->dataSaver = nullptr;
@@ -805,12 +878,14 @@ void
 InspectorUI::feed(const SUCOMPLEX *data, unsigned int size)
 {
   bool dataForwarding = this->recording || this->forwarding;
-  bool symbolForwarding =
-      this->ui->dataVarCombo->currentIndex() == SIGDIGGER_INSPECTOR_UI_SYMBOLS;
-  bool decisionNeeded =
-      (dataForwarding && symbolForwarding) || this->symViewTab->isRecording();
-  bool haveDecision = false;
-  this->ui->constellation->feed(data, size);
+
+  if (m_tabConfig->densityMap) {
+    this->densityWorker->pushData(data, size);
+    emit densityMapData();
+  } else {
+    this->ui->constellation->feed(data, size);
+  }
+
   this->ui->histogram->feed(data, size);
 
   if (this->estimating) {
@@ -830,16 +905,12 @@ InspectorUI::feed(const SUCOMPLEX *data, unsigned int size)
     }
   }
 
-  // Decision happens here.
-  if (decisionNeeded) {
+  // Decision happens here. Recorded symbols are decided by the data worker.
+  if (this->symViewTab->isRecording()) {
     if (this->decider.getBps() > 0) {
       this->decider.feed(data, size);
-      haveDecision = true;
-
-      if (this->symViewTab->isRecording()) {
-        this->symViewTab->feed(this->decider.get());
-        this->ui->transition->feed(this->decider.get());
-      }
+      this->symViewTab->feed(this->decider.get());
+      this->ui->transition->feed(this->decider.get());
     }
   }
 
@@ -853,80 +924,22 @@ InspectorUI::feed(const SUCOMPLEX *data, unsigned int size)
     this->wfTab->feed(data, size);
 
   if (dataForwarding) {
-    switch (this->ui->dataVarCombo->currentIndex()) {
-      case SIGDIGGER_INSPECTOR_UI_DECISION_SPACE:
-        if (this->floatBuffer.size() < size)
-          this->floatBuffer.resize(size);
-
-        switch (this->decider.getDecisionMode()) {
-          case Decider::MODULUS:
-            for (unsigned i = 0; i < size; ++i)
-              this->floatBuffer[i] = SU_C_ABS(data[i]);
-            break;
-
-          case Decider::ARGUMENT:
-            for (unsigned i = 0; i < size; ++i)
-              this->floatBuffer[i] = SU_C_ARG(SU_I * data[i]) / PI;
-            break;
-        }
-
-        // Decision space: deliver floats
-        if (this->recording)
-          this->dataSaver->write(this->floatBuffer.data(), size);
-
-        if (this->forwarding)
-          this->socketForwarder->write(this->floatBuffer.data(), size);
-
-        break;
-
-      case SIGDIGGER_INSPECTOR_UI_SOFT_BITS:
-        // Pure softbits: deliver complex I/Q samples
-        if (this->recording)
-          this->dataSaver->write(data, size);
-
-        if (this->forwarding)
-          this->socketForwarder->write(data, size);
-        break;
-
-      case SIGDIGGER_INSPECTOR_UI_SOFT_BITS_I:
-        if (this->floatBuffer.size() < size)
-          this->floatBuffer.resize(size);
-        for (unsigned i = 0; i < size; ++i)
-          this->floatBuffer[i] = SU_C_REAL(data[i]);
-
-        if (this->recording)
-          this->dataSaver->write(this->floatBuffer.data(), size);
-
-        if (this->forwarding)
-          this->socketForwarder->write(this->floatBuffer.data(), size);
-        break;
-
-      case SIGDIGGER_INSPECTOR_UI_SOFT_BITS_Q:
-        if (this->floatBuffer.size() < size)
-          this->floatBuffer.resize(size);
-        for (unsigned i = 0; i < size; ++i)
-          this->floatBuffer[i] = SU_C_IMAG(data[i]);
-
-        if (this->recording)
-          this->dataSaver->write(this->floatBuffer.data(), size);
-
-        if (this->forwarding)
-          this->socketForwarder->write(this->floatBuffer.data(), size);
-        break;
-
-      case SIGDIGGER_INSPECTOR_UI_SYMBOLS:
-        if (haveDecision) {
-          if (this->recording)
-            this->dataSaver->write(
-                this->decider.get().data(),
-                this->decider.get().size());
-
-          if (this->forwarding)
-            this->socketForwarder->write(
-                this->decider.get().data(),
-                this->decider.get().size());
-        }
-        break;
+    DataForwardSettings settings;
+
+    settings.variable = this->ui->dataVarCombo->currentIndex();
+    settings.mode     = this->decider.getDecisionMode();
+    settings.min      = this->decider.getMinimum();
+    settings.max      = this->decider.getMaximum();
+    settings.bps      = this->decider.getBps();
+
+    if (this->dataWorker->pushData(data, size, settings)) {
+      emit forwardData();
+    } else {
+      this->dataWorker->reset();
+      if (this->recording)
+        this->onSaveSwamped();
+      if (this->forwarding)
+        this->onNetSwamped();
     }
   }
 }
@@ -1033,6 +1046,59 @@ InspectorUI::getState(void) const
   return this->state;
 }
 
+bool
+InspectorUI::isRecording(void) const
+{
+  return this->recording;
+}
+
+bool
+InspectorUI::isForwarding(void) const
+{
+  return this->forwarding;
+}
+
+void
+InspectorUI::refreshBatchInfo(void)
+{
+  QString info =
+      "Batch size: "
+      + QString::number(this->batchSamples)
+      + " samples ("
+      + SuWidgetsHelpers::formatQuantity(this->batchLatency, 3, "s")
+      + ")";
+
+  if (this->threadLoad >= 0)
+    info += "\nProcessing thread: "
+        + QString::number(this->threadLoad * 100, 'f', 1)
+        + "% CPU";
+
+  this->ui->sampleRateLabel->setToolTip(info);
+}
+
+void
+InspectorUI::setBatchInfo(quint64 samples, qreal latency)
+{
+  this->batchSamples = samples;
+  this->batchLatency = latency;
+
+  this->refreshBatchInfo();
+}
+
+void
+InspectorUI::setThreadLoad(qreal load)
+{
+  this->threadLoad = load;
+
+  this->refreshBatchInfo();
+}
+
+ProcessingThread *
+InspectorUI::getProcessingThread(void) const
+{
+  return this->tvTab->processingThread();
+}
+
 void
 InspectorUI::pushControl(InspectorCtl *ctl)
 {
@@ -1300,6 +1366,10 @@ InspectorUI::setAppConfig(AppConfig const &cfg)
   this->ui->constellation->setBackgroundColor(colors.constellationBackground);
   this->ui->constellation->setAxesColor(colors.constellationAxes);
 
+  this->densityMap->setBackgroundColor(colors.constellationBackground);
+  this->densityMap->setAxesColor(colors.constellationAxes);
+  this->densityWorker->setBackgroundColor(colors.constellationBackground);
+
   this->ui->transition->setForegroundColor(colors.transitionForeground);
   this->ui->transition->setBackgroundColor(colors.transitionBackground);
   this->ui->transition->setAxesColor(colors.transitionAxes);
@@ -1341,6 +1411,8 @@ InspectorUI::setAppConfig(AppConfig const &cfg)
   (void) this->setPalette(m_tabConfig->spectrumPalette);
   this->ui->peakHoldButton->setChecked(m_tabConfig->peakHold);
   this->ui->peakDetectionButton->setChecked(m_tabConfig->peakDetect);
+  this->ui->densityButton->setChecked(m_tabConfig->densityMap);
+  this->onToggleDensityMap();
   this->ui->aspectSlider->setValue(SCAST(int, 100 * m_tabConfig->spectrumRatio));
   this->ui->unitsCombo->setCurrentText(QString::fromStdString(m_tabConfig->units));
   this->ui->gainSpinBox->setValue(SCAST(qreal, m_tabConfig->gain));
@@ -1432,6 +1504,32 @@ InspectorUI::onFPSChanged(void)
 {
   this->throttle.setRate(
         SCAST(unsigned int, this->ui->fpsSpin->value()));
+  this->densityWorker->setRate(
+        SCAST(unsigned int, this->ui->fpsSpin->value()));
+}
+
+void
+InspectorUI::onToggleDensityMap(void)
+{
+  bool density = this->ui->densityButton->isChecked();
+
+  m_tabConfig->densityMap = density;
+
+  // Start from an empty map every time
+  this->densityWorker->reset();
+  this->densityMap->clear();
+
+  this->ui->constellation->setVisible(!density);
+  this->densityMap->setVisible(density);
+}
+
+void
+InspectorUI::onDensityMapFrame(QImage image)
+{
+  this->densityWorker->acknowledgeFrame();
+
+  if (m_tabConfig->densityMap)
+    this->densityMap->setImage(image);
 }
 
 void
@@ -1593,8 +1691,8 @@ InspectorUI::onNetReady(void)
 void
 InspectorUI::onNetError(void)
 {
-  if (this->socketForwarder != nullptr) {
-    QString error = this->socketForwarder->getLastError();
+  if (this->netForwarder != nullptr) {
+    QString error = this->netForwarder->getLastError();
     this->forwarding = false;
     this->uninstallNetForwarder();
     QMessageBox::warning(
@@ -1610,7 +1708,7 @@ InspectorUI::onNetError(void)
 void
 InspectorUI::onNetSwamped(void)
 {
-  if (this->socketForwarder != nullptr) {
+  if (this->netForwarder != nullptr) {
     this->forwarding = false;
     this->uninstallNetForwarder();
 
@@ -1633,7 +1731,7 @@ InspectorUI::onNetRate(qreal rate)
 void
 InspectorUI::onNetCommit(void)
 {
-  this->netForwarderUI->setCaptureSize(this->socketForwarder->getSize());
+  this->netForwarderUI->setCaptureSize(this->netForwarder->getSize());
 }
 
 void
@@ -34,6 +34,7 @@
 #include <SNREstimator.h>
 #include <sys/time.h>
 #include <SocketForwarder.h>
+#include <SharedMemoryForwarder.h>
 #include <AbstractWaterfall.h>
 
 #include "ThrottleableWidget.h"
@@ -48,17 +49,14 @@
 #include "TVProcessorTab.h"
 #include "WaveformTab.h"
 #include "FACTab.h"
+#include "DensityMapView.h"
+#include "DensityMapWorker.h"
+#include "DataForwardWorker.h"
 
 namespace Ui {
   class Inspector;
 }
 
-#define SIGDIGGER_INSPECTOR_UI_DECISION_SPACE 0
-#define SIGDIGGER_INSPECTOR_UI_SOFT_BITS      1
-#define SIGDIGGER_INSPECTOR_UI_SOFT_BITS_I    2
-#define SIGDIGGER_INSPECTOR_UI_SOFT_BITS_Q    3
-#define SIGDIGGER_INSPECTOR_UI_SYMBOLS        4
-
 namespace SigDigger {
   class FrequencyCorrectionDialog;
   class AppConfig;
@@ -108,7 +106,6 @@ namespace SigDigger {
 
     bool estimating = false;
     struct timeval last_estimator_update;
-    std::vector<SUFLOAT>  floatBuffer;
     std::vector<SUFLOAT>  fftData;
 
     // UI objects
@@ -131,11 +128,14 @@ namespace SigDigger {
     DataSaverUI *saverUI = nullptr;
     NetForwarderUI *netForwarderUI = nullptr;
     FileDataSaver *dataSaver = nullptr;
-    SocketForwarder *socketForwarder = nullptr;
+    GenericDataSaver *netForwarder = nullptr;
     TVProcessorTab *tvTab = nullptr;
     FACTab *facTab = nullptr;
     WaveformTab *wfTab = nullptr;
     SymViewTab *symViewTab = nullptr;
+    DensityMapView *densityMap = nullptr;
+    DensityMapWorker *densityWorker = nullptr;
+    DataForwardWorker *dataWorker = nullptr;
 
     FrequencyCorrectionDialog *fcDialog = nullptr;
 
@@ -144,6 +144,11 @@ namespace SigDigger {
     SUSCOUNT lastRate = 0;
     bool editingTVProcessorParams = false;
 
+    quint64 batchSamples = 0;
+    qreal batchLatency = 0;
+    qreal threadLoad = -1;
+
+    void refreshBatchInfo(void);
     void pushControl(InspectorCtl *ctl);
     void setBps(unsigned int bps);
     void connectAll(void);
@@ -234,6 +239,11 @@ namespace SigDigger {
       void adjustSizes(void);
       float getZeroPoint(void) const;
       enum State getState(void) const;
+      bool isRecording(void) const;
+      bool isForwarding(void) const;
+      void setBatchInfo(quint64 samples, qreal latency);
+      void setThreadLoad(qreal load);
+      ProcessingThread *getProcessingThread(void) const;
 
     public slots:
       void onInspectorControlChanged();
@@ -242,6 +252,8 @@ namespace SigDigger {
       void onCPUBurnClicked(void);
       void onFPSReset(void);
       void onFPSChanged(void);
+      void onToggleDensityMap(void);
+      void onDensityMapFrame(QImage);
       void onSpectrumConfigChanged(void);
       void onSpectrumSourceChanged(void);
       void onToggleSNR(void);
@@ -282,6 +294,8 @@ namespace SigDigger {
 
     signals:
       void configChanged(void);
+      void densityMapData(void);
+      void forwardData(void);
       void setSpectrumSource(unsigned int index);
       void loChanged(void);
       void bandwidthChanged(void);
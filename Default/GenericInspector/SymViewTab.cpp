@@ -19,8 +19,8 @@
 
 #include <ThrottleableWidget.h>
 #include <SuWidgetsHelpers.h>
-#include <QMessageBox>
-#include <QFileDialog>
+#include <SigDiggerHelpers.h>
+#include <Suscan/Library.h>
 
 #include "SymViewTab.h"
 #include "ui_SymViewTab.h"
@@ -164,11 +164,15 @@ SymViewTab::setColorConfig(const ColorConfig &colors)
   this->ui->symView->setLoColor(colors.symViewLow);
   this->ui->symView->setHiColor(colors.symViewHigh);
   this->ui->symView->setBackgroundColor(colors.symViewBackground);
+
+  this->loColor = colors.symViewLow;
+  this->hiColor = colors.symViewHigh;
 }
 
 void
 SymViewTab::feed(const Symbol *data, unsigned int size)
 {
+  this->symbols.append(data, size);
   this->ui->symView->feed(data, size);
   this->refreshSizes();
 }
@@ -357,65 +361,20 @@ SymViewTab::onSymViewControlsChanged(void)
 void
 SymViewTab::onSaveSymView(void)
 {
-  QFileDialog dialog(this->ui->symView);
-  QStringList filters;
-  enum SymView::FileFormat fmt = SymView::FILE_FORMAT_TEXT;
-
-  filters << "Text file (*.txt)"
-          << "Binary file (*.bin)"
-          << "C source file (*.c)"
-          << "Microsoft Windows Bitmap (*.bmp)"
-          << "PNG Image (*.png)"
-          << "JPEG Image (*.jpg)"
-          << "Portable Pixel Map (*.ppm)";
-
-  dialog.setFileMode(QFileDialog::AnyFile);
-  dialog.setAcceptMode(QFileDialog::AcceptSave);
-  dialog.setWindowTitle(QString("Save current symbol capture as..."));
-  dialog.setNameFilters(filters);
-
-  if (dialog.exec()) {
-    // This sucks
-    QString filter = dialog.selectedNameFilter();
-    QString path = dialog.selectedFiles().first();
-    QFileInfo fi(path);
-    QString ext = fi.suffix().size() > 0
-        ? fi.suffix()
-        : SuWidgetsHelpers::extractFilterExtension(filter);
-
-    if (ext == "txt")
-      fmt = SymView::FILE_FORMAT_TEXT;
-    else if (ext == "bin")
-      fmt = SymView::FILE_FORMAT_RAW;
-    else if (ext == "c" || ext == "h" || ext == "cpp")
-      fmt = SymView::FILE_FORMAT_C_ARRAY;
-    else if (ext == "bmp")
-      fmt = SymView::FILE_FORMAT_BMP;
-    else if (ext == "png")
-      fmt = SymView::FILE_FORMAT_PNG;
-    else if (ext == "jpg" || ext == "jpeg")
-      fmt = SymView::FILE_FORMAT_JPEG;
-    else if (ext == "ppm")
-      fmt = SymView::FILE_FORMAT_PPM;
-
-    try {
-      this->ui->symView->save(
-            SuWidgetsHelpers::ensureExtension(path, ext),
-            fmt);
-    } catch (std::ios_base::failure const &) {
-      (void) QMessageBox::critical(
-            this->ui->symView,
-            "Save symbol file",
-            "Failed to save file in the specified location. Please verify if "
-            "permission and disk space allow this operation.",
-            QMessageBox::Close);
-    }
-  }
+  SigDiggerHelpers::openSaveSymbolsDialog(
+        this->ui->symView,
+        this->symbols.snapshot(),
+        this->bps,
+        this->ui->symView->getStride(),
+        this->loColor,
+        this->hiColor,
+        Suscan::Singleton::get_instance()->getBackgroundTaskController());
 }
 
 void
 SymViewTab::onClearSymView(void)
 {
+  this->symbols.clear();
   this->ui->symView->clear();
   this->onOffsetChanged(0);
   this->refreshVScrollBar();
@@ -21,8 +21,10 @@
 #define SYMVIEWTAB_H
 
 #include <QWidget>
+#include <QColor>
 #include <Decider.h>
 #include <ColorConfig.h>
+#include <ExportSymbolsTask.h>
 
 namespace Ui {
   class SymViewTab;
@@ -40,6 +42,11 @@ namespace SigDigger {
 
     unsigned int bps = 1;
 
+    // Export snapshots are taken from here, so saving never blocks the view
+    SymbolStore symbols;
+    QColor loColor = Qt::black;
+    QColor hiColor = Qt::white;
+
     void refreshSizes(void);
     void refreshVScrollBar(void) const;
     void refreshHScrollBar(void) const;
@@ -21,7 +21,7 @@
 #include "ui_TVProcessorTab.h"
 #include <QMessageBox>
 #include <SuWidgetsHelpers.h>
-#include <QThread>
+#include <ProcessingThread.h>
 #include <QFileDialog>
 
 using namespace SigDigger;
@@ -37,7 +37,7 @@ TVProcessorTab::TVProcessorTab(QWidget *parent, qreal rate) :
 
   ui->setupUi(this);
 
-  this->tvThread = new QThread();
+  this->tvThread = new ProcessingThread();
   this->tvWorker = new TVProcessorWorker();
   this->tvWorker->moveToThread(this->tvThread);
 
@@ -67,6 +67,12 @@ TVProcessorTab::~TVProcessorTab()
   delete ui;
 }
 
+ProcessingThread *
+TVProcessorTab::processingThread(void) const
+{
+  return this->tvThread;
+}
+
 void
 TVProcessorTab::connectAll(void)
 {
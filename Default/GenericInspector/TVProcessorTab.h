@@ -29,6 +29,8 @@ namespace Ui {
 }
 
 namespace SigDigger {
+  class ProcessingThread;
+
   class TVProcessorTab : public QWidget
   {
     Q_OBJECT
@@ -40,7 +42,7 @@ namespace SigDigger {
     Decider::DecisionMode decisionMode = Decider::MODULUS;
 
     TVProcessorWorker *tvWorker = nullptr;
-    QThread *tvThread = nullptr;
+    ProcessingThread *tvThread = nullptr;
     std::vector<SUFLOAT> floatBuffer;
 
     void connectAll(void);
@@ -66,6 +68,7 @@ namespace SigDigger {
     void setDecisionMode(Decider::DecisionMode);
     void feed(const SUCOMPLEX *, unsigned int size);
     void setSampleRate(qreal);
+    ProcessingThread *processingThread(void) const;
 
   signals:
     void startTVProcessor(void);
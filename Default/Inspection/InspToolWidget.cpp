@@ -71,9 +71,6 @@ InspToolWidgetConfig::serialize()
 Suscan::Serializable *
 InspToolWidget::allocConfig()
 {
-  if (m_timeWindow == nullptr)
-    m_timeWindow = new TimeWindow(this);
-
   return m_panelConfig = new InspToolWidgetConfig();
 }
 
@@ -118,23 +115,42 @@ InspToolWidget::applyConfig()
   refreshInspectorCombo();
   setInspectorClass(m_panelConfig->inspectorClass);
   setPrecise(m_panelConfig->precise);
-  m_timeWindow->postLoadInit();
-  m_timeWindow->setPalette(m_panelConfig->palette);
-  m_timeWindow->setPaletteOffset(m_panelConfig->paletteOffset);
-  m_timeWindow->setPaletteContrast(m_panelConfig->paletteContrast);
+
+  if (m_timeWindow.isReady()) {
+    m_timeWindow->setPalette(m_panelConfig->palette);
+    m_timeWindow->setPaletteOffset(m_panelConfig->paletteOffset);
+    m_timeWindow->setPaletteContrast(m_panelConfig->paletteContrast);
+  }
+
   m_ui->frequencySpinBox->setEditable(false);
   m_ui->frequencySpinBox->setMinimum(-18e9);
   m_ui->triggerSpin->setValue(
         static_cast<qreal>(m_panelConfig->autoSquelchTriggerSNR));
 
   setProperty("collapsed", m_panelConfig->collapsed);
+}
+
+TimeWindow *
+InspToolWidget::makeTimeWindow()
+{
+  TimeWindow *window = new TimeWindow(this);
+
+  window->postLoadInit();
+  window->setPalette(m_panelConfig->palette);
+  window->setPaletteOffset(m_panelConfig->paletteOffset);
+  window->setPaletteContrast(m_panelConfig->paletteContrast);
+
+  if (m_haveColorConfig)
+    window->setColorConfig(m_colorConfig);
 
   // Track changes now
   connect(
-        m_timeWindow,
+        window,
         SIGNAL(configChanged()),
         this,
         SLOT(onTimeWindowConfigChanged()));
+
+  return window;
 }
 
 bool
@@ -321,7 +337,11 @@ InspToolWidget::setDemodFrequency(qint64 freq)
 void
 InspToolWidget::setColorConfig(ColorConfig const &config)
 {
-  m_timeWindow->setColorConfig(config);
+  m_colorConfig     = config;
+  m_haveColorConfig = true;
+
+  if (m_timeWindow.isReady())
+    m_timeWindow->setColorConfig(config);
 }
 
 void
@@ -435,22 +455,26 @@ InspToolWidget::refreshCaptureInfo()
   m_ui->memoryLabel->setText(
         SuWidgetsHelpers::formatBinaryQuantity(
           static_cast<qint64>(m_data.size() * sizeof(SUCOMPLEX))));
+
+  // Let an open time window follow the capture as it grows
+  if (m_timeWindow.isReady() && m_timeWindow->isVisible())
+    m_timeWindow->extendData(
+          m_data.data(),
+          m_data.size(),
+          m_timeWindowFs,
+          m_ui->bandwidthSpin->value());
 }
 
 void
 InspToolWidget::transferHistory()
 {
   // Insert older samples
-  m_data.insert(
-        m_data.end(),
-        m_history.begin() + m_historyPtr,
-        m_history.end());
+  m_data.append(
+        m_history.data() + m_historyPtr,
+        m_history.size() - m_historyPtr);
 
   // Insert newer samples
-  m_data.insert(
-        m_data.end(),
-        m_history.begin(),
-        m_history.begin() + m_historyPtr);
+  m_data.append(m_history.data(), m_historyPtr);
 }
 
 void
@@ -465,7 +489,7 @@ InspToolWidget::feedRawInspector(const SUCOMPLEX *data, size_t size)
 
   if (m_ui->captureButton->isDown()) {
     // Manual capture
-    m_data.insert(m_data.end(), data, data + size);
+    m_data.append(data, size);
     if (refreshUi)
       refreshCaptureInfo();
   } else if (m_autoSquelch) {
@@ -550,7 +574,7 @@ InspToolWidget::feedRawInspector(const SUCOMPLEX *data, size_t size)
 
     // TRIGGERED: Recording the channel
     if (m_autoSquelchTriggered) {
-      m_data.insert(m_data.end(), data, data + size);
+      m_data.append(data, size);
       refreshCaptureInfo();
       if (m_data.size() > m_hangLength) {
         if (immLevel >= m_hangLevel)
@@ -570,8 +594,11 @@ InspToolWidget::feedRawInspector(const SUCOMPLEX *data, size_t size)
 void
 InspToolWidget::openTimeWindow()
 {
+  // Spilled or not, the capture stays at the same address
+  m_data.markUsed();
   m_timeWindow->setData(
-        m_data,
+        m_data.data(),
+        m_data.size(),
         m_timeWindowFs,
         m_ui->bandwidthSpin->value());
   m_timeWindow->refresh();
@@ -631,11 +658,14 @@ InspToolWidget::cancelAutoSquelch()
 void
 InspToolWidget::startRawCapture()
 {
-  m_data.resize(0);
-  m_timeWindow->setData(
-        m_data,
-        m_timeWindowFs,
-        m_ui->bandwidthSpin->value());
+  m_data.clear();
+
+  if (m_timeWindow.isReady())
+    m_timeWindow->setData(
+          m_data.data(),
+          m_data.size(),
+          m_timeWindowFs,
+          m_ui->bandwidthSpin->value());
 
   if (m_analyzer != nullptr && !m_opened) {
     Suscan::Channel ch;
@@ -673,6 +703,10 @@ InspToolWidget::setState(int, Suscan::Analyzer *analyzer)
 
   if (m_analyzer != analyzer) {
     m_mediator->setUIBusy(false);
+
+    if (m_analyzer != nullptr)
+      m_analyzer->unsubscribeInspector(this);
+
     m_analyzer = analyzer;
 
     m_tracker->setAnalyzer(analyzer);
@@ -684,18 +718,6 @@ InspToolWidget::setState(int, Suscan::Analyzer *analyzer)
             SIGNAL(source_info_message(Suscan::SourceInfoMessage const &)),
             this,
             SLOT(onSourceInfoMessage(Suscan::SourceInfoMessage const &)));
-
-      connect(
-            m_analyzer,
-            SIGNAL(inspector_message(Suscan::InspectorMessage const &)),
-            this,
-            SLOT(onInspectorMessage(Suscan::InspectorMessage const &)));
-
-      connect(
-            m_analyzer,
-            SIGNAL(samples_message(Suscan::SamplesMessage const &)),
-            this,
-            SLOT(onInspectorSamples(Suscan::SamplesMessage const &)));
     }
 
     setState(m_analyzer == nullptr ? DETACHED : ATTACHED);
@@ -734,12 +756,16 @@ InspToolWidget::openInspector(
 InspToolWidget::InspToolWidget
 (InspToolWidgetFactory *factory, UIMediator *mediator, QWidget *parent) :
   ToolWidget(factory, mediator, parent),
-  m_ui(new Ui::InspectorPanel)
+  m_ui(new Ui::InspectorPanel),
+  m_data("Inspector capture")
 {
   m_ui->setupUi(this);
 
   m_tracker = new Suscan::AnalyzerRequestTracker(this);
 
+  // Most sessions never open the time window. Build it on demand.
+  m_timeWindow.setFactory([this] () { return makeTimeWindow(); });
+
   assertConfig();
   setState(DETACHED);
   refreshUi();
@@ -767,6 +793,9 @@ InspToolWidget::InspToolWidget
 
 InspToolWidget::~InspToolWidget()
 {
+  if (m_analyzer != nullptr)
+    m_analyzer->unsubscribeInspector(this);
+
   delete m_ui;
 }
 
@@ -894,6 +923,11 @@ InspToolWidget::onOpened(Suscan::AnalyzerRequest const &request)
 
   m_mediator->setUIBusy(false);
 
+  if (m_analyzer != nullptr) {
+    m_analyzer->unsubscribeInspector(this);
+    m_analyzer->subscribeInspector(request.inspectorId, this);
+  }
+
   resetRawInspector(SCAST(qreal, request.equivRate));
 }
 
@@ -22,6 +22,8 @@
 #include <ToolWidgetFactory.h>
 #include <TimeWindow.h>
 #include <ColorConfig.h>
+#include <LazyWidget.h>
+#include <SampleBuffer.h>
 #include <Suscan/Analyzer.h>
 #include <Suscan/AnalyzerRequestTracker.h>
 
@@ -57,7 +59,7 @@ namespace SigDigger {
     Suscan::Object &&serialize() override;
   };
 
-  class InspToolWidget : public ToolWidget
+  class InspToolWidget : public ToolWidget, public Suscan::InspectorListener
   {
     Q_OBJECT
 
@@ -76,7 +78,9 @@ namespace SigDigger {
     bool m_stateSet = false;
 
     // TODO: Allow multiple TimeWindows
-    TimeWindow *m_timeWindow = nullptr;
+    LazyWidget<TimeWindow> m_timeWindow;
+    ColorConfig m_colorConfig;
+    bool m_haveColorConfig = false;
     qreal m_timeWindowFs = 1;
     qint64 m_demodFreq = 0;
     SUFLOAT m_squelch = 0;
@@ -93,7 +97,7 @@ namespace SigDigger {
     Suscan::AnalyzerSourceInfo m_sourceInfo =
         Suscan::AnalyzerSourceInfo();
 
-    std::vector<SUCOMPLEX> m_data;
+    SampleBuffer m_data;
     std::vector<SUCOMPLEX> m_history;
     unsigned int m_historyPtr = 0;
     SUFLOAT  m_currEnergy = 0;
@@ -114,6 +118,7 @@ namespace SigDigger {
     void setInspectorClass(std::string const &cls);
     void refreshCaptureInfo();
     void openTimeWindow();
+    TimeWindow *makeTimeWindow();
     void transferHistory();
 
     void applySourceInfo(Suscan::AnalyzerSourceInfo const &info);
@@ -184,8 +189,8 @@ namespace SigDigger {
 
     // Analyzer slots
     void onSourceInfoMessage(Suscan::SourceInfoMessage const &);
-    void onInspectorMessage(Suscan::InspectorMessage const &);
-    void onInspectorSamples(Suscan::SamplesMessage const &);
+    void onInspectorMessage(Suscan::InspectorMessage const &) override;
+    void onInspectorSamples(Suscan::SamplesMessage const &) override;
 
     void onOpenASK();
     void onOpenFSK();
@@ -20,6 +20,8 @@
 #include "Registration.h"
 #include "Audio/AudioWidgetFactory.h"
 #include "Source/SourceWidgetFactory.h"
+#include "Scanner/ScannerWidgetFactory.h"
+#include "ChannelBatch/ChannelBatchWidgetFactory.h"
 #include "Inspection/InspToolWidgetFactory.h"
 #include "FFT/FFTWidgetFactory.h"
 #include "DefaultTab/DefaultTabWidgetFactory.h"
@@ -47,6 +49,8 @@ SigDigger::DefaultPluginEntry(Suscan::Plugin *plugin)
   // they will show up in the GUI
 
   sus->registerToolWidgetFactory(new AudioWidgetFactory(plugin));
+  sus->registerToolWidgetFactory(new ScannerWidgetFactory(plugin));
+  sus->registerToolWidgetFactory(new ChannelBatchWidgetFactory(plugin));
   sus->registerToolWidgetFactory(new SourceWidgetFactory(plugin));
   sus->registerToolWidgetFactory(new InspToolWidgetFactory(plugin));
   sus->registerToolWidgetFactory(new FFTWidgetFactory(plugin));
@@ -0,0 +1,552 @@
+//
+//    ChannelScanner.cpp: Memory channel scanner
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "ChannelScanner.h"
+
+#include <Suscan/AnalyzerRequestTracker.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace SigDigger;
+
+ChannelScanner::ChannelScanner(QObject *parent) : QObject(parent)
+{
+  m_tracker = new Suscan::AnalyzerRequestTracker(this);
+
+  connectAll();
+}
+
+ChannelScanner::~ChannelScanner()
+{
+  if (m_analyzer != nullptr)
+    m_analyzer->unsubscribeInspector(this);
+
+  if (m_cfgTemplate != nullptr)
+    suscan_config_destroy(m_cfgTemplate);
+}
+
+void
+ChannelScanner::connectAll()
+{
+  connect(
+        m_tracker,
+        SIGNAL(opened(Suscan::AnalyzerRequest const &)),
+        this,
+        SLOT(onOpened(Suscan::AnalyzerRequest const &)));
+
+  connect(
+        m_tracker,
+        SIGNAL(cancelled(Suscan::AnalyzerRequest const &)),
+        this,
+        SLOT(onCancelled(Suscan::AnalyzerRequest const &)));
+
+  connect(
+        m_tracker,
+        SIGNAL(error(Suscan::AnalyzerRequest const &, const std::string &)),
+        this,
+        SLOT(onError(Suscan::AnalyzerRequest const &, const std::string &)));
+}
+
+void
+ChannelScanner::setState(State state)
+{
+  if (m_state != state) {
+    m_state = state;
+    emit stateChanged(state);
+  }
+}
+
+void
+ChannelScanner::closeInspector()
+{
+  if (m_analyzer != nullptr) {
+    if (m_opened)
+      m_analyzer->closeInspector(m_handle);
+    else
+      m_tracker->cancelAll();
+
+    m_analyzer->unsubscribeInspector(this);
+  }
+
+  m_opened = false;
+  m_handle = -1;
+  m_visits.clear();
+}
+
+// Every retune gives the inspector a new tag. Only the tags of the visits
+// still in flight are of interest.
+void
+ChannelScanner::refreshSubscriptions()
+{
+  m_analyzer->unsubscribeInspector(this);
+
+  for (auto &visit : m_visits)
+    m_analyzer->subscribeInspector(visit.tag, this);
+}
+
+unsigned int
+ChannelScanner::reportsFor(qreal time) const
+{
+  qreal period = SIGDIGGER_SCANNER_INTEGRATION_TIME;
+
+  if (m_equivRate > 0)
+    period = std::max(
+          std::round(m_equivRate * SIGDIGGER_SCANNER_INTEGRATION_TIME),
+          1.) / m_equivRate;
+
+  return std::max(1u, SCAST(unsigned int, std::ceil(time / period)));
+}
+
+bool
+ChannelScanner::inSpan(ScanChannel const &ch) const
+{
+  SUFREQ bw = ch.bandwidth > 0 ? ch.bandwidth : m_defaultBw;
+  SUFREQ offset = std::fabs(ch.freq - m_analyzer->getFrequency());
+
+  return offset + .5 * bw
+      <= .5 * SIGDIGGER_SCANNER_SPAN_USAGE * m_basebandRate;
+}
+
+unsigned int
+ChannelScanner::nextChannel(unsigned int channel) const
+{
+  unsigned int count = SCAST(unsigned int, m_channels.size());
+
+  for (unsigned int i = 1; i <= count; ++i) {
+    unsigned int next = (channel + i) % count;
+    if (m_canTune || inSpan(m_channels[next]))
+      return next;
+  }
+
+  return channel;
+}
+
+void
+ChannelScanner::retune(unsigned int channel)
+{
+  ScanChannel const &ch = m_channels[channel];
+  SUFREQ bw = ch.bandwidth > 0 ? ch.bandwidth : m_defaultBw;
+  Visit visit;
+
+  visit.channel = channel;
+  visit.needed  = reportsFor(m_dwell);
+  visit.discard = 1 + reportsFor(SIGDIGGER_SCANNER_FILTER_SETTLE);
+
+  try {
+    if (!inSpan(ch)) {
+      // Leave the channel in the lower part of the span, the list is
+      // sorted and the next few channels will probably fit above it.
+      visit.discard += reportsFor(SIGDIGGER_SCANNER_TUNER_SETTLE);
+      emit tuneRequested(ch.freq + .25 * m_basebandRate);
+    }
+
+    if (!sufeq(bw, m_currBw, 1)) {
+      m_analyzer->setInspectorBandwidth(m_handle, bw);
+      m_currBw = bw;
+    }
+
+    m_analyzer->setInspectorFreq(m_handle, ch.freq - m_analyzer->getFrequency());
+
+    visit.tag = m_analyzer->allocateInspectorId();
+    m_analyzer->setInspectorId(m_handle, visit.tag);
+  } catch (Suscan::Exception const &e) {
+    stop();
+    emit error("Failed to retune scanner: " + QString(e.what()));
+    return;
+  }
+
+  visit.issuedAt = m_clock.elapsed();
+  m_visits.push_back(visit);
+  m_current = channel;
+
+  refreshSubscriptions();
+
+  emit channelChanged(ch);
+}
+
+void
+ChannelScanner::updateRate()
+{
+  qint64 elapsed = m_rateTimer.elapsed();
+
+  if (elapsed >= 1000) {
+    emit scanRate(m_visited * 1e3 / SCAST(qreal, elapsed));
+    m_visited = 0;
+    m_rateTimer.start();
+  }
+}
+
+void
+ChannelScanner::finishVisit(Visit const &visit)
+{
+  ScanChannel const &ch = m_channels[visit.channel];
+  SUFREQ bw = ch.bandwidth > 0 ? ch.bandwidth : m_defaultBw;
+  SUFLOAT psd = 0;
+  SUFLOAT snr = 0;
+
+  ++m_visited;
+  ++m_totalVisited;
+  updateRate();
+
+  // Retagged before any useful report came: nothing to say about it
+  if (visit.got == 0) {
+    if (m_visits.empty())
+      retune(nextChannel(visit.channel));
+    return;
+  }
+
+  psd = visit.accum / SCAST(SUFLOAT, visit.got * bw);
+
+  if (m_floor > 0)
+    snr = SU_POWER_DB(psd / m_floor);
+
+  if (m_floor > 0 && snr > m_threshold) {
+    Visit monitor = visit;
+
+    if (m_visits.empty()) {
+      // Still there. Keep measuring with the same tag.
+      monitor.got   = 0;
+      monitor.accum = 0;
+      monitor.discard = 0;
+      m_visits.push_back(monitor);
+    } else {
+      // The next retune was issued too early. Go back.
+      ++m_speculationMisses;
+      m_visits.clear();
+      retune(visit.channel);
+      if (m_visits.empty())
+        return;
+    }
+
+    setState(HOLDING);
+    emit activity(ch, SCAST(qreal, snr));
+    return;
+  }
+
+  if (m_floor <= 0 || psd < m_floor)
+    m_floor = psd;
+  else
+    m_floor += SIGDIGGER_SCANNER_FLOOR_ALPHA * (psd - m_floor);
+
+  // Not pipelined (either a tuner hop or the dwell was too short)
+  if (m_visits.empty())
+    retune(nextChannel(visit.channel));
+}
+
+void
+ChannelScanner::feedReport(Visit &visit, SUFLOAT power)
+{
+  if (visit.discard > 0) {
+    --visit.discard;
+    return;
+  }
+
+  visit.accum += power;
+  ++visit.got;
+
+  if (m_state == SCANNING) {
+    // Pipelining: the reports still in flight will complete this dwell
+    if (!visit.followed
+        && m_visits.size() == 1
+        && visit.got + m_lookahead >= visit.needed) {
+      unsigned int next = nextChannel(visit.channel);
+
+      if (next != visit.channel && inSpan(m_channels[next])) {
+        visit.followed = true;
+        retune(next);
+
+        // Retune failed and the scanner stopped
+        if (m_state != SCANNING)
+          return;
+      }
+    }
+
+    if (visit.got >= visit.needed) {
+      Visit done = visit;
+      m_visits.pop_front();
+      finishVisit(done);
+    }
+  } else if (visit.got >= visit.needed) {
+    ScanChannel const &ch = m_channels[visit.channel];
+    SUFREQ bw = ch.bandwidth > 0 ? ch.bandwidth : m_defaultBw;
+    SUFLOAT psd = visit.accum / SCAST(SUFLOAT, visit.got * bw);
+    SUFLOAT snr = m_floor > 0 ? SU_POWER_DB(psd / m_floor) : 0;
+
+    visit.got = 0;
+    visit.accum = 0;
+
+    if (snr > m_threshold) {
+      setState(HOLDING);
+    } else if (m_state == HOLDING) {
+      m_quietSince = m_clock.elapsed();
+      setState(HANGING);
+    } else if (m_clock.elapsed() - m_quietSince >= SCAST(qint64, m_hang * 1e3)) {
+      resume();
+    }
+  }
+}
+
+//////////////////////////////// Setters ///////////////////////////////////////
+void
+ChannelScanner::setAnalyzer(Suscan::Analyzer *analyzer)
+{
+  if (m_analyzer != nullptr)
+    stop();
+
+  m_analyzer = analyzer;
+  m_tracker->setAnalyzer(analyzer);
+}
+
+void
+ChannelScanner::setChannels(std::vector<ScanChannel> const &channels)
+{
+  m_channels = channels;
+
+  std::sort(
+        m_channels.begin(),
+        m_channels.end(),
+        [] (ScanChannel const &a, ScanChannel const &b) {
+          return a.freq < b.freq;
+        });
+
+  m_current = 0;
+
+  if (m_state != IDLE && m_state != OPENING) {
+    m_visits.clear();
+
+    if (m_channels.empty()) {
+      stop();
+    } else {
+      setState(SCANNING);
+      retune(0);
+    }
+  }
+}
+
+void
+ChannelScanner::setDwellTime(qreal dwell)
+{
+  m_dwell = dwell;
+}
+
+void
+ChannelScanner::setHangTime(qreal hang)
+{
+  m_hang = hang;
+}
+
+void
+ChannelScanner::setThreshold(SUFLOAT threshold)
+{
+  m_threshold = threshold;
+}
+
+void
+ChannelScanner::setDefaultBandwidth(SUFREQ bw)
+{
+  m_defaultBw = bw;
+}
+
+bool
+ChannelScanner::start()
+{
+  if (m_analyzer == nullptr || m_channels.empty())
+    return false;
+
+  if (m_state != IDLE)
+    return true;
+
+  m_canTune = m_analyzer->getSourceInfo().testPermission(
+        SUSCAN_ANALYZER_PERM_SET_FREQ);
+
+  m_clock.start();
+  m_rateTimer.start();
+  m_visited = 0;
+  m_lookahead = 0;
+
+  if (m_current >= m_channels.size())
+    m_current = 0;
+
+  if (m_opened) {
+    setState(SCANNING);
+    retune(m_current);
+  } else {
+    Suscan::Channel ch;
+
+    ch.fc    = 0;
+    ch.ft    = 0;
+    ch.bw    = m_defaultBw;
+    ch.fLow  = -.5 * m_defaultBw;
+    ch.fHigh = +.5 * m_defaultBw;
+
+    if (!m_tracker->requestOpen("power", ch)) {
+      emit error("Internal Suscan error while opening scanner channel");
+      return false;
+    }
+
+    setState(OPENING);
+  }
+
+  return true;
+}
+
+void
+ChannelScanner::stop()
+{
+  closeInspector();
+  setState(IDLE);
+}
+
+void
+ChannelScanner::resume()
+{
+  if (m_state == HOLDING || m_state == HANGING) {
+    m_visits.clear();
+    setState(SCANNING);
+    retune(nextChannel(m_current));
+  }
+}
+
+//////////////////////////////// Getters ///////////////////////////////////////
+ChannelScanner::State
+ChannelScanner::getState() const
+{
+  return m_state;
+}
+
+ScanChannel const *
+ChannelScanner::getCurrentChannel() const
+{
+  if (m_state == IDLE || m_current >= m_channels.size())
+    return nullptr;
+
+  return &m_channels[m_current];
+}
+
+quint64
+ChannelScanner::getVisitedChannels() const
+{
+  return m_totalVisited;
+}
+
+quint64
+ChannelScanner::getSpeculationMisses() const
+{
+  return m_speculationMisses;
+}
+
+///////////////////////////// Analyzer slots //////////////////////////////////
+void
+ChannelScanner::onInspectorSamples(Suscan::SamplesMessage const &msg)
+{
+  const SUCOMPLEX *samples = msg.getSamples();
+  unsigned int count = msg.getCount();
+  uint32_t tag = msg.getInspectorId();
+  auto it = m_visits.begin();
+
+  if (!m_opened || m_state == IDLE || m_state == OPENING)
+    return;
+
+  while (it != m_visits.end() && it->tag != tag)
+    ++it;
+
+  if (it == m_visits.end())
+    return;
+
+  // First report with this tag: the inspector has been retagged, so older
+  // visits will not receive anything else.
+  if (!it->firstSeen) {
+    qreal latency = (m_clock.elapsed() - it->issuedAt) * 1e-3;
+    qreal reports = reportsFor(latency);
+
+    it->firstSeen = true;
+    m_lookahead += .2 * (reports - m_lookahead);
+
+    while (!m_visits.empty() && m_visits.front().tag != tag) {
+      Visit old = m_visits.front();
+      m_visits.pop_front();
+      finishVisit(old);
+    }
+  }
+
+  for (unsigned int i = 0; i < count; ++i) {
+    if (m_visits.empty() || m_visits.front().tag != tag)
+      break;
+
+    feedReport(m_visits.front(), SU_C_REAL(samples[i]));
+  }
+}
+
+////////////////////////// Request tracker slots ///////////////////////////////
+void
+ChannelScanner::onOpened(Suscan::AnalyzerRequest const &req)
+{
+  if (m_analyzer == nullptr)
+    return;
+
+  if (m_state != OPENING) {
+    m_analyzer->closeInspector(req.handle);
+    return;
+  }
+
+  if (m_cfgTemplate != nullptr) {
+    suscan_config_destroy(m_cfgTemplate);
+    m_cfgTemplate = nullptr;
+  }
+
+  if ((m_cfgTemplate = suscan_config_dup(req.config)) == nullptr) {
+    m_analyzer->closeInspector(req.handle);
+    setState(IDLE);
+    emit error("Failed to duplicate scanner channel configuration");
+    return;
+  }
+
+  m_handle       = req.handle;
+  m_equivRate    = SCAST(qreal, req.equivRate);
+  m_basebandRate = SCAST(qreal, req.basebandRate);
+  m_currBw       = SCAST(SUFREQ, req.bandwidth);
+  m_opened       = true;
+
+  Suscan::Config cfg(m_cfgTemplate);
+  cfg.set(
+        "power.integrate-samples",
+        SCAST(uint64_t, std::max(
+          std::round(m_equivRate * SIGDIGGER_SCANNER_INTEGRATION_TIME),
+          1.)));
+  m_analyzer->setInspectorConfig(m_handle, cfg);
+
+  setState(SCANNING);
+  retune(m_current);
+}
+
+void
+ChannelScanner::onCancelled(Suscan::AnalyzerRequest const &)
+{
+  m_opened = false;
+  setState(IDLE);
+}
+
+void
+ChannelScanner::onError(Suscan::AnalyzerRequest const &, std::string const &err)
+{
+  m_opened = false;
+  setState(IDLE);
+
+  emit error(
+        "Failed to open scanner channel: " + QString::fromStdString(err));
+}
@@ -0,0 +1,170 @@
+//
+//    ChannelScanner.h: Memory channel scanner
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef CHANNELSCANNER_H
+#define CHANNELSCANNER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <Suscan/Analyzer.h>
+#include <deque>
+#include <vector>
+
+#define SIGDIGGER_SCANNER_INTEGRATION_TIME  1e-3  // s, per power report
+#define SIGDIGGER_SCANNER_FILTER_SETTLE     2e-3  // s, after an inspector hop
+#define SIGDIGGER_SCANNER_TUNER_SETTLE      20e-3 // s, after a tuner hop
+#define SIGDIGGER_SCANNER_SPAN_USAGE        .9    // Usable fraction of fs
+#define SIGDIGGER_SCANNER_FLOOR_ALPHA       .05
+
+namespace Suscan {
+  class AnalyzerRequestTracker;
+  struct AnalyzerRequest;
+};
+
+namespace SigDigger {
+  struct ScanChannel {
+    SUFREQ  freq = 0;
+    SUFREQ  bandwidth = 0;
+    QString name;
+  };
+
+  //
+  // Steps a power inspector through a list of channels and stops on the
+  // first one whose energy exceeds the noise floor by a given threshold.
+  //
+  // Every hop retags the inspector with a fresh inspector ID right after
+  // retuning it. Since the analyzer processes inspector requests in order,
+  // power reports carrying the new tag were measured (at least partially)
+  // at the new frequency, so discarding the first few of them removes the
+  // filter transient exactly, regardless of the link latency.
+  //
+  // Hops that stay within the current capture span are pipelined: the next
+  // retune is issued as soon as the reports still in flight are expected
+  // to complete the current dwell. If those late reports reveal activity,
+  // the scanner simply goes back to that channel. Hops that need moving the
+  // tuner are not speculative, as they would corrupt the reports of the
+  // channel being measured.
+  //
+  class ChannelScanner : public QObject, public Suscan::InspectorListener
+  {
+    Q_OBJECT
+
+  public:
+    enum State {
+      IDLE,
+      OPENING,
+      SCANNING,
+      HOLDING,
+      HANGING
+    };
+
+  private:
+    struct Visit {
+      unsigned int channel = 0;
+      uint32_t     tag = 0;
+      unsigned int discard = 0;
+      unsigned int needed = 0;
+      unsigned int got = 0;
+      SUFLOAT      accum = 0;
+      bool         followed = false; // Next retune already issued
+      qint64       issuedAt = 0;
+      bool         firstSeen = false;
+    };
+
+    // Scan parameters
+    std::vector<ScanChannel> m_channels;
+    qreal        m_dwell = 50e-3;
+    qreal        m_hang = 2;
+    SUFLOAT      m_threshold = 10; // dB above the noise floor
+    SUFREQ       m_defaultBw = 12.5e3;
+
+    // Inspector state
+    Suscan::Analyzer *m_analyzer = nullptr;
+    Suscan::AnalyzerRequestTracker *m_tracker = nullptr;
+    suscan_config_t  *m_cfgTemplate = nullptr;
+    Suscan::Handle    m_handle = -1;
+    bool              m_opened = false;
+    bool              m_canTune = false;
+    qreal             m_equivRate = 0;
+    qreal             m_basebandRate = 0;
+    SUFREQ            m_currBw = 0;
+
+    // Scanner state
+    State             m_state = IDLE;
+    std::deque<Visit> m_visits;
+    unsigned int      m_current = 0;
+    SUFLOAT           m_floor = 0; // Power spectral density
+    qreal             m_lookahead = 0; // In reports
+    QElapsedTimer     m_clock;
+    qint64            m_quietSince = 0;
+
+    // Statistics
+    QElapsedTimer     m_rateTimer;
+    unsigned int      m_visited = 0;
+    quint64           m_totalVisited = 0;
+    quint64           m_speculationMisses = 0;
+
+    void connectAll();
+    void setState(State);
+    void closeInspector();
+    void refreshSubscriptions();
+    unsigned int reportsFor(qreal) const;
+    bool inSpan(ScanChannel const &) const;
+    void retune(unsigned int channel);
+    unsigned int nextChannel(unsigned int channel) const;
+    void finishVisit(Visit const &);
+    void feedReport(Visit &, SUFLOAT);
+    void updateRate();
+
+  public:
+    explicit ChannelScanner(QObject *parent = nullptr);
+    virtual ~ChannelScanner() override;
+
+    void setAnalyzer(Suscan::Analyzer *);
+    void setChannels(std::vector<ScanChannel> const &);
+    void setDwellTime(qreal);
+    void setHangTime(qreal);
+    void setThreshold(SUFLOAT);
+    void setDefaultBandwidth(SUFREQ);
+
+    bool start();
+    void stop();
+    void resume();
+
+    State getState() const;
+    ScanChannel const *getCurrentChannel() const;
+    quint64 getVisitedChannels() const;
+    quint64 getSpeculationMisses() const;
+
+  signals:
+    void stateChanged(int);
+    void channelChanged(SigDigger::ScanChannel const &);
+    void tuneRequested(qreal center);
+    void activity(SigDigger::ScanChannel const &, qreal snr);
+    void scanRate(qreal channelsPerSecond);
+    void error(QString);
+
+  public slots:
+    void onInspectorSamples(Suscan::SamplesMessage const &) override;
+    void onOpened(Suscan::AnalyzerRequest const &);
+    void onCancelled(Suscan::AnalyzerRequest const &);
+    void onError(Suscan::AnalyzerRequest const &, std::string const &);
+  };
+}
+
+#endif // CHANNELSCANNER_H
@@ -0,0 +1,464 @@
+//
+//    Default/Scanner/ScannerWidget.cpp: Channel scanner panel
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "ScannerWidgetFactory.h"
+#include "ScannerWidget.h"
+#include "ui_ScannerWidget.h"
+#include <QDynamicPropertyChangeEvent>
+#include <QMessageBox>
+#include <UIMediator.h>
+#include <MainSpectrum.h>
+#include <SuWidgetsHelpers.h>
+#include <Suscan/Library.h>
+
+// Do not let a typo in the step create millions of channels
+#define SIGDIGGER_SCANNER_MAX_CHANNELS 100000
+
+using namespace SigDigger;
+
+#define STRINGFY(x) #x
+#define STORE(field) obj.set(STRINGFY(field), field)
+#define LOAD(field) field = conf.get(STRINGFY(field), field)
+
+void
+ScannerWidgetConfig::deserialize(Suscan::Object const &conf)
+{
+  LOAD(collapsed);
+  LOAD(useBookmarks);
+  LOAD(rangeStart);
+  LOAD(rangeEnd);
+  LOAD(step);
+  LOAD(bandwidth);
+  LOAD(dwellMs);
+  LOAD(hangTime);
+  LOAD(threshold);
+}
+
+Suscan::Object &&
+ScannerWidgetConfig::serialize()
+{
+  Suscan::Object obj(SUSCAN_OBJECT_TYPE_OBJECT);
+
+  obj.setClass("ScannerWidgetConfig");
+
+  STORE(collapsed);
+  STORE(useBookmarks);
+  STORE(rangeStart);
+  STORE(rangeEnd);
+  STORE(step);
+  STORE(bandwidth);
+  STORE(dwellMs);
+  STORE(hangTime);
+  STORE(threshold);
+
+  return persist(obj);
+}
+
+/////////////////////////////////// Scanner Widget /////////////////////////////
+ScannerWidget::ScannerWidget(
+    ScannerWidgetFactory *factory,
+    UIMediator *mediator,
+    QWidget *parent) :
+  ToolWidget(factory, mediator, parent),
+  m_ui(new Ui::ScannerPanel)
+{
+  m_ui->setupUi(this);
+
+  m_scanner  = new ChannelScanner(this);
+  m_spectrum = mediator->getMainSpectrum();
+
+  m_ui->startSpin->setMinimum(0);
+  m_ui->startSpin->setMaximum(300e9);
+  m_ui->endSpin->setMinimum(0);
+  m_ui->endSpin->setMaximum(300e9);
+  m_ui->stepSpin->setMinimum(1);
+  m_ui->stepSpin->setMaximum(1e9);
+  m_ui->bandwidthSpin->setMinimum(1);
+  m_ui->bandwidthSpin->setMaximum(1e9);
+
+  assertConfig();
+  connectAll();
+
+  setProperty("collapsed", m_panelConfig->collapsed);
+}
+
+ScannerWidget::~ScannerWidget()
+{
+  delete m_ui;
+}
+
+// Private methods
+void
+ScannerWidget::connectAll()
+{
+  connect(
+        m_ui->sourceCombo,
+        SIGNAL(activated(int)),
+        this,
+        SLOT(onSourceChanged()));
+
+  connect(
+        m_ui->startSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->endSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->stepSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->bandwidthSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->dwellSpin,
+        SIGNAL(valueChanged(int)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->hangSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->thresholdSpin,
+        SIGNAL(valueChanged(double)),
+        this,
+        SLOT(onParamsChanged()));
+
+  connect(
+        m_ui->scanButton,
+        SIGNAL(clicked(bool)),
+        this,
+        SLOT(onToggleScan()));
+
+  connect(
+        m_ui->skipButton,
+        SIGNAL(clicked(bool)),
+        this,
+        SLOT(onSkip()));
+
+  connect(
+        m_scanner,
+        SIGNAL(stateChanged(int)),
+        this,
+        SLOT(onScannerStateChanged(int)));
+
+  connect(
+        m_scanner,
+        SIGNAL(channelChanged(SigDigger::ScanChannel const &)),
+        this,
+        SLOT(onChannelChanged(SigDigger::ScanChannel const &)));
+
+  connect(
+        m_scanner,
+        SIGNAL(tuneRequested(qreal)),
+        this,
+        SLOT(onTuneRequested(qreal)));
+
+  connect(
+        m_scanner,
+        SIGNAL(activity(SigDigger::ScanChannel const &, qreal)),
+        this,
+        SLOT(onActivity(SigDigger::ScanChannel const &, qreal)));
+
+  connect(
+        m_scanner,
+        SIGNAL(scanRate(qreal)),
+        this,
+        SLOT(onScanRate(qreal)));
+
+  connect(
+        m_scanner,
+        SIGNAL(error(QString)),
+        this,
+        SLOT(onScannerError(QString)));
+}
+
+void
+ScannerWidget::refreshUi()
+{
+  bool idle = m_scanner->getState() == ChannelScanner::IDLE;
+  bool range = !m_panelConfig->useBookmarks;
+  bool stopped =
+      m_scanner->getState() == ChannelScanner::HOLDING
+      || m_scanner->getState() == ChannelScanner::HANGING;
+
+  m_ui->sourceCombo->setEnabled(idle);
+  m_ui->startSpin->setEnabled(idle && range);
+  m_ui->endSpin->setEnabled(idle && range);
+  m_ui->stepSpin->setEnabled(idle && range);
+
+  m_ui->scanButton->setEnabled(m_analyzer != nullptr);
+  m_ui->skipButton->setEnabled(stopped);
+
+  BLOCKSIG(m_ui->scanButton, setChecked(!idle));
+}
+
+void
+ScannerWidget::applyParams()
+{
+  m_scanner->setDwellTime(m_panelConfig->dwellMs * 1e-3);
+  m_scanner->setHangTime(SCAST(qreal, m_panelConfig->hangTime));
+  m_scanner->setThreshold(m_panelConfig->threshold);
+  m_scanner->setDefaultBandwidth(m_panelConfig->bandwidth);
+}
+
+std::vector<ScanChannel>
+ScannerWidget::makeChannelList() const
+{
+  std::vector<ScanChannel> list;
+
+  if (m_panelConfig->useBookmarks) {
+    auto &bookmarks = Suscan::Singleton::get_instance()->getBookmarkMap();
+
+    for (auto &p : bookmarks) {
+      ScanChannel ch;
+
+      ch.freq      = SCAST(SUFREQ, p.info.frequency);
+      ch.bandwidth = SCAST(SUFREQ, p.info.bandwidth());
+      ch.name      = p.info.name;
+
+      list.push_back(ch);
+    }
+  } else {
+    SUFREQ start = std::min(m_panelConfig->rangeStart, m_panelConfig->rangeEnd);
+    SUFREQ end   = std::max(m_panelConfig->rangeStart, m_panelConfig->rangeEnd);
+    SUFREQ step  = m_panelConfig->step;
+
+    for (SUFREQ f = start;
+         f <= end && list.size() < SIGDIGGER_SCANNER_MAX_CHANNELS;
+         f += step) {
+      ScanChannel ch;
+
+      ch.freq      = f;
+      ch.bandwidth = m_panelConfig->bandwidth;
+
+      list.push_back(ch);
+    }
+  }
+
+  return list;
+}
+
+Suscan::Serializable *
+ScannerWidget::allocConfig()
+{
+  return m_panelConfig = new ScannerWidgetConfig();
+}
+
+void
+ScannerWidget::applyConfig()
+{
+  BLOCKSIG(
+        m_ui->sourceCombo,
+        setCurrentIndex(m_panelConfig->useBookmarks ? 0 : 1));
+  BLOCKSIG(m_ui->startSpin, setValue(m_panelConfig->rangeStart));
+  BLOCKSIG(m_ui->endSpin, setValue(m_panelConfig->rangeEnd));
+  BLOCKSIG(m_ui->stepSpin, setValue(m_panelConfig->step));
+  BLOCKSIG(m_ui->bandwidthSpin, setValue(m_panelConfig->bandwidth));
+  BLOCKSIG(m_ui->dwellSpin, setValue(SCAST(int, m_panelConfig->dwellMs)));
+  BLOCKSIG(
+        m_ui->hangSpin,
+        setValue(SCAST(qreal, m_panelConfig->hangTime)));
+  BLOCKSIG(
+        m_ui->thresholdSpin,
+        setValue(SCAST(qreal, m_panelConfig->threshold)));
+
+  setProperty("collapsed", m_panelConfig->collapsed);
+
+  applyParams();
+  refreshUi();
+}
+
+bool
+ScannerWidget::event(QEvent *event)
+{
+  if (event->type() == QEvent::DynamicPropertyChange) {
+    QDynamicPropertyChangeEvent *const propEvent =
+        static_cast<QDynamicPropertyChangeEvent*>(event);
+    QString propName = propEvent->propertyName();
+    if (propName == "collapsed")
+      m_panelConfig->collapsed = property("collapsed").value<bool>();
+  }
+
+  return QWidget::event(event);
+}
+
+void
+ScannerWidget::setState(int, Suscan::Analyzer *analyzer)
+{
+  if (m_analyzer != analyzer) {
+    m_analyzer = analyzer;
+    m_scanner->setAnalyzer(analyzer);
+
+    if (analyzer == nullptr) {
+      m_ui->channelLabel->setText("N/A");
+      m_ui->rateLabel->setText("N/A");
+    }
+  }
+
+  refreshUi();
+}
+
+////////////////////////////////// Slots ///////////////////////////////////////
+void
+ScannerWidget::onSourceChanged()
+{
+  m_panelConfig->useBookmarks = m_ui->sourceCombo->currentIndex() == 0;
+  refreshUi();
+}
+
+void
+ScannerWidget::onParamsChanged()
+{
+  m_panelConfig->rangeStart = m_ui->startSpin->value();
+  m_panelConfig->rangeEnd   = m_ui->endSpin->value();
+  m_panelConfig->step       = m_ui->stepSpin->value();
+  m_panelConfig->bandwidth  = m_ui->bandwidthSpin->value();
+  m_panelConfig->dwellMs    = SCAST(unsigned int, m_ui->dwellSpin->value());
+  m_panelConfig->hangTime   = SCAST(SUFLOAT, m_ui->hangSpin->value());
+  m_panelConfig->threshold  = SCAST(SUFLOAT, m_ui->thresholdSpin->value());
+
+  applyParams();
+}
+
+void
+ScannerWidget::onToggleScan()
+{
+  if (m_ui->scanButton->isChecked()) {
+    auto list = makeChannelList();
+
+    if (list.empty()) {
+      QMessageBox::warning(
+            this,
+            "Channel scanner",
+            m_panelConfig->useBookmarks
+            ? "There are no bookmarks to scan. Add some bookmarks first."
+            : "The frequency range is empty.",
+            QMessageBox::Ok);
+    } else {
+      m_scanner->setChannels(list);
+      applyParams();
+      m_scanner->start();
+    }
+  } else {
+    m_scanner->stop();
+  }
+
+  refreshUi();
+}
+
+void
+ScannerWidget::onSkip()
+{
+  m_scanner->resume();
+}
+
+void
+ScannerWidget::onScannerStateChanged(int state)
+{
+  switch (state) {
+    case ChannelScanner::IDLE:
+      m_ui->stateLabel->setText("Idle");
+      m_ui->rateLabel->setText("N/A");
+      break;
+
+    case ChannelScanner::OPENING:
+      m_ui->stateLabel->setText("Opening channel...");
+      break;
+
+    case ChannelScanner::SCANNING:
+      m_ui->stateLabel->setText("Scanning");
+      break;
+
+    case ChannelScanner::HOLDING:
+      m_ui->stateLabel->setText("Activity");
+      break;
+
+    case ChannelScanner::HANGING:
+      m_ui->stateLabel->setText("Hang");
+      break;
+  }
+
+  refreshUi();
+}
+
+void
+ScannerWidget::onChannelChanged(ScanChannel const &ch)
+{
+  QString freq = SuWidgetsHelpers::formatQuantity(ch.freq, 6, "Hz");
+
+  m_ui->channelLabel->setText(
+        ch.name.isEmpty() ? freq : ch.name + " (" + freq + ")");
+}
+
+void
+ScannerWidget::onTuneRequested(qreal center)
+{
+  // Same path as jumping to a bookmark: keeps the UI and the profile
+  // in sync with the tuner.
+  m_spectrum->setCenterFreq(SCAST(qint64, center));
+  m_mediator->onFrequencyChanged(SCAST(qint64, center));
+}
+
+void
+ScannerWidget::onActivity(ScanChannel const &ch, qreal snr)
+{
+  // Bring the demodulator there, so audio preview follows the scanner
+  m_spectrum->setLoFreq(
+        SCAST(qint64, ch.freq) - m_spectrum->getCenterFreq());
+
+  m_ui->stateLabel->setText(
+        "Activity (" + QString::number(snr, 'f', 1) + " dB)");
+}
+
+void
+ScannerWidget::onScanRate(qreal rate)
+{
+  m_ui->rateLabel->setText(
+        QString::number(rate, 'f', 1)
+        + " ch/s ("
+        + QString::number(m_scanner->getSpeculationMisses())
+        + " backtracks)");
+}
+
+void
+ScannerWidget::onScannerError(QString error)
+{
+  refreshUi();
+
+  QMessageBox::warning(
+        this,
+        "Channel scanner",
+        error,
+        QMessageBox::Ok);
+}
@@ -0,0 +1,97 @@
+//
+//    Default/Scanner/ScannerWidget.h: Channel scanner panel
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef SCANNERWIDGET_H
+#define SCANNERWIDGET_H
+
+#include <ToolWidgetFactory.h>
+#include "ChannelScanner.h"
+
+namespace Ui {
+  class ScannerPanel;
+}
+
+namespace SigDigger {
+  class ScannerWidgetFactory;
+  class MainSpectrum;
+
+  class ScannerWidgetConfig : public Suscan::Serializable {
+  public:
+    bool collapsed       = false;
+    bool useBookmarks    = true;
+    SUFREQ rangeStart    = 144e6;
+    SUFREQ rangeEnd      = 146e6;
+    SUFREQ step          = 12.5e3;
+    SUFREQ bandwidth     = 12.5e3;
+    unsigned int dwellMs = 50;
+    SUFLOAT hangTime     = 2;
+    SUFLOAT threshold    = 10;
+
+    // Overriden methods
+    void deserialize(Suscan::Object const &conf) override;
+    Suscan::Object &&serialize() override;
+  };
+
+  class ScannerWidget : public ToolWidget
+  {
+    Q_OBJECT
+
+    ScannerWidgetConfig *m_panelConfig = nullptr;
+
+    ChannelScanner   *m_scanner = nullptr;
+    Suscan::Analyzer *m_analyzer = nullptr; // Borrowed
+
+    // UI members
+    MainSpectrum *m_spectrum = nullptr;
+    Ui::ScannerPanel *m_ui = nullptr;
+
+    // Private methods
+    void connectAll();
+    void refreshUi();
+    void applyParams();
+    std::vector<ScanChannel> makeChannelList() const;
+
+  public:
+    ScannerWidget(ScannerWidgetFactory *, UIMediator *, QWidget *parent = nullptr);
+    ~ScannerWidget() override;
+
+    // Configuration methods
+    Suscan::Serializable *allocConfig() override;
+    void applyConfig() override;
+    bool event(QEvent *) override;
+
+    // Overriden methods
+    void setState(int, Suscan::Analyzer *) override;
+
+  public slots:
+    void onSourceChanged();
+    void onParamsChanged();
+    void onToggleScan();
+    void onSkip();
+
+    // Scanner slots
+    void onScannerStateChanged(int);
+    void onChannelChanged(SigDigger::ScanChannel const &);
+    void onTuneRequested(qreal);
+    void onActivity(SigDigger::ScanChannel const &, qreal);
+    void onScanRate(qreal);
+    void onScannerError(QString);
+  };
+}
+
+#endif // SCANNERWIDGET_H
@@ -0,0 +1,49 @@
+//
+//    Default/Scanner/ScannerWidgetFactory.cpp: description
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "ScannerWidgetFactory.h"
+#include "ScannerWidget.h"
+
+using namespace SigDigger;
+
+const char *
+ScannerWidgetFactory::name() const
+{
+  return "ScannerWidget";
+}
+
+ToolWidget *
+ScannerWidgetFactory::make(UIMediator *mediator)
+{
+  return new ScannerWidget(this, mediator);
+}
+
+ScannerWidgetFactory::ScannerWidgetFactory(Suscan::Plugin *plugin) :
+  ToolWidgetFactory(plugin) { }
+
+const char *
+ScannerWidgetFactory::desc() const
+{
+  return "Channel scanner";
+}
+
+std::string
+ScannerWidgetFactory::getTitle() const
+{
+  return desc();
+}
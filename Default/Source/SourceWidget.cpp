@@ -22,13 +22,24 @@
 #include "SuWidgetsHelpers.h"
 #include "ui_SourceWidget.h"
 #include <QMessageBox>
+#include <QFile>
+#include <QTimer>
+#include <QDateTime>
+#include <cmath>
+#include <climits>
 #include <FileDataSaver.h>
+#include <CaptureIndex.h>
 #include <fcntl.h>
 #include <UIMediator.h>
 #include <SigDiggerHelpers.h>
+#include <QTimeSlider.h>
+#include <TimeWindow.h>
 
 using namespace SigDigger;
 
+#define SIGDIGGER_SOURCE_GAIN_CONTROL_INTERVAL_MS 500
+#define SIGDIGGER_SOURCE_GAIN_EVENTS_SHOWN       8
+
 #define STRINGFY(x) #x
 #define STORE(field) obj.set(STRINGFY(field), field)
 #define LOAD(field) field = conf.get(STRINGFY(field), field)
@@ -70,8 +81,14 @@ SourceWidgetConfig::deserialize(Suscan::Object const &conf)
   LOAD(iqRev);
   LOAD(agcEnabled);
   LOAD(gainPresetEnabled);
+  LOAD(captureIndex);
+  LOAD(segmentRecordings);
+  LOAD(closedLoopGain);
   LOAD(allocHistory);
   LOAD(replayAllocationMiB);
+  LOAD(indexedHistory);
+  LOAD(historyBacking);
+  LOAD(historySpan);
 
   try {
     Suscan::Object field = conf.getField("dataSaverConfig");
@@ -116,8 +133,14 @@ SourceWidgetConfig::serialize(void)
   STORE(iqRev);
   STORE(agcEnabled);
   STORE(gainPresetEnabled);
+  STORE(captureIndex);
+  STORE(segmentRecordings);
+  STORE(closedLoopGain);
   STORE(allocHistory);
   STORE(replayAllocationMiB);
+  STORE(indexedHistory);
+  STORE(historyBacking);
+  STORE(historySpan);
 
   dataSaverConfig = this->dataSaverConfig->serialize();
 
@@ -154,6 +177,15 @@ SourceWidget::SourceWidget(
   m_ui->throttleSpin->setUnits("sps");
   m_ui->throttleSpin->setMinimum(0);
 
+  m_historySlider = new QTimeSlider(this);
+  m_ui->gridLayout_3->addWidget(m_historySlider, 6, 0, 1, 3);
+
+  m_gainTimer = new QTimer(this);
+  m_gainTimer->setInterval(SIGDIGGER_SOURCE_GAIN_CONTROL_INTERVAL_MS);
+  m_gainTimer->start();
+
+  m_ui->pipeLabel->hide();
+
   assertConfig();
   connectAll();
 
@@ -162,6 +194,9 @@ SourceWidget::SourceWidget(
 
 SourceWidget::~SourceWidget()
 {
+  if (m_historyWindow != nullptr)
+    delete m_historyWindow;
+
   delete m_ui;
 }
 
@@ -241,6 +276,24 @@ SourceWidget::connectAll(void)
         this,
         SLOT(onPPMChanged(void)));
 
+  connect(
+        m_ui->closedLoopGainCheck,
+        SIGNAL(toggled(bool)),
+        this,
+        SLOT(onToggleClosedLoopGain(void)));
+
+  connect(
+        m_ui->captureIndexCheck,
+        SIGNAL(toggled(bool)),
+        this,
+        SLOT(onToggleCaptureIndex(void)));
+
+  connect(
+        m_gainTimer,
+        SIGNAL(timeout()),
+        this,
+        SLOT(onGainControlTimer(void)));
+
   connect(
         m_ui->allocHistoryCheck,
         SIGNAL(toggled(bool)),
@@ -258,6 +311,42 @@ SourceWidget::connectAll(void)
         SIGNAL(toggled(bool)),
         this,
         SLOT(onToggleReplay()));
+
+  connect(
+        m_ui->indexedHistoryCheck,
+        SIGNAL(toggled(bool)),
+        this,
+        SLOT(onIndexedHistoryToggled()));
+
+  connect(
+        m_ui->historyBackingCombo,
+        SIGNAL(activated(int)),
+        this,
+        SLOT(onHistoryBackingChanged()));
+
+  connect(
+        m_ui->historySpanSpin,
+        SIGNAL(valueChanged(qreal)),
+        this,
+        SLOT(onHistorySpanChanged()));
+
+  connect(
+        m_ui->openHistoryButton,
+        SIGNAL(clicked(bool)),
+        this,
+        SLOT(onOpenHistory()));
+
+  connect(
+        m_ui->saveHistoryButton,
+        SIGNAL(clicked(bool)),
+        this,
+        SLOT(onSaveHistory()));
+
+  connect(
+        &m_stdinPipe,
+        SIGNAL(statsChanged()),
+        this,
+        SLOT(onStdinPipeStats()));
 }
 
 
@@ -383,6 +472,15 @@ SourceWidget::applySourceInfo(Suscan::AnalyzerSourceInfo const &info)
 
   m_sourceInfo = Suscan::AnalyzerSourceInfo(info);
 
+  if (m_dataSaver != nullptr) {
+    bool retuned =
+        !sufeq(info.getFrequency(), m_captureFreq, 1)
+        || SCAST(unsigned, info.getEffectiveSampleRate()) != m_captureRate;
+
+    if (retuned && m_panelConfig->segmentRecordings)
+      segmentCapture();
+  }
+
   if (!m_haveSourceInfo) {
 
     // First source info! Set delayed analyzer options (this ones are
@@ -451,6 +549,122 @@ SourceWidget::applySourceInfo(Suscan::AnalyzerSourceInfo const &info)
   setBlockingSignals(oldBlocking);
 }
 
+bool
+SourceWidget::canControlGain() const
+{
+  return m_analyzer != nullptr
+      && m_profile != nullptr
+      && m_profile->isRealTime()
+      && !m_gainControls.empty()
+      && m_sourceInfo.testPermission(SUSCAN_ANALYZER_PERM_SET_GAIN);
+}
+
+bool
+SourceWidget::applyGainCorrection(qreal dB)
+{
+  bool changed = false;
+
+  m_applyingGainCorrection = true;
+
+  if (m_panelConfig->gainPresetEnabled && m_currentAutoGain != nullptr) {
+    // Presets have no units: move one position at a time
+    int value = m_ui->autoGainSlider->value() + (dB > 0 ? 1 : -1);
+
+    if (value >= m_currentAutoGain->getMin()
+        && value <= m_currentAutoGain->getMax()) {
+      BLOCKSIG(m_ui->autoGainSlider, setValue(value));
+      applyCurrentAutogain();
+      changed = true;
+    }
+  } else {
+    // Raise gains front to back, lower them back to front. Only one gain
+    // element is touched per correction.
+    size_t count = m_gainControls.size();
+
+    for (size_t n = 0; n < count && !changed; ++n) {
+      DeviceGain *gain = m_gainControls[dB > 0 ? n : count - n - 1];
+      float current = gain->getGain();
+      float steps = std::round(SCAST(float, dB) / gain->getStep());
+      float target;
+
+      if (steps == 0)
+        steps = dB > 0 ? 1 : -1;
+
+      target = qBound(
+            gain->getMin(),
+            current + steps * gain->getStep(),
+            gain->getMax());
+
+      if (target != current) {
+        gain->setGain(target);
+        onGainChanged(
+              QString::fromStdString(gain->getName()),
+              gain->getGain());
+        changed = true;
+      }
+    }
+  }
+
+  m_applyingGainCorrection = false;
+
+  return changed;
+}
+
+void
+SourceWidget::refreshGainStats(BasebandStats const &stats)
+{
+  QString toolTip;
+
+  if (!m_panelConfig->closedLoopGain) {
+    m_ui->closedLoopGainLabel->setText("Disabled");
+    m_ui->closedLoopGainLabel->setToolTip("");
+    return;
+  }
+
+  if (stats.samples == 0) {
+    m_ui->closedLoopGainLabel->setText("N/A");
+    return;
+  }
+
+  m_ui->closedLoopGainLabel->setText(
+        QString::number(stats.peakDb(), 'f', 1)
+        + " dBFS peak"
+        + (stats.clipped > 0 ? " (clipping)" : ""));
+
+  toolTip =
+      "Peak: " + QString::number(stats.peakDb(), 'f', 1) + " dBFS\n"
+      + "RMS: " + QString::number(stats.rmsDb(), 'f', 1) + " dBFS\n"
+      + "Peak to RMS: " + QString::number(stats.crestDb(), 'f', 1) + " dB\n"
+      + "Noise floor: " + QString::number(stats.floorDb(), 'f', 1) + " dBFS\n"
+      + "Clipped: "
+      + QString::number(stats.clipRatio() * 100, 'g', 3) + "%";
+
+  auto events = m_gainController.events();
+  size_t first = events.size() > SIGDIGGER_SOURCE_GAIN_EVENTS_SHOWN
+      ? events.size() - SIGDIGGER_SOURCE_GAIN_EVENTS_SHOWN
+      : 0;
+
+  if (first < events.size())
+    toolTip += "\n\nRecent gain changes:";
+
+  for (size_t i = first; i < events.size(); ++i) {
+    auto const &ev = events[i];
+    QDateTime when = QDateTime::fromMSecsSinceEpoch(
+          SCAST(qint64, ev.tv.tv_sec) * 1000 + ev.tv.tv_usec / 1000);
+
+    toolTip += "\n"
+        + when.toString("hh:mm:ss.zzz")
+        + " "
+        + QString::fromStdString(ev.name)
+        + " = "
+        + QString::number(SCAST(qreal, ev.value))
+        + " dB"
+        + (ev.automatic ? " (auto)" : "");
+  }
+
+  m_ui->closedLoopGainLabel->setToolTip(toolTip);
+}
+
 void
 SourceWidget::applyCurrentAutogain(void)
 {
@@ -591,6 +805,9 @@ SourceWidget::refreshUi()
         && m_sourceInfo.testPermission(SUSCAN_ANALYZER_PERM_SET_GAIN));
   m_ui->autoGainFrame->setEnabled(
         m_sourceInfo.testPermission(SUSCAN_ANALYZER_PERM_SET_GAIN));
+  m_ui->closedLoopGainCheck->setEnabled(
+        m_analyzer == nullptr
+        || m_sourceInfo.testPermission(SUSCAN_ANALYZER_PERM_SET_GAIN));
 
   if (m_analyzer == nullptr) {
     canReplay = false;
@@ -620,6 +837,14 @@ SourceWidget::refreshUi()
   m_ui->replayButton->setEnabled(canReplay);
   m_ui->replayButton->setStyleSheet(
         canReplay ? "color: white;\nbackground-color: " + color + ";" : "");
+
+  // Indexed history
+  bool haveHistory = m_history.isAllocated() && m_history.end() > 0;
+  m_ui->historyBackingCombo->setEnabled(m_panelConfig->indexedHistory);
+  m_historySlider->setEnabled(haveHistory);
+  m_ui->historySpanSpin->setEnabled(haveHistory);
+  m_ui->openHistoryButton->setEnabled(haveHistory);
+  m_ui->saveHistoryButton->setEnabled(haveHistory);
   m_ui->autoGainCombo->setEnabled(gainPresetEnabled);
   m_ui->autoGainSlider->setEnabled(gainPresetEnabled);
 }
@@ -644,6 +869,7 @@ SourceWidget::setSampleRate(unsigned int rate)
   if (m_rate != rate) {
     float step;
     m_rate = rate;
+    m_history.setSampleRate(rate);
     if (rate == 0) {
       setProcessRate(0);
       m_ui->sampleRateLabel->setText("N/A");
@@ -892,8 +1118,15 @@ SourceWidget::applyConfig()
   BLOCKSIG(m_ui->swapIQCheck, setChecked(m_panelConfig->iqRev));
   BLOCKSIG(m_ui->agcEnabledCheck, setChecked(m_panelConfig->agcEnabled));
   BLOCKSIG(m_ui->gainPresetCheck, setChecked(m_panelConfig->gainPresetEnabled));
+  BLOCKSIG(m_ui->closedLoopGainCheck, setChecked(m_panelConfig->closedLoopGain));
+  BLOCKSIG(m_ui->captureIndexCheck, setChecked(m_panelConfig->captureIndex));
   BLOCKSIG(m_ui->allocHistoryCheck, setChecked(m_panelConfig->allocHistory));
   BLOCKSIG(m_ui->allocSizeSpin, setValue(m_panelConfig->replayAllocationMiB));
+  BLOCKSIG(m_ui->indexedHistoryCheck, setChecked(m_panelConfig->indexedHistory));
+  BLOCKSIG(
+        m_ui->historyBackingCombo,
+        setCurrentIndex(m_panelConfig->historyBacking));
+  BLOCKSIG(m_ui->historySpanSpin, setValue(m_panelConfig->historySpan));
 
   setProperty("collapsed", m_panelConfig->collapsed);
 
@@ -975,6 +1208,7 @@ SourceWidget::setState(int state, Suscan::Analyzer *analyzer)
     if (m_analyzer == nullptr) {
       m_sourceInfo = Suscan::AnalyzerSourceInfo();
       setProcessRate(0);
+      m_stdinPipe.stop();
     } else {
       // Switched to running! Then, do the following:
       // 1. Connect source_info_message
@@ -996,6 +1230,17 @@ SourceWidget::setState(int state, Suscan::Analyzer *analyzer)
 
       // First presence of analyzer!
       adjustHistoryConfig();
+
+      m_gainController.reset();
+      if (m_panelConfig->closedLoopGain)
+        installBaseBandFilter();
+
+      // The indexed history of the previous run is kept until a new
+      // analyzer shows up
+      m_history.clear();
+      adjustIndexedHistory();
+
+      startStdinPipe();
     }
 
     m_ui->replayButton->setChecked(false);
@@ -1058,6 +1303,15 @@ SourceWidget::setProfile(Suscan::Source::Config &profile)
   setBlockingSignals(oldBlocking);
 }
 
+void
+SourceWidget::setColorConfig(ColorConfig const &colors)
+{
+  m_colors = colors;
+
+  if (m_historyWindow != nullptr)
+    m_historyWindow->setColorConfig(colors);
+}
+
 void
 SourceWidget::adjustHistoryConfig()
 {
@@ -1071,6 +1325,86 @@ SourceWidget::adjustHistoryConfig()
   }
 }
 
+void
+SourceWidget::adjustIndexedHistory()
+{
+  SUSCOUNT samples = 0;
+  auto backing = static_cast<SampleHistory::Backing>(
+        m_panelConfig->historyBacking);
+
+  // Do not pull the rug from under an open time window
+  if (m_history.isFrozen())
+    return;
+
+  if (m_panelConfig->indexedHistory)
+    samples = static_cast<SUSCOUNT>(
+          m_panelConfig->replayAllocationMiB * (1 << 20) / sizeof(SUCOMPLEX));
+
+  if (samples == m_history.capacity() && backing == m_history.backing())
+    return;
+
+  if (!m_history.allocate(samples, backing)) {
+    QMessageBox::warning(
+          this,
+          "SigDigger error",
+          "Cannot allocate indexed history: " + m_history.getLastError(),
+          QMessageBox::Ok);
+    BLOCKSIG(m_ui->indexedHistoryCheck, setChecked(false));
+    m_panelConfig->indexedHistory = false;
+    m_history.release();
+  }
+
+  m_history.setSampleRate(m_rate);
+
+  // A new ring may push other buffers out of the memory budget
+  MemoryBudget::instance()->touch(&m_history);
+
+  if (m_history.isAllocated())
+    installBaseBandFilter();
+}
+
+void
+SourceWidget::refreshHistorySlider()
+{
+  quint64 first, end;
+
+  if (!m_history.isAllocated())
+    return;
+
+  first = m_history.first();
+  end   = m_history.end();
+
+  if (end > first) {
+    m_historySlider->setSampleRate(SCAST(quint64, m_history.sampleRate()));
+    m_historySlider->setStartTime(m_history.timeAt(first));
+    m_historySlider->setEndTime(m_history.timeAt(end));
+  }
+}
+
+bool
+SourceWidget::getHistorySelection(quint64 &start, SUSCOUNT &len) const
+{
+  struct timeval offset, tv;
+  quint64 first = m_history.first();
+  quint64 end   = m_history.end();
+
+  if (end <= first)
+    return false;
+
+  // The slider reports the time relative to its start
+  offset = m_historySlider->getTimeStamp();
+  tv     = m_history.timeAt(first);
+  timeradd(&tv, &offset, &tv);
+
+  start = m_history.sampleAt(tv);
+  len   = SCAST(SUSCOUNT, m_panelConfig->historySpan * m_history.sampleRate());
+
+  if (start + len > end)
+    len = SCAST(SUSCOUNT, end - start);
+
+  return len > 0;
+}
+
 //////////////////////////////// Data saving ///////////////////////////////////
 int
 SourceWidget::openCaptureFile(void)
@@ -1084,6 +1418,16 @@ SourceWidget::openCaptureFile(void)
   if (m_profile == nullptr)
     return -1;
 
+  // Once the source reports its tuning, that is what segments are
+  // compared against. Baseband is recorded after decimation.
+  if (m_haveSourceInfo) {
+    m_captureRate = SCAST(unsigned, m_sourceInfo.getEffectiveSampleRate());
+    m_captureFreq = m_sourceInfo.getFrequency();
+  } else {
+    m_captureRate = m_profile->getDecimatedSampleRate();
+    m_captureFreq = m_mediator->getCurrentCenterFreq();
+  }
+
   unixtime = time(nullptr);
   gmtime_r(&unixtime, &tm);
   strftime(datetime, sizeof(datetime), "%Y%m%d_%H%M%SZ", &tm);
@@ -1093,12 +1437,25 @@ SourceWidget::openCaptureFile(void)
         sizeof(baseName),
         "sigdigger_%s_%d_%.0lf_float32_iq.raw",
         datetime,
-        m_profile->getDecimatedSampleRate(),
-        m_mediator->getCurrentCenterFreq());
+        m_captureRate,
+        m_captureFreq);
 
   std::string fullPath =
       m_saverUI->getRecordSavePath() + "/" + baseName;
 
+  // Quick retunes back and forth may produce the same name twice
+  for (unsigned int i = 1; QFile::exists(QString::fromStdString(fullPath)); ++i) {
+    snprintf(
+          baseName,
+          sizeof(baseName),
+          "sigdigger_%s_%d_%.0lf_float32_iq_%u.raw",
+          datetime,
+          m_captureRate,
+          m_captureFreq,
+          i);
+    fullPath = m_saverUI->getRecordSavePath() + "/" + baseName;
+  }
+
   if ((fd = creat(fullPath.c_str(), 0600)) == -1) {
     QMessageBox::warning(
               this,
@@ -1106,18 +1463,70 @@ SourceWidget::openCaptureFile(void)
               "Failed to open capture file for writing: " +
               QString(strerror(errno)),
               QMessageBox::Ok);
+  } else if (m_panelConfig->captureIndex) {
+    // The index is optional: the recording is usable without it
+    auto index = new CaptureIndexWriter();
+
+    if (index->open(
+          CaptureIndex::pathFor(fullPath),
+          m_captureRate,
+          m_captureFreq)) {
+      CaptureIndexWriter *old;
+
+      m_saverMutex.lock();
+      old = m_captureIndex;
+      m_captureIndex = index;
+      m_saverMutex.unlock();
+
+      delete old;
+    } else {
+      SU_WARNING(
+            "Cannot create capture index: %s\n",
+            index->getLastError().c_str());
+      delete index;
+    }
   }
 
   return fd;
 }
 
+void
+SourceWidget::segmentCapture()
+{
+  int fd;
+
+  // Close the current segment and start a new one with the new tuning in
+  // its name and index. Gain changes do not split the recording, they are
+  // kept as events in the index instead.
+  uninstallDataSaver();
+
+  if ((fd = openCaptureFile()) != -1) {
+    installDataSaver(fd);
+  } else {
+    setCaptureSize(0);
+    setRecordState(false);
+  }
+}
+
 void
 SourceWidget::uninstallDataSaver()
 {
-  if (m_dataSaver != nullptr)
-    delete m_dataSaver;
+  FileDataSaver *saver;
+  CaptureIndexWriter *index;
 
+  // Once detached, the baseband filter cannot be using them anymore
+  m_saverMutex.lock();
+  saver = m_dataSaver;
+  index = m_captureIndex;
   m_dataSaver = nullptr;
+  m_captureIndex = nullptr;
+  m_saverMutex.unlock();
+
+  if (saver != nullptr)
+    delete saver;
+
+  if (index != nullptr)
+    delete index;
 }
 
 void
@@ -1160,25 +1569,70 @@ SigDigger::onBaseBandData(
   SourceWidget *widget = static_cast<SourceWidget *>(privdata);
   FileDataSaver *saver;
 
-  if ((saver = widget->m_dataSaver) != nullptr)
-    saver->write(samples, length);
+  widget->m_saverMutex.lock();
+  if ((saver = widget->m_dataSaver) != nullptr) {
+    // Dropped batches never reach the file, keep the index in step
+    if (saver->write(samples, length) && widget->m_captureIndex != nullptr)
+      widget->m_captureIndex->feed(length);
+  }
+  widget->m_saverMutex.unlock();
+
+  widget->m_history.feed(samples, length);
+
+  if (widget->m_panelConfig->closedLoopGain)
+    widget->m_gainController.feed(samples, length);
 
   return SU_TRUE;
 }
 
+void
+SourceWidget::installBaseBandFilter()
+{
+  if (!m_filterInstalled && m_analyzer != nullptr) {
+    m_analyzer->registerBaseBandFilter(onBaseBandData, this);
+    m_filterInstalled = true;
+  }
+}
+
+void
+SourceWidget::startStdinPipe()
+{
+  bool isStdin = m_profile != nullptr
+      && m_profile->getType() == "stdin"
+      && StdinPipe::isPipe();
+
+  m_ui->pipeLabel->setVisible(isStdin);
+
+  if (isStdin) {
+    auto param = m_profile->getParam("pipe_size");
+    qint64 size = SCAST(qint64, SIGDIGGER_STDIN_PIPE_DEFAULT_MIB) << 20;
+
+    if (!param.empty())
+      size = strtoll(param.c_str(), nullptr, 10);
+
+    // Zero leaves the system default in place
+    if (size > 0)
+      StdinPipe::grow(SCAST(int, qMin<qint64>(size, INT_MAX)));
+
+    m_stdinPipe.start();
+  }
+}
+
 void
 SourceWidget::installDataSaver(int fd)
 {
   if (m_dataSaver == nullptr) {
     if (m_profile != nullptr && m_analyzer != nullptr) {
-      m_dataSaver = new FileDataSaver(fd, this);
-      m_dataSaver->setSampleRate(m_profile->getDecimatedSampleRate());
+      FileDataSaver *saver = new FileDataSaver(fd, this);
 
-      if (!m_filterInstalled) {
-        m_analyzer->registerBaseBandFilter(onBaseBandData, this);
-        m_filterInstalled = true;
-      }
+      // Same rate the segment was named and indexed with
+      saver->setSampleRate(m_captureRate);
 
+      m_saverMutex.lock();
+      m_dataSaver = saver;
+      m_saverMutex.unlock();
+
+      installBaseBandFilter();
       connectDataSaver();
     }
   }
@@ -1206,6 +1660,13 @@ SourceWidget::onPSDMessage(Suscan::PSDMessage const &msg)
     m_ui->replayTimeProgress->setFormat(text);
     m_ui->replayTimeProgress->setValue(size >> 10);
   }
+
+  if (m_history.isAllocated() && !m_history.isFrozen()) {
+    refreshHistorySlider();
+
+    if (!m_ui->openHistoryButton->isEnabled() && m_history.end() > 0)
+      refreshUi();
+  }
 }
 
 void
@@ -1216,6 +1677,14 @@ SourceWidget::onGainChanged(QString name, float val)
   if (m_profile != nullptr)
     m_profile->setGain(name.toStdString(), val);
 
+  // Keep the closed loop away from gains just set by hand
+  m_gainController.recordEvent(
+        name.toStdString(),
+        val,
+        m_applyingGainCorrection);
+  if (!m_applyingGainCorrection)
+    m_gainController.holdOff();
+
   if (m_analyzer != nullptr) {
     try {
       m_analyzer->setGain(name.toStdString(), val);
@@ -1316,6 +1785,42 @@ SourceWidget::onPPMChanged(void)
   }
 }
 
+void
+SourceWidget::onToggleClosedLoopGain(void)
+{
+  m_panelConfig->closedLoopGain = m_ui->closedLoopGainCheck->isChecked();
+  m_gainController.reset();
+
+  if (m_panelConfig->closedLoopGain)
+    installBaseBandFilter();
+
+  refreshGainStats(BasebandStats());
+}
+
+void
+SourceWidget::onToggleCaptureIndex(void)
+{
+  // Takes effect with the next recording (or segment)
+  m_panelConfig->captureIndex = m_ui->captureIndexCheck->isChecked();
+}
+
+void
+SourceWidget::onGainControlTimer(void)
+{
+  BasebandStats stats = m_gainController.take();
+  qreal dB;
+
+  refreshGainStats(stats);
+
+  if (!m_panelConfig->closedLoopGain || !canControlGain())
+    return;
+
+  dB = m_gainController.decide(stats);
+
+  if (dB != 0 && applyGainCorrection(dB))
+    m_gainController.holdOff();
+}
+
 void
 SourceWidget::onChangeAutoGain(void)
 {
@@ -1495,6 +2000,7 @@ SourceWidget::onAllocHistorySizeChanged()
 {
   m_panelConfig->replayAllocationMiB = m_ui->allocSizeSpin->value();
   adjustHistoryConfig();
+  adjustIndexedHistory();
 }
 
 void
@@ -1504,3 +2010,135 @@ SourceWidget::onToggleReplay()
     m_analyzer->replay(m_ui->replayButton->isChecked());
 }
 
+void
+SourceWidget::onIndexedHistoryToggled()
+{
+  m_panelConfig->indexedHistory = m_ui->indexedHistoryCheck->isChecked();
+  adjustIndexedHistory();
+  refreshUi();
+}
+
+void
+SourceWidget::onHistoryBackingChanged()
+{
+  m_panelConfig->historyBacking = m_ui->historyBackingCombo->currentIndex();
+  adjustIndexedHistory();
+  refreshUi();
+}
+
+void
+SourceWidget::onHistorySpanChanged()
+{
+  m_panelConfig->historySpan = m_ui->historySpanSpin->value();
+}
+
+void
+SourceWidget::onOpenHistory()
+{
+  quint64 start;
+  SUSCOUNT len;
+  const SUCOMPLEX *data;
+
+  if (!getHistorySelection(start, len))
+    return;
+
+  // Freeze the ring: the window reads straight from it
+  m_history.setFrozen(true);
+
+  if ((data = m_history.span(start, len)) == nullptr) {
+    if (!m_history.copySpan(start, len, m_historyCopy)) {
+      m_history.setFrozen(false);
+      return;
+    }
+    data = m_historyCopy.data();
+  }
+
+  if (m_historyWindow == nullptr) {
+    m_historyWindow = new TimeWindow(this);
+    m_historyWindow->postLoadInit();
+    m_historyWindow->setColorConfig(m_colors);
+
+    connect(
+          m_historyWindow,
+          SIGNAL(closed()),
+          this,
+          SLOT(onHistoryWindowClosed()));
+  }
+
+  m_historyWindow->setData(
+        data,
+        len,
+        m_history.sampleRate(),
+        m_history.sampleRate());
+  m_historyWindow->refresh();
+  m_historyWindow->setCenterFreq(m_mediator->getCurrentCenterFreq());
+  m_historyWindow->show();
+  m_historyWindow->raise();
+  m_historyWindow->activateWindow();
+  m_historyWindow->onFit();
+}
+
+void
+SourceWidget::onSaveHistory()
+{
+  quint64 start;
+  SUSCOUNT len;
+  const SUCOMPLEX *data;
+  std::vector<SUCOMPLEX> copy;
+  bool frozen = m_history.isFrozen();
+
+  if (!getHistorySelection(start, len))
+    return;
+
+  // Export tasks take their own snapshot of the samples
+  m_history.setFrozen(true);
+
+  if ((data = m_history.span(start, len)) == nullptr
+      && m_history.copySpan(start, len, copy))
+    data = copy.data();
+
+  if (data != nullptr)
+    SigDiggerHelpers::openSaveSamplesDialog(
+          this,
+          data,
+          len,
+          m_history.sampleRate(),
+          0,
+          SCAST(int, len),
+          Suscan::Singleton::get_instance()->getBackgroundTaskController());
+
+  m_history.setFrozen(frozen);
+}
+
+void
+SourceWidget::onHistoryWindowClosed()
+{
+  m_history.setFrozen(false);
+  m_historyCopy.clear();
+  m_historyCopy.shrink_to_fit();
+
+  // Apply any allocation changes made while frozen
+  adjustIndexedHistory();
+}
+
+void
+SourceWidget::onStdinPipeStats()
+{
+  StdinPipeStats const &stats = m_stdinPipe.stats();
+  QString text;
+
+  if (stats.capacity <= 0) {
+    m_ui->pipeLabel->setText("Pipe: unknown size");
+    return;
+  }
+
+  text = "Pipe: "
+      + QString::number(100ll * stats.queued / stats.capacity) + "% of "
+      + SuWidgetsHelpers::formatBinaryQuantity(stats.capacity)
+      + " (peak " + QString::number(100ll * stats.peak / stats.capacity) + "%)";
+
+  if (stats.stalls > 0)
+    text += ", " + QString::number(stats.stalls) + " stalls";
+
+  m_ui->pipeLabel->setText(text);
+}
@@ -23,14 +23,24 @@
 #include "DataSaverUI.h"
 #include "DeviceGain.h"
 #include "AutoGain.h"
+#include "SampleHistory.h"
+#include "GainController.h"
+#include "ColorConfig.h"
+#include "StdinPipe.h"
+#include <QMutex>
 
 namespace Ui {
   class SourcePanel;
 }
 
+class QTimer;
+
 namespace SigDigger {
   class SourceWidgetFactory;
   class FileDataSaver;
+  class CaptureIndexWriter;
+  class QTimeSlider;
+  class TimeWindow;
 
   SUBOOL onBaseBandData(
       void *privdata,
@@ -58,9 +68,15 @@ namespace SigDigger {
       bool iqRev = false;
       bool agcEnabled = false;
       bool gainPresetEnabled = false;
+      bool captureIndex = false;
+      bool segmentRecordings = true;
+      bool closedLoopGain = false;
 
       bool  allocHistory = false;
       qreal replayAllocationMiB = 100;
+      bool  indexedHistory = false;
+      int   historyBacking = SampleHistory::HISTORY_BACKING_HEAP;
+      qreal historySpan = 1;
 
       std::map<std::string, GainPresetSetting> agcSettings;
       unsigned int throttleRate = 196000;
@@ -99,9 +115,29 @@ namespace SigDigger {
     std::vector<AutoGain>    *m_currAutoGainSet = nullptr;
     AutoGain                 *m_currentAutoGain = nullptr;
 
-    // Data saving state
+    // Data saving state. The baseband filter runs in the analyzer thread
+    // and holds m_saverMutex while it uses the saver and the index.
     bool                      m_filterInstalled = false;
+    QMutex                    m_saverMutex;
     FileDataSaver            *m_dataSaver = nullptr;
+    CaptureIndexWriter       *m_captureIndex = nullptr;
+    SUFREQ                    m_captureFreq = 0;
+    unsigned int              m_captureRate = 0;
+
+    // Closed-loop gain control
+    GainController            m_gainController;
+    QTimer                   *m_gainTimer = nullptr;
+    bool                      m_applyingGainCorrection = false;
+
+    // Indexed history
+    SampleHistory             m_history;
+    QTimeSlider              *m_historySlider = nullptr;
+    TimeWindow               *m_historyWindow = nullptr;
+    std::vector<SUCOMPLEX>    m_historyCopy;
+    ColorConfig               m_colors;
+
+    // Standard input pipe (stdin sources only)
+    StdinPipe                 m_stdinPipe;
 
     // Private methods
     DeviceGain *lookupGain(std::string const &name);
@@ -128,6 +164,9 @@ namespace SigDigger {
     void setProcessRate(unsigned int rate);
     void applySourceInfo(Suscan::AnalyzerSourceInfo const &info);
     void setGain(std::string const &name, SUFLOAT val);
+    bool canControlGain() const;
+    bool applyGainCorrection(qreal dB);
+    void refreshGainStats(BasebandStats const &stats);
 
     void setCaptureSize(quint64);
     void setIORate(qreal);
@@ -143,10 +182,18 @@ namespace SigDigger {
 
     // History
     void adjustHistoryConfig();
+    void adjustIndexedHistory();
+    void refreshHistorySlider();
+    bool getHistorySelection(quint64 &start, SUSCOUNT &len) const;
+    void installBaseBandFilter();
+
+    // Stdin pipe
+    void startStdinPipe();
 
     // Data saver
     int openCaptureFile();
     void installDataSaver(int fd);
+    void segmentCapture();
     void connectDataSaver();
     void uninstallDataSaver();
 
@@ -162,6 +209,7 @@ namespace SigDigger {
     // Overriden methods
     void setState(int, Suscan::Analyzer *) override;
     void setProfile(Suscan::Source::Config &) override;
+    void setColorConfig(ColorConfig const &) override;
 
     friend SUBOOL
     onBaseBandData(
@@ -186,11 +234,23 @@ namespace SigDigger {
     void onToggleAGCEnabled();
     void onBandwidthChanged();
     void onPPMChanged();
+    void onToggleClosedLoopGain();
+    void onToggleCaptureIndex();
+    void onGainControlTimer();
 
     // History
     void onAllocHistoryToggled();
     void onAllocHistorySizeChanged();
     void onToggleReplay();
+    void onIndexedHistoryToggled();
+    void onHistoryBackingChanged();
+    void onHistorySpanChanged();
+    void onOpenHistory();
+    void onSaveHistory();
+    void onHistoryWindowClosed();
+
+    // Stdin pipe
+    void onStdinPipeStats();
 
     // Saver UI
     void onSaveError(void);
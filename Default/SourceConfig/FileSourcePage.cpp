@@ -20,6 +20,7 @@
 #include "FileSourcePage.h"
 #include "ui_FileSourcePage.h"
 #include "SigDiggerHelpers.h"
+#include "CaptureIndex.h"
 
 #include <QFileDialog>
 #include <QFileInfo>
@@ -119,7 +120,9 @@ FileSourcePage::guessParamsFromFileName()
   if (m_config == nullptr)
     return false;
 
-  if (m_config->guessMetadata(meta)) {
+  // Recordings with a capture index do not need their name to be parsed
+  if (CaptureIndex::guessMetadata(m_config->getPath(), meta)
+      || m_config->guessMetadata(meta)) {
     auto st = m_config->getStartTime();
     if ((meta.guessed & SUSCAN_SOURCE_CONFIG_GUESS_START_TIME)
         && (st.tv_sec != meta.start_time.tv_sec || st.tv_usec != meta.start_time.tv_usec)) {
@@ -18,6 +18,8 @@
 //
 #include "StdinSourcePage.h"
 #include <SuWidgetsHelpers.h>
+#include <StdinPipe.h>
+#include <vector>
 #include <suscan/util/cfg.h>
 #include "ui_StdinSourcePage.h"
 
@@ -72,6 +74,18 @@ StdinSourcePage::connectAll()
         SIGNAL(toggled(bool)),
         this,
         SLOT(onConfigChanged()));
+
+  connect(
+        ui->pipeSizeSpin,
+        SIGNAL(valueChanged(int)),
+        this,
+        SLOT(onConfigChanged()));
+
+  connect(
+        ui->detectButton,
+        SIGNAL(clicked(bool)),
+        this,
+        SLOT(onDetectFormat()));
 }
 
 uint64_t
@@ -112,6 +126,16 @@ StdinSourcePage::refreshUi()
   auto realtime = m_config->getParam("realtime");
   bool rt       = suscan_config_str_to_bool(realtime.c_str(), SU_FALSE) == SU_TRUE;
   BLOCKSIG(ui->realTimeCheck, setChecked(rt));
+
+  // Set pipe size (stored in bytes, empty means default)
+  auto pipeSize = m_config->getParam("pipe_size");
+  int mib       = SIGDIGGER_STDIN_PIPE_DEFAULT_MIB;
+  if (!pipeSize.empty())
+    mib = static_cast<int>(strtoll(pipeSize.c_str(), nullptr, 10) >> 20);
+  BLOCKSIG(ui->pipeSizeSpin, setValue(mib));
+
+  ui->detectButton->setEnabled(StdinPipe::isPipe());
+  ui->detectLabel->clear();
 }
 
 void
@@ -148,6 +172,44 @@ StdinSourcePage::onConfigChanged()
 
   m_config->setParam("format", ui->formatCombo->currentData().value<QString>().toStdString());
   m_config->setParam("realtime", ui->realTimeCheck->isChecked() ? "yes" : "no");
+  m_config->setParam(
+        "pipe_size",
+        std::to_string(static_cast<qint64>(ui->pipeSizeSpin->value()) << 20));
 
   emit changed();
 }
+
+void
+StdinSourcePage::onDetectFormat()
+{
+  std::vector<uint8_t> peeked(SIGDIGGER_STDIN_PIPE_PEEK_SIZE);
+  qint64 got;
+  QString format;
+  int index;
+
+  if (!StdinPipe::isPipe()) {
+    ui->detectLabel->setText("Standard input is not a pipe");
+    return;
+  }
+
+  got = StdinPipe::peek(peeked.data(), peeked.size());
+  if (got < 0) {
+    ui->detectLabel->setText("Cannot inspect the standard input");
+    return;
+  }
+
+  format = StdinPipe::guessFormat(peeked.data(), static_cast<size_t>(got));
+  index  = ui->formatCombo->findData(format);
+
+  if (format.isEmpty() || index == -1) {
+    ui->detectLabel->setText(
+          "Not enough data queued yet. Start the producer and try again.");
+    return;
+  }
+
+  ui->formatCombo->setCurrentIndex(index);
+  ui->detectLabel->setText(
+        "Looks like " + ui->formatCombo->currentText().toLower());
+
+  onConfigChanged();
+}
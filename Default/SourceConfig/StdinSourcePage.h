@@ -60,6 +60,7 @@ namespace SigDigger {
 
   public slots:
     void onConfigChanged();
+    void onDetectFormat();
 
   private:
     Ui::StdinSourcePage *ui;
@@ -0,0 +1,390 @@
+//
+//    ArenaAllocator.cpp: Aligned, huge page and NUMA aware buffer arena
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include <ArenaAllocator.h>
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+
+#ifdef _WIN32
+#  include <malloc.h>
+#else
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif // _WIN32
+
+#ifdef __linux__
+#  include <sys/syscall.h>
+#endif // __linux__
+
+// From <numaif.h>, which we do not want to depend on
+#define SIGDIGGER_MPOL_PREFERRED 1
+
+using namespace SigDigger;
+
+static void *
+alignedAlloc(size_t bytes)
+{
+#ifdef _WIN32
+  return _aligned_malloc(bytes, SIGDIGGER_ARENA_ALIGNMENT);
+#else
+  void *ptr = nullptr;
+
+  if (posix_memalign(&ptr, SIGDIGGER_ARENA_ALIGNMENT, bytes) != 0)
+    return nullptr;
+
+  return ptr;
+#endif // _WIN32
+}
+
+static void
+alignedFree(void *ptr)
+{
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif // _WIN32
+}
+
+#ifndef _WIN32
+static void
+applyPolicy(
+    ArenaPolicy const &policy,
+    void *ptr,
+    size_t bytes,
+    bool hugeTLB)
+{
+#ifdef MADV_HUGEPAGE
+  if (policy.hugePages != ARENA_HUGEPAGES_NONE && !hugeTLB)
+    (void) madvise(ptr, bytes, MADV_HUGEPAGE);
+#else
+  (void) hugeTLB;
+#endif // MADV_HUGEPAGE
+
+#if defined(__linux__) && defined(SYS_mbind)
+  // Only a preference: if the node is full, the kernel goes elsewhere
+  if (policy.numaNode >= 0
+      && policy.numaNode < static_cast<int>(8 * sizeof(unsigned long))) {
+    unsigned long mask = 1ul << policy.numaNode;
+
+    (void) syscall(
+          SYS_mbind,
+          ptr,
+          bytes,
+          SIGDIGGER_MPOL_PREFERRED,
+          &mask,
+          8 * sizeof(mask) + 1,
+          0);
+  }
+#else
+  (void) ptr;
+  (void) bytes;
+#endif // __linux__
+}
+
+static void
+prefault(void *ptr, size_t bytes)
+{
+  size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  volatile uint8_t *p = static_cast<uint8_t *>(ptr);
+
+#ifdef MADV_POPULATE_WRITE
+  if (madvise(ptr, bytes, MADV_POPULATE_WRITE) == 0)
+    return;
+#endif // MADV_POPULATE_WRITE
+
+  for (size_t i = 0; i < bytes; i += page)
+    p[i] = 0;
+}
+#endif // _WIN32
+
+Arena::Arena()
+{
+}
+
+Arena &
+Arena::instance()
+{
+  static Arena arena;
+
+  return arena;
+}
+
+size_t
+Arena::roundUp(size_t bytes) const
+{
+#ifdef _WIN32
+  return bytes;
+#else
+  size_t page = m_policy.hugePages != ARENA_HUGEPAGES_NONE
+      ? SIGDIGGER_ARENA_HUGEPAGE_SIZE
+      : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+  return (bytes + page - 1) / page * page;
+#endif // _WIN32
+}
+
+void *
+Arena::map(size_t bytes)
+{
+#ifdef _WIN32
+  (void) bytes;
+  return nullptr;
+#else
+  ArenaPolicy policy;
+  void *ptr = MAP_FAILED;
+  bool hugeTLB = false;
+
+  {
+    QMutexLocker locker(&m_mutex);
+    policy = m_policy;
+  }
+
+#ifdef MAP_HUGETLB
+  if (policy.hugePages == ARENA_HUGEPAGES_EXPLICIT) {
+    ptr = mmap(
+          nullptr,
+          bytes,
+          PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+          -1,
+          0);
+    hugeTLB = ptr != MAP_FAILED;
+  }
+#endif // MAP_HUGETLB
+
+  if (ptr == MAP_FAILED)
+    ptr = mmap(
+          nullptr,
+          bytes,
+          PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS,
+          -1,
+          0);
+
+  if (ptr == MAP_FAILED)
+    return nullptr;
+
+  // Placement must be decided before the first touch
+  applyPolicy(policy, ptr, bytes, hugeTLB);
+
+  if (policy.prefault)
+    prefault(ptr, bytes);
+
+  {
+    QMutexLocker locker(&m_mutex);
+
+    ++m_stats.mappings;
+    if (hugeTLB)
+      ++m_stats.hugeTLB;
+    else if (policy.hugePages == ARENA_HUGEPAGES_EXPLICIT)
+      ++m_stats.hugeTLBFails;
+  }
+
+  return ptr;
+#endif // _WIN32
+}
+
+void
+Arena::unmap(void *ptr, size_t bytes)
+{
+#ifdef _WIN32
+  (void) ptr;
+  (void) bytes;
+#else
+  (void) munmap(ptr, bytes);
+#endif // _WIN32
+}
+
+// Protected by mutex
+quint64
+Arena::trimUnlocked(size_t limit)
+{
+  quint64 released = 0;
+
+  while (m_stats.bytesCached > limit && !m_cache.empty()) {
+    // Drop the largest blocks first
+    auto last = std::prev(m_cache.end());
+
+    unmap(last->second, last->first);
+    m_stats.bytesCached -= last->first;
+    released            += last->first;
+    m_cache.erase(last);
+  }
+
+  return released;
+}
+
+void
+Arena::setPolicy(ArenaPolicy const &policy)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_policy = policy;
+
+  // Cached blocks were mapped under the old policy
+  trimUnlocked(0);
+}
+
+ArenaPolicy
+Arena::policy() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_policy;
+}
+
+void
+Arena::setCacheLimit(size_t bytes)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_cacheLimit = std::min(bytes, SIGDIGGER_ARENA_CACHE_LIMIT);
+
+  trimUnlocked(m_cacheLimit);
+}
+
+ArenaStats
+Arena::stats() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_stats;
+}
+
+void *
+Arena::allocate(size_t bytes)
+{
+  void *ptr = nullptr;
+  size_t size;
+
+  if (bytes == 0)
+    bytes = 1;
+
+  {
+    QMutexLocker locker(&m_mutex);
+
+    ++m_stats.allocations;
+
+#ifdef _WIN32
+    size = 0;
+#else
+    size = roundUp(bytes);
+
+    if (bytes >= SIGDIGGER_ARENA_LARGE_THRESHOLD) {
+      // Accept a cached block up to 25% larger than needed
+      auto it = m_cache.lower_bound(size);
+
+      if (it != m_cache.end() && it->first <= size + size / 4) {
+        ptr  = it->second;
+        size = it->first;
+
+        m_cache.erase(it);
+        m_blocks[ptr] = size;
+        m_stats.bytesCached -= size;
+        m_stats.bytesInUse  += size;
+        ++m_stats.reused;
+
+        return ptr;
+      }
+    }
+#endif // _WIN32
+  }
+
+  if (bytes < SIGDIGGER_ARENA_LARGE_THRESHOLD
+      || (ptr = map(size)) == nullptr)
+    return alignedAlloc(bytes);
+
+  QMutexLocker locker(&m_mutex);
+
+  m_blocks[ptr] = size;
+  m_stats.bytesInUse += size;
+
+  return ptr;
+}
+
+void
+Arena::release(void *ptr)
+{
+  size_t size;
+
+  if (ptr == nullptr)
+    return;
+
+  {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_blocks.find(ptr);
+
+    if (it != m_blocks.end()) {
+      size = it->second;
+
+      m_blocks.erase(it);
+      m_stats.bytesInUse -= size;
+
+      m_cache.insert(std::make_pair(size, ptr));
+      m_stats.bytesCached += size;
+
+      trimUnlocked(m_cacheLimit);
+      return;
+    }
+  }
+
+  alignedFree(ptr);
+}
+
+void
+Arena::trim()
+{
+  QMutexLocker locker(&m_mutex);
+
+  trimUnlocked(0);
+}
+
+void
+Arena::advise(void *ptr, size_t bytes) const
+{
+#ifdef _WIN32
+  (void) ptr;
+  (void) bytes;
+#else
+  applyPolicy(policy(), ptr, bytes, false);
+#endif // _WIN32
+}
+
+QString
+Arena::memoryConsumerName() const
+{
+  return "Buffer cache";
+}
+
+quint64
+Arena::residentBytes() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_stats.bytesCached;
+}
+
+quint64
+Arena::spill()
+{
+  QMutexLocker locker(&m_mutex);
+
+  return trimUnlocked(0);
+}
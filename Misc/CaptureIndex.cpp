@@ -0,0 +1,412 @@
+//
+//    CaptureIndex.cpp: Seek index of baseband recordings
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "CaptureIndex.h"
+#include <Suscan/Source.h>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace SigDigger;
+
+static_assert(sizeof(CaptureIndexHeader) == 64, "Unexpected header layout");
+static_assert(sizeof(CaptureIndexRecord) == 64, "Unexpected record layout");
+
+// FNV-1a over everything but the trailing checksum field
+static uint32_t
+captureIndexChecksum(const void *data, size_t size)
+{
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  uint32_t hash = 2166136261u;
+
+  for (size_t i = 0; i < size - sizeof(uint32_t); ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+static struct timeval
+captureIndexAddSeconds(struct timeval const &tv, qreal seconds)
+{
+  struct timeval delta, result;
+  qreal integral = std::floor(seconds);
+
+  delta.tv_sec  = static_cast<time_t>(integral);
+  delta.tv_usec = static_cast<suseconds_t>(
+        std::floor((seconds - integral) * 1e6));
+
+  timeradd(&tv, &delta, &result);
+
+  return result;
+}
+
+/////////////////////////////// CaptureIndexWriter /////////////////////////////
+CaptureIndexWriter::CaptureIndexWriter()
+{
+}
+
+CaptureIndexWriter::~CaptureIndexWriter()
+{
+  close();
+}
+
+bool
+CaptureIndexWriter::appendUnlocked(
+    CaptureIndexRecordType type,
+    quint64 sample,
+    struct timeval const &tv)
+{
+  CaptureIndexRecord record;
+
+  if (!m_file.isOpen())
+    return false;
+
+  memset(&record, 0, sizeof(CaptureIndexRecord));
+
+  record.type    = static_cast<uint32_t>(type);
+  record.sample  = sample;
+  record.tv_sec  = tv.tv_sec;
+  record.tv_usec = tv.tv_usec;
+  record.checksum = captureIndexChecksum(&record, sizeof(CaptureIndexRecord));
+
+  // Unbuffered: every record reaches the file in a single write
+  if (m_file.write(
+        reinterpret_cast<const char *>(&record),
+        sizeof(CaptureIndexRecord)) != sizeof(CaptureIndexRecord)) {
+    m_lastError = m_file.errorString().toStdString();
+    m_file.close();
+    return false;
+  }
+
+  return true;
+}
+
+bool
+CaptureIndexWriter::open(std::string const &path, qreal fs, SUFREQ freq)
+{
+  QMutexLocker locker(&m_mutex);
+  CaptureIndexHeader header;
+  struct timeval tv;
+
+  if (m_file.isOpen())
+    m_file.close();
+
+  m_file.setFileName(QString::fromStdString(path));
+
+  if (!m_file.open(
+        QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+    m_lastError = m_file.errorString().toStdString();
+    return false;
+  }
+
+  gettimeofday(&tv, nullptr);
+
+  m_fs        = fs;
+  m_written   = 0;
+  m_nextBlock = 0;
+  m_blockSize = std::max<SUSCOUNT>(
+        SIGDIGGER_CAPTURE_INDEX_MIN_BLOCK,
+        static_cast<SUSCOUNT>(fs * SIGDIGGER_CAPTURE_INDEX_BLOCK_TIME));
+
+  memset(&header, 0, sizeof(CaptureIndexHeader));
+  memcpy(header.magic, SIGDIGGER_CAPTURE_INDEX_MAGIC, sizeof(header.magic));
+  header.version    = SIGDIGGER_CAPTURE_INDEX_VERSION;
+  header.format     = SUSCAN_SOURCE_FORMAT_RAW_FLOAT32;
+  header.sampleRate = fs;
+  header.frequency  = freq;
+  header.tv_sec     = tv.tv_sec;
+  header.tv_usec    = tv.tv_usec;
+  header.blockSize  = m_blockSize;
+  header.checksum   = captureIndexChecksum(&header, sizeof(CaptureIndexHeader));
+
+  if (m_file.write(
+        reinterpret_cast<const char *>(&header),
+        sizeof(CaptureIndexHeader)) != sizeof(CaptureIndexHeader)) {
+    m_lastError = m_file.errorString().toStdString();
+    m_file.close();
+    return false;
+  }
+
+  return true;
+}
+
+void
+CaptureIndexWriter::close()
+{
+  QMutexLocker locker(&m_mutex);
+  struct timeval tv;
+
+  if (!m_file.isOpen())
+    return;
+
+  gettimeofday(&tv, nullptr);
+  appendUnlocked(CAPTURE_INDEX_RECORD_END, m_written, tv);
+
+  m_file.close();
+}
+
+void
+CaptureIndexWriter::feed(SUSCOUNT len)
+{
+  QMutexLocker locker(&m_mutex);
+  struct timeval now, tv;
+  quint64 end = m_written + len;
+
+  if (!m_file.isOpen())
+    return;
+
+  gettimeofday(&now, nullptr);
+
+  // The batch was received just now, block starts are backdated according
+  // to their position in it.
+  while (m_nextBlock < end) {
+    tv = captureIndexAddSeconds(
+          now,
+          -static_cast<qreal>(end - m_nextBlock) / m_fs);
+
+    if (!appendUnlocked(CAPTURE_INDEX_RECORD_BLOCK, m_nextBlock, tv))
+      return;
+
+    m_nextBlock += m_blockSize;
+  }
+
+  m_written = end;
+}
+
+std::string
+CaptureIndexWriter::getLastError() const
+{
+  return m_lastError;
+}
+
+////////////////////////////////// CaptureIndex ////////////////////////////////
+CaptureIndex::CaptureIndex()
+{
+  memset(&m_header, 0, sizeof(CaptureIndexHeader));
+}
+
+std::string
+CaptureIndex::pathFor(std::string const &dataPath)
+{
+  return dataPath + SIGDIGGER_CAPTURE_INDEX_SUFFIX;
+}
+
+bool
+CaptureIndex::guessMetadata(
+    std::string const &dataPath,
+    struct suscan_source_metadata &meta)
+{
+  CaptureIndex index;
+
+  if (!index.load(pathFor(dataPath)))
+    return false;
+
+  meta.guessed     = SUSCAN_SOURCE_CONFIG_GUESS_FORMAT
+      | SUSCAN_SOURCE_CONFIG_GUESS_SAMP_RATE
+      | SUSCAN_SOURCE_CONFIG_GUESS_FREQ
+      | SUSCAN_SOURCE_CONFIG_GUESS_START_TIME;
+  meta.format      = SUSCAN_SOURCE_FORMAT_RAW_FLOAT32;
+  meta.sample_rate = static_cast<unsigned>(index.sampleRate());
+  meta.frequency   = index.initialFrequency();
+  meta.start_time  = index.startTime();
+
+  return true;
+}
+
+bool
+CaptureIndex::load(std::string const &path)
+{
+  QFile file(QString::fromStdString(path));
+  QByteArray data;
+  const CaptureIndexRecord *records;
+  size_t count;
+
+  m_blocks.clear();
+  m_end      = 0;
+  m_complete = false;
+  m_loaded   = false;
+
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  data = file.readAll();
+
+  if (static_cast<size_t>(data.size()) < sizeof(CaptureIndexHeader))
+    return false;
+
+  memcpy(&m_header, data.constData(), sizeof(CaptureIndexHeader));
+
+  if (memcmp(m_header.magic, SIGDIGGER_CAPTURE_INDEX_MAGIC, 8) != 0
+      || m_header.version != SIGDIGGER_CAPTURE_INDEX_VERSION
+      || m_header.checksum
+         != captureIndexChecksum(&m_header, sizeof(CaptureIndexHeader))
+      || m_header.sampleRate <= 0
+      || m_header.blockSize == 0)
+    return false;
+
+  records = reinterpret_cast<const CaptureIndexRecord *>(
+        data.constData() + sizeof(CaptureIndexHeader));
+  count   = (static_cast<size_t>(data.size()) - sizeof(CaptureIndexHeader))
+      / sizeof(CaptureIndexRecord);
+
+  // Stop at the first torn or out-of-order record
+  for (size_t i = 0; i < count && !m_complete; ++i) {
+    CaptureIndexRecord record;
+    struct timeval tv;
+
+    memcpy(&record, records + i, sizeof(CaptureIndexRecord));
+
+    if (record.checksum
+        != captureIndexChecksum(&record, sizeof(CaptureIndexRecord)))
+      break;
+
+    tv.tv_sec  = static_cast<time_t>(record.tv_sec);
+    tv.tv_usec = static_cast<suseconds_t>(record.tv_usec);
+
+    if (record.type == CAPTURE_INDEX_RECORD_BLOCK) {
+      if (record.sample != m_blocks.size() * m_header.blockSize)
+        break;
+      m_blocks.push_back(tv);
+      m_end = record.sample;
+    } else if (record.type == CAPTURE_INDEX_RECORD_END) {
+      m_end = record.sample;
+      m_complete = true;
+    }
+  }
+
+  // No END record (the recording did not finish cleanly): the last block
+  // was started, but we do not know how much of it made it to the file.
+  // The data file tells, otherwise assume the block is whole.
+  if (!m_complete && !m_blocks.empty()) {
+    std::string dataPath = path;
+    size_t suffixLen = strlen(SIGDIGGER_CAPTURE_INDEX_SUFFIX);
+    QFileInfo info;
+
+    m_end += m_header.blockSize;
+
+    if (dataPath.size() > suffixLen
+        && dataPath.compare(
+          dataPath.size() - suffixLen,
+          suffixLen,
+          SIGDIGGER_CAPTURE_INDEX_SUFFIX) == 0) {
+      dataPath.resize(dataPath.size() - suffixLen);
+      info.setFile(QString::fromStdString(dataPath));
+
+      if (info.exists())
+        m_end = std::min<quint64>(
+              m_end,
+              static_cast<quint64>(info.size()) / sizeof(SUCOMPLEX));
+    }
+  }
+
+  if (m_blocks.empty()) {
+    struct timeval start;
+
+    start.tv_sec  = static_cast<time_t>(m_header.tv_sec);
+    start.tv_usec = static_cast<suseconds_t>(m_header.tv_usec);
+    m_blocks.push_back(start);
+  }
+
+  m_loaded = true;
+
+  return true;
+}
+
+bool
+CaptureIndex::isLoaded() const
+{
+  return m_loaded;
+}
+
+bool
+CaptureIndex::isComplete() const
+{
+  return m_complete;
+}
+
+qreal
+CaptureIndex::sampleRate() const
+{
+  return m_header.sampleRate;
+}
+
+SUFREQ
+CaptureIndex::initialFrequency() const
+{
+  return m_header.frequency;
+}
+
+struct timeval
+CaptureIndex::startTime() const
+{
+  return m_blocks.empty() ? timeval() : m_blocks.front();
+}
+
+struct timeval
+CaptureIndex::timeAt(quint64 sample) const
+{
+  size_t block;
+
+  if (m_blocks.empty())
+    return timeval();
+
+  sample = std::min(sample, m_end);
+  block  = std::min<size_t>(sample / m_header.blockSize, m_blocks.size() - 1);
+
+  return captureIndexAddSeconds(
+        m_blocks[block],
+        static_cast<qreal>(sample - block * m_header.blockSize)
+        / m_header.sampleRate);
+}
+
+quint64
+CaptureIndex::sampleAt(struct timeval const &tv) const
+{
+  struct timeval elapsed;
+  size_t block;
+  qreal offset;
+  quint64 sample;
+
+  if (m_blocks.empty() || !timercmp(&tv, &m_blocks.front(), >))
+    return 0;
+
+  // Last block starting at or before tv. Receive times only go backwards
+  // on clock adjustments, which we do not try to make sense of.
+  block = static_cast<size_t>(
+        std::upper_bound(
+          m_blocks.begin(),
+          m_blocks.end(),
+          tv,
+          [] (struct timeval const &a, struct timeval const &b) {
+            return timercmp(&a, &b, <);
+          }) - m_blocks.begin()) - 1;
+
+  timersub(&tv, &m_blocks[block], &elapsed);
+  offset = (elapsed.tv_sec + elapsed.tv_usec * 1e-6) * m_header.sampleRate;
+
+  // Samples are never placed past the start of the next block: anything
+  // in between was not received.
+  sample = block * m_header.blockSize + std::min<quint64>(
+        static_cast<quint64>(offset),
+        m_header.blockSize);
+
+  return std::min(sample, m_end);
+}
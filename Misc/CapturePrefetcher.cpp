@@ -0,0 +1,293 @@
+//
+//    CapturePrefetcher.cpp: Warm up the page cache around the playhead
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "CapturePrefetcher.h"
+#include <sigutils/types.h>
+#include <algorithm>
+
+#ifdef __linux__
+#  include <fcntl.h>
+#endif // __linux__
+
+using namespace SigDigger;
+
+//////////////////////////////// Reader thread /////////////////////////////////
+CapturePrefetchWorker::CapturePrefetchWorker(std::atomic<quint64> &generation) :
+  m_generation(generation)
+{
+}
+
+CapturePrefetchWorker::~CapturePrefetchWorker()
+{
+  onClose();
+}
+
+void
+CapturePrefetchWorker::onOpen(QString path)
+{
+  onClose();
+
+  m_file.setFileName(path);
+
+  if (!m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+    return;
+
+  m_size = m_file.size();
+
+#ifdef __linux__
+  // We jump around the file: the kernel's sequential heuristics only get
+  // in the way.
+  posix_fadvise(m_file.handle(), 0, 0, POSIX_FADV_RANDOM);
+#endif // __linux__
+}
+
+void
+CapturePrefetchWorker::onClose()
+{
+  if (m_file.isOpen())
+    m_file.close();
+
+  m_size        = 0;
+  m_cachedStart = 0;
+  m_cachedEnd   = 0;
+}
+
+bool
+CapturePrefetchWorker::fetch(quint64 generation, qint64 start, qint64 end)
+{
+  qint64 pos = start;
+
+  while (pos < end) {
+    qint64 len = std::min<qint64>(SIGDIGGER_PREFETCH_CHUNK_SIZE, end - pos);
+
+    if (m_generation.load() != generation)
+      return false;
+
+#ifdef __linux__
+    // Blocks until the chunk is in the page cache, without copying it
+    if (readahead(m_file.handle(), pos, static_cast<size_t>(len)) == -1)
+      return false;
+#else
+    if (m_scratch.size() < SIGDIGGER_PREFETCH_CHUNK_SIZE)
+      m_scratch.resize(SIGDIGGER_PREFETCH_CHUNK_SIZE);
+
+    if (!m_file.seek(pos) || m_file.read(m_scratch.data(), len) != len)
+      return false;
+#endif // __linux__
+
+    pos += len;
+  }
+
+  return true;
+}
+
+void
+CapturePrefetchWorker::onPrefetch(quint64 generation, qint64 start, qint64 end)
+{
+  qint64 center;
+
+  if (!m_file.isOpen() || m_generation.load() != generation)
+    return;
+
+  center = start + SCAST(qint64, (end - start) * SIGDIGGER_PREFETCH_BEHIND_FRACTION);
+  start  = std::max<qint64>(0, start);
+  end    = std::min<qint64>(m_size, end);
+  center = qBound(start, center, end);
+
+  if (end <= start)
+    return;
+
+#ifdef __linux__
+  // Cheap hint for the whole window first. Network filesystems may ignore
+  // it, which is why we also read it below.
+  posix_fadvise(m_file.handle(), start, end - start, POSIX_FADV_WILLNEED);
+#endif // __linux__
+
+  // Skip what is already known to be cached. Ahead of the playhead
+  // comes first, since that is what replay will need next.
+  if (m_cachedEnd > m_cachedStart
+      && m_cachedStart <= center && center < m_cachedEnd) {
+    if (!fetch(generation, m_cachedEnd, end))
+      return;
+    if (!fetch(generation, start, std::min(m_cachedStart, end)))
+      return;
+
+    m_cachedStart = std::min(m_cachedStart, start);
+    m_cachedEnd   = std::max(m_cachedEnd, end);
+
+    // Do not let the cached range grow past what the cache will hold
+    if (m_cachedEnd - m_cachedStart > 2 * (end - start)) {
+      m_cachedStart = start;
+      m_cachedEnd   = end;
+    }
+  } else {
+    if (!fetch(generation, center, end))
+      return;
+    if (!fetch(generation, start, center))
+      return;
+
+    m_cachedStart = start;
+    m_cachedEnd   = end;
+  }
+}
+
+////////////////////////////////// Front end ///////////////////////////////////
+CapturePrefetcher::CapturePrefetcher(QObject *parent) :
+  QObject(parent),
+  m_generation(0)
+{
+  m_start = {0, 0};
+  m_end   = {0, 0};
+
+  m_thread = new QThread(this);
+  m_worker = new CapturePrefetchWorker(m_generation);
+
+  m_worker->moveToThread(m_thread);
+
+  connect(
+        this,
+        SIGNAL(open(QString)),
+        m_worker,
+        SLOT(onOpen(QString)));
+
+  connect(
+        this,
+        SIGNAL(close()),
+        m_worker,
+        SLOT(onClose()));
+
+  connect(
+        this,
+        SIGNAL(prefetch(quint64, qint64, qint64)),
+        m_worker,
+        SLOT(onPrefetch(quint64, qint64, qint64)));
+
+  connect(
+        m_thread,
+        SIGNAL(finished()),
+        m_worker,
+        SLOT(deleteLater()));
+
+  m_thread->start(QThread::LowPriority);
+}
+
+CapturePrefetcher::~CapturePrefetcher()
+{
+  // Abandon whatever is in progress
+  ++m_generation;
+
+  m_thread->quit();
+  m_thread->wait();
+}
+
+bool
+CapturePrefetcher::setCapture(
+    std::string const &path,
+    struct timeval const &start,
+    struct timeval const &end)
+{
+  QFile file(QString::fromStdString(path));
+
+  clear();
+
+  if (!timercmp(&end, &start, >))
+    return false;
+
+  m_size = file.size();
+  if (m_size <= 0)
+    return false;
+
+  m_start = start;
+  m_end   = end;
+  m_open  = true;
+
+  emit open(QString::fromStdString(path));
+
+  return true;
+}
+
+void
+CapturePrefetcher::clear()
+{
+  if (m_open) {
+    ++m_generation;
+    m_open      = false;
+    m_lastStart = m_lastEnd = -1;
+    emit close();
+  }
+}
+
+bool
+CapturePrefetcher::isActive() const
+{
+  return m_open;
+}
+
+void
+CapturePrefetcher::setWindow(qint64 ms)
+{
+  m_windowMs  = std::max<qint64>(0, ms);
+  m_lastStart = m_lastEnd = -1;
+}
+
+qint64
+CapturePrefetcher::window() const
+{
+  return m_windowMs;
+}
+
+void
+CapturePrefetcher::setPlayhead(struct timeval const &tv, bool seek)
+{
+  struct timeval span, offset;
+  qreal spanMs, offsetMs, bytesPerMs;
+  qint64 window, center, start, end;
+
+  if (!m_open || m_windowMs == 0)
+    return;
+
+  timersub(&m_end, &m_start, &span);
+  timersub(&tv, &m_start, &offset);
+
+  spanMs     = span.tv_sec * 1e3 + span.tv_usec * 1e-3;
+  offsetMs   = offset.tv_sec * 1e3 + offset.tv_usec * 1e-3;
+  offsetMs   = qBound<qreal>(0, offsetMs, spanMs);
+
+  // Headers are small enough to pretend the samples span the whole file
+  bytesPerMs = m_size / spanMs;
+  window     = std::min<qint64>(
+        SCAST(qint64, m_windowMs * bytesPerMs),
+        SIGDIGGER_PREFETCH_MAX_WINDOW_BYTES);
+  center     = SCAST(qint64, offsetMs * bytesPerMs);
+
+  // Regular playback: nothing to do while at least half a window of the
+  // last request is still ahead of the playhead.
+  if (!seek
+      && m_lastEnd > m_lastStart
+      && center >= m_lastStart
+      && m_lastEnd - center > window / 2)
+    return;
+
+  start = center - SCAST(qint64, window * SIGDIGGER_PREFETCH_BEHIND_FRACTION);
+  end   = start + window;
+
+  m_lastStart = start;
+  m_lastEnd   = end;
+
+  emit prefetch(++m_generation, start, end);
+}
@@ -19,6 +19,13 @@
 
 #include "FileDataSaver.h"
 #include <unistd.h>
+#include <climits>
+
+#ifndef _WIN32
+#  include <sys/uio.h>
+#endif // _WIN32
+
+#define SIGDIGGER_FILEDATASAVER_MAX_IOVECS 1024
 
 using namespace SigDigger;
 
@@ -34,6 +41,7 @@ namespace SigDigger {
     bool canWrite(void) const;
     std::string getError(void) const;
     ssize_t write(const void *data, size_t len);
+    ssize_t writeChunks(const GenericDataChunk *chunks, size_t count);
     bool close(void);
     ~FileDataWriter();
   };
@@ -78,6 +86,35 @@ FileDataWriter::write(const void *data, size_t len)
   return result;
 }
 
+ssize_t
+FileDataWriter::writeChunks(const GenericDataChunk *chunks, size_t count)
+{
+#ifdef _WIN32
+  return GenericDataWriter::writeChunks(chunks, count);
+#else
+  struct iovec iov[SIGDIGGER_FILEDATASAVER_MAX_IOVECS];
+  ssize_t result;
+
+  if (this->fd == -1)
+    return 0;
+
+  if (count > SIGDIGGER_FILEDATASAVER_MAX_IOVECS)
+    count = SIGDIGGER_FILEDATASAVER_MAX_IOVECS;
+
+  for (size_t i = 0; i < count; ++i) {
+    iov[i].iov_base = const_cast<uint8_t *>(chunks[i].data);
+    iov[i].iov_len  = chunks[i].len;
+  }
+
+  result = ::writev(this->fd, iov, static_cast<int>(count));
+
+  if (result < 1)
+    lastError = "writev() failed: " + std::string(strerror(errno));
+
+  return result;
+#endif // _WIN32
+}
+
 bool
 FileDataWriter::close(void)
 {
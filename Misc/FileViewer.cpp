@@ -3,6 +3,7 @@
 #include <QMessageBox>
 #include <SigDiggerHelpers.h>
 #include <TimeWindow.h>
+#include <CaptureIndex.h>
 #include <QEventLoop>
 
 using namespace SigDigger;
@@ -45,7 +46,8 @@ FileViewer::processFile(QString path)
 
   config.setPath(path.toStdString());
 
-  if (!config.guessMetadata(meta)) {
+  if (!CaptureIndex::guessMetadata(path.toStdString(), meta)
+      && !config.guessMetadata(meta)) {
     QMessageBox::warning(
           nullptr,
           "Unrecognized file",
@@ -0,0 +1,249 @@
+//
+//    GainController.cpp: Closed-loop hardware gain control
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "GainController.h"
+#include <QMutexLocker>
+#include <cmath>
+
+using namespace SigDigger;
+
+#define GAIN_CONTROLLER_DB(x) (10. * std::log10(static_cast<qreal>(x) + 1e-20))
+
+//////////////////////////////// Baseband stats ////////////////////////////////
+qreal
+BasebandStats::clipRatio() const
+{
+  if (samples == 0)
+    return 0;
+
+  return static_cast<qreal>(clipped) / static_cast<qreal>(samples);
+}
+
+qreal
+BasebandStats::peakDb() const
+{
+  return GAIN_CONTROLLER_DB(peak);
+}
+
+qreal
+BasebandStats::rmsDb() const
+{
+  if (samples == 0)
+    return GAIN_CONTROLLER_DB(0);
+
+  return GAIN_CONTROLLER_DB(energy / static_cast<SUFLOAT>(samples));
+}
+
+qreal
+BasebandStats::crestDb() const
+{
+  return peakDb() - rmsDb();
+}
+
+qreal
+BasebandStats::floorDb() const
+{
+  return GAIN_CONTROLLER_DB(floor);
+}
+
+//////////////////////////////// Gain controller ///////////////////////////////
+GainController::GainController()
+{
+}
+
+void
+GainController::setParams(GainControllerParams const &params)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_params = params;
+}
+
+GainControllerParams const &
+GainController::params() const
+{
+  return m_params;
+}
+
+void
+GainController::feed(const SUCOMPLEX *samples, SUSCOUNT length)
+{
+  BasebandStats local;
+  SUFLOAT blockEnergy, blockFloor = 0;
+  SUSCOUNT blockLen;
+  bool haveFloor = false;
+
+  // This runs at the full baseband rate: one pass over the batch, and the
+  // lock is only held to load and merge the accumulated state.
+  m_mutex.lock();
+  blockEnergy = m_blockEnergy;
+  blockLen    = m_blockLen;
+  m_mutex.unlock();
+
+  for (SUSCOUNT i = 0; i < length; ++i) {
+    SUFLOAT re  = SU_C_REAL(samples[i]);
+    SUFLOAT im  = SU_C_IMAG(samples[i]);
+    SUFLOAT pwr = re * re + im * im;
+
+    if (std::fabs(re) >= SIGDIGGER_GAIN_CONTROLLER_CLIP_LEVEL
+        || std::fabs(im) >= SIGDIGGER_GAIN_CONTROLLER_CLIP_LEVEL)
+      ++local.clipped;
+
+    if (pwr > local.peak)
+      local.peak = pwr;
+
+    local.energy += pwr;
+    blockEnergy  += pwr;
+
+    if (++blockLen == SIGDIGGER_GAIN_CONTROLLER_FLOOR_BLOCK) {
+      SUFLOAT mean = blockEnergy / SIGDIGGER_GAIN_CONTROLLER_FLOOR_BLOCK;
+
+      if (!haveFloor || mean < blockFloor) {
+        blockFloor = mean;
+        haveFloor  = true;
+      }
+
+      blockEnergy = 0;
+      blockLen    = 0;
+    }
+  }
+
+  local.samples = length;
+
+  m_mutex.lock();
+  if (haveFloor && (m_acc.floor == 0 || blockFloor < m_acc.floor))
+    m_acc.floor = blockFloor;
+
+  m_acc.samples += local.samples;
+  m_acc.clipped += local.clipped;
+  m_acc.energy  += local.energy;
+  if (local.peak > m_acc.peak)
+    m_acc.peak = local.peak;
+
+  m_blockEnergy = blockEnergy;
+  m_blockLen    = blockLen;
+  m_mutex.unlock();
+}
+
+BasebandStats
+GainController::take()
+{
+  QMutexLocker locker(&m_mutex);
+  BasebandStats stats = m_acc;
+
+  m_acc = BasebandStats();
+
+  return stats;
+}
+
+qreal
+GainController::decide(BasebandStats const &stats)
+{
+  qreal correction = 0;
+  qreal peakDb;
+
+  if (stats.samples < m_params.minSamples)
+    return 0;
+
+  peakDb = stats.peakDb();
+
+  if (stats.clipRatio() > m_params.maxClipRatio) {
+    m_lastClip.start();
+
+    if (m_lastChange.isValid()
+        && m_lastChange.elapsed() < m_params.decreaseHoldMs)
+      return 0;
+
+    // Clipping hides the actual peak. Back off by a full step.
+    correction = -m_params.maxStepDb;
+  } else if (peakDb > m_params.targetPeakDb) {
+    if (m_lastChange.isValid()
+        && m_lastChange.elapsed() < m_params.decreaseHoldMs)
+      return 0;
+
+    correction = m_params.targetPeakDb - peakDb;
+  } else if (peakDb < m_params.targetPeakDb - m_params.hysteresisDb) {
+    if (m_lastChange.isValid()
+        && m_lastChange.elapsed() < m_params.increaseHoldMs)
+      return 0;
+
+    if (m_lastClip.isValid() && m_lastClip.elapsed() < m_params.clipHoldMs)
+      return 0;
+
+    correction = m_params.targetPeakDb - peakDb;
+
+    // Do not trade dynamic range for a noise floor near full scale
+    if (stats.floor > 0
+        && stats.floorDb() + correction > m_params.maxFloorDb)
+      correction = m_params.maxFloorDb - stats.floorDb();
+
+    if (correction <= 0)
+      return 0;
+  }
+
+  if (correction > m_params.maxStepDb)
+    correction = m_params.maxStepDb;
+  else if (correction < -m_params.maxStepDb)
+    correction = -m_params.maxStepDb;
+
+  return correction;
+}
+
+void
+GainController::holdOff()
+{
+  m_lastChange.start();
+}
+
+void
+GainController::reset()
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_acc         = BasebandStats();
+  m_blockEnergy = 0;
+  m_blockLen    = 0;
+
+  m_lastChange.invalidate();
+  m_lastClip.invalidate();
+}
+
+void
+GainController::recordEvent(
+    std::string const &name,
+    float value,
+    bool automatic)
+{
+  GainEvent event;
+
+  gettimeofday(&event.tv, nullptr);
+  event.name      = name;
+  event.value     = value;
+  event.automatic = automatic;
+
+  m_events.push_back(event);
+
+  if (m_events.size() > SIGDIGGER_GAIN_CONTROLLER_MAX_EVENTS)
+    m_events.pop_front();
+}
+
+std::vector<GainEvent>
+GainController::events() const
+{
+  return std::vector<GainEvent>(m_events.begin(), m_events.end());
+}
@@ -39,6 +39,35 @@ TEMPLATE_INSTANCE_FOR_WRITE_NO_MATTER_WHAT(uint8_t);
 TEMPLATE_INSTANCE_FOR_WRITE_NO_MATTER_WHAT(SUFLOAT);
 TEMPLATE_INSTANCE_FOR_WRITE_NO_MATTER_WHAT(SUCOMPLEX);
 
+ssize_t
+GenericDataWriter::writeChunks(const GenericDataChunk *chunks, size_t count)
+{
+  ssize_t total = 0;
+  ssize_t dumped;
+
+  for (size_t i = 0; i < count; ++i) {
+    dumped = this->write(
+          reinterpret_cast<const void *>(chunks[i].data),
+          chunks[i].len);
+
+    if (dumped < 1)
+      return total > 0 ? total : dumped;
+
+    total += dumped;
+
+    if (static_cast<size_t>(dumped) < chunks[i].len)
+      break;
+  }
+
+  return total;
+}
+
+size_t
+GenericDataWriter::maxChunkSize(void) const
+{
+  return 0;
+}
+
 GenericDataWriter::~GenericDataWriter()
 {
   // ?
@@ -67,25 +96,38 @@ GenericDataWorker::onCommit(void)
 {
   if (!this->writerPrepared) {
     // Silently ignore this buffer
+    QMutexLocker locker(&this->instance->dataMutex);
+    this->instance->chunks[1 - this->instance->buffer].clear();
     this->instance->bufferReady = true;
   } else if (!this->failed) {
     QMutexLocker locker(&this->instance->dataMutex);
     struct timeval tv, otv, sub;
     ssize_t dumped;
     size_t allocation = this->instance->allocation;
-    std::vector<uint8_t> *thisBuf =
-        &this->instance->buffers[1 - this->instance->buffer];
-    uint8_t *buffer = thisBuf->data();
-    int remaining = static_cast<int>(this->instance->commitedSize);
+    unsigned int committed = 1 - this->instance->buffer;
+    ArenaVector<uint8_t> *thisBuf = &this->instance->buffers[committed];
+    std::vector<GenericDataSaver::ChunkRef> *refs =
+        &this->instance->chunks[committed];
+    std::vector<GenericDataChunk> list;
+    GenericDataChunk *chunk;
+    size_t remaining;
 
     locker.unlock();
 
+    // Translate chunk offsets into a scatter/gather list
+    list.resize(refs->size());
+    for (size_t i = 0; i < refs->size(); ++i) {
+      list[i].data = thisBuf->data() + (*refs)[i].offset;
+      list[i].len  = (*refs)[i].len;
+    }
+
+    chunk     = list.data();
+    remaining = list.size();
+
     gettimeofday(&otv, nullptr);
 
     while (remaining > 0) {
-      dumped = this->instance->writer->write(
-            buffer,
-            static_cast<unsigned>(remaining));
+      dumped = this->instance->writer->writeChunks(chunk, remaining);
 
       if (dumped < 1) {
         this->failed = true;
@@ -93,12 +135,23 @@ GenericDataWorker::onCommit(void)
         return;
       }
 
-      remaining -= dumped;
-      buffer += dumped;
+      // Skip whatever was written, and adjust the first partial chunk
+      while (remaining > 0 && static_cast<size_t>(dumped) >= chunk->len) {
+        dumped -= chunk->len;
+        ++chunk;
+        --remaining;
+      }
+
+      if (remaining > 0) {
+        chunk->data += dumped;
+        chunk->len  -= static_cast<size_t>(dumped);
+      }
     }
 
     gettimeofday(&tv, nullptr);
 
+    refs->clear();
+
     // Requested allocation does not match buffer size.
     if (thisBuf->size() != allocation) {
       try {
@@ -110,7 +163,10 @@ GenericDataWorker::onCommit(void)
       }
     }
 
+    locker.relock();
     this->instance->bufferReady = true;
+    locker.unlock();
+
     timersub(&tv, &otv, &sub);
 
     emit writeFinished(static_cast<quint64>(
@@ -123,8 +179,27 @@ GenericDataSaver::GenericDataSaver(
     QObject *parent) : QObject(parent), workerObject(this)
 {
   this->writer = writer;
+  this->maxChunk = writer->maxChunkSize();
   this->setSampleRate(1000000);
 
+  gettimeofday(&this->lastCommit, nullptr);
+  this->firstPending = this->lastCommit;
+
+  this->flushTimer.setSingleShot(true);
+  this->flushTimer.setTimerType(Qt::PreciseTimer);
+
+  QObject::connect(
+        this,
+        SIGNAL(armFlush()),
+        this,
+        SLOT(onArmFlush()));
+
+  QObject::connect(
+        &this->flushTimer,
+        SIGNAL(timeout()),
+        this,
+        SLOT(onFlushTimeout()));
+
   QObject::connect(
         this,
         SIGNAL(prepare()),
@@ -199,6 +274,84 @@ GenericDataSaver::doCommit(void)
   }
 }
 
+// Protected by mutex
+void
+GenericDataSaver::pushChunk(size_t offset, size_t len)
+{
+  std::vector<ChunkRef> &list = this->chunks[this->buffer];
+
+  // Contiguous producer chunks are merged as long as the writer allows it
+  if (!list.empty()) {
+    ChunkRef &last = list.back();
+
+    if (last.offset + last.len == offset) {
+      size_t room = this->maxChunk == 0 ? len : this->maxChunk - last.len;
+      if (room > len)
+        room = len;
+
+      last.len += room;
+      offset   += room;
+      len      -= room;
+    }
+  }
+
+  while (len > 0) {
+    size_t piece = this->maxChunk == 0 || len < this->maxChunk
+        ? len
+        : this->maxChunk;
+
+    list.push_back(ChunkRef {offset, piece});
+    offset += piece;
+    len    -= piece;
+  }
+}
+
+// Protected by mutex
+quint64
+GenericDataSaver::pendingAge(void) const
+{
+  struct timeval tv, sub;
+
+  gettimeofday(&tv, nullptr);
+  timersub(&tv, &this->firstPending, &sub);
+
+  return static_cast<quint64>(sub.tv_usec + sub.tv_sec * 1000000l);
+}
+
+// Protected by mutex
+bool
+GenericDataSaver::latencyExceeded(void) const
+{
+  if (this->flushPolicy != FLUSH_LATENCY || this->ptr == 0)
+    return false;
+
+  return this->pendingAge() >= this->maxLatency;
+}
+
+// Protected by mutex
+void
+GenericDataSaver::scheduleFlush(void)
+{
+  quint64 age, remaining;
+
+  if (this->flushPolicy != FLUSH_LATENCY || this->ptr == 0)
+    return;
+
+  age = this->pendingAge();
+  remaining = age < this->maxLatency ? this->maxLatency - age : 0;
+
+  this->flushTimer.start(static_cast<int>(qMax<quint64>(1, remaining / 1000)));
+}
+
+void
+GenericDataSaver::setFlushPolicy(FlushPolicy policy, quint64 maxLatencyUsec)
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  this->flushPolicy = policy;
+  this->maxLatency  = maxLatencyUsec;
+}
+
 void
 GenericDataSaver::setSampleRate(unsigned int rate)
 {
@@ -223,40 +376,62 @@ GenericDataSaver::setBufferSize(unsigned int size)
   this->buffers[1].resize(size);
 }
 
-template<typename T> void
+template<typename T> bool
 GenericDataSaver::write(const T *data, size_t size)
 {
   if (this->writer->canWrite()) {
     QMutexLocker locker(&this->dataMutex);
     size_t totalBytes = this->buffers[this->buffer].size();
     size_t avail = (totalBytes - this->ptr) / sizeof(T);
+    bool wasEmpty = this->ptr == 0;
+    bool arm;
 
     this->dataWritten = true;
 
     if (size > avail) {
       emit swamped();
-      return;
+      return false;
     }
 
+    // First chunk after a commit: this is the one that ages
+    if (wasEmpty)
+      gettimeofday(&this->firstPending, nullptr);
+
     // Copy data
     memcpy(
       this->buffers[this->buffer].data() + this->ptr,
       data,
       size * sizeof(T));
 
+    this->pushChunk(this->ptr, size * sizeof(T));
     this->ptr += size * sizeof(T);
 
-    if (this->ptr > totalBytes / 2) {
-      // Buffer starts to get filled up, issue commit request
+    if (this->ptr > totalBytes / 2 || this->latencyExceeded()) {
+      // Buffer starts to get filled up (or data has been waiting for too
+      // long), issue commit request
       this->doCommit();
     }
+
+    // If no more data arrives, pending data must still leave in time.
+    // The timer is armed once per batch, and keeps itself running until
+    // the batch is committed. The slot may be called directly: do not
+    // hold the lock while signalling.
+    arm = this->flushPolicy == FLUSH_LATENCY && wasEmpty && this->ptr > 0;
+    locker.unlock();
+
+    if (arm)
+      emit armFlush();
+
+    return true;
   }
+
+  return false;
 }
 
 // Explicit instantiation of these ones
-template void GenericDataSaver::write<SUCOMPLEX>(const SUCOMPLEX *, size_t);
-template void GenericDataSaver::write<SUFLOAT>(const SUFLOAT *, size_t);
-template void GenericDataSaver::write<uint8_t>(const uint8_t *, size_t);
+template bool GenericDataSaver::write<SUCOMPLEX>(const SUCOMPLEX *, size_t);
+template bool GenericDataSaver::write<SUFLOAT>(const SUFLOAT *, size_t);
+template bool GenericDataSaver::write<uint8_t>(const uint8_t *, size_t);
 
 quint64
 GenericDataSaver::getSize(void) const
@@ -300,3 +475,25 @@ GenericDataSaver::onPrepared(void)
 {
   emit ready();
 }
+
+void
+GenericDataSaver::onArmFlush(void)
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  if (!this->flushTimer.isActive())
+    this->scheduleFlush();
+}
+
+void
+GenericDataSaver::onFlushTimeout(void)
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  if (this->latencyExceeded())
+    this->doCommit();
+
+  // Either too young, or the worker was still busy with the other
+  // buffer (so nothing was flipped). Check again later.
+  this->scheduleFlush();
+}
@@ -0,0 +1,58 @@
+//
+//    LazyWidget.cpp: Widgets built on first use
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "LazyWidget.h"
+
+using namespace SigDigger;
+
+unsigned int LazyWidgetStats::declared      = 0;
+unsigned int LazyWidgetStats::materialized  = 0;
+qint64       LazyWidgetStats::materializeNs = 0;
+
+LazyWidgetBase::LazyWidgetBase()
+{
+  instances().push_back(this);
+}
+
+LazyWidgetBase::~LazyWidgetBase()
+{
+  instances().remove(this);
+}
+
+std::list<LazyWidgetBase *> &
+LazyWidgetBase::instances()
+{
+  static std::list<LazyWidgetBase *> list;
+
+  return list;
+}
+
+unsigned int
+LazyWidgetBase::materializeAll()
+{
+  // Work on a copy: building a widget may declare further lazy widgets,
+  // which are left alone
+  std::list<LazyWidgetBase *> pending = instances();
+  unsigned int count = 0;
+
+  for (auto p : pending)
+    if (p->materialize())
+      ++count;
+
+  return count;
+}
@@ -0,0 +1,337 @@
+//
+//    MeasureIndex.cpp: Fast selection measures over a capture
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include <MeasureIndex.h>
+#include <cmath>
+
+using namespace SigDigger;
+
+void
+MeasureIndex::Extrema::merge(Extrema const &other)
+{
+  if (other.minI < minI)
+    minI = other.minI;
+  if (other.maxI > maxI)
+    maxI = other.maxI;
+  if (other.minQ < minQ)
+    minQ = other.minQ;
+  if (other.maxQ > maxQ)
+    maxQ = other.maxQ;
+  if (other.peak > peak)
+    peak = other.peak;
+}
+
+void
+MeasureIndex::Extrema::add(SUCOMPLEX x)
+{
+  SUFLOAT i = SU_C_REAL(x);
+  SUFLOAT q = SU_C_IMAG(x);
+  SUFLOAT e = i * i + q * q;
+
+  if (i < minI)
+    minI = i;
+  if (i > maxI)
+    maxI = i;
+  if (q < minQ)
+    minQ = q;
+  if (q > maxQ)
+    maxQ = q;
+  if (e > peak)
+    peak = e;
+}
+
+MeasureIndex::MeasureIndex()
+{
+  clear();
+}
+
+SUSCOUNT
+MeasureIndex::blocks() const
+{
+  return m_levels.empty() ? 0 : m_levels[0].size();
+}
+
+void
+MeasureIndex::clear()
+{
+  m_data = nullptr;
+  m_size = 0;
+
+  m_sumI.assign(1, 0.);
+  m_sumQ.assign(1, 0.);
+  m_sumE.assign(1, 0.);
+  m_levels.clear();
+}
+
+void
+MeasureIndex::rebuild(const SUCOMPLEX *data, SUSCOUNT size)
+{
+  clear();
+  extend(data, size);
+}
+
+const SUCOMPLEX *
+MeasureIndex::data() const
+{
+  return m_data;
+}
+
+SUSCOUNT
+MeasureIndex::size() const
+{
+  return m_size;
+}
+
+quint64
+MeasureIndex::memoryBytes() const
+{
+  quint64 bytes = (m_sumI.capacity() + m_sumQ.capacity() + m_sumE.capacity())
+      * sizeof(double);
+
+  for (auto const &level : m_levels)
+    bytes += level.capacity() * sizeof(Extrema);
+
+  return bytes;
+}
+
+void
+MeasureIndex::extend(const SUCOMPLEX *data, SUSCOUNT size)
+{
+  SUSCOUNT first, count;
+
+  if (data == nullptr)
+    size = 0;
+
+  if (m_data != nullptr && (data != m_data || size < m_size)) {
+    rebuild(data, size);
+    return;
+  }
+
+  first  = blocks();
+  count  = size / SIGDIGGER_MEASURE_INDEX_BLOCK;
+  m_data = data;
+  m_size = size;
+
+  if (count == first)
+    return;
+
+  if (m_levels.empty())
+    m_levels.resize(1);
+
+  m_levels[0].reserve(count);
+  m_sumI.reserve(count + 1);
+  m_sumQ.reserve(count + 1);
+  m_sumE.reserve(count + 1);
+
+  for (SUSCOUNT b = first; b < count; ++b) {
+    const SUCOMPLEX *p = data + b * SIGDIGGER_MEASURE_INDEX_BLOCK;
+    Extrema ext;
+    double sumI = 0, sumQ = 0, sumE = 0;
+
+    ext.minI = ext.maxI = SU_C_REAL(p[0]);
+    ext.minQ = ext.maxQ = SU_C_IMAG(p[0]);
+    ext.peak = 0;
+
+    for (unsigned int i = 0; i < SIGDIGGER_MEASURE_INDEX_BLOCK; ++i) {
+      SUFLOAT re = SU_C_REAL(p[i]);
+      SUFLOAT im = SU_C_IMAG(p[i]);
+
+      sumI += re;
+      sumQ += im;
+      sumE += re * re + im * im;
+      ext.add(p[i]);
+    }
+
+    m_sumI.push_back(m_sumI.back() + sumI);
+    m_sumQ.push_back(m_sumQ.back() + sumQ);
+    m_sumE.push_back(m_sumE.back() + sumE);
+    m_levels[0].push_back(ext);
+  }
+
+  updateLevels(first);
+}
+
+// Recompute every node above the blocks starting at firstBlock
+void
+MeasureIndex::updateLevels(SUSCOUNT firstBlock)
+{
+  SUSCOUNT from = firstBlock;
+
+  for (size_t k = 1; m_levels[k - 1].size() > 1; ++k) {
+    std::vector<Extrema> const *below;
+    SUSCOUNT count;
+
+    if (m_levels.size() == k)
+      m_levels.resize(k + 1);
+
+    below = &m_levels[k - 1];
+    count = (below->size() + 1) / 2;
+    from /= 2;
+
+    m_levels[k].resize(count);
+
+    for (SUSCOUNT i = from; i < count; ++i) {
+      Extrema ext = (*below)[2 * i];
+
+      if (2 * i + 1 < below->size())
+        ext.merge((*below)[2 * i + 1]);
+
+      m_levels[k][i] = ext;
+    }
+  }
+}
+
+void
+MeasureIndex::scan(
+    SUSCOUNT start,
+    SUSCOUNT end,
+    double &sumI,
+    double &sumQ,
+    double &sumE,
+    Extrema &ext,
+    bool &haveExt) const
+{
+  for (SUSCOUNT i = start; i < end; ++i) {
+    SUFLOAT re = SU_C_REAL(m_data[i]);
+    SUFLOAT im = SU_C_IMAG(m_data[i]);
+
+    sumI += re;
+    sumQ += im;
+    sumE += re * re + im * im;
+
+    if (!haveExt) {
+      ext.minI = ext.maxI = re;
+      ext.minQ = ext.maxQ = im;
+      ext.peak = 0;
+      haveExt  = true;
+    }
+
+    ext.add(m_data[i]);
+  }
+}
+
+// Extrema of blocks [first, last), bottom-up over the levels
+void
+MeasureIndex::blockExtrema(
+    SUSCOUNT first,
+    SUSCOUNT last,
+    Extrema &ext,
+    bool &haveExt) const
+{
+  for (size_t k = 0; first < last; ++k) {
+    std::vector<Extrema> const &level = m_levels[k];
+
+    if (first & 1) {
+      if (haveExt)
+        ext.merge(level[first]);
+      else
+        ext = level[first];
+      haveExt = true;
+      ++first;
+    }
+
+    if (last & 1) {
+      --last;
+      if (haveExt)
+        ext.merge(level[last]);
+      else
+        ext = level[last];
+      haveExt = true;
+    }
+
+    first /= 2;
+    last  /= 2;
+  }
+}
+
+bool
+MeasureIndex::measure(
+    SUSCOUNT start,
+    SUSCOUNT end,
+    SelectionMeasures &result) const
+{
+  double sumI = 0, sumQ = 0, sumE = 0;
+  double meanI, meanQ, meanE, variance;
+  SUSCOUNT firstBlock, lastBlock;
+  Extrema ext;
+  bool haveExt = false;
+
+  if (end > m_size)
+    end = m_size;
+
+  if (start >= end || m_data == nullptr)
+    return false;
+
+  // Complete blocks inside the range
+  firstBlock =
+      (start + SIGDIGGER_MEASURE_INDEX_BLOCK - 1)
+      / SIGDIGGER_MEASURE_INDEX_BLOCK;
+  lastBlock  = end / SIGDIGGER_MEASURE_INDEX_BLOCK;
+
+  if (lastBlock > blocks())
+    lastBlock = blocks();
+
+  if (firstBlock >= lastBlock) {
+    scan(start, end, sumI, sumQ, sumE, ext, haveExt);
+  } else {
+    scan(
+          start,
+          firstBlock * SIGDIGGER_MEASURE_INDEX_BLOCK,
+          sumI,
+          sumQ,
+          sumE,
+          ext,
+          haveExt);
+
+    sumI += m_sumI[lastBlock] - m_sumI[firstBlock];
+    sumQ += m_sumQ[lastBlock] - m_sumQ[firstBlock];
+    sumE += m_sumE[lastBlock] - m_sumE[firstBlock];
+    blockExtrema(firstBlock, lastBlock, ext, haveExt);
+
+    scan(
+          lastBlock * SIGDIGGER_MEASURE_INDEX_BLOCK,
+          end,
+          sumI,
+          sumQ,
+          sumE,
+          ext,
+          haveExt);
+  }
+
+  meanI = sumI / (end - start);
+  meanQ = sumQ / (end - start);
+  meanE = sumE / (end - start);
+
+  // Rounding may take it slightly below zero on constant signals
+  variance = meanE - (meanI * meanI + meanQ * meanQ);
+  if (variance < 0)
+    variance = 0;
+
+  result.length   = end - start;
+  result.min      = SUCOMPLEX(ext.minI, ext.minQ);
+  result.max      = SUCOMPLEX(ext.maxI, ext.maxQ);
+  result.mean     = SUCOMPLEX(
+        static_cast<SUFLOAT>(meanI),
+        static_cast<SUFLOAT>(meanQ));
+  result.energy   = static_cast<SUFLOAT>(sumE);
+  result.rms      = static_cast<SUFLOAT>(std::sqrt(meanE));
+  result.peak     = std::sqrt(ext.peak);
+  result.variance = static_cast<SUFLOAT>(variance);
+
+  return true;
+}
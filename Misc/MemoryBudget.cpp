@@ -0,0 +1,195 @@
+//
+//    MemoryBudget.cpp: Keep large sample buffers within a memory budget
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "MemoryBudget.h"
+#include <algorithm>
+
+using namespace SigDigger;
+
+MemoryBudget *MemoryBudget::m_instance = nullptr;
+
+////////////////////////////// MemoryConsumer //////////////////////////////////
+MemoryConsumer::~MemoryConsumer()
+{
+}
+
+quint64
+MemoryConsumer::spilledBytes() const
+{
+  return 0;
+}
+
+quint64
+MemoryConsumer::spill()
+{
+  return 0;
+}
+
+/////////////////////////////// MemoryBudget ////////////////////////////////////
+MemoryBudget::MemoryBudget()
+{
+  m_notifyTimer.setSingleShot(true);
+  m_notifyTimer.setInterval(SIGDIGGER_MEMORY_BUDGET_NOTIFY_MS);
+
+  connect(
+        &m_notifyTimer,
+        SIGNAL(timeout()),
+        this,
+        SIGNAL(usageChanged()));
+}
+
+MemoryBudget *
+MemoryBudget::instance()
+{
+  if (m_instance == nullptr)
+    m_instance = new MemoryBudget();
+
+  return m_instance;
+}
+
+void
+MemoryBudget::scheduleNotify()
+{
+  if (!m_notifyTimer.isActive())
+    m_notifyTimer.start();
+}
+
+void
+MemoryBudget::enforce()
+{
+  quint64 total;
+
+  // Spilling may end up calling touch() again
+  if (m_enforcing || m_budget == SIGDIGGER_MEMORY_BUDGET_UNLIMITED)
+    return;
+
+  total = resident();
+  if (total <= m_budget)
+    return;
+
+  m_enforcing = true;
+
+  // Coldest first. The consumer that was just touched comes last: if it
+  // alone exceeds the budget, it has to go to disk too.
+  for (auto it = m_consumers.rbegin();
+       it != m_consumers.rend() && total > m_budget;
+       ++it) {
+    quint64 released = (*it)->spill();
+
+    if (released > 0) {
+      total -= std::min(total, released);
+      ++m_spills;
+    }
+  }
+
+  m_enforcing = false;
+}
+
+void
+MemoryBudget::setBudget(quint64 bytes)
+{
+  if (m_budget != bytes) {
+    m_budget = bytes;
+    enforce();
+    scheduleNotify();
+  }
+}
+
+quint64
+MemoryBudget::budget() const
+{
+  return m_budget;
+}
+
+void
+MemoryBudget::add(MemoryConsumer *consumer)
+{
+  if (std::find(m_consumers.begin(), m_consumers.end(), consumer)
+      == m_consumers.end())
+    m_consumers.push_front(consumer);
+
+  scheduleNotify();
+}
+
+void
+MemoryBudget::remove(MemoryConsumer *consumer)
+{
+  m_consumers.remove(consumer);
+  scheduleNotify();
+}
+
+void
+MemoryBudget::touch(MemoryConsumer *consumer)
+{
+  auto it = std::find(m_consumers.begin(), m_consumers.end(), consumer);
+
+  if (it == m_consumers.end())
+    return;
+
+  if (it != m_consumers.begin())
+    m_consumers.splice(m_consumers.begin(), m_consumers, it);
+
+  enforce();
+  scheduleNotify();
+}
+
+quint64
+MemoryBudget::resident() const
+{
+  quint64 total = 0;
+
+  for (auto p : m_consumers)
+    total += p->residentBytes();
+
+  return total;
+}
+
+quint64
+MemoryBudget::spilled() const
+{
+  quint64 total = 0;
+
+  for (auto p : m_consumers)
+    total += p->spilledBytes();
+
+  return total;
+}
+
+quint64
+MemoryBudget::spills() const
+{
+  return m_spills;
+}
+
+std::vector<MemoryConsumerUsage>
+MemoryBudget::usage() const
+{
+  std::vector<MemoryConsumerUsage> result;
+
+  for (auto p : m_consumers) {
+    MemoryConsumerUsage entry;
+
+    entry.name     = p->memoryConsumerName();
+    entry.resident = p->residentBytes();
+    entry.spilled  = p->spilledBytes();
+
+    result.push_back(entry);
+  }
+
+  return result;
+}
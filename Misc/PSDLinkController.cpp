@@ -0,0 +1,216 @@
+//
+//    PSDLinkController.cpp: Adapt spectrum rate and size to the link
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "PSDLinkController.h"
+#include <algorithm>
+
+using namespace SigDigger;
+
+PSDLinkController::PSDLinkController()
+{
+}
+
+void
+PSDLinkController::reset(PSDLinkSettings const &requested)
+{
+  m_requested    = requested;
+  m_steps.clear();
+
+  m_haveBaseline = false;
+  m_baseline     = 0;
+  m_latency      = 0;
+  m_frames       = 0;
+  m_bytes        = 0;
+  m_stats        = PSDLinkStats();
+  m_haveStats    = false;
+
+  m_window.invalidate();
+  m_lastChange.invalidate();
+  m_healthySince.invalidate();
+}
+
+void
+PSDLinkController::setTarget(qreal ms)
+{
+  m_targetMs = ms;
+}
+
+qreal
+PSDLinkController::target() const
+{
+  return m_targetMs;
+}
+
+bool
+PSDLinkController::feed(struct timeval const &sent, SUSCOUNT bins)
+{
+  struct timeval now, diff;
+  qreal delay;
+
+  gettimeofday(&now, nullptr);
+  timersub(&now, &sent, &diff);
+
+  delay = diff.tv_sec + diff.tv_usec * 1e-6;
+
+  if (!m_haveBaseline || delay < m_baseline) {
+    m_baseline     = delay;
+    m_haveBaseline = true;
+  }
+
+  SU_SPLPF_FEED(
+        m_latency,
+        (delay - m_baseline) * 1e3,
+        SIGDIGGER_PSD_LINK_LATENCY_ALPHA);
+
+  ++m_frames;
+  m_bytes += bins * sizeof(SUFLOAT);
+
+  if (!m_window.isValid()) {
+    m_window.start();
+    return false;
+  }
+
+  if (m_window.elapsed() < SIGDIGGER_PSD_LINK_MEASURE_MS)
+    return false;
+
+  // Close the measurement window
+  qreal seconds = m_window.restart() * 1e-3;
+
+  m_stats.latencyMs  = m_latency;
+  m_stats.frameRate  = m_frames / seconds;
+  m_stats.throughput = m_bytes / seconds;
+  m_haveStats        = true;
+
+  m_frames = 0;
+  m_bytes  = 0;
+
+  return true;
+}
+
+PSDLinkSettings
+PSDLinkController::degrade(PSDLinkSettings const &settings) const
+{
+  PSDLinkSettings next = settings;
+  unsigned int comfortRate = std::max<unsigned int>(
+        SIGDIGGER_PSD_LINK_MIN_RATE,
+        m_requested.rate / 4);
+
+  // Fewer spectra first, then smaller ones, then even fewer.
+  if (settings.rate > comfortRate)
+    next.rate = std::max(comfortRate, (settings.rate + 1) / 2);
+  else if (settings.fftSize / 2 >= SIGDIGGER_PSD_LINK_MIN_FFT_SIZE)
+    next.fftSize = settings.fftSize / 2;
+  else if (settings.rate > SIGDIGGER_PSD_LINK_MIN_RATE)
+    next.rate = std::max<unsigned int>(
+          SIGDIGGER_PSD_LINK_MIN_RATE,
+          settings.rate / 2);
+
+  return next;
+}
+
+bool
+PSDLinkController::decide(PSDLinkSettings &next)
+{
+  PSDLinkSettings curr = current();
+  bool congested, healthy;
+
+  if (!m_haveStats || curr.rate == 0)
+    return false;
+
+  congested = m_stats.latencyMs > m_targetMs
+      || m_stats.frameRate < .8 * curr.rate;
+  healthy   = m_stats.latencyMs < .5 * m_targetMs
+      && m_stats.frameRate >= .95 * curr.rate;
+
+  if (congested) {
+    m_healthySince.invalidate();
+
+    // Give the server time to apply the previous step and the queues
+    // time to drain before judging it.
+    if (m_lastChange.isValid()
+        && m_lastChange.elapsed() < SIGDIGGER_PSD_LINK_DEGRADE_HOLD_MS)
+      return false;
+
+    next = degrade(curr);
+    if (next == curr)
+      return false;
+
+    m_steps.push_back(next);
+    m_lastChange.start();
+    return true;
+  }
+
+  if (!healthy) {
+    m_healthySince.invalidate();
+    return false;
+  }
+
+  if (!m_healthySince.isValid())
+    m_healthySince.start();
+
+  if (m_steps.empty()
+      || m_healthySince.elapsed() < SIGDIGGER_PSD_LINK_RECOVER_HOLD_MS
+      || (m_lastChange.isValid()
+          && m_lastChange.elapsed() < SIGDIGGER_PSD_LINK_RECOVER_HOLD_MS))
+    return false;
+
+  m_steps.pop_back();
+  next = current();
+
+  // The link has to prove itself again at the new settings
+  m_healthySince.invalidate();
+  m_lastChange.start();
+
+  return true;
+}
+
+PSDLinkSettings
+PSDLinkController::requested() const
+{
+  return m_requested;
+}
+
+PSDLinkSettings
+PSDLinkController::current() const
+{
+  return m_steps.empty() ? m_requested : m_steps.back();
+}
+
+unsigned int
+PSDLinkController::level() const
+{
+  return static_cast<unsigned int>(m_steps.size());
+}
+
+bool
+PSDLinkController::isAdapted() const
+{
+  return !m_steps.empty();
+}
+
+bool
+PSDLinkController::haveStats() const
+{
+  return m_haveStats;
+}
+
+PSDLinkStats const &
+PSDLinkController::stats() const
+{
+  return m_stats;
+}
@@ -0,0 +1,245 @@
+//
+//    PowerOverview.cpp: Coarse power overview of a capture file
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "PowerOverview.h"
+#include <QFile>
+#include <QMutexLocker>
+#include <cstring>
+
+using namespace SigDigger;
+
+PowerOverview::PowerOverview()
+{
+}
+
+std::string
+PowerOverview::pathFor(std::string const &dataPath)
+{
+  return dataPath + SIGDIGGER_POWER_OVERVIEW_SUFFIX;
+}
+
+void
+PowerOverview::reset(size_t buckets, quint64 samples)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_buckets.assign(buckets, PowerOverviewBucket());
+  m_spectra.assign(buckets * SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS, -200);
+  m_samples  = samples;
+  m_filled   = 0;
+  m_complete = false;
+}
+
+void
+PowerOverview::clear()
+{
+  reset(0, 0);
+}
+
+void
+PowerOverview::setBucket(
+    size_t index,
+    PowerOverviewBucket const &bucket,
+    const float *spectrum)
+{
+  QMutexLocker locker(&m_mutex);
+
+  if (index >= m_buckets.size())
+    return;
+
+  m_buckets[index] = bucket;
+
+  if (spectrum != nullptr)
+    std::memcpy(
+          m_spectra.data() + index * SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS,
+          spectrum,
+          SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS * sizeof(float));
+
+  if (index + 1 > m_filled)
+    m_filled = index + 1;
+}
+
+void
+PowerOverview::setComplete()
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_filled   = m_buckets.size();
+  m_complete = true;
+}
+
+size_t
+PowerOverview::size() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_buckets.size();
+}
+
+size_t
+PowerOverview::filled() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_filled;
+}
+
+quint64
+PowerOverview::samples() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_samples;
+}
+
+bool
+PowerOverview::isComplete() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_complete;
+}
+
+bool
+PowerOverview::bucket(size_t index, PowerOverviewBucket &bucket) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  if (index >= m_filled)
+    return false;
+
+  bucket = m_buckets[index];
+
+  return true;
+}
+
+bool
+PowerOverview::spectrum(size_t index, std::vector<float> &spectrum) const
+{
+  QMutexLocker locker(&m_mutex);
+  const float *start;
+
+  if (index >= m_filled)
+    return false;
+
+  start = m_spectra.data() + index * SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS;
+  spectrum.assign(start, start + SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS);
+
+  return true;
+}
+
+bool
+PowerOverview::save(
+    std::string const &path,
+    quint64 dataSize,
+    qint64 dataMtime) const
+{
+  QMutexLocker locker(&m_mutex);
+  PowerOverviewHeader header;
+  QFile file(QString::fromStdString(path));
+  qint64 bucketBytes, spectraBytes;
+
+  if (!m_complete)
+    return false;
+
+  std::memset(&header, 0, sizeof(PowerOverviewHeader));
+  std::memcpy(header.magic, SIGDIGGER_POWER_OVERVIEW_MAGIC, 8);
+  header.version   = SIGDIGGER_POWER_OVERVIEW_VERSION;
+  header.buckets   = static_cast<uint32_t>(m_buckets.size());
+  header.bins      = SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS;
+  header.samples   = m_samples;
+  header.dataSize  = dataSize;
+  header.dataMtime = dataMtime;
+
+  bucketBytes  = static_cast<qint64>(
+        m_buckets.size() * sizeof(PowerOverviewBucket));
+  spectraBytes = static_cast<qint64>(m_spectra.size() * sizeof(float));
+
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return false;
+
+  if (file.write(
+        reinterpret_cast<const char *>(&header),
+        sizeof(PowerOverviewHeader))
+      != sizeof(PowerOverviewHeader)
+      || file.write(
+        reinterpret_cast<const char *>(m_buckets.data()),
+        bucketBytes) != bucketBytes
+      || file.write(
+        reinterpret_cast<const char *>(m_spectra.data()),
+        spectraBytes) != spectraBytes) {
+    file.close();
+    file.remove();
+    return false;
+  }
+
+  return true;
+}
+
+bool
+PowerOverview::load(
+    std::string const &path,
+    quint64 dataSize,
+    qint64 dataMtime)
+{
+  PowerOverviewHeader header;
+  QFile file(QString::fromStdString(path));
+  std::vector<PowerOverviewBucket> buckets;
+  std::vector<float> spectra;
+  qint64 bucketBytes, spectraBytes;
+
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  if (file.read(reinterpret_cast<char *>(&header), sizeof(PowerOverviewHeader))
+      != sizeof(PowerOverviewHeader))
+    return false;
+
+  // A stale overview is as good as none
+  if (std::memcmp(header.magic, SIGDIGGER_POWER_OVERVIEW_MAGIC, 8) != 0
+      || header.version != SIGDIGGER_POWER_OVERVIEW_VERSION
+      || header.bins != SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS
+      || header.buckets == 0
+      || header.buckets > SIGDIGGER_POWER_OVERVIEW_MAX_BUCKETS
+      || header.dataSize != dataSize
+      || header.dataMtime != dataMtime)
+    return false;
+
+  buckets.resize(header.buckets);
+  spectra.resize(header.buckets * SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS);
+
+  bucketBytes  = static_cast<qint64>(
+        buckets.size() * sizeof(PowerOverviewBucket));
+  spectraBytes = static_cast<qint64>(spectra.size() * sizeof(float));
+
+  if (file.read(reinterpret_cast<char *>(buckets.data()), bucketBytes)
+      != bucketBytes
+      || file.read(reinterpret_cast<char *>(spectra.data()), spectraBytes)
+      != spectraBytes)
+    return false;
+
+  QMutexLocker locker(&m_mutex);
+
+  m_buckets  = std::move(buckets);
+  m_spectra  = std::move(spectra);
+  m_samples  = header.samples;
+  m_filled   = m_buckets.size();
+  m_complete = true;
+
+  return true;
+}
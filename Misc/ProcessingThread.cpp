@@ -0,0 +1,316 @@
+//
+//    ProcessingThread.cpp: Worker thread with affinity and priority controls
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "ProcessingThread.h"
+#include <QMutexLocker>
+#include <QStringList>
+#include <algorithm>
+#include <cerrno>
+
+#ifdef __linux__
+#  include <pthread.h>
+#  include <sched.h>
+#  include <time.h>
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#  include <sys/resource.h>
+#endif // __linux__
+
+#define SIGDIGGER_PROCESSING_THREAD_MAX_CPU 1024
+
+using namespace SigDigger;
+
+ProcessingThread::ProcessingThread(QObject *parent) : QThread(parent)
+{
+}
+
+ProcessingThread::~ProcessingThread()
+{
+  quit();
+  wait();
+}
+
+// Must be called with m_mutex held
+bool
+ProcessingThread::applyAffinity()
+{
+#ifdef __linux__
+  cpu_set_t set;
+
+  if (!m_haveHandle)
+    return true;
+
+  CPU_ZERO(&set);
+
+  if (m_affinity.isEmpty()) {
+    for (int i = 0; i < CPU_SETSIZE; ++i)
+      CPU_SET(i, &set);
+  } else {
+    for (auto cpu : m_affinity)
+      if (cpu >= 0 && cpu < CPU_SETSIZE)
+        CPU_SET(cpu, &set);
+  }
+
+  return pthread_setaffinity_np(
+        static_cast<pthread_t>(m_handle),
+        sizeof(cpu_set_t),
+        &set) == 0;
+#else
+  return m_affinity.isEmpty();
+#endif // __linux__
+}
+
+// Must be called with m_mutex held
+bool
+ProcessingThread::applyPriority()
+{
+#ifdef __linux__
+  struct sched_param param;
+  int policy = SCHED_OTHER;
+  int nice   = m_baseNice;
+  pid_t tid  = static_cast<pid_t>(m_tid);
+
+  if (!m_haveHandle)
+    return true;
+
+  // Threads under SCHED_OTHER all share the same static priority, which is
+  // what QThread::setPriority changes. Their share of the CPU is given by
+  // their nice value instead, which Linux keeps per thread.
+  switch (m_priority) {
+    case IdlePriority:
+      policy = SCHED_IDLE;
+      break;
+
+    case LowestPriority:
+      nice += 10;
+      break;
+
+    case LowPriority:
+      nice += 5;
+      break;
+
+    case HighPriority:
+      nice -= 5;
+      break;
+
+    case HighestPriority:
+      nice -= 10;
+      break;
+
+    case TimeCriticalPriority:
+      nice -= 15;
+      break;
+
+    default:
+      // Normal and inherited priorities: back to where the thread started
+      break;
+  }
+
+  nice = std::max(-20, std::min(19, nice));
+
+  param.sched_priority = 0;
+  if (sched_setscheduler(tid, policy, &param) == -1)
+    return false;
+
+  // Raising it requires CAP_SYS_NICE or a suitable RLIMIT_NICE
+  return setpriority(PRIO_PROCESS, static_cast<id_t>(tid), nice) == 0;
+#else
+  if (!m_haveHandle)
+    return true;
+
+  setPriority(m_priority == InheritPriority ? NormalPriority : m_priority);
+
+  return true;
+#endif // __linux__
+}
+
+void
+ProcessingThread::run()
+{
+  m_mutex.lock();
+  m_haveHandle = true;
+#ifdef __linux__
+  m_handle     = static_cast<unsigned long>(pthread_self());
+  m_tid        = static_cast<long>(syscall(SYS_gettid));
+  errno        = 0;
+  m_baseNice   = getpriority(PRIO_PROCESS, static_cast<id_t>(m_tid));
+  if (errno != 0)
+    m_baseNice = 0;
+#endif // __linux__
+  (void) applyAffinity();
+  if (m_priority != InheritPriority)
+    (void) applyPriority();
+  m_mutex.unlock();
+
+  exec();
+
+  m_mutex.lock();
+  m_haveHandle = false;
+  m_mutex.unlock();
+}
+
+bool
+ProcessingThread::setAffinity(QList<int> const &cpus)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_affinity = cpus;
+
+  return applyAffinity();
+}
+
+bool
+ProcessingThread::setProcessingPriority(Priority priority)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_priority = priority;
+
+  // If the thread is not running yet, run() takes care of it
+  return applyPriority();
+}
+
+QList<int>
+ProcessingThread::affinity() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_affinity;
+}
+
+QThread::Priority
+ProcessingThread::processingPriority() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_priority;
+}
+
+qreal
+ProcessingThread::load()
+{
+#ifdef __linux__
+  clockid_t clock;
+  struct timespec ts;
+  qint64 cpuNs, wallNs;
+  qreal result = -1;
+  QMutexLocker locker(&m_mutex);
+
+  if (!m_haveHandle)
+    return -1;
+
+  if (pthread_getcpuclockid(static_cast<pthread_t>(m_handle), &clock) != 0)
+    return -1;
+
+  if (clock_gettime(clock, &ts) != 0)
+    return -1;
+
+  cpuNs = static_cast<qint64>(ts.tv_sec) * 1000000000ll + ts.tv_nsec;
+
+  if (m_lastCpuNs >= 0 && m_loadTimer.isValid()) {
+    wallNs = m_loadTimer.nsecsElapsed();
+    if (wallNs > 0)
+      result = static_cast<qreal>(cpuNs - m_lastCpuNs) / wallNs;
+  }
+
+  m_lastCpuNs = cpuNs;
+  m_loadTimer.restart();
+
+  return result;
+#else
+  return -1;
+#endif // __linux__
+}
+
+QList<int>
+ProcessingThread::parseCpuList(QString const &list, bool *ok)
+{
+  QList<int> cpus;
+  bool good = true;
+
+  for (auto const &part : list.split(",")) {
+    QStringList range = part.trimmed().split("-");
+    int first, last;
+    bool okFirst, okLast;
+
+    if (part.trimmed().isEmpty())
+      continue;
+
+    if (range.size() == 1) {
+      first   = range[0].trimmed().toInt(&okFirst);
+      last    = first;
+      okLast  = true;
+    } else if (range.size() == 2) {
+      first   = range[0].trimmed().toInt(&okFirst);
+      last    = range[1].trimmed().toInt(&okLast);
+    } else {
+      good = false;
+      break;
+    }
+
+    if (!okFirst
+        || !okLast
+        || first < 0
+        || last < first
+        || last >= SIGDIGGER_PROCESSING_THREAD_MAX_CPU) {
+      good = false;
+      break;
+    }
+
+    for (int i = first; i <= last; ++i)
+      if (!cpus.contains(i))
+        cpus.append(i);
+  }
+
+  if (!good)
+    cpus.clear();
+
+  std::sort(cpus.begin(), cpus.end());
+
+  if (ok != nullptr)
+    *ok = good;
+
+  return cpus;
+}
+
+QString
+ProcessingThread::formatCpuList(QList<int> const &cpus)
+{
+  QList<int> sorted = cpus;
+  QStringList parts;
+  int i = 0;
+
+  std::sort(sorted.begin(), sorted.end());
+
+  while (i < sorted.size()) {
+    int j = i;
+
+    while (j + 1 < sorted.size() && sorted[j + 1] == sorted[j] + 1)
+      ++j;
+
+    if (j == i)
+      parts.append(QString::number(sorted[i]));
+    else
+      parts.append(
+            QString::number(sorted[i]) + "-" + QString::number(sorted[j]));
+
+    i = j + 1;
+  }
+
+  return parts.join(",");
+}
@@ -0,0 +1,336 @@
+//
+//    SampleBuffer.cpp: Growable sample buffer that can spill to disk
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include <SampleBuffer.h>
+#include <ArenaAllocator.h>
+#include <QDir>
+#include <sigutils/log.h>
+#include <cstring>
+#include <cerrno>
+
+#ifndef _WIN32
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  include <fcntl.h>
+#endif // _WIN32
+
+#ifndef MAP_NORESERVE
+#  define MAP_NORESERVE 0
+#endif // MAP_NORESERVE
+
+using namespace SigDigger;
+
+SampleBuffer::SampleBuffer(QString const &name) : m_name(name)
+{
+  MemoryBudget::instance()->add(this);
+}
+
+SampleBuffer::~SampleBuffer()
+{
+  MemoryBudget::instance()->remove(this);
+  unmap();
+}
+
+bool
+SampleBuffer::reserve()
+{
+#ifdef _WIN32
+  return false;
+#else
+  void *map;
+
+  if (m_base != nullptr)
+    return true;
+
+  map = mmap(
+        nullptr,
+        SIGDIGGER_SAMPLE_BUFFER_RESERVE,
+        PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+        -1,
+        0);
+
+  if (map == MAP_FAILED) {
+    SU_WARNING(
+          "%s: cannot reserve address space (%s), spilling disabled\n",
+          m_name.toStdString().c_str(),
+          strerror(errno));
+    return false;
+  }
+
+  m_base      = static_cast<SUCOMPLEX *>(map);
+  m_reserved  = SIGDIGGER_SAMPLE_BUFFER_RESERVE;
+  m_committed = 0;
+
+  // Same huge page and NUMA placement as the rest of the sample buffers
+  Arena::instance().advise(m_base, m_reserved);
+
+  return true;
+#endif // _WIN32
+}
+
+bool
+SampleBuffer::commit(size_t bytes)
+{
+#ifdef _WIN32
+  (void) bytes;
+  return false;
+#else
+  uint8_t *base = reinterpret_cast<uint8_t *>(m_base);
+  size_t target;
+
+  if (bytes <= m_committed)
+    return true;
+
+  target = (bytes + SIGDIGGER_SAMPLE_BUFFER_GROWTH - 1)
+      / SIGDIGGER_SAMPLE_BUFFER_GROWTH
+      * SIGDIGGER_SAMPLE_BUFFER_GROWTH;
+
+  if (target > m_reserved)
+    return false;
+
+  if (m_fd == -1) {
+    if (mprotect(
+          base + m_committed,
+          target - m_committed,
+          PROT_READ | PROT_WRITE) == -1)
+      return false;
+  } else {
+    // Spilled: keep growing the file instead
+    if (ftruncate(m_fd, static_cast<off_t>(target)) == -1)
+      return false;
+
+    if (mmap(
+          base + m_committed,
+          target - m_committed,
+          PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_FIXED,
+          m_fd,
+          static_cast<off_t>(m_committed)) == MAP_FAILED)
+      return false;
+  }
+
+  m_committed = target;
+
+  return true;
+#endif // _WIN32
+}
+
+void
+SampleBuffer::decommit()
+{
+#ifndef _WIN32
+  // Fresh anonymous pages over the old ones, spilled or not. They read as
+  // zeros and take no memory until the next capture writes to them.
+  if (m_base != nullptr && m_committed > 0) {
+    if (mmap(
+          m_base,
+          m_committed,
+          PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE,
+          -1,
+          0) == MAP_FAILED)
+      SU_WARNING(
+            "%s: cannot release capture memory: %s\n",
+            m_name.toStdString().c_str(),
+            strerror(errno));
+    else
+      Arena::instance().advise(m_base, m_committed);
+  }
+
+  // The mapping (if it is still there) keeps the file alive
+  if (m_fd != -1)
+    (void) ::close(m_fd);
+#endif // _WIN32
+
+  m_committed = 0;
+  m_size      = 0;
+  m_fd        = -1;
+}
+
+void
+SampleBuffer::unmap()
+{
+#ifndef _WIN32
+  if (m_base != nullptr)
+    (void) munmap(m_base, m_reserved);
+
+  if (m_fd != -1)
+    (void) ::close(m_fd);
+#endif // _WIN32
+
+  m_base      = nullptr;
+  m_reserved  = 0;
+  m_committed = 0;
+  m_size      = 0;
+  m_fd        = -1;
+}
+
+const SUCOMPLEX *
+SampleBuffer::data() const
+{
+  return m_base != nullptr ? m_base : m_fallback.data();
+}
+
+SUSCOUNT
+SampleBuffer::size() const
+{
+  return m_base != nullptr ? m_size : m_fallback.size();
+}
+
+bool
+SampleBuffer::empty() const
+{
+  return size() == 0;
+}
+
+bool
+SampleBuffer::isSpilled() const
+{
+  return m_fd != -1;
+}
+
+bool
+SampleBuffer::append(const SUCOMPLEX *data, SUSCOUNT len)
+{
+  if (m_base == nullptr && m_fallback.empty() && !m_noReserve)
+    m_noReserve = !reserve();
+
+  if (m_base != nullptr) {
+    if (!commit((m_size + len) * sizeof(SUCOMPLEX)))
+      return false;
+
+    memcpy(m_base + m_size, data, len * sizeof(SUCOMPLEX));
+    m_size += len;
+  } else {
+    m_fallback.insert(m_fallback.end(), data, data + len);
+  }
+
+  markUsed();
+
+  return true;
+}
+
+void
+SampleBuffer::clear()
+{
+  // Give the memory back, but not the addresses: a task may still be
+  // working on the previous capture. They are unmapped on destruction.
+  decommit();
+
+  m_fallback.clear();
+
+  MemoryBudget::instance()->touch(this);
+}
+
+void
+SampleBuffer::markUsed()
+{
+  MemoryBudget::instance()->touch(this);
+}
+
+QString
+SampleBuffer::memoryConsumerName() const
+{
+  return m_name;
+}
+
+quint64
+SampleBuffer::residentBytes() const
+{
+  if (m_base == nullptr)
+    return m_fallback.capacity() * sizeof(SUCOMPLEX);
+
+  return m_fd == -1 ? m_committed : 0;
+}
+
+quint64
+SampleBuffer::spilledBytes() const
+{
+  return m_fd == -1 ? 0 : m_size * sizeof(SUCOMPLEX);
+}
+
+quint64
+SampleBuffer::spill()
+{
+#ifdef _WIN32
+  return 0;
+#else
+  std::string path =
+      QDir::tempPath().toStdString() + "/sigdigger-spill-XXXXXX";
+  std::vector<char> tmpl(path.begin(), path.end());
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(m_base);
+  size_t bytes = m_size * sizeof(SUCOMPLEX);
+  size_t done = 0;
+  quint64 released = m_committed;
+  int fd;
+
+  if (m_base == nullptr || m_fd != -1 || m_size == 0)
+    return 0;
+
+  tmpl.push_back('\0');
+
+  if ((fd = mkstemp(tmpl.data())) == -1) {
+    SU_WARNING(
+          "%s: cannot create spill file: %s\n",
+          m_name.toStdString().c_str(),
+          strerror(errno));
+    return 0;
+  }
+
+  // Nobody else needs to see it. The mapping keeps it alive.
+  (void) unlink(tmpl.data());
+
+  if (ftruncate(fd, static_cast<off_t>(m_committed)) == -1)
+    goto fail;
+
+  while (done < bytes) {
+    ssize_t got = pwrite(fd, p + done, bytes - done, static_cast<off_t>(done));
+
+    if (got < 0) {
+      if (errno == EINTR)
+        continue;
+      goto fail;
+    }
+
+    done += static_cast<size_t>(got);
+  }
+
+  // Same addresses, now backed by the file. The anonymous pages are gone.
+  if (mmap(
+        m_base,
+        m_committed,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_FIXED,
+        fd,
+        0) == MAP_FAILED)
+    goto fail;
+
+  m_fd = fd;
+
+  return released;
+
+fail:
+  SU_WARNING(
+        "%s: cannot spill to disk: %s\n",
+        m_name.toStdString().c_str(),
+        strerror(errno));
+  (void) ::close(fd);
+  return 0;
+#endif // _WIN32
+}
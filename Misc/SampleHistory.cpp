@@ -0,0 +1,531 @@
+//
+//    Misc/SampleHistory.cpp: Indexed, random-access sample history
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#include <SampleHistory.h>
+#include <QDir>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#ifndef _WIN32
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  include <fcntl.h>
+#endif // _WIN32
+
+#define SIGDIGGER_SAMPLE_HISTORY_HUGEPAGE_SIZE (2 << 20)
+
+using namespace SigDigger;
+
+SampleHistory::SampleHistory()
+{
+  MemoryBudget::instance()->add(this);
+}
+
+SampleHistory::~SampleHistory()
+{
+  MemoryBudget::instance()->remove(this);
+  release();
+}
+
+bool
+SampleHistory::allocateMirrored(size_t bytes, Backing backing, bool hugeTLB)
+{
+#ifdef _WIN32
+  (void) bytes;
+  (void) backing;
+  (void) hugeTLB;
+  return false;
+#else
+  size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  uint8_t *base = nullptr;
+  void *map;
+  int fd = -1;
+
+  if (backing == HISTORY_BACKING_HUGEPAGES)
+    page = SIGDIGGER_SAMPLE_HISTORY_HUGEPAGE_SIZE;
+
+  bytes = (bytes + page - 1) / page * page;
+
+  switch (backing) {
+    case HISTORY_BACKING_HEAP:
+    case HISTORY_BACKING_HUGEPAGES:
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+#  ifdef MFD_HUGETLB
+      if (hugeTLB)
+        fd = memfd_create("sigdigger-history", MFD_CLOEXEC | MFD_HUGETLB);
+      else
+#  endif // MFD_HUGETLB
+      fd = memfd_create("sigdigger-history", MFD_CLOEXEC);
+      break;
+#endif // __linux__
+
+      // Fallthrough: no anonymous files here, use a temporary one instead
+
+    case HISTORY_BACKING_FILE: {
+      std::string path =
+          QDir::tempPath().toStdString() + "/sigdigger-history-XXXXXX";
+      std::vector<char> tmpl(path.begin(), path.end());
+      tmpl.push_back('\0');
+
+      if ((fd = mkstemp(tmpl.data())) != -1)
+        (void) unlink(tmpl.data());
+      break;
+    }
+  }
+
+  if (fd == -1) {
+    m_lastError = "Cannot create history backing file: "
+        + QString(strerror(errno));
+    return false;
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(bytes)) == -1) {
+    m_lastError = "Cannot allocate history: " + QString(strerror(errno));
+    goto fail;
+  }
+
+  // Reserve twice the size, then map the same file on both halves
+  map = mmap(
+        nullptr,
+        2 * bytes,
+        PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+  if (map == MAP_FAILED) {
+    m_lastError = "Cannot reserve history memory: " + QString(strerror(errno));
+    goto fail;
+  }
+
+  base = static_cast<uint8_t *>(map);
+
+  for (int i = 0; i < 2; ++i) {
+    map = mmap(
+          base + i * bytes,
+          bytes,
+          PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_FIXED,
+          fd,
+          0);
+
+    if (map == MAP_FAILED) {
+      m_lastError = "Cannot map history memory: " + QString(strerror(errno));
+      (void) munmap(base, 2 * bytes);
+      goto fail;
+    }
+  }
+
+#ifdef MADV_HUGEPAGE
+  if (backing == HISTORY_BACKING_HUGEPAGES && !hugeTLB)
+    (void) madvise(base, 2 * bytes, MADV_HUGEPAGE);
+#else
+  (void) hugeTLB;
+#endif // MADV_HUGEPAGE
+
+  // The mappings keep the file alive
+  (void) ::close(fd);
+
+  m_buffer   = reinterpret_cast<SUCOMPLEX *>(base);
+  m_mapSize  = bytes;
+  m_capacity = bytes / sizeof(SUCOMPLEX);
+  m_mirrored = true;
+
+  return true;
+
+fail:
+  (void) ::close(fd);
+  return false;
+#endif // _WIN32
+}
+
+void
+SampleHistory::releaseUnlocked()
+{
+#ifndef _WIN32
+  if (m_mirrored && m_buffer != nullptr)
+    (void) munmap(m_buffer, 2 * m_mapSize);
+#endif // _WIN32
+
+  m_fallback.clear();
+  m_fallback.shrink_to_fit();
+
+  m_buffer   = nullptr;
+  m_mapSize  = 0;
+  m_capacity = 0;
+  m_mirrored = false;
+  m_written  = 0;
+  m_dropped  = 0;
+  m_index.clear();
+}
+
+bool
+SampleHistory::allocate(SUSCOUNT samples, Backing backing)
+{
+  QMutexLocker locker(&m_mutex);
+
+  releaseUnlocked();
+
+  m_backing = backing;
+
+  if (samples == 0)
+    return true;
+
+  // Explicit huge pages need a reserved pool. If there is none, settle
+  // for transparent huge pages.
+  if (!allocateMirrored(
+        samples * sizeof(SUCOMPLEX),
+        backing,
+        backing == HISTORY_BACKING_HUGEPAGES)
+      && (backing != HISTORY_BACKING_HUGEPAGES
+          || !allocateMirrored(samples * sizeof(SUCOMPLEX), backing, false))) {
+    // Could not mirror the ring. Spans that wrap around need a copy now.
+    if (backing != HISTORY_BACKING_HEAP)
+      return false;
+
+    try {
+      m_fallback.resize(samples);
+    } catch (std::bad_alloc &) {
+      m_lastError = "Cannot allocate history: out of memory";
+      return false;
+    }
+
+    m_buffer   = m_fallback.data();
+    m_capacity = samples;
+  }
+
+  return true;
+}
+
+void
+SampleHistory::release()
+{
+  QMutexLocker locker(&m_mutex);
+
+  releaseUnlocked();
+}
+
+void
+SampleHistory::clear()
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_written = 0;
+  m_dropped = 0;
+  m_index.clear();
+}
+
+// Protected by mutex
+quint64
+SampleHistory::firstUnlocked() const
+{
+  return m_written > m_capacity ? m_written - m_capacity : 0;
+}
+
+// Protected by mutex
+void
+SampleHistory::expireIndex()
+{
+  quint64 first = firstUnlocked();
+
+  // Keep the entry right before the first retained sample, so that
+  // timeAt(first()) still has something to interpolate from
+  while (m_index.size() > 1 && m_index[1].sample <= first)
+    m_index.pop_front();
+}
+
+void
+SampleHistory::feed(const SUCOMPLEX *data, SUSCOUNT len)
+{
+  QMutexLocker locker(&m_mutex);
+  SUSCOUNT pos;
+
+  if (m_capacity == 0)
+    return;
+
+  if (m_frozen) {
+    m_dropped += len;
+    return;
+  }
+
+  if (m_index.empty()
+      || m_written - m_index.back().sample >= m_blockSize) {
+    IndexEntry entry;
+    entry.sample = m_written;
+    gettimeofday(&entry.tv, nullptr);
+    m_index.push_back(entry);
+  }
+
+  // Only the newest samples fit
+  if (len > m_capacity) {
+    data      += len - m_capacity;
+    m_written += len - m_capacity;
+    len        = m_capacity;
+  }
+
+  pos = static_cast<SUSCOUNT>(m_written % m_capacity);
+
+  if (m_mirrored || pos + len <= m_capacity) {
+    memcpy(m_buffer + pos, data, len * sizeof(SUCOMPLEX));
+  } else {
+    SUSCOUNT head = m_capacity - pos;
+    memcpy(m_buffer + pos, data, head * sizeof(SUCOMPLEX));
+    memcpy(m_buffer, data + head, (len - head) * sizeof(SUCOMPLEX));
+  }
+
+  m_written += len;
+
+  expireIndex();
+}
+
+void
+SampleHistory::setSampleRate(qreal fs)
+{
+  QMutexLocker locker(&m_mutex);
+
+  if (fs > 0)
+    m_fs = fs;
+}
+
+void
+SampleHistory::setFrozen(bool frozen)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_frozen = frozen;
+}
+
+bool
+SampleHistory::isAllocated() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_capacity > 0;
+}
+
+bool
+SampleHistory::isFrozen() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_frozen;
+}
+
+bool
+SampleHistory::isMirrored() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_mirrored;
+}
+
+SampleHistory::Backing
+SampleHistory::backing() const
+{
+  return m_backing;
+}
+
+qreal
+SampleHistory::sampleRate() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_fs;
+}
+
+SUSCOUNT
+SampleHistory::capacity() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_capacity;
+}
+
+quint64
+SampleHistory::dropped() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_dropped;
+}
+
+QString
+SampleHistory::getLastError() const
+{
+  return m_lastError;
+}
+
+quint64
+SampleHistory::first() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return firstUnlocked();
+}
+
+quint64
+SampleHistory::end() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_written;
+}
+
+struct timeval
+SampleHistory::timeAt(quint64 sample) const
+{
+  QMutexLocker locker(&m_mutex);
+  struct timeval tv = {0, 0};
+  struct timeval delta;
+  qreal seconds;
+
+  if (m_index.empty())
+    return tv;
+
+  // Last entry at or before the requested sample
+  auto it = std::upper_bound(
+        m_index.begin(),
+        m_index.end(),
+        sample,
+        [] (quint64 s, IndexEntry const &e) { return s < e.sample; });
+
+  if (it != m_index.begin())
+    --it;
+
+  seconds = (static_cast<qreal>(sample) - static_cast<qreal>(it->sample))
+      / m_fs;
+
+  if (seconds < 0)
+    seconds = 0;
+
+  delta.tv_sec  = static_cast<time_t>(seconds);
+  delta.tv_usec = static_cast<suseconds_t>(
+        (seconds - static_cast<qreal>(delta.tv_sec)) * 1e6);
+
+  timeradd(&it->tv, &delta, &tv);
+
+  return tv;
+}
+
+quint64
+SampleHistory::sampleAt(struct timeval const &tv) const
+{
+  QMutexLocker locker(&m_mutex);
+  struct timeval diff;
+  quint64 first = firstUnlocked();
+  quint64 sample;
+
+  if (m_index.empty())
+    return first;
+
+  // Last entry whose timestamp is not after tv
+  auto it = std::upper_bound(
+        m_index.begin(),
+        m_index.end(),
+        tv,
+        [] (struct timeval const &t, IndexEntry const &e) {
+          return timercmp(&t, &e.tv, <);
+        });
+
+  if (it == m_index.begin())
+    return first;
+
+  --it;
+
+  timersub(&tv, &it->tv, &diff);
+  sample = it->sample + static_cast<quint64>(
+        (static_cast<qreal>(diff.tv_sec)
+         + static_cast<qreal>(diff.tv_usec) * 1e-6) * m_fs);
+
+  // Never beyond the next block (there may be a gap in between)
+  if (it + 1 != m_index.end() && sample > (it + 1)->sample)
+    sample = (it + 1)->sample;
+
+  return std::max(first, std::min(sample, m_written));
+}
+
+const SUCOMPLEX *
+SampleHistory::span(quint64 start, SUSCOUNT len) const
+{
+  QMutexLocker locker(&m_mutex);
+  SUSCOUNT pos;
+
+  if (m_capacity == 0
+      || start < firstUnlocked()
+      || start + len > m_written)
+    return nullptr;
+
+  pos = static_cast<SUSCOUNT>(start % m_capacity);
+
+  if (!m_mirrored && pos + len > m_capacity)
+    return nullptr;
+
+  return m_buffer + pos;
+}
+
+bool
+SampleHistory::copySpan(
+    quint64 start,
+    SUSCOUNT len,
+    std::vector<SUCOMPLEX> &dest) const
+{
+  QMutexLocker locker(&m_mutex);
+  SUSCOUNT pos, head;
+
+  if (m_capacity == 0
+      || start < firstUnlocked()
+      || start + len > m_written)
+    return false;
+
+  pos  = static_cast<SUSCOUNT>(start % m_capacity);
+  head = m_mirrored ? len : std::min(len, m_capacity - pos);
+
+  dest.resize(len);
+  memcpy(dest.data(), m_buffer + pos, head * sizeof(SUCOMPLEX));
+
+  if (head < len)
+    memcpy(dest.data() + head, m_buffer, (len - head) * sizeof(SUCOMPLEX));
+
+  return true;
+}
+
+QString
+SampleHistory::memoryConsumerName() const
+{
+  return "Source history";
+}
+
+quint64
+SampleHistory::residentBytes() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  if (!m_mirrored)
+    return m_fallback.capacity() * sizeof(SUCOMPLEX);
+
+  return m_backing == HISTORY_BACKING_FILE ? 0 : m_mapSize;
+}
+
+quint64
+SampleHistory::spilledBytes() const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_mirrored && m_backing == HISTORY_BACKING_FILE ? m_mapSize : 0;
+}
@@ -0,0 +1,275 @@
+//
+//    Misc/SharedMemoryForwarder.cpp: Forward data through shared memory
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#include <SharedMemoryForwarder.h>
+#include <ShmRing.h>
+#include <algorithm>
+
+using namespace SigDigger;
+
+namespace SigDigger {
+  class SharedMemoryDataWriter : public GenericDataWriter {
+    std::string name;
+    size_t capacity;
+    unsigned int rate = 0;
+    ShmRingHeader *hdr = nullptr;
+    uint8_t *data = nullptr;
+    size_t mapSize = 0;
+    std::string lastError;
+
+    bool push(const uint8_t *data, size_t len);
+
+  public:
+    SharedMemoryDataWriter(
+        std::string const &name,
+        unsigned int rate,
+        size_t capacity);
+
+    bool prepare(void) override;
+    std::string getError(void) const override;
+    bool canWrite(void) const override;
+    size_t maxChunkSize(void) const override;
+    ssize_t write(const void *data, size_t len) override;
+    ssize_t writeChunks(const GenericDataChunk *, size_t) override;
+    bool close(void) override;
+    ~SharedMemoryDataWriter() override;
+  };
+}
+
+SharedMemoryDataWriter::SharedMemoryDataWriter(
+    std::string const &name,
+    unsigned int rate,
+    size_t capacity) :
+  name(name.size() > 0 && name[0] == '/' ? name : "/" + name),
+  rate(rate)
+{
+  // The ring relies on masking, round up to the next power of two
+  this->capacity = 1;
+  while (this->capacity < capacity)
+    this->capacity <<= 1;
+}
+
+bool
+SharedMemoryDataWriter::prepare(void)
+{
+#ifdef _WIN32
+  this->lastError = "Shared memory forwarding is not supported on Windows";
+  return false;
+#else
+  size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t offset = (sizeof(ShmRingHeader) + page - 1) / page * page;
+  void *map;
+  int fd;
+
+  if (this->hdr != nullptr)
+    return true;
+
+  // Never take over an existing segment: another forwarder (or another
+  // SigDigger instance) may still be publishing through it.
+  if ((fd = shm_open(
+         this->name.c_str(),
+         O_RDWR | O_CREAT | O_EXCL,
+         0600)) == -1) {
+    if (errno == EEXIST)
+      this->lastError =
+          "Shared memory segment "
+          + this->name
+          + " already exists. Choose a different name, or remove it if "
+            "it was left behind by a session that did not exit cleanly";
+    else
+      this->lastError =
+          "Cannot create shared memory segment "
+          + this->name
+          + ": "
+          + strerror(errno);
+    return false;
+  }
+
+  this->mapSize = offset + this->capacity;
+
+  if (ftruncate(fd, static_cast<off_t>(this->mapSize)) == -1) {
+    this->lastError = "Cannot allocate shared memory: "
+        + std::string(strerror(errno));
+    ::close(fd);
+    (void) shm_unlink(this->name.c_str());
+    return false;
+  }
+
+  map = mmap(
+        nullptr,
+        this->mapSize,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED,
+        fd,
+        0);
+  ::close(fd);
+
+  if (map == MAP_FAILED) {
+    this->lastError = "Cannot map shared memory: "
+        + std::string(strerror(errno));
+    (void) shm_unlink(this->name.c_str());
+    return false;
+  }
+
+  this->hdr  = static_cast<ShmRingHeader *>(map);
+  this->data = static_cast<uint8_t *>(map) + offset;
+
+  memset(this->hdr, 0, sizeof(ShmRingHeader));
+  this->hdr->version    = SIGDIGGER_SHM_RING_VERSION;
+  this->hdr->capacity   = this->capacity;
+  this->hdr->dataOffset = offset;
+  this->hdr->sampleRate = this->rate;
+
+  // Readers check the magic last, publish it once everything is in place
+  __atomic_store_n(&this->hdr->magic, SIGDIGGER_SHM_RING_MAGIC, __ATOMIC_RELEASE);
+
+  return true;
+#endif // _WIN32
+}
+
+std::string
+SharedMemoryDataWriter::getError(void) const
+{
+  return this->lastError;
+}
+
+bool
+SharedMemoryDataWriter::canWrite(void) const
+{
+  return true;
+}
+
+size_t
+SharedMemoryDataWriter::maxChunkSize(void) const
+{
+  // The saver merges contiguous writes into chunks of up to this size,
+  // and a chunk that does not fit is dropped as a whole. Keep them well
+  // below the capacity, and a multiple of any sample size (the capacity
+  // is a power of two).
+  return std::max<size_t>(this->capacity / 4, sizeof(SUCOMPLEX));
+}
+
+bool
+SharedMemoryDataWriter::push(const uint8_t *data, size_t len)
+{
+  uint64_t head = this->hdr->head;
+  uint64_t tail = __atomic_load_n(&this->hdr->tail, __ATOMIC_ACQUIRE);
+  size_t room = static_cast<size_t>(this->capacity - (head - tail));
+  size_t pos = static_cast<size_t>(head & (this->capacity - 1));
+  size_t first;
+
+  // A slow consumer must not stall the inspector: drop what does not fit.
+  // Chunks hold a whole number of samples (see maxChunkSize()), and they
+  // are dropped as a whole so that the ring never ends in the middle of
+  // a sample.
+  if (len > room) {
+    __atomic_add_fetch(&this->hdr->dropped, len, __ATOMIC_RELAXED);
+    return false;
+  }
+
+  first = std::min(len, this->capacity - pos);
+  memcpy(this->data + pos, data, first);
+  memcpy(this->data, data + first, len - first);
+
+  __atomic_store_n(&this->hdr->head, head + len, __ATOMIC_RELEASE);
+
+  return true;
+}
+
+ssize_t
+SharedMemoryDataWriter::write(const void *data, size_t len)
+{
+  if (this->hdr == nullptr) {
+    this->lastError = "Shared memory segment is not ready";
+    return -1;
+  }
+
+  if (this->push(static_cast<const uint8_t *>(data), len))
+    shmRingWake(this->hdr);
+
+  // Dropped data is accounted in the ring header, not retried
+  return static_cast<ssize_t>(len);
+}
+
+ssize_t
+SharedMemoryDataWriter::writeChunks(const GenericDataChunk *chunks, size_t count)
+{
+  ssize_t total = 0;
+  bool pushed = false;
+
+  if (this->hdr == nullptr) {
+    this->lastError = "Shared memory segment is not ready";
+    return -1;
+  }
+
+  // Publish the whole commit and ring the doorbell only once
+  for (size_t i = 0; i < count; ++i) {
+    if (this->push(chunks[i].data, chunks[i].len))
+      pushed = true;
+    total += static_cast<ssize_t>(chunks[i].len);
+  }
+
+  if (pushed)
+    shmRingWake(this->hdr);
+
+  return total;
+}
+
+bool
+SharedMemoryDataWriter::close(void)
+{
+#ifndef _WIN32
+  if (this->hdr != nullptr) {
+    __atomic_or_fetch(
+          &this->hdr->flags,
+          SIGDIGGER_SHM_RING_FLAG_CLOSED,
+          __ATOMIC_RELEASE);
+    shmRingWake(this->hdr);
+
+    // Readers keep their mappings until they close them
+    (void) munmap(this->hdr, this->mapSize);
+    (void) shm_unlink(this->name.c_str());
+
+    this->hdr  = nullptr;
+    this->data = nullptr;
+  }
+#endif // _WIN32
+
+  return true;
+}
+
+SharedMemoryDataWriter::~SharedMemoryDataWriter(void)
+{
+  this->close();
+}
+
+SharedMemoryForwarder::SharedMemoryForwarder(
+    std::string const &name,
+    unsigned int rate,
+    size_t capacity,
+    QObject *parent) :
+  GenericDataSaver(
+    this->writer = new SharedMemoryDataWriter(name, rate, capacity),
+    parent)
+{
+  this->setFlushPolicy(
+        FLUSH_LATENCY,
+        SIGDIGGER_SHMFORWARDER_DEFAULT_MAX_LATENCY_US);
+  this->setSampleRate(rate);
+}
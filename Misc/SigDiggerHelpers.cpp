@@ -29,6 +29,7 @@
 #include <Suscan/MultitaskController.h>
 #include <ExportSamplesTask.h>
 #include <ExportCSVTask.h>
+#include <ExportSymbolsTask.h>
 #include <sigutils/util/compat-stdlib.h>
 
 #ifndef SIGDIGGER_PKGVERSION
@@ -296,6 +297,97 @@ SigDiggerHelpers::openSaveCoherentSamplesDialog(
   } while (!done);
 }
 
+void
+SigDiggerHelpers::openSaveSymbolsDialog(
+    QWidget *root,
+    SymbolSnapshot const &symbols,
+    unsigned int bps,
+    unsigned int stride,
+    QColor const &lo,
+    QColor const &hi,
+    Suscan::MultitaskController *mt)
+{
+  bool done = false;
+
+  if (symbols.empty()) {
+    QMessageBox::information(
+          root,
+          "Save symbol file",
+          "There are no symbols to save. Record some symbols first.");
+    return;
+  }
+
+  do {
+    QFileDialog dialog(root);
+    QStringList filters;
+    SymView::FileFormat fmt = SymView::FILE_FORMAT_TEXT;
+
+    filters << "Text file (*.txt)"
+            << "Binary file (*.bin)"
+            << "C source file (*.c)"
+            << "Microsoft Windows Bitmap (*.bmp)"
+            << "PNG Image (*.png)"
+            << "JPEG Image (*.jpg)"
+            << "Portable Pixel Map (*.ppm)";
+
+    dialog.setFileMode(QFileDialog::AnyFile);
+    dialog.setAcceptMode(QFileDialog::AcceptSave);
+    dialog.setWindowTitle(QString("Save current symbol capture as..."));
+    dialog.setNameFilters(filters);
+
+    if (dialog.exec()) {
+      QString filter = dialog.selectedNameFilter();
+      QString path = dialog.selectedFiles().first();
+      QFileInfo fi(path);
+      QString ext = fi.suffix().size() > 0
+          ? fi.suffix()
+          : SuWidgetsHelpers::extractFilterExtension(filter);
+      ExportSymbolsTask *task;
+
+      if (ext == "txt")
+        fmt = SymView::FILE_FORMAT_TEXT;
+      else if (ext == "bin")
+        fmt = SymView::FILE_FORMAT_RAW;
+      else if (ext == "c" || ext == "h" || ext == "cpp")
+        fmt = SymView::FILE_FORMAT_C_ARRAY;
+      else if (ext == "bmp")
+        fmt = SymView::FILE_FORMAT_BMP;
+      else if (ext == "png")
+        fmt = SymView::FILE_FORMAT_PNG;
+      else if (ext == "jpg" || ext == "jpeg")
+        fmt = SymView::FILE_FORMAT_JPEG;
+      else if (ext == "ppm")
+        fmt = SymView::FILE_FORMAT_PPM;
+
+      path = SuWidgetsHelpers::ensureExtension(path, ext);
+
+      task = new ExportSymbolsTask(
+            path,
+            fmt,
+            symbols,
+            bps,
+            stride,
+            lo,
+            hi);
+
+      if (!task->attemptOpen()) {
+        QMessageBox::critical(
+              root,
+              "Save symbol file",
+              task->getLastError());
+        delete task;
+      } else {
+        QFileInfo info(path);
+
+        mt->pushTask(task, "Save symbols to " + info.fileName());
+        done = true;
+      }
+    } else {
+      done = true;
+    }
+  } while (!done);
+}
+
 
 Palette *
 SigDiggerHelpers::getGqrxPalette()
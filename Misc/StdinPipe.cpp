@@ -0,0 +1,257 @@
+//
+//    StdinPipe.cpp: Size and watch the pipe the stdin source reads from
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include <StdinPipe.h>
+#include <sigutils/log.h>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+
+#ifndef _WIN32
+#  include <sys/stat.h>
+#  include <sys/ioctl.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif // _WIN32
+
+using namespace SigDigger;
+
+StdinPipe::StdinPipe(QObject *parent) : QObject(parent)
+{
+  m_timer.setInterval(SIGDIGGER_STDIN_PIPE_POLL_MS);
+
+  connect(
+        &m_timer,
+        SIGNAL(timeout()),
+        this,
+        SLOT(onPoll()));
+}
+
+bool
+StdinPipe::isPipe()
+{
+#ifdef _WIN32
+  return false;
+#else
+  struct stat sbuf;
+
+  if (fstat(STDIN_FILENO, &sbuf) == -1)
+    return false;
+
+  return S_ISFIFO(sbuf.st_mode);
+#endif // _WIN32
+}
+
+int
+StdinPipe::capacity()
+{
+#ifdef F_GETPIPE_SZ
+  if (isPipe())
+    return fcntl(STDIN_FILENO, F_GETPIPE_SZ);
+#endif // F_GETPIPE_SZ
+
+  return -1;
+}
+
+int
+StdinPipe::queued()
+{
+#if !defined(_WIN32) && defined(FIONREAD)
+  int bytes = 0;
+
+  if (ioctl(STDIN_FILENO, FIONREAD, &bytes) == -1)
+    return 0;
+
+  return bytes;
+#else
+  return 0;
+#endif // FIONREAD
+}
+
+int
+StdinPipe::grow(int bytes)
+{
+#ifdef F_SETPIPE_SZ
+  int current = capacity();
+  int result;
+
+  if (current == -1 || bytes <= current)
+    return current;
+
+  result = fcntl(STDIN_FILENO, F_SETPIPE_SZ, bytes);
+
+  // Unprivileged users cannot go past pipe-max-size
+  if (result == -1 && errno == EPERM) {
+    FILE *fp = fopen("/proc/sys/fs/pipe-max-size", "r");
+    int max = 0;
+
+    if (fp != nullptr) {
+      if (fscanf(fp, "%d", &max) != 1)
+        max = 0;
+      fclose(fp);
+    }
+
+    if (max > current)
+      result = fcntl(STDIN_FILENO, F_SETPIPE_SZ, max);
+  }
+
+  if (result == -1) {
+    SU_WARNING(
+          "Cannot grow stdin pipe to %d bytes: %s\n",
+          bytes,
+          strerror(errno));
+    return current;
+  }
+
+  return result;
+#else
+  (void) bytes;
+  return capacity();
+#endif // F_SETPIPE_SZ
+}
+
+qint64
+StdinPipe::peek(void *buf, size_t len)
+{
+#ifdef __linux__
+  int fds[2];
+  ssize_t copied, got;
+
+  if (!isPipe())
+    return -1;
+
+  if (pipe(fds) == -1)
+    return -1;
+
+  // Duplicates the queued pages into our pipe. Nothing is consumed.
+  copied = tee(STDIN_FILENO, fds[1], len, SPLICE_F_NONBLOCK);
+  got    = copied > 0 ? read(fds[0], buf, static_cast<size_t>(copied)) : copied;
+
+  close(fds[0]);
+  close(fds[1]);
+
+  if (got < 0)
+    return errno == EAGAIN ? 0 : -1;
+
+  return got;
+#else
+  (void) buf;
+  (void) len;
+  return -1;
+#endif // __linux__
+}
+
+QString
+StdinPipe::guessFormat(const uint8_t *data, size_t len)
+{
+  size_t floats = len / 4;
+  size_t plausible = 0, centered = 0;
+  quint64 diff[4] = {0, 0, 0, 0};
+  float f;
+
+  if (len < SIGDIGGER_STDIN_PIPE_MIN_GUESS)
+    return QString();
+
+  // Reinterpreted integers have absurd exponents (or are NaNs)
+  for (size_t i = 0; i < floats; ++i) {
+    memcpy(&f, data + 4 * i, sizeof(float));
+    if (std::isfinite(f)
+        && (f == 0 || (std::fabs(f) > 1e-10f && std::fabs(f) < 1e4f)))
+      ++plausible;
+  }
+
+  if (plausible >= floats - floats / 50)
+    return "complex_float32";
+
+  // Offset binary (e.g. rtl_sdr) sits around 127
+  for (size_t i = 0; i < len; ++i)
+    if (data[i] >= 0x40 && data[i] < 0xc0)
+      ++centered;
+
+  if (centered >= len - len / 10)
+    return "complex_unsigned8";
+
+  // Step between consecutive values of each byte of an I/Q pair. For
+  // 16-bit samples, high bytes (1 and 3) barely move compared to low
+  // bytes. For 8-bit samples, all four are samples and move alike.
+  for (size_t i = 4; i + 4 <= len; i += 4)
+    for (int k = 0; k < 4; ++k)
+      diff[k] += static_cast<quint64>(std::abs(
+            static_cast<int8_t>(data[i + k] - data[i + k - 4])));
+
+  if (2 * (diff[1] + diff[3]) < diff[0] + diff[2])
+    return "complex_signed16";
+
+  return "complex_signed8";
+}
+
+void
+StdinPipe::start()
+{
+  m_stats = StdinPipeStats();
+  m_full  = false;
+
+  if (isPipe()) {
+    m_stats.capacity = capacity();
+    m_timer.start();
+  }
+
+  emit statsChanged();
+}
+
+void
+StdinPipe::stop()
+{
+  m_timer.stop();
+}
+
+bool
+StdinPipe::isRunning() const
+{
+  return m_timer.isActive();
+}
+
+StdinPipeStats const &
+StdinPipe::stats() const
+{
+  return m_stats;
+}
+
+/////////////////////////////////// Slots //////////////////////////////////////
+void
+StdinPipe::onPoll()
+{
+  bool full;
+
+  m_stats.capacity = capacity();
+  m_stats.queued   = queued();
+
+  if (m_stats.queued > m_stats.peak)
+    m_stats.peak = m_stats.queued;
+
+  // Less than a page left: the producer is (or was about to be) blocked
+  full = m_stats.capacity > 0 && m_stats.queued + 4096 >= m_stats.capacity;
+
+  if (full && !m_full)
+    ++m_stats.stalls;
+
+  m_full = full;
+
+  emit statsChanged();
+}
@@ -32,6 +32,13 @@ GuiConfigTab::save()
   this->guiConfig.enableMsgTTL   = this->ui->ttlCheck->isChecked();
   this->guiConfig.msgTTL         = static_cast<unsigned>(
         this->ui->ttlSpin->value());
+  this->guiConfig.adaptivePSD    = this->ui->adaptivePsdCheck->isChecked();
+  this->guiConfig.targetLatency  = static_cast<unsigned>(
+        this->ui->latencySpin->value());
+  this->guiConfig.memoryBudget   = static_cast<unsigned>(
+        this->ui->memoryBudgetSpin->value());
+  this->guiConfig.hugePages      = this->ui->hugePagesCombo->currentIndex();
+  this->guiConfig.numaNode       = this->ui->numaNodeSpin->value();
   this->guiConfig.infoText       = this->ui->infoTextEdit->toPlainText().toStdString();
   this->guiConfig.infoTextColor  = this->ui->infoTextColor->getColor();
 }
@@ -52,6 +59,15 @@ GuiConfigTab::refreshUi()
   this->ui->ttlLabel->setEnabled(this->ui->ttlCheck->isChecked());
   this->ui->ttlSpin->setEnabled(this->ui->ttlCheck->isChecked());
   this->ui->ttlSpin->setValue(static_cast<int>(this->guiConfig.msgTTL));
+  this->ui->adaptivePsdCheck->setChecked(this->guiConfig.adaptivePSD);
+  this->ui->latencyLabel->setEnabled(this->ui->adaptivePsdCheck->isChecked());
+  this->ui->latencySpin->setEnabled(this->ui->adaptivePsdCheck->isChecked());
+  this->ui->latencySpin->setValue(
+        static_cast<int>(this->guiConfig.targetLatency));
+  this->ui->memoryBudgetSpin->setValue(
+        static_cast<int>(this->guiConfig.memoryBudget));
+  this->ui->hugePagesCombo->setCurrentIndex(this->guiConfig.hugePages);
+  this->ui->numaNodeSpin->setValue(this->guiConfig.numaNode);
   this->ui->infoTextEdit->setPlainText(QString::fromStdString(this->guiConfig.infoText));
   this->ui->infoTextColor->setColor(this->guiConfig.infoTextColor);
 }
@@ -121,6 +137,36 @@ GuiConfigTab::connectAll()
         this,
         SLOT(onConfigChanged()));
 
+  connect(
+        this->ui->adaptivePsdCheck,
+        SIGNAL(toggled(bool)),
+        this,
+        SLOT(onConfigChanged()));
+
+  connect(
+        this->ui->latencySpin,
+        SIGNAL(valueChanged(int)),
+        this,
+        SLOT(onConfigChanged()));
+
+  connect(
+        this->ui->memoryBudgetSpin,
+        SIGNAL(valueChanged(int)),
+        this,
+        SLOT(onConfigChanged()));
+
+  connect(
+        this->ui->hugePagesCombo,
+        SIGNAL(activated(int)),
+        this,
+        SLOT(onConfigChanged()));
+
+  connect(
+        this->ui->numaNodeSpin,
+        SIGNAL(valueChanged(int)),
+        this,
+        SLOT(onConfigChanged()));
+
   connect(
         this->ui->infoTextEdit,
         SIGNAL(textChanged()),
@@ -160,6 +206,9 @@ GuiConfigTab::onConfigChanged()
   this->ui->ttlLabel->setEnabled(this->ui->ttlCheck->isChecked());
   this->ui->ttlSpin->setEnabled(this->ui->ttlCheck->isChecked());
 
+  this->ui->latencyLabel->setEnabled(this->ui->adaptivePsdCheck->isChecked());
+  this->ui->latencySpin->setEnabled(this->ui->adaptivePsdCheck->isChecked());
+
   this->modified = true;
   emit changed();
 }
@@ -88,6 +88,7 @@ SOURCES += \
     Components/AddTLESourceDialog.cpp \
     Components/DataSaverUI.cpp \
     Components/DeviceGain.cpp \
+    Components/CycloDialog.cpp \
     Components/DopplerDialog.cpp \
     Components/FrequencyCorrectionDialog.cpp \
     Components/GainSlider.cpp \
@@ -108,6 +109,9 @@ SOURCES += \
     Default/DefaultTab/DefaultTabWidgetFactory.cpp \
     Default/FFT/FFTWidget.cpp \
     Default/FFT/FFTWidgetFactory.cpp \
+    Default/GenericInspector/DensityMapView.cpp \
+    Default/GenericInspector/DataForwardWorker.cpp \
+    Default/GenericInspector/DensityMapWorker.cpp \
     Default/GenericInspector/FACTab.cpp \
     Default/GenericInspector/GenericInspector.cpp \
     Default/GenericInspector/GenericInspectorFactory.cpp \
@@ -130,6 +134,12 @@ SOURCES += \
     Default/RMSInspector/RMSInspector.cpp \
     Default/RMSInspector/RMSInspectorFactory.cpp \
     Default/Registration.cpp \
+    Default/Scanner/ChannelScanner.cpp \
+    Default/Scanner/ScannerWidget.cpp \
+    Default/Scanner/ScannerWidgetFactory.cpp \
+    Default/ChannelBatch/ChannelBatch.cpp \
+    Default/ChannelBatch/ChannelBatchWidget.cpp \
+    Default/ChannelBatch/ChannelBatchWidgetFactory.cpp \
     Default/Source/SourceWidget.cpp \
     Default/Source/SourceWidgetFactory.cpp \
     Default/SourceConfig/DeviceTweaks.cpp \
@@ -141,13 +151,26 @@ SOURCES += \
     Default/SourceConfig/StdinSourcePageFactory.cpp \
     Default/SourceConfig/ToneGenSourcePage.cpp \
     Default/SourceConfig/ToneGenSourcePageFactory.cpp \
+    Misc/ArenaAllocator.cpp \
     Misc/AutoGain.cpp \
     Misc/Averager.cpp \
+    Misc/CaptureIndex.cpp \
+    Misc/CapturePrefetcher.cpp \
     Misc/FileViewer.cpp \
+    Misc/GainController.cpp \
     Misc/GlobalProperty.cpp \
+    Misc/LazyWidget.cpp \
+    Misc/MeasureIndex.cpp \
+    Misc/MemoryBudget.cpp \
     Misc/Palette.cpp \
+    Misc/PowerOverview.cpp \
+    Misc/ProcessingThread.cpp \
+    Misc/PSDLinkController.cpp \
+    Misc/SampleBuffer.cpp \
+    Misc/SampleHistory.cpp \
     Misc/SNREstimator.cpp \
     Misc/SigDiggerHelpers.cpp \
+    Misc/StdinPipe.cpp \
     Settings/AudioConfigTab.cpp \
     Settings/ColorConfigTab.cpp \
     Settings/ConfigDialog.cpp \
@@ -180,17 +203,21 @@ SOURCES += \
     Suscan/Plugin.cpp \
     Suscan/Serializable.cpp \
     Suscan/Source.cpp \
+    Suscan/WatermarkController.cpp \
     Tasks/AGCTask.cpp \
     Tasks/CarrierDetector.cpp \
     Tasks/CarrierXlator.cpp \
     Tasks/CostasRecoveryTask.cpp \
+    Tasks/CycloSpectrumTask.cpp \
     Tasks/DelayedConjTask.cpp \
     Tasks/DopplerCalculator.cpp \
     Tasks/ExportCSVTask.cpp \
     Tasks/HistogramFeeder.cpp \
     Tasks/LPFTask.cpp \
     Tasks/PLLSyncTask.cpp \
+    Tasks/PowerOverviewTask.cpp \
     Tasks/QuadDemodTask.cpp \
+    Tasks/ResamplerTask.cpp \
     Tasks/WaveSampler.cpp \
     UIComponent/InspectionWidgetFactory.cpp \
     UIComponent/SourceConfigWidgetFactory.cpp \
@@ -208,6 +235,7 @@ SOURCES += \
     Misc/GenericDataSaver.cpp \
     Misc/FileDataSaver.cpp \
     UDP/SocketForwarder.cpp \
+    Misc/SharedMemoryForwarder.cpp \
     Components/NetForwarderUI.cpp \
     Components/WaitingSpinnerWidget.cpp \
     Components/DeviceDialog.cpp \
@@ -221,6 +249,7 @@ SOURCES += \
     Misc/MultitaskControllerModel.cpp \
     Components/BackgroundTasksDialog.cpp \
     Tasks/ExportSamplesTask.cpp \
+    Tasks/ExportSymbolsTask.cpp \
     Components/AddBookmarkDialog.cpp \
     Misc/BookmarkTableModel.cpp \
     Components/BookmarkManagerDialog.cpp \
@@ -232,6 +261,7 @@ INSTALL_HEADERS += \
     include/AppUI.h \
     include/AudioConfig.h \
     include/AudioFileSaver.h \
+    include/ArenaAllocator.h \
     include/AudioPlayback.h \
     include/Averager.h \
     include/ColorConfig.h \
@@ -240,10 +270,15 @@ INSTALL_HEADERS += \
     include/GuiConfig.h \
     include/GlobalProperty.h \
     include/InspectionWidgetFactory.h \
+    include/LazyWidget.h \
     include/SigDiggerHelpers.h \
     include/MainSpectrum.h \
     include/MainWindow.h \
+    include/MeasureIndex.h \
+    include/MemoryBudget.h \
     include/Palette.h \
+    include/ProcessingThread.h \
+    include/PSDLinkController.h \
     include/PersistentWidget.h \
     include/RemoteControlConfig.h \
     include/SourceConfigWidgetFactory.h \
@@ -278,7 +313,8 @@ SUSCAN_HEADERS += \
     include/Suscan/Plugin.h \
     include/Suscan/Serializable.h \
     include/Suscan/Source.h \
-    include/Suscan/SpectrumSource.h
+    include/Suscan/SpectrumSource.h \
+    include/Suscan/WatermarkController.h
 
 suscan_headers.path   = $$SIGDIGGER_INSTALL_HEADERS/Suscan
 suscan_headers.files += $$SUSCAN_HEADERS
@@ -308,6 +344,9 @@ HEADERS += \
     Default/DefaultTab/DefaultTabWidgetFactory.h \
     Default/FFT/FFTWidget.h \
     Default/FFT/FFTWidgetFactory.h \
+    Default/GenericInspector/DensityMapView.h \
+    Default/GenericInspector/DataForwardWorker.h \
+    Default/GenericInspector/DensityMapWorker.h \
     Default/GenericInspector/FACTab.h \
     Default/GenericInspector/GenericInspector.h \
     Default/GenericInspector/GenericInspectorFactory.h \
@@ -330,6 +369,12 @@ HEADERS += \
     Default/RMSInspector/RMSInspector.h \
     Default/RMSInspector/RMSInspectorFactory.h \
     Default/Registration.h \
+    Default/Scanner/ChannelScanner.h \
+    Default/Scanner/ScannerWidget.h \
+    Default/Scanner/ScannerWidgetFactory.h \
+    Default/ChannelBatch/ChannelBatch.h \
+    Default/ChannelBatch/ChannelBatchWidget.h \
+    Default/ChannelBatch/ChannelBatchWidgetFactory.h \
     Default/Source/SourceWidget.h \
     Default/Source/SourceWidgetFactory.h \
     Default/SourceConfig/DeviceTweaks.h \
@@ -347,16 +392,21 @@ HEADERS += \
     include/AlsaPlayer.h \
     include/AudioConfig.h \
     include/AudioConfigTab.h \
+    include/CaptureIndex.h \
+    include/CapturePrefetcher.h \
     include/CarrierDetector.h \
     include/CarrierXlator.h \
     include/ColorConfigTab.h \
     include/CostasRecoveryTask.h \
     include/DelayedConjTask.h \
     include/DopplerCalculator.h \
+    include/CycloDialog.h \
+    include/CycloSpectrumTask.h \
     include/DopplerDialog.h \
     include/FileViewer.h \
     include/FloatingTabWindow.h \
     include/FrequencyCorrectionDialog.h \
+    include/GainController.h \
     include/GenericAudioPlayer.h \
     include/GenericDataSaverUI.h \
     include/GuiConfigTab.h \
@@ -366,14 +416,20 @@ HEADERS += \
     include/LocationConfigTab.h \
     include/PLLSyncTask.h \
     include/PortAudioPlayer.h \
+    include/PowerOverview.h \
+    include/PowerOverviewTask.h \
     include/ProfileConfigTab.h \
     include/QTimeSlider.h \
     include/QuadDemodTask.h \
+    include/ResamplerTask.h \
     include/QuickConnectDialog.h \
     include/RemoteControlServer.h \
     include/RemoteControlTab.h \
     include/SamplerDialog.h \
+    include/SampleBuffer.h \
+    include/SampleHistory.h \
     include/SamplingProperties.h \
+    include/StdinPipe.h \
     include/AboutDialog.h \
     include/AutoGain.h \
     include/ConfigDialog.h \
@@ -388,6 +444,8 @@ HEADERS += \
     include/TimeWindow.h \
     include/FileDataSaver.h \
     include/SocketForwarder.h \
+    include/SharedMemoryForwarder.h \
+    include/ShmRing.h \
     include/NetForwarderUI.h \
     include/WaitingSpinnerWidget.h \
     include/DeviceDialog.h \
@@ -401,6 +459,7 @@ HEADERS += \
     include/MultitaskControllerModel.h \
     include/BackgroundTasksDialog.h \
     include/ExportSamplesTask.h \
+    include/ExportSymbolsTask.h \
     include/AddBookmarkDialog.h \
     include/BookmarkTableModel.h \
     include/BookmarkManagerDialog.h \
@@ -418,6 +477,8 @@ FORMS += \
     Default/GenericInspector/WaveformTab.ui \
     Default/Inspection/InspToolWidget.ui \
     Default/RMSInspector/RMSInspector.ui \
+    Default/Scanner/ScannerWidget.ui \
+    Default/ChannelBatch/ChannelBatchWidget.ui \
     Default/Source/SourceWidget.ui \
     Default/SourceConfig/DeviceTweaks.ui \
     Default/SourceConfig/FileSourcePage.ui \
@@ -434,6 +495,7 @@ FORMS += \
     ui/Config.ui \
     ui/DataSaverUI.ui \
     ui/DeviceGain.ui \
+    ui/CycloDialog.ui \
     ui/DopplerDialog.ui \
     ui/EqualizerControl.ui \
     ui/FloatingTabWindow.ui \
@@ -518,6 +580,9 @@ win32 {
   LIBS += -lsuwidgets$$SUWIDGETS_BUILDTYPE_SUFFIX -ldl
 }
 
+# shm_open lives in librt on older glibc
+linux: LIBS += -lrt
+
 DISTFILES += \
     icons/icon-alpha.png \
     icons/icon-color-about.png \
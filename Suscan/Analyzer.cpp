@@ -18,6 +18,7 @@
 //
 
 #include <iostream>
+#include <algorithm>
 
 #include <QMetaType>
 #include <Suscan/Library.h>
@@ -39,6 +40,23 @@ Q_DECLARE_METATYPE(Suscan::Orbit);
 
 using namespace Suscan;
 
+// Inspector listener
+InspectorListener::~InspectorListener()
+{
+}
+
+void
+InspectorListener::onInspectorMessage(InspectorMessage const &)
+{
+  // NO-OP
+}
+
+void
+InspectorListener::onInspectorSamples(SamplesMessage const &)
+{
+  // NO-OP
+}
+
 // Orbit
 void
 Orbit::debug() const
@@ -117,6 +135,8 @@ Analyzer::read(uint32_t &type)
 void
 Analyzer::setThrottle(unsigned int throttle)
 {
+  this->flushPendingCommands();
+
   suscan_analyzer_set_throttle_async(
         this->instance,
         throttle,
@@ -145,24 +165,64 @@ Analyzer::registerBaseBandFilter(
 void
 Analyzer::setGain(std::string const &name, SUFLOAT value)
 {
-  SU_ATTEMPT(suscan_analyzer_set_gain(this->instance, name.c_str(), value));
+  PendingCommand cmd;
+
+  cmd.type  = COMMAND_GAIN;
+  cmd.name  = name;
+  cmd.value = value;
+
+  this->enqueueCommand(cmd);
 }
 
 void
 Analyzer::seek(struct timeval const &tv)
 {
-  SU_ATTEMPT(suscan_analyzer_seek(this->instance, &tv));
+  // Dragging the time slider produces a seek per intermediate position.
+  // Those arriving while the analyzer is still serving the previous one
+  // only update the target.
+  if (this->seekInFlight) {
+    if (this->seekPending)
+      ++this->skippedSeeks;
+
+    this->pendingSeek = tv;
+    this->seekPending = true;
+    return;
+  }
+
+  this->sendSeek(tv);
+}
+
+bool
+Analyzer::isSeeking() const
+{
+  return this->seekInFlight;
+}
+
+quint64
+Analyzer::getSkippedSeeks() const
+{
+  return this->skippedSeeks;
+}
+
+quint64
+Analyzer::getDroppedPSDs() const
+{
+  return this->droppedPSDs;
 }
 
 void
 Analyzer::setHistorySize(SUSCOUNT size)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(suscan_analyzer_set_history_size(this->instance, size));
 }
 
 void
 Analyzer::replay(bool replay)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(suscan_analyzer_replay(this->instance, replay));
 }
 
@@ -170,12 +230,16 @@ Analyzer::replay(bool replay)
 void
 Analyzer::setAntenna(std::string const &name)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(suscan_analyzer_set_antenna(this->instance, name.c_str()));
 }
 
 void
 Analyzer::setSweepStrategy(SweepStrategy strategy)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(suscan_analyzer_set_sweep_stratrgy(
                this->instance,
                static_cast<enum suscan_analyzer_sweep_strategy>(strategy)));
@@ -184,6 +248,8 @@ Analyzer::setSweepStrategy(SweepStrategy strategy)
 void
 Analyzer::setSpectrumPartitioning(SpectrumPartitioning partitioning)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(suscan_analyzer_set_spectrum_partitioning(
                this->instance,
                static_cast<enum suscan_analyzer_spectrum_partitioning>(partitioning)));
@@ -192,33 +258,47 @@ Analyzer::setSpectrumPartitioning(SpectrumPartitioning partitioning)
 void
 Analyzer::setBandwidth(SUFLOAT value)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(suscan_analyzer_set_bw(this->instance, value));
 }
 
 void
 Analyzer::setPPM(SUFLOAT value)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(suscan_analyzer_set_ppm(this->instance, value));
 }
 
 void
 Analyzer::setFrequency(SUFREQ freq)
 {
-  SU_ATTEMPT(suscan_analyzer_set_freq(this->instance, freq, lastLnbFreq));
-  lastFreq = freq;
+  this->setFrequency(freq, lastLnbFreq);
 }
 
 void
 Analyzer::setFrequency(SUFREQ freq, SUFREQ lnb)
 {
-  SU_ATTEMPT(suscan_analyzer_set_freq(this->instance, freq, lnb));
+  PendingCommand cmd;
+
+  cmd.type  = COMMAND_FREQUENCY;
+  cmd.value = freq;
+  cmd.lnb   = lnb;
+
+  // The requested frequency is reported right away, even if it has not
+  // been sent yet.
   lastLnbFreq = lnb;
   lastFreq = freq;
+
+  this->enqueueCommand(cmd);
 }
 
 void
 Analyzer::setParams(AnalyzerParams &params)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_set_params_async(
           this->instance,
@@ -229,6 +309,8 @@ Analyzer::setParams(AnalyzerParams &params)
 void
 Analyzer::setDCRemove(bool remove)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_set_dc_remove(
           this->instance,
@@ -238,6 +320,8 @@ Analyzer::setDCRemove(bool remove)
 void
 Analyzer::setIQReverse(bool remove)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_set_iq_reverse(
           this->instance,
@@ -247,6 +331,8 @@ Analyzer::setIQReverse(bool remove)
 void
 Analyzer::setAGC(bool enabled)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_set_agc(this->instance, enabled ? SU_TRUE : SU_FALSE));
 
@@ -255,6 +341,8 @@ Analyzer::setAGC(bool enabled)
 void
 Analyzer::setHopRange(SUFREQ min, SUFREQ max)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_set_hop_range(this->instance, min, max));
 }
@@ -262,6 +350,8 @@ Analyzer::setHopRange(SUFREQ min, SUFREQ max)
 void
 Analyzer::setRelBandwidth(SUFLOAT rel_bw)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_set_rel_bandwidth(this->instance, rel_bw));
 }
@@ -269,6 +359,8 @@ Analyzer::setRelBandwidth(SUFLOAT rel_bw)
 void
 Analyzer::setBufferingSize(SUSCOUNT len)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(suscan_analyzer_set_buffering_size(this->instance, len));
 }
 
@@ -318,9 +410,192 @@ Analyzer::getSourceInfo() const
 void
 Analyzer::halt()
 {
+  this->pendingCommands.clear();
+  this->commandTimer->stop();
+
+  this->seekTimer->stop();
+  this->seekInFlight = false;
+  this->seekPending  = false;
+
   suscan_analyzer_req_halt(this->instance);
 }
 
+// Seek coalescing
+void
+Analyzer::sendSeek(struct timeval const &tv)
+{
+  this->flushPendingCommands();
+
+  SU_ATTEMPT(suscan_analyzer_seek(this->instance, &tv));
+
+  this->inFlightSeek = tv;
+  this->seekInFlight = true;
+  this->seekTimer->start(SUSCAN_ANALYZER_SEEK_TIMEOUT_MS);
+}
+
+void
+Analyzer::completeSeek()
+{
+  this->seekTimer->stop();
+  this->seekInFlight = false;
+
+  if (this->seekPending) {
+    this->seekPending = false;
+    this->sendSeek(this->pendingSeek);
+  }
+}
+
+bool
+Analyzer::isStalePSD(struct timeval const &tv) const
+{
+  struct timeval diff;
+  qint64 ms;
+
+  timersub(&tv, &this->inFlightSeek, &diff);
+  ms = SCAST(qint64, diff.tv_sec) * 1000 + diff.tv_usec / 1000;
+
+  return ms < 0 || ms > SUSCAN_ANALYZER_SEEK_TOLERANCE_MS;
+}
+
+void
+Analyzer::onSeekTimeout()
+{
+  // No fresh spectrum in time (paused or heavily throttled source). Do not
+  // hold the rest of the seeks hostage.
+  try {
+    this->completeSeek();
+  } catch (Suscan::Exception const &e) {
+    SU_WARNING("Failed to send coalesced seek: %s\n", e.what());
+  }
+}
+
+// Command coalescing
+void
+Analyzer::sendCommand(PendingCommand const &cmd)
+{
+  switch (cmd.type) {
+    case COMMAND_FREQUENCY:
+      SU_ATTEMPT(
+            suscan_analyzer_set_freq(this->instance, cmd.value, cmd.lnb));
+      break;
+
+    case COMMAND_GAIN:
+      SU_ATTEMPT(
+            suscan_analyzer_set_gain(
+              this->instance,
+              cmd.name.c_str(),
+              SCAST(SUFLOAT, cmd.value)));
+      break;
+
+    case COMMAND_INSPECTOR_FREQ:
+      SU_ATTEMPT(
+            suscan_analyzer_set_inspector_freq_overridable(
+              this->instance,
+              cmd.handle,
+              cmd.value));
+      break;
+
+    case COMMAND_INSPECTOR_BANDWIDTH:
+      SU_ATTEMPT(
+            suscan_analyzer_set_inspector_bandwidth_overridable(
+              this->instance,
+              cmd.handle,
+              cmd.value));
+      break;
+  }
+}
+
+void
+Analyzer::enqueueCommand(PendingCommand const &cmd)
+{
+  CommandKey key(cmd.type, cmd.handle, cmd.name);
+  qint64 interval;
+  auto it = this->pendingCommands.find(key);
+
+  // Something with the same key is still waiting: replace it.
+  if (it != this->pendingCommands.end()) {
+    it->second = cmd;
+    ++this->skippedCommands;
+    return;
+  }
+
+  interval = 1000 / SUSCAN_ANALYZER_COMMAND_RATE;
+
+  // Idle for long enough: no reason to delay this one.
+  if (this->pendingCommands.empty()
+      && (!this->lastFlush.isValid()
+          || this->lastFlush.elapsed() >= interval)) {
+    this->lastFlush.start();
+    this->sendCommand(cmd);
+    return;
+  }
+
+  this->pendingCommands[key] = cmd;
+
+  if (!this->commandTimer->isActive())
+    this->commandTimer->start(
+          static_cast<int>(
+            std::max<qint64>(0, interval - this->lastFlush.elapsed())));
+}
+
+void
+Analyzer::dropCommands(Handle handle)
+{
+  auto it = this->pendingCommands.begin();
+
+  while (it != this->pendingCommands.end()) {
+    if (it->second.handle == handle)
+      it = this->pendingCommands.erase(it);
+    else
+      ++it;
+  }
+}
+
+// Commands sent right away (open, setInspectorId, seek...) must
+// not overtake coalesced ones issued before them
+void
+Analyzer::flushPendingCommands()
+{
+  if (!this->pendingCommands.empty())
+    this->flushCommands();
+}
+
+void
+Analyzer::flushCommands()
+{
+  std::map<CommandKey, PendingCommand> pending;
+
+  this->commandTimer->stop();
+  pending.swap(this->pendingCommands);
+
+  if (!pending.empty()) {
+    this->lastFlush.start();
+
+    // A failed command must not take the rest with it
+    for (auto const &p : pending) {
+      try {
+        this->sendCommand(p.second);
+      } catch (Suscan::Exception const &e) {
+        SU_WARNING(
+              "Failed to send coalesced analyzer command: %s\n",
+              e.what());
+      }
+    }
+  }
+}
+
+quint64
+Analyzer::getSkippedCommands() const
+{
+  return this->skippedCommands;
+}
+
+void
+Analyzer::onCommandTimeout()
+{
+  this->flushCommands();
+}
+
 // Signal slots
 void
 Analyzer::captureMessage(quint32 type, void *data)
@@ -335,17 +610,56 @@ Analyzer::captureMessage(quint32 type, void *data)
       emit source_info_message(SourceInfoMessage(asSrcInfo));
       break;
 
-    case SUSCAN_ANALYZER_MESSAGE_TYPE_INSPECTOR:
-      emit inspector_message(InspectorMessage(static_cast<struct suscan_analyzer_inspector_msg *>(data)));
+    case SUSCAN_ANALYZER_MESSAGE_TYPE_INSPECTOR: {
+      InspectorMessage msg(static_cast<struct suscan_analyzer_inspector_msg *>(data));
+
+      this->dispatch(
+            msg.getInspectorId(),
+            msg,
+            &InspectorListener::onInspectorMessage);
+
+      // Request trackers match these by request ID, keep broadcasting them
+      emit inspector_message(msg);
       break;
+    }
 
-    case SUSCAN_ANALYZER_MESSAGE_TYPE_PSD:
-      emit psd_message(PSDMessage(static_cast<struct suscan_analyzer_psd_msg *>(data)));
+    case SUSCAN_ANALYZER_MESSAGE_TYPE_PSD: {
+      PSDMessage msg(static_cast<struct suscan_analyzer_psd_msg *>(data));
+
+      if (this->seekInFlight) {
+        if (!msg.hasLooped() && this->isStalePSD(msg.getTimeStamp())) {
+          ++this->droppedPSDs;
+          break;
+        }
+
+        try {
+          this->completeSeek();
+        } catch (Suscan::Exception const &e) {
+          SU_WARNING("Failed to send coalesced seek: %s\n", e.what());
+        }
+
+        // A newer seek is already on its way, this spectrum is stale too
+        if (this->seekInFlight) {
+          ++this->droppedPSDs;
+          break;
+        }
+      }
+
+      emit psd_message(msg);
       break;
+    }
 
-    case SUSCAN_ANALYZER_MESSAGE_TYPE_SAMPLES:
-      emit samples_message(SamplesMessage(static_cast<struct suscan_analyzer_sample_batch_msg *>(data)));
+    case SUSCAN_ANALYZER_MESSAGE_TYPE_SAMPLES: {
+      SamplesMessage msg(static_cast<struct suscan_analyzer_sample_batch_msg *>(data));
+
+      this->dispatch(
+            msg.getInspectorId(),
+            msg,
+            &InspectorListener::onInspectorSamples);
+
+      emit samples_message(msg);
       break;
+    }
 
     case SUSCAN_ANALYZER_MESSAGE_TYPE_INTERNAL:
     case SUSCAN_ANALYZER_MESSAGE_TYPE_SOURCE_INIT:
@@ -408,6 +722,84 @@ Analyzer::allocateInspectorId()
   return ++this->inspectorId;
 }
 
+void
+Analyzer::subscribeInspector(InspectorId id, InspectorListener *listener)
+{
+  auto &list = this->listeners[id];
+
+  if (std::find(list.begin(), list.end(), listener) == list.end())
+    list.push_back(listener);
+}
+
+void
+Analyzer::unsubscribeInspector(InspectorId id, InspectorListener *listener)
+{
+  auto it = this->listeners.find(id);
+
+  if (it != this->listeners.end()) {
+    std::replace(it->second.begin(), it->second.end(), listener, nullptr);
+    this->listenersDirty = true;
+  }
+
+  this->sweepListeners();
+}
+
+void
+Analyzer::unsubscribeInspector(InspectorListener *listener)
+{
+  for (auto &p : this->listeners)
+    std::replace(p.second.begin(), p.second.end(), listener, nullptr);
+
+  this->listenersDirty = true;
+  this->sweepListeners();
+}
+
+// Listeners may unsubscribe (or subscribe others) from their own
+// callback, so the list is walked by index and nothing is erased
+// until the outermost delivery returns.
+template <class T>
+void
+Analyzer::dispatch(
+    InspectorId id,
+    T const &msg,
+    void (InspectorListener::*callback)(T const &))
+{
+  auto it = this->listeners.find(id);
+
+  if (it == this->listeners.end())
+    return;
+
+  auto &list = it->second;
+
+  ++this->dispatching;
+  for (size_t i = 0; i < list.size(); ++i)
+    if (list[i] != nullptr)
+      (list[i]->*callback)(msg);
+  --this->dispatching;
+
+  this->sweepListeners();
+}
+
+void
+Analyzer::sweepListeners()
+{
+  if (this->dispatching > 0 || !this->listenersDirty)
+    return;
+
+  for (auto it = this->listeners.begin(); it != this->listeners.end(); ) {
+    auto &list = it->second;
+
+    list.erase(std::remove(list.begin(), list.end(), nullptr), list.end());
+
+    if (list.empty())
+      it = this->listeners.erase(it);
+    else
+      ++it;
+  }
+
+  this->listenersDirty = false;
+}
+
 void
 Analyzer::open(
     std::string const &inspClass,
@@ -417,6 +809,8 @@ Analyzer::open(
   struct sigutils_channel c_ch =
       sigutils_channel_INITIALIZER;
 
+  this->flushPendingCommands();
+
   c_ch.fc   = SCAST(SUFREQ, ch.fc);
   c_ch.ft   = SCAST(SUFREQ, ch.ft);
   c_ch.f_lo = SCAST(SUFREQ, ch.fLow);
@@ -440,6 +834,8 @@ Analyzer::openPrecise(
   struct sigutils_channel c_ch =
       sigutils_channel_INITIALIZER;
 
+  this->flushPendingCommands();
+
   c_ch.fc   = SCAST(SUFREQ, ch.fc);
   c_ch.ft   = SCAST(SUFREQ, ch.ft);
   c_ch.f_lo = SCAST(SUFREQ, ch.fLow);
@@ -467,6 +863,8 @@ Analyzer::openEx(
   struct sigutils_channel c_ch =
       sigutils_channel_INITIALIZER;
 
+  this->flushPendingCommands();
+
   c_ch.fc   = SCAST(SUFREQ, ch.fc);
   c_ch.ft   = SCAST(SUFREQ, ch.ft);
   c_ch.f_lo = SCAST(SUFREQ, ch.fLow);
@@ -486,6 +884,8 @@ Analyzer::openEx(
 void
 Analyzer::setInspectorConfig(Handle handle, Config const &cfg, RequestId id)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_set_inspector_config_async(
           this->instance,
@@ -497,6 +897,8 @@ Analyzer::setInspectorConfig(Handle handle, Config const &cfg, RequestId id)
 void
 Analyzer::setInspectorId(Handle handle, InspectorId id, RequestId req_id)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_set_inspector_id_async(
           this->instance,
@@ -508,26 +910,32 @@ Analyzer::setInspectorId(Handle handle, InspectorId id, RequestId req_id)
 void
 Analyzer::setInspectorFreq(Handle handle, SUFREQ freq, RequestId)
 {
-  SU_ATTEMPT(
-        suscan_analyzer_set_inspector_freq_overridable(
-          this->instance,
-          handle,
-          freq));
+  PendingCommand cmd;
+
+  cmd.type   = COMMAND_INSPECTOR_FREQ;
+  cmd.handle = handle;
+  cmd.value  = freq;
+
+  this->enqueueCommand(cmd);
 }
 
 void
 Analyzer::setInspectorBandwidth(Handle handle, SUFREQ bw, RequestId)
 {
-  SU_ATTEMPT(
-        suscan_analyzer_set_inspector_bandwidth_overridable(
-          this->instance,
-          handle,
-          bw));
+  PendingCommand cmd;
+
+  cmd.type   = COMMAND_INSPECTOR_BANDWIDTH;
+  cmd.handle = handle;
+  cmd.value  = bw;
+
+  this->enqueueCommand(cmd);
 }
 
 void
 Analyzer::setInspectorWatermark(Handle handle, SUSCOUNT wm, RequestId req_id)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_set_inspector_watermark_async(
           this->instance,
@@ -539,6 +947,8 @@ Analyzer::setInspectorWatermark(Handle handle, SUSCOUNT wm, RequestId req_id)
 void
 Analyzer::setSpectrumSource(Handle handle, unsigned int src, RequestId id)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_inspector_set_spectrum_async(
           this->instance,
@@ -555,6 +965,8 @@ Analyzer::setInspectorEnabled(
     bool enabled,
     RequestId id)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_inspector_estimator_cmd_async(
           this->instance,
@@ -570,6 +982,8 @@ Analyzer::setInspectorDopplerCorrection(
     Orbit const &orbit,
     RequestId id)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_inspector_set_tle_async(
           this->instance,
@@ -583,6 +997,8 @@ Analyzer::disableDopplerCorrection(
     Handle handle,
     RequestId id)
 {
+  this->flushPendingCommands();
+
   SU_ATTEMPT(
         suscan_analyzer_inspector_set_tle_async(
           this->instance,
@@ -594,6 +1010,10 @@ Analyzer::disableDopplerCorrection(
 void
 Analyzer::closeInspector(Handle handle, RequestId id)
 {
+  // Retuning an inspector that is about to be closed makes no sense
+  this->dropCommands(handle);
+  this->flushPendingCommands();
+
   SU_ATTEMPT(suscan_analyzer_close_async(this->instance, handle, id));
 }
 
@@ -610,6 +1030,24 @@ Analyzer::Analyzer(AnalyzerParams &params, Source::Config const &config)
         config.instance,
         &mq.mq));
 
+  this->commandTimer = new QTimer(this);
+  this->commandTimer->setSingleShot(true);
+
+  connect(
+        this->commandTimer,
+        SIGNAL(timeout()),
+        this,
+        SLOT(onCommandTimeout()));
+
+  this->seekTimer = new QTimer(this);
+  this->seekTimer->setSingleShot(true);
+
+  connect(
+        this->seekTimer,
+        SIGNAL(timeout()),
+        this,
+        SLOT(onSeekTimeout()));
+
   this->asyncThread = new AsyncThread(this);
 
   connect(
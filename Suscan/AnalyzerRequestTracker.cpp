@@ -96,17 +96,116 @@ AnalyzerRequestTracker::requestOpen(
   return this->executeOpenRequest(request);
 }
 
+//
+// Opens one inspector per channel in a single go. Batch channels are never
+// precise: non-precise inspectors are all fed by the analyzer's
+// overlap-save channelizer, which computes a single forward FFT for the
+// whole capture. Every extra channel only adds its own (small) inverse FFT
+// and the copy of its output. Requests are sent back to back, without
+// waiting for the previous one to complete.
+//
+uint32_t
+AnalyzerRequestTracker::requestOpenBatch(
+    std::string const &inspClass,
+    std::vector<Channel> const &channels,
+    QVariant data,
+    Handle parent)
+{
+  uint32_t batchId;
+  Batch batch;
+
+  if (!g_registered) {
+    qRegisterMetaType<Suscan::AnalyzerRequest>();
+    g_registered = true;
+  }
+
+  if (m_analyzer == nullptr || channels.empty())
+    return 0;
+
+  if (++m_lastBatchId == 0)
+    ++m_lastBatchId;
+
+  batchId = m_lastBatchId;
+
+  for (unsigned i = 0; i < channels.size(); ++i) {
+    AnalyzerRequest request;
+
+    request.requestId   = m_analyzer->allocateRequestId();
+    request.inspectorId = m_analyzer->allocateInspectorId();
+    request.inspClass   = inspClass;
+    request.channel     = channels[i];
+    request.precise     = false;
+    request.parent      = parent;
+    request.data        = data;
+    request.batchId     = batchId;
+    request.batchIndex  = i;
+
+    if (this->executeOpenRequest(request)) {
+      ++batch.pending;
+    } else {
+      m_pendingRequests.remove(request.requestId);
+      ++batch.failed;
+    }
+  }
+
+  if (batch.pending == 0) {
+    emit batchCompleted(batchId, 0, batch.failed);
+    return 0;
+  }
+
+  m_batches[batchId] = batch;
+
+  return batchId;
+}
+
+void
+AnalyzerRequestTracker::resolveBatch(AnalyzerRequest const &req, bool ok)
+{
+  if (req.batchId == 0)
+    return;
+
+  auto it = m_batches.find(req.batchId);
+
+  if (it != m_batches.end()) {
+    if (ok)
+      ++it->opened;
+    else
+      ++it->failed;
+
+    if (--it->pending == 0) {
+      Batch batch = *it;
+      m_batches.erase(it);
+      emit batchCompleted(req.batchId, batch.opened, batch.failed);
+    }
+  }
+}
+
+void
+AnalyzerRequestTracker::failRequest(uint32_t requestId, std::string const &err)
+{
+  // Slots may issue new requests, do not keep iterators around
+  AnalyzerRequest req = m_pendingRequests[requestId];
+
+  m_pendingRequests.remove(requestId);
+
+  emit error(req, err);
+  resolveBatch(req, false);
+}
+
 void
 AnalyzerRequestTracker::cancelAll()
 {
-  for (auto &r : m_pendingRequests) {
+  auto requests = m_pendingRequests;
+
+  m_pendingRequests.clear();
+
+  for (auto &r : requests) {
     if (m_analyzer != nullptr && r.opened)
       m_analyzer->closeInspector(r.handle, r.requestId);
 
     emit cancelled(r);
+    resolveBatch(r, false);
   }
-
-  m_pendingRequests.clear();
 }
 
 void
@@ -150,30 +249,29 @@ AnalyzerRequestTracker::onInspectorMessage(
         this->executeSetInspectorId(*it);
         break;
 
-      case SUSCAN_ANALYZER_INSPECTOR_MSGKIND_SET_ID:
-        it->idSet = true;
-        emit opened(*it);
-        m_pendingRequests.remove(it->requestId);
+      case SUSCAN_ANALYZER_INSPECTOR_MSGKIND_SET_ID: {
+        AnalyzerRequest req = *it;
+        req.idSet = true;
+        m_pendingRequests.remove(req.requestId);
+        emit opened(req);
+        resolveBatch(req, true);
         break;
+      }
 
       case SUSCAN_ANALYZER_INSPECTOR_MSGKIND_INVALID_CHANNEL:
-        emit error(*it, "Invalid channel specification (invalid bandwidth / frequency)");
-        m_pendingRequests.remove(it->requestId);
+        failRequest(it->requestId, "Invalid channel specification (invalid bandwidth / frequency)");
         break;
 
       case SUSCAN_ANALYZER_INSPECTOR_MSGKIND_WRONG_HANDLE:
-        emit error(*it, "Wrong handle (server desync?)");
-        m_pendingRequests.remove(it->requestId);
+        failRequest(it->requestId, "Wrong handle (server desync?)");
         break;
 
       case SUSCAN_ANALYZER_INSPECTOR_MSGKIND_WRONG_OBJECT:
-        emit error(*it, "Wrong object");
-        m_pendingRequests.remove(it->requestId);
+        failRequest(it->requestId, "Wrong object");
         break;
 
       case SUSCAN_ANALYZER_INSPECTOR_MSGKIND_WRONG_KIND:
-        emit error(*it, "Invalid message kind");
-        m_pendingRequests.remove(it->requestId);
+        failRequest(it->requestId, "Invalid message kind");
         break;
 
       default:
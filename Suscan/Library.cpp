@@ -109,6 +109,7 @@ Singleton::Singleton()
   this->estimators_initd = false;
   this->spectrum_sources_initd = false;
   this->inspectors_initd = false;
+  this->plugins_initd = false;
 
   this->backgroundTaskController = new MultitaskController;
 
@@ -485,6 +486,10 @@ Singleton::init_plugins()
   Plugin *defPlug = Plugin::getDefaultPlugin();
   QStringList plugins;
 
+  // Plugins are shared by all the sessions of this process
+  if (this->plugins_initd)
+    return;
+
   if (!defPlug->load())
     throw Exception(
         "Failed to load the default plugin. "
@@ -517,6 +522,8 @@ Singleton::init_plugins()
       }
     }
   }
+
+  this->plugins_initd = true;
 }
 
 void
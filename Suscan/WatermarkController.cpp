@@ -0,0 +1,271 @@
+//
+//    WatermarkController.cpp: Adaptive inspector watermark
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include <Suscan/WatermarkController.h>
+#include <cmath>
+
+using namespace Suscan;
+
+WatermarkPolicy
+WatermarkPolicy::fromProfile(WatermarkProfile profile)
+{
+  WatermarkPolicy policy;
+
+  switch (profile) {
+    case WATERMARK_PROFILE_AUDIO:
+      policy.minLatency = 5e-3;
+      policy.maxLatency = 100e-3;
+      policy.maxMsgRate = 100;
+      break;
+
+    case WATERMARK_PROFILE_CONSTELLATION:
+      policy.minLatency = 10e-3;
+      policy.maxLatency = 100e-3;
+      policy.maxMsgRate = 60;
+      break;
+
+    case WATERMARK_PROFILE_RECORDING:
+      policy.minLatency = 50e-3;
+      policy.maxLatency = 1;
+      policy.maxMsgRate = 20;
+      break;
+
+    case WATERMARK_PROFILE_FORWARDING:
+      policy.minLatency = 1e-3;
+      policy.maxLatency = 50e-3;
+      policy.maxMsgRate = 500;
+      break;
+  }
+
+  return policy;
+}
+
+WatermarkController::WatermarkController(QObject *parent) : QObject(parent)
+{
+}
+
+WatermarkController::~WatermarkController()
+{
+}
+
+SUSCOUNT
+WatermarkController::clamp(qreal wm) const
+{
+  qreal rate = m_rateHint > 0 ? m_rateHint : m_rate;
+
+  if (rate > 0)
+    wm = qBound(
+          m_policy.minLatency * rate,
+          wm,
+          m_policy.maxLatency * rate);
+
+  return wm < 1 ? 1 : static_cast<SUSCOUNT>(std::round(wm));
+}
+
+void
+WatermarkController::apply(SUSCOUNT wm)
+{
+  if (m_analyzer == nullptr || m_handle == -1)
+    return;
+
+  try {
+    m_analyzer->setInspectorWatermark(m_handle, wm);
+    m_watermark = wm;
+    emit watermarkChanged(m_watermark, getLatency());
+  } catch (Suscan::Exception const &) {
+    // Analyzer is probably going away. Keep the previous value.
+  }
+}
+
+void
+WatermarkController::evaluate()
+{
+  qreal wall = 1e-9 * static_cast<qreal>(m_window.nsecsElapsed());
+  qreal rate, load, msgRate, current, next;
+  bool backlog;
+
+  if (m_messages > 0 && wall > 0) {
+    rate    = static_cast<qreal>(m_samples) / wall;
+    load    = 1e-9 * static_cast<qreal>(m_busyNs) / wall;
+    msgRate = m_messages / wall;
+
+    // More samples than the source can produce: messages were queued.
+    // Without a nominal rate, compare against what we measured so far.
+    if (m_rateHint > 0)
+      backlog = rate > SUSCAN_WATERMARK_BACKLOG_RATIO * m_rateHint;
+    else
+      backlog = m_rate > 0 && rate > SUSCAN_WATERMARK_BACKLOG_RATIO * m_rate;
+
+    // A genuine rate change looks like a backlog for a couple of
+    // windows, until the average catches up.
+    if (m_rate <= 0)
+      m_rate = rate;
+    else
+      m_rate += SUSCAN_WATERMARK_RATE_ALPHA * (rate - m_rate);
+
+    // If no watermark was set yet, the analyzer default is whatever the
+    // batches look like
+    current = m_watermark > 0
+        ? static_cast<qreal>(m_watermark)
+        : static_cast<qreal>(m_samples) / m_messages;
+    next    = current;
+
+    if (load > SUSCAN_WATERMARK_HIGH_LOAD || backlog)
+      next = 2 * current;
+    else if (msgRate > m_policy.maxMsgRate)
+      next = current * msgRate / m_policy.maxMsgRate;
+    else if (load < SUSCAN_WATERMARK_LOW_LOAD
+             && msgRate < .5 * m_policy.maxMsgRate)
+      next = .75 * current;
+
+    SUSCOUNT wm = clamp(next);
+
+    if (m_watermark == 0
+        || std::fabs(static_cast<qreal>(wm) - m_watermark)
+           > SUSCAN_WATERMARK_HYSTERESIS * m_watermark)
+      apply(wm);
+  }
+
+  m_busyNs   = 0;
+  m_messages = 0;
+  m_samples  = 0;
+  m_window.restart();
+}
+
+void
+WatermarkController::setAnalyzer(Analyzer *analyzer)
+{
+  m_analyzer = analyzer;
+
+  if (analyzer == nullptr)
+    m_handle = -1;
+}
+
+void
+WatermarkController::setInspector(Handle handle, qreal rateHint, SUSCOUNT initial)
+{
+  m_handle    = handle;
+  m_rateHint  = rateHint;
+  m_rate      = 0;
+  m_watermark = 0;
+
+  reset();
+
+  if (initial > 0)
+    apply(clamp(initial));
+}
+
+void
+WatermarkController::setRateHint(qreal rate)
+{
+  qreal prev = m_rateHint > 0 ? m_rateHint : m_rate;
+
+  m_rateHint = rate;
+  m_rate     = 0;
+
+  reset();
+
+  // Keep the same latency at the new rate
+  if (m_watermark > 0 && prev > 0 && rate > 0)
+    apply(clamp(m_watermark * rate / prev));
+}
+
+void
+WatermarkController::setProfile(WatermarkProfile profile)
+{
+  setPolicy(WatermarkPolicy::fromProfile(profile));
+}
+
+void
+WatermarkController::setPolicy(WatermarkPolicy const &policy)
+{
+  m_policy = policy;
+
+  if (m_watermark > 0) {
+    SUSCOUNT wm = clamp(m_watermark);
+    if (wm != m_watermark)
+      apply(wm);
+  }
+}
+
+void
+WatermarkController::setLatencyBounds(qreal min, qreal max)
+{
+  WatermarkPolicy policy = m_policy;
+
+  policy.minLatency = min;
+  policy.maxLatency = max < min ? min : max;
+
+  setPolicy(policy);
+}
+
+void
+WatermarkController::reset()
+{
+  m_busyNs   = 0;
+  m_messages = 0;
+  m_samples  = 0;
+  m_window.invalidate();
+}
+
+void
+WatermarkController::beginBatch()
+{
+  if (!m_window.isValid())
+    m_window.start();
+
+  m_batch.start();
+}
+
+void
+WatermarkController::endBatch(SUSCOUNT count)
+{
+  if (!m_batch.isValid())
+    return;
+
+  m_busyNs += m_batch.nsecsElapsed();
+  m_samples += count;
+  ++m_messages;
+
+  if (m_handle != -1
+      && m_window.elapsed() >= SUSCAN_WATERMARK_EVAL_INTERVAL_MS)
+    evaluate();
+}
+
+WatermarkPolicy const &
+WatermarkController::getPolicy() const
+{
+  return m_policy;
+}
+
+SUSCOUNT
+WatermarkController::getWatermark() const
+{
+  return m_watermark;
+}
+
+qreal
+WatermarkController::getLatency() const
+{
+  qreal rate = m_rateHint > 0 ? m_rateHint : m_rate;
+
+  if (rate <= 0 || m_watermark == 0)
+    return 0;
+
+  return static_cast<qreal>(m_watermark) / rate;
+}
@@ -17,6 +17,7 @@
 //    <http://www.gnu.org/licenses/>
 //
 #include "CarrierDetector.h"
+#include "ArenaAllocator.h"
 #include <sigutils/taps.h>
 
 using namespace SigDigger;
@@ -43,7 +44,7 @@ CarrierDetector::~CarrierDetector()
     SU_FFTW(_destroy_plan)(this->plan);
 
   if (this->buffer != nullptr)
-    SU_FFTW(_free)(this->buffer);
+    Arena::instance().release(this->buffer);
 }
 
 bool
@@ -56,7 +57,7 @@ CarrierDetector::work(void)
         this->allocation <<= 1;
 
       if ((this->buffer = static_cast<SU_FFTW(_complex) *>(
-             SU_FFTW(_malloc)(this->allocation * sizeof(SUCOMPLEX)))) == nullptr) {
+             Arena::instance().allocate(this->allocation * sizeof(SUCOMPLEX)))) == nullptr) {
         emit error(
               "Failed to allocate "
               + QString::number(this->allocation)
@@ -0,0 +1,458 @@
+//
+//    Tasks/CycloSpectrumTask.cpp: Spectral correlation by FFT accumulation
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include <CycloSpectrumTask.h>
+#include <Suscan/Library.h>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#define SIGDIGGER_CYCLO_PEAK_NEIGHBORHOOD 4
+
+using namespace SigDigger;
+
+struct CycloSpectrumTask::Worker {
+  SU_FFTW(_complex)   *buffer = nullptr;
+  std::vector<SUFLOAT> map;
+  std::vector<SUFLOAT> profile;
+};
+
+CycloSpectrumTask::CycloSpectrumTask(
+    const SUCOMPLEX *data,
+    size_t length,
+    qreal fs,
+    unsigned int channels,
+    bool conjugate,
+    QObject *parent) : CancellableTask(parent)
+{
+  size_t total;
+
+  m_data      = data;
+  m_length    = length;
+  m_fs        = fs;
+  m_conjugate = conjugate;
+
+  if (channels < 8 || (channels & (channels - 1)) != 0)
+    throw Suscan::Exception("Number of channels must be a power of 2");
+
+  m_channels = channels;
+  m_hop      = channels / 4;
+
+  total = length < channels ? 0 : (length - channels) / m_hop + 1;
+
+  if (total < SIGDIGGER_CYCLO_MIN_FRAMES)
+    throw Suscan::Exception(
+        "Selection is too short for this frequency resolution");
+
+  // Frames per block: the largest power of 2 that fits in the capture
+  m_frames = SIGDIGGER_CYCLO_MAX_FRAMES;
+  while (m_frames > total)
+    m_frames >>= 1;
+
+  m_blocks  = static_cast<unsigned int>(total / m_frames);
+  m_mapRows = 2 * m_channels;
+
+  this->setProgress(0);
+  this->setStatus("Estimating best FFT plans");
+}
+
+CycloSpectrumTask::~CycloSpectrumTask()
+{
+  for (auto p : m_workers) {
+    if (p->buffer != nullptr)
+      Arena::instance().release(p->buffer);
+    delete p;
+  }
+
+  if (m_chanPlan != nullptr)
+    SU_FFTW(_destroy_plan)(m_chanPlan);
+
+  if (m_corrPlan != nullptr)
+    SU_FFTW(_destroy_plan)(m_corrPlan);
+
+  if (m_chanBuf != nullptr)
+    Arena::instance().release(m_chanBuf);
+
+  if (m_corrBuf != nullptr)
+    Arena::instance().release(m_corrBuf);
+}
+
+bool
+CycloSpectrumTask::plan(void)
+{
+  unsigned int threads = static_cast<unsigned int>(
+        std::max(1, QThread::idealThreadCount()));
+  qint64 perChan = m_frames / 4;
+  qint64 half = perChan / 2;
+
+  m_chanBuf = static_cast<SU_FFTW(_complex) *>(
+        Arena::instance().allocate(m_channels * sizeof(SU_FFTW(_complex))));
+  m_corrBuf = static_cast<SU_FFTW(_complex) *>(
+        Arena::instance().allocate(m_frames * sizeof(SU_FFTW(_complex))));
+
+  if (m_chanBuf == nullptr || m_corrBuf == nullptr) {
+    emit error("Failed to allocate FFT buffers");
+    return false;
+  }
+
+  // Plans are created here, once. Workers only run them on their own
+  // buffers through the new-array interface, which is thread-safe.
+  m_chanPlan = SU_FFTW(_plan_dft_1d)(
+        static_cast<int>(m_channels),
+        m_chanBuf,
+        m_chanBuf,
+        FFTW_FORWARD,
+        FFTW_ESTIMATE);
+
+  m_corrPlan = SU_FFTW(_plan_dft_1d)(
+        static_cast<int>(m_frames),
+        m_corrBuf,
+        m_corrBuf,
+        FFTW_FORWARD,
+        FFTW_ESTIMATE);
+
+  if (m_chanPlan == nullptr || m_corrPlan == nullptr) {
+    emit error("Failed to initialize FFT plans");
+    return false;
+  }
+
+  // Normalized Hamming window
+  m_window.resize(m_channels);
+  SUFLOAT norm = 0;
+  for (unsigned int i = 0; i < m_channels; ++i) {
+    m_window[i] = SU_ASFLOAT(
+          .54 - .46 * cos(2 * M_PI * i / (m_channels - 1)));
+    norm += m_window[i] * m_window[i];
+  }
+
+  for (auto &w : m_window)
+    w /= SU_SQRT(norm);
+
+  // Cycle frequencies are indexed in units of fs / (frames * hop). Each
+  // channel pair contributes the central quarter of its correlation FFT.
+  if (m_conjugate) {
+    m_alphaMin   = -static_cast<qint64>(m_channels) * perChan - half;
+    m_alphaCount = (static_cast<qint64>(m_channels) - 2) * perChan + half
+        - m_alphaMin;
+  } else {
+    m_alphaMin   = 0;
+    m_alphaCount = (static_cast<qint64>(m_channels) - 1) * perChan + half;
+  }
+
+  m_demod.resize(static_cast<size_t>(m_frames) * m_channels);
+  m_map.assign(static_cast<size_t>(m_mapRows) * m_mapCols, 0);
+  m_profile.assign(static_cast<size_t>(m_alphaCount), 0);
+
+  for (unsigned int i = 0; i < threads; ++i) {
+    Worker *w = new Worker;
+    m_workers.push_back(w);
+
+    w->buffer = static_cast<SU_FFTW(_complex) *>(
+          Arena::instance().allocate(m_frames * sizeof(SU_FFTW(_complex))));
+
+    if (w->buffer == nullptr) {
+      emit error("Failed to allocate correlation buffers");
+      return false;
+    }
+
+    w->map.resize(m_map.size());
+    w->profile.resize(m_profile.size());
+  }
+
+  return true;
+}
+
+void
+CycloSpectrumTask::channelize(unsigned int block)
+{
+  SUCOMPLEX *buf = reinterpret_cast<SUCOMPLEX *>(m_chanBuf);
+  const SUCOMPLEX *frame =
+      m_data + static_cast<size_t>(block) * m_frames * m_hop;
+  int halfChan = static_cast<int>(m_channels / 2);
+
+  for (unsigned int n = 0; n < m_frames; ++n) {
+    SUCOMPLEX *row = m_demod.data() + static_cast<size_t>(n) * m_channels;
+
+    for (unsigned int i = 0; i < m_channels; ++i)
+      buf[i] = m_window[i] * frame[i];
+
+    SU_FFTW(_execute)(m_chanPlan);
+
+    // Store channels in ascending frequency order, and take them to
+    // baseband so that pair products only keep the residual cycle
+    // frequency.
+    for (int k = -halfChan; k < halfChan; ++k) {
+      SUFLOAT phase = SU_ASFLOAT(
+            -2 * M_PI * k * static_cast<qreal>(n * m_hop) / m_channels);
+      row[k + halfChan] =
+          buf[(k + static_cast<int>(m_channels)) % m_channels]
+          * SU_C_EXP(SU_I * phase);
+    }
+
+    frame += m_hop;
+  }
+}
+
+void
+CycloSpectrumTask::correlate(Worker *worker, unsigned int row)
+{
+  SUCOMPLEX *buf = reinterpret_cast<SUCOMPLEX *>(worker->buffer);
+  const SUCOMPLEX *demod = m_demod.data();
+  int halfChan = static_cast<int>(m_channels / 2);
+  qint64 perChan = m_frames / 4;
+  qint64 half = perChan / 2;
+  int k1 = static_cast<int>(row) - halfChan;
+  SUFLOAT scale = 1.f / m_frames;
+
+  for (int k2 = -halfChan; k2 <= k1; ++k2) {
+    const SUCOMPLEX *a = demod + k1 + halfChan;
+    const SUCOMPLEX *b = demod + k2 + halfChan;
+    qint64 base;
+    int freq2;
+
+    if (m_conjugate) {
+      for (unsigned int n = 0; n < m_frames; ++n)
+        buf[n] = a[n * m_channels] * b[n * m_channels];
+      base  = k1 + k2;
+      freq2 = k1 - k2;
+    } else {
+      for (unsigned int n = 0; n < m_frames; ++n)
+        buf[n] = a[n * m_channels] * SU_C_CONJ(b[n * m_channels]);
+      base  = k1 - k2;
+      freq2 = k1 + k2;
+    }
+
+    SU_FFTW(_execute_dft)(m_corrPlan, worker->buffer, worker->buffer);
+
+    size_t mapRow = static_cast<size_t>(
+          std::min(
+            std::max(freq2 + static_cast<int>(m_channels), 0),
+            static_cast<int>(m_mapRows) - 1));
+    SUFLOAT *mapLine = worker->map.data() + mapRow * m_mapCols;
+
+    for (qint64 q = -half; q < half; ++q) {
+      qint64 index = base * perChan + q - m_alphaMin;
+
+      if (index < 0 || index >= m_alphaCount)
+        continue;
+
+      SUFLOAT val = SU_C_ABS(buf[(q + m_frames) % m_frames]) * scale;
+      size_t col = static_cast<size_t>(index * m_mapCols / m_alphaCount);
+
+      if (val > worker->profile[static_cast<size_t>(index)])
+        worker->profile[static_cast<size_t>(index)] = val;
+
+      if (val > mapLine[col])
+        mapLine[col] = val;
+    }
+  }
+}
+
+void
+CycloSpectrumTask::runBlock(void)
+{
+  std::atomic<unsigned int> next(0);
+  std::vector<std::thread> threads;
+
+  channelize(m_block);
+
+  auto loop = [this, &next] (Worker *w) {
+    unsigned int row;
+
+    std::fill(w->map.begin(), w->map.end(), 0);
+    std::fill(w->profile.begin(), w->profile.end(), 0);
+
+    // Rows have different lengths, hand them out one by one
+    while ((row = next++) < m_channels)
+      correlate(w, row);
+  };
+
+  for (size_t i = 1; i < m_workers.size(); ++i)
+    threads.emplace_back(loop, m_workers[i]);
+
+  loop(m_workers[0]);
+
+  for (auto &t : threads)
+    t.join();
+
+  // Each worker holds the maximum of the cells it touched. Merge them,
+  // and accumulate the block into the average.
+  for (size_t i = 0; i < m_map.size(); ++i) {
+    SUFLOAT max = 0;
+    for (auto w : m_workers)
+      max = std::max(max, w->map[i]);
+    m_map[i] += max / m_blocks;
+  }
+
+  for (size_t i = 0; i < m_profile.size(); ++i) {
+    SUFLOAT max = 0;
+    for (auto w : m_workers)
+      max = std::max(max, w->profile[i]);
+    m_profile[i] += max / m_blocks;
+  }
+}
+
+void
+CycloSpectrumTask::pickPeaks(void)
+{
+  std::vector<SUFLOAT> sorted;
+  std::vector<size_t> candidates;
+  qint64 w = SIGDIGGER_CYCLO_PEAK_NEIGHBORHOOD;
+  qint64 start = w;
+  SUFLOAT median;
+
+  // Non-conjugate correlation near alpha = 0 is just the power spectrum
+  if (!m_conjugate)
+    start = std::max<qint64>(w, m_frames / 8);
+
+  if (m_alphaCount <= start + w)
+    return;
+
+  sorted.assign(m_profile.begin() + start, m_profile.end());
+  std::nth_element(
+        sorted.begin(),
+        sorted.begin() + static_cast<qint64>(sorted.size()) / 2,
+        sorted.end());
+  median = sorted[sorted.size() / 2];
+
+  if (median <= 0)
+    median = std::numeric_limits<SUFLOAT>::min();
+
+  for (qint64 i = start; i < m_alphaCount - w; ++i) {
+    SUFLOAT v = m_profile[static_cast<size_t>(i)];
+    bool isMax = v > median;
+
+    // On plateaus, keep the leftmost point only
+    for (qint64 j = i - w; isMax && j < i; ++j)
+      isMax = m_profile[static_cast<size_t>(j)] < v;
+
+    for (qint64 j = i + 1; isMax && j <= i + w; ++j)
+      isMax = m_profile[static_cast<size_t>(j)] <= v;
+
+    if (isMax)
+      candidates.push_back(static_cast<size_t>(i));
+  }
+
+  std::sort(
+        candidates.begin(),
+        candidates.end(),
+        [this] (size_t a, size_t b) {
+          return m_profile[a] > m_profile[b];
+        });
+
+  if (candidates.size() > SIGDIGGER_CYCLO_MAX_PEAKS)
+    candidates.resize(SIGDIGGER_CYCLO_MAX_PEAKS);
+
+  for (auto i : candidates) {
+    // Parabolic interpolation of the peak position
+    SUFLOAT y0 = m_profile[i - 1];
+    SUFLOAT y1 = m_profile[i];
+    SUFLOAT y2 = m_profile[i + 1];
+    SUFLOAT den = y0 - 2 * y1 + y2;
+    qreal delta = den < 0 ? .5 * (y0 - y2) / den : 0;
+    CycloPeak peak;
+
+    peak.alpha    = (m_alphaMin + static_cast<qint64>(i) + delta) * alphaStep();
+    peak.strength = 10 * log10(static_cast<qreal>(y1 / median));
+
+    m_peaks.push_back(peak);
+  }
+}
+
+bool
+CycloSpectrumTask::work(void)
+{
+  switch (m_state) {
+    case PLANNING:
+      if (!plan())
+        return false;
+
+      m_state = CORRELATING;
+      break;
+
+    case CORRELATING:
+      this->setStatus(
+            "Correlating block "
+            + QString::number(m_block + 1)
+            + "/"
+            + QString::number(m_blocks));
+
+      runBlock();
+      ++m_block;
+
+      this->setProgress(static_cast<qreal>(m_block) / m_blocks);
+
+      if (m_block == m_blocks) {
+        this->setStatus("Looking for cyclic features");
+        m_state = PICKING;
+      }
+      break;
+
+    case PICKING:
+      pickPeaks();
+      emit done();
+      return false;
+  }
+
+  return true;
+}
+
+void
+CycloSpectrumTask::cancel(void)
+{
+  emit cancelled();
+}
+
+qreal
+CycloSpectrumTask::alphaStep(void) const
+{
+  return m_fs / (static_cast<qreal>(m_frames) * m_hop);
+}
+
+qreal
+CycloSpectrumTask::alphaMin(void) const
+{
+  return m_alphaMin * alphaStep();
+}
+
+qreal
+CycloSpectrumTask::alphaMax(void) const
+{
+  return (m_alphaMin + m_alphaCount) * alphaStep();
+}
+
+std::vector<SUFLOAT> &&
+CycloSpectrumTask::takeMap(void)
+{
+  return std::move(m_map);
+}
+
+std::vector<SUFLOAT> &&
+CycloSpectrumTask::takeProfile(void)
+{
+  return std::move(m_profile);
+}
+
+std::vector<CycloPeak> const &
+CycloSpectrumTask::getPeaks(void) const
+{
+  return m_peaks;
+}
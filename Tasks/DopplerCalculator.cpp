@@ -17,6 +17,7 @@
 //    <http://www.gnu.org/licenses/>
 //
 #include "DopplerCalculator.h"
+#include "ArenaAllocator.h"
 #include <sigutils/taps.h>
 #include <sigutils/sampling.h>
 
@@ -46,7 +47,7 @@ DopplerCalculator::~DopplerCalculator()
     SU_FFTW(_destroy_plan)(this->plan);
 
   if (this->buffer != nullptr)
-    SU_FFTW(_free)(this->buffer);
+    Arena::instance().release(this->buffer);
 }
 
 bool
@@ -61,7 +62,7 @@ DopplerCalculator::work(void)
       this->psd.resize(this->allocation);
 
       if ((this->buffer = static_cast<SU_FFTW(_complex) *>(
-             SU_FFTW(_malloc)(this->allocation * sizeof(SUCOMPLEX)))) == nullptr) {
+             Arena::instance().allocate(this->allocation * sizeof(SUCOMPLEX)))) == nullptr) {
         emit error(
               "Failed to allocate "
               + QString::number(this->allocation)
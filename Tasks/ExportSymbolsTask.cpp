@@ -0,0 +1,417 @@
+//
+//    Tasks/ExportSymbolsTask.cpp: Export symbol captures in the background
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+
+#include <ExportSymbolsTask.h>
+#include <QCoreApplication>
+#include <QImage>
+#include <cstring>
+
+using namespace SigDigger;
+
+#define SIGDIGGER_EXPORT_SYMBOLS_BREATHE_INTERVAL_MS 100
+#define SIGDIGGER_EXPORT_SYMBOLS_BREATHE_BLOCK_SIZE  0x10000
+#define SIGDIGGER_EXPORT_SYMBOLS_C_ARRAY_COLUMNS     16
+
+void
+ExportSymbolsTask::breathe(quint64 i)
+{
+  size_t size = m_data.size();
+
+  if (m_timer.elapsed() > SIGDIGGER_EXPORT_SYMBOLS_BREATHE_INTERVAL_MS) {
+    m_timer.restart();
+    emit progress(
+        static_cast<qreal>(i) / static_cast<qreal>(size > 1 ? size - 1 : 1),
+        "Saving symbols");
+    QCoreApplication::processEvents();
+  }
+}
+
+QRgb
+ExportSymbolsTask::symbolToRgb(Symbol sym) const
+{
+  unsigned int max = (1u << m_bps) - 1;
+  qreal t = max > 0 ? static_cast<qreal>(sym) / max : 0;
+
+  return qRgb(
+        static_cast<int>(m_lo.red()   + t * (m_hi.red()   - m_lo.red())),
+        static_cast<int>(m_lo.green() + t * (m_hi.green() - m_lo.green())),
+        static_cast<int>(m_lo.blue()  + t * (m_hi.blue()  - m_lo.blue())));
+}
+
+bool
+ExportSymbolsTask::exportToText()
+{
+  static const char hexDigits[] = "0123456789abcdef";
+  size_t size = m_data.size();
+  std::string line;
+
+  line.reserve(4 * m_stride + 1);
+
+  for (size_t i = 0; !m_cancelFlag && i < size; i += m_stride) {
+    size_t end = std::min(i + m_stride, size);
+
+    line.clear();
+
+    if (m_bps <= 4) {
+      for (size_t j = i; j < end; ++j)
+        line += hexDigits[m_data[j] & 0xf];
+    } else {
+      for (size_t j = i; j < end; ++j) {
+        if (j > i)
+          line += ' ';
+        line += std::to_string(static_cast<unsigned>(m_data[j]));
+      }
+    }
+
+    line += '\n';
+    m_of.write(line.data(), static_cast<std::streamsize>(line.size()));
+
+    breathe(i);
+  }
+
+  return m_of.good();
+}
+
+bool
+ExportSymbolsTask::exportToRaw()
+{
+  size_t size = m_data.size();
+  std::vector<uint8_t> block;
+  unsigned int acc = 0;
+  unsigned int bits = 0;
+
+  block.reserve(SIGDIGGER_EXPORT_SYMBOLS_BREATHE_BLOCK_SIZE);
+
+  // Symbols are packed MSB first, bps bits each
+  for (size_t i = 0; !m_cancelFlag && i < size; ++i) {
+    acc   = (acc << m_bps) | (m_data[i] & ((1u << m_bps) - 1));
+    bits += m_bps;
+
+    while (bits >= 8) {
+      bits -= 8;
+      block.push_back(static_cast<uint8_t>(acc >> bits));
+    }
+
+    acc &= (1u << bits) - 1;
+
+    if (block.size() >= SIGDIGGER_EXPORT_SYMBOLS_BREATHE_BLOCK_SIZE) {
+      m_of.write(
+            reinterpret_cast<const char *>(block.data()),
+            static_cast<std::streamsize>(block.size()));
+      block.clear();
+      breathe(i);
+    }
+  }
+
+  if (bits > 0)
+    block.push_back(static_cast<uint8_t>(acc << (8 - bits)));
+
+  if (!block.empty())
+    m_of.write(
+          reinterpret_cast<const char *>(block.data()),
+          static_cast<std::streamsize>(block.size()));
+
+  return m_of.good();
+}
+
+bool
+ExportSymbolsTask::exportToCArray()
+{
+  size_t size = m_data.size();
+  char item[8];
+
+  m_of << "/*\n";
+  m_of << " * Symbol capture generated by SigDigger\n";
+  m_of << " * Bits per symbol: " << m_bps << "\n";
+  m_of << " */\n\n";
+  m_of << "#include <stdint.h>\n\n";
+  m_of << "const uint8_t symbols[" << size << "] = {";
+
+  for (size_t i = 0; !m_cancelFlag && i < size; ++i) {
+    if (i % SIGDIGGER_EXPORT_SYMBOLS_C_ARRAY_COLUMNS == 0)
+      m_of << "\n  ";
+
+    snprintf(
+          item,
+          sizeof(item),
+          i + 1 < size ? "0x%02x, " : "0x%02x",
+          static_cast<unsigned>(m_data[i]));
+    m_of << item;
+
+    if (i % SIGDIGGER_EXPORT_SYMBOLS_BREATHE_BLOCK_SIZE == 0)
+      breathe(i);
+  }
+
+  m_of << "\n};\n";
+
+  return m_of.good();
+}
+
+bool
+ExportSymbolsTask::exportToPPM()
+{
+  size_t size = m_data.size();
+  size_t rows = (size + m_stride - 1) / m_stride;
+  std::vector<uint8_t> row(3 * m_stride);
+
+  m_of << "P6\n" << m_stride << " " << rows << "\n255\n";
+
+  for (size_t i = 0; !m_cancelFlag && i < size; i += m_stride) {
+    size_t len = std::min<size_t>(m_stride, size - i);
+
+    for (size_t j = 0; j < m_stride; ++j) {
+      QRgb rgb = j < len ? symbolToRgb(m_data[i + j]) : qRgb(0, 0, 0);
+      row[3 * j + 0] = static_cast<uint8_t>(qRed(rgb));
+      row[3 * j + 1] = static_cast<uint8_t>(qGreen(rgb));
+      row[3 * j + 2] = static_cast<uint8_t>(qBlue(rgb));
+    }
+
+    m_of.write(
+          reinterpret_cast<const char *>(row.data()),
+          static_cast<std::streamsize>(row.size()));
+
+    breathe(i);
+  }
+
+  return m_of.good();
+}
+
+bool
+ExportSymbolsTask::exportToImage(const char *format)
+{
+  size_t size = m_data.size();
+  int rows = static_cast<int>((size + m_stride - 1) / m_stride);
+
+  if (size == 0) {
+    emit error("No symbols to save to " + m_path);
+    return false;
+  }
+
+  QImage image(static_cast<int>(m_stride), rows, QImage::Format_RGB32);
+
+  if (image.isNull()) {
+    emit error(
+        "Cannot allocate image for "
+        + m_path
+        + ": symbol capture is too big for this format");
+    return false;
+  }
+
+  image.fill(Qt::black);
+
+  for (int r = 0; !m_cancelFlag && r < rows; ++r) {
+    QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(r));
+    size_t p = static_cast<size_t>(r) * m_stride;
+    size_t len = std::min<size_t>(m_stride, size - p);
+
+    for (size_t j = 0; j < len; ++j)
+      line[j] = symbolToRgb(m_data[p + j]);
+
+    breathe(p);
+  }
+
+  if (m_cancelFlag)
+    return true;
+
+  emit progress(1, "Encoding image");
+
+  if (!image.save(m_path, format)) {
+    emit error("Cannot save symbols to " + m_path);
+    return false;
+  }
+
+  return true;
+}
+
+bool
+ExportSymbolsTask::work()
+{
+  bool ok = false;
+
+  m_timer.start();
+
+  switch (m_format) {
+    case SymView::FILE_FORMAT_TEXT:
+      ok = exportToText();
+      break;
+
+    case SymView::FILE_FORMAT_RAW:
+      ok = exportToRaw();
+      break;
+
+    case SymView::FILE_FORMAT_C_ARRAY:
+      ok = exportToCArray();
+      break;
+
+    case SymView::FILE_FORMAT_PPM:
+      ok = exportToPPM();
+      break;
+
+    case SymView::FILE_FORMAT_BMP:
+      ok = exportToImage("BMP");
+      break;
+
+    case SymView::FILE_FORMAT_PNG:
+      ok = exportToImage("PNG");
+      break;
+
+    case SymView::FILE_FORMAT_JPEG:
+      ok = exportToImage("JPG");
+      break;
+  }
+
+  if (m_of.is_open()) {
+    m_of.close();
+    if (!m_of.good()) {
+      emit error(
+          "Failed to write symbols to "
+          + m_path
+          + ". Please verify if permission and disk space allow this "
+            "operation.");
+      return false;
+    }
+  }
+
+  if (ok) {
+    if (m_cancelFlag)
+      emit cancelled();
+    else
+      emit done();
+  }
+
+  return false;
+}
+
+void
+ExportSymbolsTask::cancel()
+{
+  m_cancelFlag = true;
+}
+
+QString
+ExportSymbolsTask::getLastError() const
+{
+  return m_lastError;
+}
+
+bool
+ExportSymbolsTask::openStream()
+{
+  m_of = std::ofstream(m_path.toStdString().c_str(), std::ofstream::binary);
+
+  if (!m_of.is_open()) {
+    m_lastError =
+        "Cannot open "
+        + m_path
+        + ": "
+        + QString(strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+bool
+ExportSymbolsTask::attemptOpen()
+{
+  if (m_stride == 0) {
+    m_lastError = "Invalid row width for symbol export";
+    return false;
+  }
+
+  switch (m_format) {
+    case SymView::FILE_FORMAT_TEXT:
+    case SymView::FILE_FORMAT_RAW:
+    case SymView::FILE_FORMAT_C_ARRAY:
+    case SymView::FILE_FORMAT_PPM:
+      return openStream();
+
+    default:
+      // QImage opens the file by itself once the image has been rendered
+      return true;
+  }
+}
+
+ExportSymbolsTask::~ExportSymbolsTask()
+{
+}
+
+ExportSymbolsTask::ExportSymbolsTask(
+    QString const &path,
+    SymView::FileFormat format,
+    SymbolSnapshot const &data,
+    unsigned int bps,
+    unsigned int stride,
+    QColor const &lo,
+    QColor const &hi)
+{
+  m_path   = path;
+  m_format = format;
+  m_bps    = bps < 1 ? 1 : (bps > 8 ? 8 : bps);
+  m_stride = stride;
+  m_lo     = lo;
+  m_hi     = hi;
+
+  m_data   = data;
+  setDataSize(m_data.size());
+}
+
+///////////////////////////////// SymbolStore //////////////////////////////////
+void
+SymbolStore::append(const Symbol *data, size_t length)
+{
+  std::vector<SymbolChunk> &chunks = m_symbols.m_chunks;
+
+  while (length > 0) {
+    size_t room, piece;
+
+    if (chunks.empty()
+        || chunks.back()->size() == SIGDIGGER_SYMBOL_STORE_CHUNK) {
+      chunks.push_back(std::make_shared<std::vector<Symbol>>());
+      chunks.back()->reserve(SIGDIGGER_SYMBOL_STORE_CHUNK);
+    } else if (chunks.back().use_count() > 1) {
+      // A snapshot still reads this chunk: move on to a copy of it
+      SymbolChunk copy = std::make_shared<std::vector<Symbol>>();
+      copy->reserve(SIGDIGGER_SYMBOL_STORE_CHUNK);
+      copy->assign(chunks.back()->begin(), chunks.back()->end());
+      chunks.back() = copy;
+    }
+
+    room  = SIGDIGGER_SYMBOL_STORE_CHUNK - chunks.back()->size();
+    piece = std::min(room, length);
+
+    chunks.back()->insert(chunks.back()->end(), data, data + piece);
+    m_symbols.m_size += piece;
+    data   += piece;
+    length -= piece;
+  }
+}
+
+void
+SymbolStore::clear()
+{
+  // Exports still running keep their snapshot alive
+  m_symbols = SymbolSnapshot();
+}
+
+SymbolSnapshot
+SymbolStore::snapshot() const
+{
+  return m_symbols;
+}
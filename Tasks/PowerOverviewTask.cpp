@@ -0,0 +1,486 @@
+//
+//    PowerOverviewTask.cpp: Compute the power overview of a capture file
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include "PowerOverviewTask.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDateTime>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace SigDigger;
+
+#define POWER_OVERVIEW_DB(x) (10.f * std::log10((x) + 1e-20f))
+
+//
+// Sum and peak of |x|^2 over n interleaved I/Q samples. Written with four
+// independent lanes and no data-dependent branches so that the compiler
+// can map it to SIMD instructions.
+//
+static inline void
+powerReduce(const SUFLOAT *iq, size_t n, SUFLOAT &sum, SUFLOAT &peak)
+{
+  SUFLOAT s[4] = {0, 0, 0, 0};
+  SUFLOAT m[4] = {0, 0, 0, 0};
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    for (unsigned k = 0; k < 4; ++k) {
+      SUFLOAT re = iq[2 * (i + k)];
+      SUFLOAT im = iq[2 * (i + k) + 1];
+      SUFLOAT p  = re * re + im * im;
+
+      s[k] += p;
+      m[k]  = m[k] > p ? m[k] : p;
+    }
+  }
+
+  for (; i < n; ++i) {
+    SUFLOAT re = iq[2 * i];
+    SUFLOAT im = iq[2 * i + 1];
+    SUFLOAT p  = re * re + im * im;
+
+    s[0] += p;
+    m[0]  = m[0] > p ? m[0] : p;
+  }
+
+  sum  = (s[0] + s[1]) + (s[2] + s[3]);
+  peak = std::max(std::max(m[0], m[1]), std::max(m[2], m[3]));
+}
+
+PowerOverviewTask::PowerOverviewTask(
+    std::string const &path,
+    enum suscan_source_format format,
+    std::shared_ptr<PowerOverview> const &overview,
+    QObject *parent) : CancellableTask(parent)
+{
+  m_path     = path;
+  m_format   = format;
+  m_overview = overview;
+
+  setProgress(0);
+  setStatus("Opening capture");
+}
+
+PowerOverviewTask::~PowerOverviewTask()
+{
+  if (m_sfp != nullptr)
+    sf_close(m_sfp);
+
+  if (m_plan != nullptr)
+    SU_FFTW(_destroy_plan)(m_plan);
+
+  if (m_fftBuf != nullptr)
+    Arena::instance().release(m_fftBuf);
+}
+
+bool
+PowerOverviewTask::supports(enum suscan_source_format format)
+{
+  switch (format) {
+    case SUSCAN_SOURCE_FORMAT_AUTO:
+    case SUSCAN_SOURCE_FORMAT_RAW_FLOAT32:
+    case SUSCAN_SOURCE_FORMAT_RAW_UNSIGNED8:
+    case SUSCAN_SOURCE_FORMAT_RAW_SIGNED8:
+    case SUSCAN_SOURCE_FORMAT_RAW_SIGNED16:
+    case SUSCAN_SOURCE_FORMAT_WAV:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+bool
+PowerOverviewTask::open()
+{
+  QFileInfo info(QString::fromStdString(m_path));
+  SF_INFO sfinfo;
+
+  if (!info.exists() || !info.isFile()) {
+    emit error("Capture file " + info.fileName() + " does not exist");
+    return false;
+  }
+
+  m_dataSize  = static_cast<quint64>(info.size());
+  m_dataMtime = info.lastModified().toMSecsSinceEpoch();
+
+  if (m_format == SUSCAN_SOURCE_FORMAT_WAV
+      || m_format == SUSCAN_SOURCE_FORMAT_AUTO) {
+    std::memset(&sfinfo, 0, sizeof(SF_INFO));
+    m_sfp = sf_open(m_path.c_str(), SFM_READ, &sfinfo);
+
+    if (m_sfp != nullptr) {
+      if (sfinfo.channels < 1 || sfinfo.channels > 2) {
+        emit error("Unsupported number of channels in " + info.fileName());
+        return false;
+      }
+
+      m_channels = sfinfo.channels;
+      m_total    = static_cast<quint64>(sfinfo.frames);
+    } else if (m_format == SUSCAN_SOURCE_FORMAT_WAV) {
+      emit error(
+            "Cannot open "
+            + info.fileName()
+            + ": "
+            + QString(sf_strerror(nullptr)));
+      return false;
+    } else {
+      // Automatic format, but not a sound file. Assume raw float32.
+      m_format = SUSCAN_SOURCE_FORMAT_RAW_FLOAT32;
+    }
+  }
+
+  if (m_sfp == nullptr) {
+    switch (m_format) {
+      case SUSCAN_SOURCE_FORMAT_RAW_UNSIGNED8:
+      case SUSCAN_SOURCE_FORMAT_RAW_SIGNED8:
+        m_sampleSize = 2;
+        break;
+
+      case SUSCAN_SOURCE_FORMAT_RAW_SIGNED16:
+        m_sampleSize = 4;
+        break;
+
+      default:
+        m_sampleSize = sizeof(SUCOMPLEX);
+    }
+
+    m_file.setFileName(info.absoluteFilePath());
+    if (!m_file.open(QIODevice::ReadOnly)) {
+      emit error(
+            "Cannot open "
+            + info.fileName()
+            + ": "
+            + m_file.errorString());
+      return false;
+    }
+
+    m_total = m_dataSize / m_sampleSize;
+    m_raw.resize(SIGDIGGER_POWER_OVERVIEW_CHUNK_SIZE * m_sampleSize);
+  }
+
+  if (m_total == 0) {
+    emit error("Capture file " + info.fileName() + " is empty");
+    return false;
+  }
+
+  m_iq.resize(2 * SIGDIGGER_POWER_OVERVIEW_CHUNK_SIZE);
+
+  // Spectrum of each bucket
+  m_fftBuf = static_cast<SU_FFTW(_complex) *>(
+        Arena::instance().allocate(SIGDIGGER_POWER_OVERVIEW_FFT_SIZE * sizeof(SUCOMPLEX)));
+  if (m_fftBuf == nullptr) {
+    emit error("Failed to allocate FFT buffer");
+    return false;
+  }
+
+  m_plan = SU_FFTW(_plan_dft_1d)(
+        SIGDIGGER_POWER_OVERVIEW_FFT_SIZE,
+        m_fftBuf,
+        m_fftBuf,
+        FFTW_FORWARD,
+        FFTW_ESTIMATE);
+  if (m_plan == nullptr) {
+    emit error("Failed to initialize FFT plan");
+    return false;
+  }
+
+  m_window.resize(SIGDIGGER_POWER_OVERVIEW_FFT_SIZE);
+  m_psd.resize(SIGDIGGER_POWER_OVERVIEW_FFT_SIZE);
+  m_windowEnergy = 0;
+  for (unsigned i = 0; i < SIGDIGGER_POWER_OVERVIEW_FFT_SIZE; ++i) {
+    m_window[i] = static_cast<SUFLOAT>(
+          std::sin(M_PI * i / SIGDIGGER_POWER_OVERVIEW_FFT_SIZE));
+    m_window[i] *= m_window[i];
+    m_windowEnergy += m_window[i] * m_window[i];
+  }
+
+  m_buckets = static_cast<size_t>(
+        std::min<quint64>(
+          SIGDIGGER_POWER_OVERVIEW_MAX_BUCKETS,
+          std::max<quint64>(1, m_total / SIGDIGGER_POWER_OVERVIEW_SUBBLOCK_SIZE)));
+
+  m_overview->reset(m_buckets, m_total);
+
+  m_bucket = 0;
+  startBucket();
+
+  m_opened = true;
+
+  setStatus("Scanning capture");
+
+  return true;
+}
+
+size_t
+PowerOverviewTask::readChunk()
+{
+  size_t got = 0;
+
+  if (m_sfp != nullptr) {
+    sf_count_t frames;
+
+    if (m_channels == 2) {
+      frames = sf_readf_float(
+            m_sfp,
+            m_iq.data(),
+            SIGDIGGER_POWER_OVERVIEW_CHUNK_SIZE);
+    } else {
+      // Mono: real signal, upper half of the buffer as scratch
+      SUFLOAT *real = m_iq.data() + SIGDIGGER_POWER_OVERVIEW_CHUNK_SIZE;
+
+      frames = sf_readf_float(
+            m_sfp,
+            real,
+            SIGDIGGER_POWER_OVERVIEW_CHUNK_SIZE);
+
+      for (sf_count_t i = 0; i < frames; ++i) {
+        m_iq[2 * static_cast<size_t>(i)]     = real[i];
+        m_iq[2 * static_cast<size_t>(i) + 1] = 0;
+      }
+    }
+
+    got = frames > 0 ? static_cast<size_t>(frames) : 0;
+  } else {
+    qint64 bytes = m_file.read(m_raw.data(), static_cast<qint64>(m_raw.size()));
+
+    if (bytes <= 0)
+      return 0;
+
+    got = static_cast<size_t>(bytes) / m_sampleSize;
+
+    switch (m_format) {
+      case SUSCAN_SOURCE_FORMAT_RAW_UNSIGNED8: {
+        const uint8_t *in = reinterpret_cast<const uint8_t *>(m_raw.data());
+        for (size_t i = 0; i < 2 * got; ++i)
+          m_iq[i] = (static_cast<SUFLOAT>(in[i]) - 127.5f) / 127.5f;
+        break;
+      }
+
+      case SUSCAN_SOURCE_FORMAT_RAW_SIGNED8: {
+        const int8_t *in = reinterpret_cast<const int8_t *>(m_raw.data());
+        for (size_t i = 0; i < 2 * got; ++i)
+          m_iq[i] = static_cast<SUFLOAT>(in[i]) / 128.f;
+        break;
+      }
+
+      case SUSCAN_SOURCE_FORMAT_RAW_SIGNED16: {
+        const int16_t *in = reinterpret_cast<const int16_t *>(m_raw.data());
+        for (size_t i = 0; i < 2 * got; ++i)
+          m_iq[i] = static_cast<SUFLOAT>(in[i]) / 32768.f;
+        break;
+      }
+
+      default:
+        std::memcpy(m_iq.data(), m_raw.data(), got * sizeof(SUCOMPLEX));
+    }
+  }
+
+  return got;
+}
+
+void
+PowerOverviewTask::startBucket()
+{
+  m_bucketStart = m_bucket * m_total / m_buckets;
+  m_bucketEnd   = (m_bucket + 1) * m_total / m_buckets;
+
+  m_sum      = 0;
+  m_peak     = 0;
+  m_subSum   = 0;
+  m_subMin   = 0;
+  m_subPos   = 0;
+  m_haveSub  = false;
+  m_fftPos   = 0;
+  m_segments = 0;
+
+  std::fill(m_psd.begin(), m_psd.end(), 0);
+}
+
+void
+PowerOverviewTask::feedSpectrum(const SUFLOAT *iq, size_t samples)
+{
+  SUCOMPLEX *buf = reinterpret_cast<SUCOMPLEX *>(m_fftBuf);
+
+  for (size_t i = 0; i < samples; ++i) {
+    buf[m_fftPos] = m_window[m_fftPos] * (iq[2 * i] + SU_I * iq[2 * i + 1]);
+
+    if (++m_fftPos == SIGDIGGER_POWER_OVERVIEW_FFT_SIZE) {
+      SU_FFTW(_execute)(m_plan);
+
+      for (unsigned k = 0; k < SIGDIGGER_POWER_OVERVIEW_FFT_SIZE; ++k)
+        m_psd[k] += SU_C_REAL(buf[k] * SU_C_CONJ(buf[k]));
+
+      ++m_segments;
+      m_fftPos = 0;
+    }
+  }
+}
+
+void
+PowerOverviewTask::finishBucket()
+{
+  const unsigned fold =
+      SIGDIGGER_POWER_OVERVIEW_FFT_SIZE / SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS;
+  const unsigned half = SIGDIGGER_POWER_OVERVIEW_FFT_SIZE / 2;
+  float spectrum[SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS];
+  PowerOverviewBucket bucket;
+  quint64 count = m_bucketEnd - m_bucketStart;
+  SUFLOAT mean = count > 0 ? m_sum / static_cast<SUFLOAT>(count) : 0;
+
+  bucket.mean = POWER_OVERVIEW_DB(mean);
+  bucket.max  = POWER_OVERVIEW_DB(m_peak);
+  bucket.min  = m_haveSub ? POWER_OVERVIEW_DB(m_subMin) : bucket.mean;
+
+  // Fold the FFT into fewer bins, negative frequencies first
+  for (unsigned b = 0; b < SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS; ++b) {
+    SUFLOAT acc = 0;
+
+    for (unsigned k = 0; k < fold; ++k)
+      acc += m_psd[(b * fold + k + half) % SIGDIGGER_POWER_OVERVIEW_FFT_SIZE];
+
+    if (m_segments > 0)
+      acc /= m_segments * fold * m_windowEnergy;
+
+    spectrum[b] = POWER_OVERVIEW_DB(acc);
+  }
+
+  m_overview->setBucket(m_bucket, bucket, spectrum);
+
+  if (++m_bucket < m_buckets)
+    startBucket();
+}
+
+void
+PowerOverviewTask::processChunk(size_t samples)
+{
+  const quint64 specLen =
+      SIGDIGGER_POWER_OVERVIEW_FFT_SIZE * SIGDIGGER_POWER_OVERVIEW_FFT_SEGMENTS;
+  size_t i = 0;
+
+  while (i < samples && m_bucket < m_buckets) {
+    size_t avail = static_cast<size_t>(
+          std::min<quint64>(samples - i, m_bucketEnd - m_pos));
+    quint64 inBucket = m_pos - m_bucketStart;
+    size_t j = 0;
+
+    if (inBucket < specLen)
+      feedSpectrum(
+            m_iq.data() + 2 * i,
+            static_cast<size_t>(std::min<quint64>(avail, specLen - inBucket)));
+
+    while (j < avail) {
+      size_t take = std::min<size_t>(
+            avail - j,
+            SIGDIGGER_POWER_OVERVIEW_SUBBLOCK_SIZE - m_subPos);
+      SUFLOAT sum, peak;
+
+      powerReduce(m_iq.data() + 2 * (i + j), take, sum, peak);
+
+      m_sum    += sum;
+      m_subSum += sum;
+      m_subPos += take;
+      if (peak > m_peak)
+        m_peak = peak;
+
+      if (m_subPos == SIGDIGGER_POWER_OVERVIEW_SUBBLOCK_SIZE) {
+        SUFLOAT subMean = m_subSum / SIGDIGGER_POWER_OVERVIEW_SUBBLOCK_SIZE;
+
+        if (!m_haveSub || subMean < m_subMin)
+          m_subMin = subMean;
+
+        m_haveSub = true;
+        m_subSum  = 0;
+        m_subPos  = 0;
+      }
+
+      j += take;
+    }
+
+    i     += avail;
+    m_pos += avail;
+
+    if (m_pos == m_bucketEnd)
+      finishBucket();
+  }
+}
+
+void
+PowerOverviewTask::finish()
+{
+  // Short read (e.g. truncated file): close the pending bucket
+  if (m_bucket < m_buckets && m_pos > m_bucketStart) {
+    m_bucketEnd = m_pos;
+    finishBucket();
+  }
+
+  m_overview->setComplete();
+
+  // The cache is an optimization only, it is fine if it cannot be written
+  (void) m_overview->save(
+        PowerOverview::pathFor(m_path),
+        m_dataSize,
+        m_dataMtime);
+
+  emit overviewUpdated();
+  emit done();
+}
+
+bool
+PowerOverviewTask::work()
+{
+  QElapsedTimer timer;
+
+  if (m_cancelFlag) {
+    emit cancelled();
+    return false;
+  }
+
+  if (!m_opened) {
+    if (!open())
+      return false;
+
+    return true;
+  }
+
+  timer.start();
+
+  while (timer.elapsed() < SIGDIGGER_POWER_OVERVIEW_SLICE_MS) {
+    size_t got = readChunk();
+
+    if (got == 0 || m_bucket >= m_buckets) {
+      finish();
+      return false;
+    }
+
+    processChunk(got);
+  }
+
+  setProgress(static_cast<qreal>(m_pos) / static_cast<qreal>(m_total));
+  emit overviewUpdated();
+
+  return true;
+}
+
+void
+PowerOverviewTask::cancel()
+{
+  m_cancelFlag = true;
+}
@@ -0,0 +1,296 @@
+//
+//    ResamplerTask.cpp: Polyphase sample rate conversion
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include <ResamplerTask.h>
+#include <Suscan/Library.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#define SIGDIGGER_RESAMPLER_MIN_BLOCK 1024 // Output samples
+
+using namespace SigDigger;
+
+ResamplerTask::ResamplerTask(
+    const SUCOMPLEX *data,
+    size_t length,
+    qreal ratio,
+    SUFLOAT cutoff,
+    QObject *parent) : CancellableTask(parent)
+{
+  size_t outLength;
+
+  if (ratio <= 0 || std::isnan(ratio) || std::isinf(ratio))
+    throw Suscan::Exception("Invalid resampling ratio");
+
+  if (length == 0)
+    throw Suscan::Exception("Nothing to resample");
+
+  m_data   = data;
+  m_length = length;
+
+  rationalize(ratio, m_interp, m_decim);
+  designFilter(cutoff);
+
+  outLength = (length * m_interp - 1) / m_decim + 1;
+
+  m_output.resize(outLength);
+  m_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  setProgress(0);
+  setStatus("Resampling...");
+}
+
+ResamplerTask::~ResamplerTask()
+{
+}
+
+void
+ResamplerTask::rationalize(qreal ratio, unsigned int &L, unsigned int &M)
+{
+  unsigned long p0 = 0, q0 = 1, p1 = 1, q1 = 0, p2, q2;
+  qreal x = ratio, a, frac;
+
+  L = M = 0;
+
+  // Walk the convergents of the continued fraction of the ratio until
+  // either term exceeds the maximum factor
+  for (int i = 0; i < 64; ++i) {
+    a  = std::floor(x);
+    p2 = static_cast<unsigned long>(a) * p1 + p0;
+    q2 = static_cast<unsigned long>(a) * q1 + q0;
+
+    if (p2 > SIGDIGGER_RESAMPLER_MAX_FACTOR
+        || q2 > SIGDIGGER_RESAMPLER_MAX_FACTOR)
+      break;
+
+    if (p2 > 0) {
+      L = static_cast<unsigned int>(p2);
+      M = static_cast<unsigned int>(q2);
+    }
+
+    p0 = p1;
+    q0 = q1;
+    p1 = p2;
+    q1 = q2;
+
+    frac = x - a;
+    if (frac < 1e-9)
+      break;
+
+    x = 1 / frac;
+  }
+
+  // Ratio below 1 / MAX_FACTOR
+  if (L == 0) {
+    L = 1;
+    M = SIGDIGGER_RESAMPLER_MAX_FACTOR;
+  }
+}
+
+void
+ResamplerTask::designFilter(SUFLOAT cutoff)
+{
+  qreal maxCutoff = SIGDIGGER_RESAMPLER_PASSBAND
+      * std::min(1., static_cast<qreal>(m_interp) / m_decim);
+  qreal fc, c, sum = 0;
+  size_t N;
+
+  if (cutoff <= 0 || cutoff > maxCutoff)
+    cutoff = static_cast<SUFLOAT>(maxCutoff);
+
+  // The transition band of a Blackman window is roughly 5.5 / N in the
+  // upsampled domain, i.e. 5.5 / taps in the input domain.
+  m_taps = static_cast<unsigned int>(
+        std::ceil(5.5 / (SIGDIGGER_RESAMPLER_TRANSITION * cutoff)));
+  m_taps = qBound(
+        static_cast<unsigned int>(SIGDIGGER_RESAMPLER_MIN_TAPS),
+        m_taps,
+        static_cast<unsigned int>(SIGDIGGER_RESAMPLER_MAX_TAPS));
+
+  // The bank holds taps x L coefficients (twice, for SIMD). Large
+  // interpolation factors trade some transition sharpness for memory.
+  m_taps = std::min(
+        m_taps,
+        std::max(
+          static_cast<unsigned int>(SIGDIGGER_RESAMPLER_MIN_TAPS),
+          static_cast<unsigned int>(
+            SIGDIGGER_RESAMPLER_MAX_PROTOTYPE / m_interp)));
+  m_taps = (m_taps + 3) & ~3u; // Multiple of 4, see computeRange
+
+  N  = static_cast<size_t>(m_taps) * m_interp;
+  fc = static_cast<qreal>(cutoff) / m_interp;
+  c  = .5 * static_cast<qreal>(N - 1);
+
+  m_delay = (N - 1) / 2;
+
+  // Windowed sinc prototype, evaluated on demand: it is never stored whole
+  auto h = [fc, c, N] (size_t j) {
+    qreal t = 2 * fc * (static_cast<qreal>(j) - c);
+    qreal sinc = std::fabs(t) < 1e-12 ? 1 : std::sin(M_PI * t) / (M_PI * t);
+    qreal w = .42
+        - .5  * std::cos(2 * M_PI * j / (N - 1))
+        + .08 * std::cos(4 * M_PI * j / (N - 1));
+
+    return 2 * fc * sinc * w;
+  };
+
+  // Each branch straight from the prototype
+  m_bank.resize(2 * N);
+  for (unsigned int phase = 0; phase < m_interp; ++phase) {
+    SUFLOAT *branch = m_bank.data() + 2 * phase * m_taps;
+
+    for (unsigned int q = 0; q < m_taps; ++q) {
+      unsigned int r = m_taps - 1 - q;
+      qreal val = h(phase + static_cast<size_t>(q) * m_interp);
+
+      branch[2 * r] = static_cast<SUFLOAT>(val);
+      sum += val;
+    }
+  }
+
+  // Unit DC gain. Zero-stuffing divides the gain by L.
+  for (size_t j = 0; j < N; ++j) {
+    SUFLOAT val = static_cast<SUFLOAT>(m_interp * m_bank[2 * j] / sum);
+    m_bank[2 * j]     = val;
+    m_bank[2 * j + 1] = val;
+  }
+}
+
+SUCOMPLEX
+ResamplerTask::computeSlow(size_t n) const
+{
+  size_t t = n * m_decim + m_delay;
+  size_t i = t / m_interp;
+  unsigned int phase = static_cast<unsigned int>(t % m_interp);
+  const SUFLOAT *branch = m_bank.data() + 2 * phase * m_taps;
+  SUCOMPLEX acc = 0;
+
+  for (unsigned int r = 0; r < m_taps; ++r) {
+    // Sample index is i - (taps - 1) + r
+    if (i + r + 1 < m_taps || i + r + 1 - m_taps >= m_length)
+      continue;
+
+    acc += branch[2 * r] * m_data[i + r + 1 - m_taps];
+  }
+
+  return acc;
+}
+
+void
+ResamplerTask::computeRange(size_t start, size_t end)
+{
+  size_t taps2 = 2 * static_cast<size_t>(m_taps);
+
+  for (size_t n = start; n < end; ++n) {
+    size_t t = n * m_decim + m_delay;
+    size_t i = t / m_interp;
+
+    if (i + 1 < m_taps || i >= m_length) {
+      m_output[n] = computeSlow(n);
+      continue;
+    }
+
+    const SUFLOAT *x =
+        reinterpret_cast<const SUFLOAT *>(m_data + i + 1 - m_taps);
+    const SUFLOAT *h = m_bank.data() + (t % m_interp) * taps2;
+    SUFLOAT acc[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    // Independent accumulators: even lanes are I, odd lanes are Q
+    for (size_t r = 0; r < taps2; r += 8)
+      for (unsigned int k = 0; k < 8; ++k)
+        acc[k] += x[r + k] * h[r + k];
+
+    m_output[n] = SUCOMPLEX(
+          acc[0] + acc[2] + acc[4] + acc[6],
+          acc[1] + acc[3] + acc[5] + acc[7]);
+  }
+}
+
+unsigned int
+ResamplerTask::getInterpolation() const
+{
+  return m_interp;
+}
+
+unsigned int
+ResamplerTask::getDecimation() const
+{
+  return m_decim;
+}
+
+qreal
+ResamplerTask::getRatio() const
+{
+  return static_cast<qreal>(m_interp) / m_decim;
+}
+
+std::vector<SUCOMPLEX> &&
+ResamplerTask::takeOutput()
+{
+  return std::move(m_output);
+}
+
+bool
+ResamplerTask::work()
+{
+  size_t block = std::max<size_t>(
+        SIGDIGGER_RESAMPLER_MIN_BLOCK,
+        SIGDIGGER_RESAMPLER_BLOCK_MACS / m_taps);
+  size_t end = std::min(m_p + block, m_output.size());
+  size_t count = end - m_p;
+  unsigned int threads = m_threads;
+  std::vector<std::thread> workers;
+
+  if (count < threads * SIGDIGGER_RESAMPLER_MIN_BLOCK)
+    threads = 1;
+
+  for (unsigned int j = 1; j < threads; ++j)
+    workers.emplace_back(
+          &ResamplerTask::computeRange,
+          this,
+          m_p + j * count / threads,
+          m_p + (j + 1) * count / threads);
+
+  computeRange(m_p, m_p + count / threads);
+
+  for (auto &t : workers)
+    t.join();
+
+  m_p = end;
+
+  setStatus("Resampling ("
+            + QString::number(m_p)
+            + "/"
+            + QString::number(m_output.size())
+            + ")...");
+
+  setProgress(static_cast<qreal>(m_p) / static_cast<qreal>(m_output.size()));
+
+  if (m_p < m_output.size())
+    return true;
+
+  emit done();
+  return false;
+}
+
+void
+ResamplerTask::cancel()
+{
+  emit cancelled();
+}
@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# Allocation benchmark for the buffer arena. Not part of SigDigger itself:
+#
+#   qmake Tools/ArenaBenchmark && make && ./ArenaBenchmark [MiB] [rounds]
+#
+#-------------------------------------------------
+
+QT      += core
+QT      -= gui
+CONFIG  += console c++1z
+CONFIG  -= app_bundle
+
+TARGET   = ArenaBenchmark
+TEMPLATE = app
+
+INCLUDEPATH += ../../include
+
+SOURCES += \
+    main.cpp \
+    ../../Misc/ArenaAllocator.cpp \
+    ../../Misc/MemoryBudget.cpp
+
+HEADERS += \
+    ../../include/ArenaAllocator.h \
+    ../../include/MemoryBudget.h
@@ -0,0 +1,180 @@
+//
+//    main.cpp: Compare the default allocator against the buffer arena
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#include <ArenaAllocator.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifndef _WIN32
+#  include <sys/resource.h>
+#endif // _WIN32
+
+using namespace SigDigger;
+
+struct Result {
+  qreal elapsed = 0;
+  long  faults  = -1;
+};
+
+static long
+minorFaults()
+{
+#ifndef _WIN32
+  struct rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+
+  return usage.ru_minflt;
+#else
+  return 0;
+#endif // _WIN32
+}
+
+// What tasks do with their buffers: fill, transform in place
+template <class Vector>
+static float
+work(Vector &v)
+{
+  float acc = 0;
+
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = static_cast<float>(i & 0xff);
+
+  for (size_t i = 0; i < v.size(); ++i)
+    acc += v[i] * .5f;
+
+  return acc;
+}
+
+//
+// Every round gets a new buffer. With cold set, the arena cache is
+// emptied first, so both allocators have to go to the system each time.
+// Otherwise, the arena may hand back the block of the previous round.
+//
+template <class Vector>
+static Result
+fresh(size_t samples, unsigned int rounds, bool cold, float &acc)
+{
+  QElapsedTimer timer;
+  Result result;
+  long before;
+  qint64 ns = 0;
+
+  before = minorFaults();
+
+  for (unsigned int r = 0; r < rounds; ++r) {
+    if (cold)
+      Arena::instance().trim();
+
+    timer.start();
+    {
+      Vector v(samples);
+      acc += work(v);
+    }
+    ns += timer.nsecsElapsed();
+  }
+
+  result.faults  = minorFaults() - before;
+  result.elapsed = ns * 1e-9;
+
+  return result;
+}
+
+// A single buffer, allocated and touched once, then reused every round
+template <class Vector>
+static Result
+reused(size_t samples, unsigned int rounds, float &acc)
+{
+  QElapsedTimer timer;
+  Result result;
+  Vector v(samples);
+  long before;
+
+  acc += work(v);
+
+  before = minorFaults();
+  timer.start();
+
+  for (unsigned int r = 0; r < rounds; ++r)
+    acc += work(v);
+
+  result.elapsed = timer.nsecsElapsed() * 1e-9;
+  result.faults  = minorFaults() - before;
+
+  return result;
+}
+
+static void
+report(const char *what, Result const &result, qreal total)
+{
+  printf(
+        "  %-28s %10ld minor faults  %10.1f MiB/s\n",
+        what,
+        result.faults,
+        total / result.elapsed / 1048576.);
+}
+
+int
+main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+  size_t mib = argc > 1 ? strtoul(argv[1], nullptr, 10) : 64;
+  unsigned int rounds = argc > 2 ? strtoul(argv[2], nullptr, 10) : 8;
+  size_t samples = (mib << 20) / sizeof(float);
+  qreal total = static_cast<qreal>(samples * sizeof(float)) * rounds;
+  float acc = 0;
+
+  if (samples == 0 || rounds == 0) {
+    fprintf(stderr, "Usage: %s [MiB] [rounds]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  printf("%u rounds of %zu MiB\n", rounds, mib);
+
+  printf("New buffer every round:\n");
+  report(
+        "default allocator",
+        fresh<std::vector<float>>(samples, rounds, false, acc),
+        total);
+  report(
+        "arena, cache emptied",
+        fresh<ArenaVector<float>>(samples, rounds, true, acc),
+        total);
+  report(
+        "arena, cache kept",
+        fresh<ArenaVector<float>>(samples, rounds, false, acc),
+        total);
+
+  printf("Same buffer every round:\n");
+  report(
+        "default allocator",
+        reused<std::vector<float>>(samples, rounds, acc),
+        total);
+  report(
+        "arena",
+        reused<ArenaVector<float>>(samples, rounds, acc),
+        total);
+
+  Arena::instance().trim();
+
+  // Keep the loops from being optimized away
+  return acc < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
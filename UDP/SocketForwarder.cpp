@@ -24,6 +24,12 @@
 #include <sigutils/util/compat-netdb.h>
 #include <stdexcept>
 
+#ifndef _WIN32
+#  include <sys/uio.h>
+#endif // _WIN32
+
+#define SIGDIGGER_SOCKETFORWARDER_MAX_BATCH 64
+
 #ifndef MSG_NOSIGNAL
 #  define MSG_NOSIGNAL 0
 #endif // MSG_NOSIGNAL
@@ -54,6 +60,8 @@ namespace SigDigger {
     std::string getError(void) const override;
     bool canWrite(void) const override;
     ssize_t write(const void *data, size_t len) override;
+    ssize_t writeChunks(const GenericDataChunk *, size_t) override;
+    size_t maxChunkSize(void) const override;
     bool close(void) override;
     ~SocketDataWriter() override;
   };
@@ -142,6 +150,79 @@ SocketDataWriter::write(const void *data, size_t len)
   return sent;
 }
 
+size_t
+SocketDataWriter::maxChunkSize(void) const
+{
+  // Each UDP chunk becomes a datagram. TCP is a stream, boundaries are
+  // meaningless there.
+  return this->tcp ? 0 : this->size;
+}
+
+ssize_t
+SocketDataWriter::writeChunks(const GenericDataChunk *chunks, size_t count)
+{
+#if defined(__linux__)
+  ssize_t sent = 0;
+
+  if (count > SIGDIGGER_SOCKETFORWARDER_MAX_BATCH)
+    count = SIGDIGGER_SOCKETFORWARDER_MAX_BATCH;
+
+  if (this->tcp) {
+    struct iovec iov[SIGDIGGER_SOCKETFORWARDER_MAX_BATCH];
+    struct msghdr msg;
+
+    memset(&msg, 0, sizeof(struct msghdr));
+
+    for (size_t i = 0; i < count; ++i) {
+      iov[i].iov_base = const_cast<uint8_t *>(chunks[i].data);
+      iov[i].iov_len  = chunks[i].len;
+    }
+
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = count;
+
+    sent = sendmsg(this->fd, &msg, MSG_NOSIGNAL);
+  } else {
+    // One datagram per chunk, all of them sent in a single syscall
+    struct mmsghdr msgs[SIGDIGGER_SOCKETFORWARDER_MAX_BATCH];
+    struct iovec iov[SIGDIGGER_SOCKETFORWARDER_MAX_BATCH];
+    int count_sent;
+
+    memset(msgs, 0, count * sizeof(struct mmsghdr));
+
+    for (size_t i = 0; i < count; ++i) {
+      iov[i].iov_base = const_cast<uint8_t *>(chunks[i].data);
+      iov[i].iov_len  = chunks[i].len;
+
+      msgs[i].msg_hdr.msg_name    = &this->addr;
+      msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+      msgs[i].msg_hdr.msg_iov     = iov + i;
+      msgs[i].msg_hdr.msg_iovlen  = 1;
+    }
+
+    count_sent = sendmmsg(
+          this->fd,
+          msgs,
+          static_cast<unsigned int>(count),
+          MSG_NOSIGNAL);
+
+    if (count_sent < 1) {
+      sent = -1;
+    } else {
+      for (int i = 0; i < count_sent; ++i)
+        sent += msgs[i].msg_len;
+    }
+  }
+
+  if (sent < 1)
+    this->lastError = std::string(strerror(errno));
+
+  return sent;
+#else
+  return GenericDataWriter::writeChunks(chunks, count);
+#endif // __linux__
+}
+
 bool
 SocketDataWriter::close(void)
 {
@@ -170,5 +251,7 @@ SocketForwarder::SocketForwarder(
     this->writer = new SocketDataWriter(host, port, size, tcp),
     parent)
 {
-
+  this->setFlushPolicy(
+        FLUSH_LATENCY,
+        SIGDIGGER_SOCKETFORWARDER_DEFAULT_MAX_LATENCY_US);
 }
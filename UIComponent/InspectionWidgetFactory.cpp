@@ -125,6 +125,22 @@ InspectionWidget::samplesMessage(Suscan::SamplesMessage const &)
  // NO-OP
 }
 
+void
+InspectionWidget::onInspectorMessage(Suscan::InspectorMessage const &msg)
+{
+  // Deletion detaches the widget from the mediator
+  if (msg.getKind() == SUSCAN_ANALYZER_INSPECTOR_MSGKIND_CLOSE)
+    this->deleteLater();
+  else
+    this->inspectorMessage(msg);
+}
+
+void
+InspectionWidget::onInspectorSamples(Suscan::SamplesMessage const &msg)
+{
+  this->samplesMessage(msg);
+}
+
 
 // Overriden methods
 
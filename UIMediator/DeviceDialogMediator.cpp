@@ -25,11 +25,13 @@ using namespace SigDigger;
 void
 UIMediator::connectDeviceDialog(void)
 {
-  connect(
-        this->m_ui->deviceDialog,
-        SIGNAL(refreshRequest(void)),
-        this,
-        SLOT(onRefreshDevices(void)));
+  this->m_ui->deviceDialog.whenReady([this] (DeviceDialog *dialog) {
+    connect(
+          dialog,
+          SIGNAL(refreshRequest(void)),
+          this,
+          SLOT(onRefreshDevices(void)));
+  });
 }
 
 void
@@ -50,22 +50,6 @@ UIMediator::connectRequestTracker()
         SLOT(onError(Suscan::AnalyzerRequest const &, const std::string &)));
 }
 
-void
-UIMediator::connectAnalyzer()
-{
-  connect(
-        m_analyzer,
-        SIGNAL(inspector_message(const Suscan::InspectorMessage &)),
-        this,
-        SLOT(onInspectorMessage(const Suscan::InspectorMessage &)));
-
-  connect(
-        m_analyzer,
-        SIGNAL(samples_message(const Suscan::SamplesMessage &)),
-        this,
-        SLOT(onInspectorSamples(const Suscan::SamplesMessage &)));
-}
-
 void
 UIMediator::detachAllInspectors()
 {
@@ -73,11 +57,13 @@ UIMediator::detachAllInspectors()
   // they are just dangling tab widgets with no relation with the current
   // analyzer whatsoever
 
-  for (auto p : m_inspectors)
+  for (auto p : m_inspectors) {
+    if (m_analyzer != nullptr)
+      m_analyzer->unsubscribeInspector(p);
     p->setState(UIMediator::HALTED, nullptr);
+  }
 
   m_inspectors.clear();
-  m_inspTable.clear();
 }
 
 bool
@@ -120,8 +106,8 @@ UIMediator::detachInspectionWidget(InspectionWidget *widget)
 {
   Suscan::InspectorId id = widget->request().inspectorId;
 
-  if (m_inspTable.contains(id) && m_inspTable[id] == widget)
-    m_inspTable.remove(id);
+  if (m_analyzer != nullptr)
+    m_analyzer->unsubscribeInspector(id, widget);
 
   if (m_inspectors.contains(widget))
     m_inspectors.removeAt(m_inspectors.indexOf(widget));
@@ -139,29 +125,6 @@ UIMediator::isLive() const
   return this->m_appConfig->profile.isRealTime();
 }
 
-void
-UIMediator::onInspectorMessage(Suscan::InspectorMessage const &msg)
-{
-  if (m_inspTable.contains(msg.getInspectorId())) {
-    InspectionWidget *widget = m_inspTable[msg.getInspectorId()];
-
-    // Deletion triggers detachAllInspectors()
-    if (msg.getKind() == SUSCAN_ANALYZER_INSPECTOR_MSGKIND_CLOSE)
-      widget->deleteLater();
-    else
-      widget->inspectorMessage(msg);
-  }
-}
-
-void
-UIMediator::onInspectorSamples(Suscan::SamplesMessage const &msg)
-{
-  if (m_inspTable.contains(msg.getInspectorId())) {
-    InspectionWidget *widget = m_inspTable[msg.getInspectorId()];
-    widget->samplesMessage(msg);
-  }
-}
-
 void
 UIMediator::onOpened(Suscan::AnalyzerRequest const &request)
 {
@@ -184,7 +147,10 @@ UIMediator::onOpened(Suscan::AnalyzerRequest const &request)
 
     widget->setColorConfig(m_appConfig->colors);
     m_inspectors.push_back(widget);
-    m_inspTable[request.inspectorId] = widget;
+
+    // Messages of this inspector go straight to its widget
+    if (m_analyzer != nullptr)
+      m_analyzer->subscribeInspector(request.inspectorId, widget);
 
     this->addTabWidget(widget);
   }
@@ -102,7 +102,8 @@ UIMediator::getPanSpectrumPartition(void) const
 void
 UIMediator::setMinPanSpectrumBw(quint64 bw)
 {
-  this->m_ui->panoramicDialog->setMinBwForZoom(bw);
+  if (this->m_ui->panoramicDialog.isReady())
+    this->m_ui->panoramicDialog->setMinBwForZoom(bw);
 }
 
 void
@@ -112,71 +113,85 @@ UIMediator::feedPanSpectrum(
     float *data,
     size_t size)
 {
-  this->m_ui->panoramicDialog->feed(minFreq, maxFreq, data, size);
+  if (this->m_ui->panoramicDialog.isReady())
+    this->m_ui->panoramicDialog->feed(minFreq, maxFreq, data, size);
 }
 
 void
 UIMediator::setPanSpectrumRunning(bool running)
 {
-  this->m_ui->panoramicDialog->setRunning(running);
+  if (this->m_ui->panoramicDialog.isReady())
+    this->m_ui->panoramicDialog->setRunning(running);
 }
 
 void
 UIMediator::connectPanoramicDialog(void)
 {
-  connect(
-        this->m_ui->panoramicDialog,
-        SIGNAL(start(void)),
-        this,
-        SLOT(onPanoramicSpectrumStart(void)));
-
-  connect(
-        this->m_ui->panoramicDialog,
-        SIGNAL(stop(void)),
-        this,
-        SLOT(onPanoramicSpectrumStop(void)));
-
-  connect(
-        this->m_ui->panoramicDialog,
-        SIGNAL(detailChanged(qint64, qint64, bool)),
-        this,
-        SLOT(onPanoramicSpectrumDetailChanged(qint64, qint64, bool)));
-
-  connect(
-        this->m_ui->panoramicDialog,
-        SIGNAL(frameSkipChanged(void)),
-        this,
-        SIGNAL(panSpectrumSkipChanged(void)));
-
-  connect(
-        this->m_ui->panoramicDialog,
-        SIGNAL(relBandwidthChanged(void)),
-        this,
-        SIGNAL(panSpectrumRelBwChanged(void)));
-
-  connect(
-        this->m_ui->panoramicDialog,
-        SIGNAL(reset(void)),
-        this,
-        SIGNAL(panSpectrumReset(void)));
-
-  connect(
-        this->m_ui->panoramicDialog,
-        SIGNAL(strategyChanged(QString)),
-        this,
-        SIGNAL(panSpectrumStrategyChanged(QString)));
-
-  connect(
-        this->m_ui->panoramicDialog,
-        SIGNAL(partitioningChanged(QString)),
-        this,
-        SIGNAL(panSpectrumPartitioningChanged(QString)));
-
-  connect(
-        this->m_ui->panoramicDialog,
-        SIGNAL(gainChanged(QString, float)),
-        this,
-        SIGNAL(panSpectrumGainChanged(QString, float)));
+  this->m_ui->panoramicDialog.whenReady([this] (PanoramicDialog *dialog) {
+    // Configuration was deserialized long ago, apply it now
+    dialog->setGuiConfig(this->m_appConfig->guiConfig);
+    dialog->setColors(this->m_appConfig->colors);
+    dialog->applyConfig();
+
+    if (this->m_state == RUNNING)
+      dialog->setBannedDevice(
+            QString::fromStdString(
+              this->m_appConfig->profile.getDevice().getDesc()));
+
+    connect(
+          dialog,
+          SIGNAL(start(void)),
+          this,
+          SLOT(onPanoramicSpectrumStart(void)));
+
+    connect(
+          dialog,
+          SIGNAL(stop(void)),
+          this,
+          SLOT(onPanoramicSpectrumStop(void)));
+
+    connect(
+          dialog,
+          SIGNAL(detailChanged(qint64, qint64, bool)),
+          this,
+          SLOT(onPanoramicSpectrumDetailChanged(qint64, qint64, bool)));
+
+    connect(
+          dialog,
+          SIGNAL(frameSkipChanged(void)),
+          this,
+          SIGNAL(panSpectrumSkipChanged(void)));
+
+    connect(
+          dialog,
+          SIGNAL(relBandwidthChanged(void)),
+          this,
+          SIGNAL(panSpectrumRelBwChanged(void)));
+
+    connect(
+          dialog,
+          SIGNAL(reset(void)),
+          this,
+          SIGNAL(panSpectrumReset(void)));
+
+    connect(
+          dialog,
+          SIGNAL(strategyChanged(QString)),
+          this,
+          SIGNAL(panSpectrumStrategyChanged(QString)));
+
+    connect(
+          dialog,
+          SIGNAL(partitioningChanged(QString)),
+          this,
+          SIGNAL(panSpectrumPartitioningChanged(QString)));
+
+    connect(
+          dialog,
+          SIGNAL(gainChanged(QString, float)),
+          this,
+          SIGNAL(panSpectrumGainChanged(QString, float)));
+  });
 }
 
 void
@@ -26,10 +26,88 @@
 
 using namespace SigDigger;
 
+bool
+UIMediator::psdLinkEnabled() const
+{
+  return m_state == RUNNING
+      && m_appConfig->profile.isRemote()
+      && m_appConfig->guiConfig.adaptivePSD;
+}
+
+void
+UIMediator::feedPSDLink(Suscan::PSDMessage const &msg)
+{
+  PSDLinkSettings next;
+
+  m_psdLink.setTarget(m_appConfig->guiConfig.targetLatency);
+
+  if (!m_psdLink.feed(msg.getRealTimeStamp(), msg.size()))
+    return;
+
+  if (m_psdLink.decide(next))
+    applyPSDLinkSettings(next);
+
+  refreshLinkBudget();
+}
+
+void
+UIMediator::applyPSDLinkSettings(PSDLinkSettings const &settings)
+{
+  Suscan::AnalyzerParams params = m_appConfig->analyzerParams;
+
+  if (m_analyzer == nullptr)
+    return;
+
+  params.psdUpdateInterval = 1.f / settings.rate;
+  params.windowSize        = settings.fftSize;
+
+  try {
+    m_analyzer->setParams(params);
+  } catch (Suscan::Exception const &e) {
+    SU_WARNING("Cannot adapt spectrum settings to link: %s\n", e.what());
+  }
+}
+
+void
+UIMediator::refreshLinkBudget()
+{
+  PSDLinkSettings curr = m_psdLink.current();
+  PSDLinkStats const &stats = m_psdLink.stats();
+  QString text;
+
+  if (!psdLinkEnabled() || !m_psdLink.haveStats()) {
+    m_linkBudgetLabel->hide();
+    return;
+  }
+
+  text = QString::asprintf(
+        "Link: %.1f fps, ",
+        stats.frameRate)
+      + SuWidgetsHelpers::formatBinaryQuantity(
+        SCAST(qint64, stats.throughput))
+      + QString::asprintf(
+        "/s, %.0f ms (target %.0f ms)",
+        stats.latencyMs,
+        m_psdLink.target());
+
+  if (m_psdLink.isAdapted())
+    text += QString::asprintf(
+          " | reduced to %u fps, %u bins",
+          curr.rate,
+          curr.fftSize);
+
+  m_linkBudgetLabel->setText(text);
+  m_linkBudgetLabel->show();
+}
+
 void
 UIMediator::feedPSD(const Suscan::PSDMessage &msg)
 {
   bool expired = false;
+  bool adaptive = psdLinkEnabled();
+
+  if (adaptive)
+    feedPSDLink(msg);
 
   if (m_appConfig->guiConfig.enableMsgTTL) {
     qreal delta;
@@ -42,6 +120,12 @@ UIMediator::feedPSD(const Suscan::PSDMessage &msg)
     qreal adj;
     max_delta = m_appConfig->guiConfig.msgTTL * 1e-3;
 
+    // Measure lag against what the server is actually sending
+    if (adaptive && m_psdLink.current().rate > 0) {
+      interval = 1. / m_psdLink.current().rate;
+      selRate  = m_psdLink.current().rate;
+    }
+
     gettimeofday(&now, nullptr);
 
     rttime = msg.getRealTimeStamp();
@@ -81,6 +165,7 @@ UIMediator::feedPSD(const Suscan::PSDMessage &msg)
       expired = delta > max_delta;
 
       if (m_appConfig->profile.isRemote()
+          && !adaptive
           && fabs(m_psdAdj / interval)
           < SIGDIGGER_UI_MEDIATOR_PSD_LAG_THRESHOLD) {
         if ((m_psdDelta - interval) / interval
@@ -19,6 +19,10 @@
 
 #include "UIMediator.h"
 #include <QTimeSlider.h>
+#include <QFileInfo>
+#include <PowerOverview.h>
+#include <PowerOverviewTask.h>
+#include <Suscan/Library.h>
 
 using namespace SigDigger;
 
@@ -41,6 +45,53 @@ UIMediator::setTimeStamp(struct timeval const &tv)
   m_ui->timeSlider->setTimeStamp(tv);
 }
 
+void
+UIMediator::refreshOverview()
+{
+  Suscan::Source::Config &profile = m_appConfig->profile;
+  std::string path;
+  QFileInfo info;
+
+  if (m_overviewTask != nullptr) {
+    m_overviewTask->cancel();
+    m_overviewTask = nullptr;
+  }
+
+  if (profile.isRemote()
+      || profile.isRealTime()
+      || !profile.fileIsValid()
+      || !PowerOverviewTask::supports(profile.getFormat())) {
+    m_overview = nullptr;
+    m_ui->timeSlider->setOverview(m_overview);
+    return;
+  }
+
+  path = profile.getPath();
+  info = QFileInfo(QString::fromStdString(path));
+
+  // The previous overview may still be referenced by a cancelled task
+  m_overview = std::make_shared<PowerOverview>();
+
+  if (!m_overview->load(
+        PowerOverview::pathFor(path),
+        SCAST(quint64, info.size()),
+        info.lastModified().toMSecsSinceEpoch())) {
+    m_overviewTask = new PowerOverviewTask(path, profile.getFormat(), m_overview);
+
+    connect(
+          m_overviewTask,
+          SIGNAL(overviewUpdated()),
+          this,
+          SLOT(onOverviewUpdated()));
+
+    Suscan::Singleton::get_instance()->getBackgroundTaskController()->pushTask(
+          m_overviewTask,
+          "Power overview of " + info.fileName());
+  }
+
+  m_ui->timeSlider->setOverview(m_overview);
+}
+
 void
 UIMediator::connectTimeSlider(void)
 {
@@ -57,3 +108,9 @@ UIMediator::onTimeStampChanged(void)
   emit seek(m_ui->timeSlider->getTimeStamp());
 }
 
+void
+UIMediator::onOverviewUpdated(void)
+{
+  m_ui->timeSlider->update();
+}
+
@@ -447,7 +447,8 @@ UIMediator::refreshUI()
       m_ui->main->actionRun->setChecked(false);
       m_ui->main->actionStart_capture->setEnabled(true);
       m_ui->main->actionStop_capture->setEnabled(false);
-      m_ui->panoramicDialog->setBannedDevice("");
+      if (m_ui->panoramicDialog.isReady())
+        m_ui->panoramicDialog->setBannedDevice("");
       m_ui->spectrum->notifyHalt();
       break;
 
@@ -474,9 +475,10 @@ UIMediator::refreshUI()
       m_ui->main->actionRun->setChecked(true);
       m_ui->main->actionStart_capture->setEnabled(false);
       m_ui->main->actionStop_capture->setEnabled(true);
-      m_ui->panoramicDialog->setBannedDevice(
-            QString::fromStdString(
-              m_appConfig->profile.getDevice().getDesc()));
+      if (m_ui->panoramicDialog.isReady())
+        m_ui->panoramicDialog->setBannedDevice(
+              QString::fromStdString(
+                m_appConfig->profile.getDevice().getDesc()));
       break;
 
     case RESTARTING:
@@ -529,6 +531,19 @@ UIMediator::refreshUI()
   setSampleRate(m_appConfig->profile.getDecimatedSampleRate());
 }
 
+void
+UIMediator::connectConfigDialog()
+{
+  m_ui->configDialog.whenReady([this] (ConfigDialog *dialog) {
+    dialog->setProfile(m_appConfig->profile);
+    dialog->setColors(m_appConfig->colors);
+    dialog->setGuiConfig(m_appConfig->guiConfig);
+    dialog->setTleSourceConfig(m_appConfig->tleSourceConfig);
+    dialog->setAudioConfig(m_appConfig->audioConfig);
+    dialog->setRemoteControlConfig(m_appConfig->rcConfig);
+  });
+}
+
 void
 UIMediator::connectMainWindow()
 {
@@ -574,11 +589,13 @@ UIMediator::connectMainWindow()
         this,
         SLOT(onQuickConnect()));
 
-  connect(
-        m_ui->quickConnectDialog,
-        SIGNAL(accepted()),
-        this,
-        SLOT(onQuickConnectAccepted()));
+  m_ui->quickConnectDialog.whenReady([this] (QuickConnectDialog *dialog) {
+    connect(
+          dialog,
+          SIGNAL(accepted()),
+          this,
+          SLOT(onQuickConnectAccepted()));
+  });
 
   connect(
         m_ui->main->actionStart_capture,
@@ -598,6 +615,12 @@ UIMediator::connectMainWindow()
         this,
         SLOT(onTriggerQuit(bool)));
 
+  connect(
+        m_ui->main->actionNew_window,
+        SIGNAL(triggered(bool)),
+        this,
+        SLOT(onTriggerNewWindow(bool)));
+
   connect(
         m_ui->main->actionRun,
         SIGNAL(triggered(bool)),
@@ -660,17 +683,20 @@ UIMediator::connectMainWindow()
         this,
         SLOT(onOpenBookmarkManager()));
 
-  connect(
-        m_ui->bookmarkManagerDialog,
-        SIGNAL(bookmarkSelected(BookmarkInfo)),
-        this,
-        SLOT(onJumpToBookmark(BookmarkInfo)));
-
-  connect(
-        m_ui->bookmarkManagerDialog,
-        SIGNAL(bookmarkChanged()),
-        this,
-        SLOT(onBookmarkChanged()));
+  m_ui->bookmarkManagerDialog.whenReady(
+        [this] (BookmarkManagerDialog *dialog) {
+    connect(
+          dialog,
+          SIGNAL(bookmarkSelected(BookmarkInfo)),
+          this,
+          SLOT(onJumpToBookmark(BookmarkInfo)));
+
+    connect(
+          dialog,
+          SIGNAL(bookmarkChanged()),
+          this,
+          SLOT(onBookmarkChanged()));
+  });
 
   m_ui->main->mainTab->tabBar()->setContextMenuPolicy(
         Qt::CustomContextMenu);
@@ -714,6 +740,26 @@ UIMediator::initUIListeners()
   }
 }
 
+GlobalProperty *
+UIMediator::makeProperty(
+    QString const &name,
+    QString const &desc,
+    QVariant const &value)
+{
+  GlobalProperty *prop = GlobalProperty::registerProperty(name, desc, value);
+
+  // Property names are process-wide and belong to the first window. Other
+  // windows keep private copies, out of reach of remote control and
+  // templates, so they do not fight over the same values.
+  if (prop == nullptr) {
+    prop = new GlobalProperty(name, desc);
+    prop->setParent(this);
+    prop->setValueSilent(value);
+  }
+
+  return prop;
+}
+
 UIMediator::UIMediator(QMainWindow *owner, AppUI *ui)
 {
   m_owner = owner;
@@ -748,22 +794,39 @@ UIMediator::UIMediator(QMainWindow *owner, AppUI *ui)
   connectMainWindow();
   connectSpectrum();
 
+  connectConfigDialog();
   connectDeviceDialog();
   connectPanoramicDialog();
   connectTimeSlider();
 
-  m_propFrequency = GlobalProperty::registerProperty("frequency", "Spectrum frequency", 0);
-  m_propLNB       = GlobalProperty::registerProperty("lnb", "LNB frequency", 0);
-  m_propSampRate  = GlobalProperty::registerProperty("samp_rate", "Sample rate", "N/A");
-  m_propFftSize   = GlobalProperty::registerProperty("fft_size", "Size of the FFT", 0);
-  m_propRBW       = GlobalProperty::registerProperty("rbw", "Resolution bandwidth", "N/A");
-  m_propDate      = GlobalProperty::registerProperty("date", "Source date (UTC)", "N/A");
-  m_propTime      = GlobalProperty::registerProperty("time", "Source time (UTC)", "N/A");
-  m_propDateTime  = GlobalProperty::registerProperty("datetime", "Source date and time (UTC)", "N/A");
-  m_propCity      = GlobalProperty::registerProperty("city", "City", "None");
-  m_propLat       = GlobalProperty::registerProperty("lat", "Receiver latitude", 0.0);
-  m_propLon       = GlobalProperty::registerProperty("lon", "Receiver longitude", 0.0);
-  m_propLocator   = GlobalProperty::registerProperty("locator", "Grid locator", "");
+  m_linkBudgetLabel = new QLabel(m_ui->main->statusBar);
+  m_linkBudgetLabel->hide();
+  m_ui->main->statusBar->addPermanentWidget(m_linkBudgetLabel);
+
+  m_memoryLabel = new QLabel(m_ui->main->statusBar);
+  m_memoryLabel->hide();
+  m_ui->main->statusBar->addPermanentWidget(m_memoryLabel);
+
+  connect(
+        MemoryBudget::instance(),
+        SIGNAL(usageChanged()),
+        this,
+        SLOT(onMemoryUsageChanged()));
+
+  m_propFrequency = makeProperty("frequency", "Spectrum frequency", 0);
+  m_propLNB       = makeProperty("lnb", "LNB frequency", 0);
+  m_propSampRate  = makeProperty("samp_rate", "Sample rate", "N/A");
+  m_propFftSize   = makeProperty("fft_size", "Size of the FFT", 0);
+  m_propRBW       = makeProperty("rbw", "Resolution bandwidth", "N/A");
+  m_propDate      = makeProperty("date", "Source date (UTC)", "N/A");
+  m_propTime      = makeProperty("time", "Source time (UTC)", "N/A");
+  m_propDateTime  = makeProperty("datetime", "Source date and time (UTC)", "N/A");
+  m_propCity      = makeProperty("city", "City", "None");
+  m_propLat       = makeProperty("lat", "Receiver latitude", 0.0);
+  m_propLon       = makeProperty("lon", "Receiver longitude", 0.0);
+  m_propLocator   = makeProperty("locator", "Grid locator", "");
+
+  m_ui->spectrum->setFFTProperties(m_propFftSize, m_propRBW);
 
   m_propFrequency->setAdjustable(true);
   connect(
@@ -841,8 +904,17 @@ UIMediator::setState(State state, Suscan::Analyzer *analyzer)
     m_state = state;
     m_analyzer = analyzer;
 
-    if (m_analyzer != nullptr)
-      connectAnalyzer();
+    if (state == RUNNING) {
+      PSDLinkSettings requested;
+
+      requested.rate    = SCAST(unsigned, qRound(
+            1. / m_appConfig->analyzerParams.psdUpdateInterval));
+      requested.fftSize = m_appConfig->analyzerParams.windowSize;
+
+      m_psdLink.reset(requested);
+    }
+
+    refreshLinkBudget();
 
     m_requestTracker->setAnalyzer(m_analyzer);
 
@@ -918,8 +990,12 @@ UIMediator::notifyTimeStamp(struct timeval const &timestamp)
 void
 UIMediator::refreshDevicesDone()
 {
-  m_ui->deviceDialog->refreshDone();
-  m_ui->configDialog->notifySingletonChanges();
+  // Dialogs built later will see the new device list anyway
+  if (m_ui->deviceDialog.isReady())
+    m_ui->deviceDialog->refreshDone();
+
+  if (m_ui->configDialog.isReady())
+    m_ui->configDialog->notifySingletonChanges();
 }
 
 QMessageBox::StandardButton
@@ -985,9 +1061,28 @@ UIMediator::notifyStartupErrors()
 void
 UIMediator::setAnalyzerParams(Suscan::AnalyzerParams const &params)
 {
+  PSDLinkSettings received;
+
+  received.rate    = SCAST(unsigned, qRound(1. / params.psdUpdateInterval));
+  received.fftSize = params.windowSize;
+
   m_appConfig->analyzerParams = params;
+
+  if (m_psdLink.isAdapted() && received == m_psdLink.current()) {
+    // These are our own degraded settings. Keep what the user asked for
+    // in the configuration.
+    PSDLinkSettings requested = m_psdLink.requested();
+
+    m_appConfig->analyzerParams.psdUpdateInterval = 1.f / requested.rate;
+    m_appConfig->analyzerParams.windowSize        = requested.fftSize;
+  } else if (received != m_psdLink.current()) {
+    // Changed by someone else (the user, most likely): start over
+    m_psdLink.reset(received);
+  }
+
   m_ui->spectrum->setExpectedRate(
         static_cast<int>(1.f / params.psdUpdateInterval));
+  refreshLinkBudget();
 }
 
 void
@@ -1009,7 +1104,8 @@ UIMediator::refreshProfile(bool updateFreqs)
   pass = getProfile()->getParam("password");
   interface = getProfile()->getInterface();
 
-  m_ui->configDialog->setProfile(m_appConfig->profile);
+  if (m_ui->configDialog.isReady())
+    m_ui->configDialog->setProfile(m_appConfig->profile);
 
   // Local sources, we may know the limits beforehand
   if (!m_appConfig->profile.isRemote()) {
@@ -1060,6 +1156,7 @@ UIMediator::refreshProfile(bool updateFreqs)
   m_ui->timeSlider->setEndTime(end);
   m_ui->timeSlider->setTimeStamp(tv);
   refreshTimeToolbarState();
+  refreshOverview();
 
   // Configure spectrum
   m_ui->spectrum->setFrequencyLimits(min, max);
@@ -1172,14 +1269,8 @@ UIMediator::applyConfig()
     m_ui->spectrum->setSidePanelRatio(m_appConfig->sidePanelRatio);
 
   // The following controls reflect elements of the configuration that are
-  // not owned by them. We need to set them manually.
-  m_ui->configDialog->setColors(m_appConfig->colors);
-  m_ui->configDialog->setGuiConfig(m_appConfig->guiConfig);
-  m_ui->configDialog->setTleSourceConfig(m_appConfig->tleSourceConfig);
-  m_ui->configDialog->setAudioConfig(m_appConfig->audioConfig);
-  m_ui->configDialog->setRemoteControlConfig(m_appConfig->rcConfig);
-  m_ui->panoramicDialog->setGuiConfig(m_appConfig->guiConfig);
-  m_ui->panoramicDialog->setColors(m_appConfig->colors);
+  // not owned by them. We need to set them manually. Dialogs pick their
+  // share of the configuration when they are first opened.
   m_ui->spectrum->setColorConfig(m_appConfig->colors);
 
   // Apply color config to all UI components
@@ -1193,6 +1284,7 @@ UIMediator::applyConfig()
 
   refreshQthProperties();
   m_ui->spectrum->setGuiConfig(m_appConfig->guiConfig);
+  refreshMemoryBudget();
 
   setAnalyzerParams(m_appConfig->analyzerParams);
 
@@ -1209,7 +1301,8 @@ UIMediator::applyConfig()
     }
 
   // The rest of them are automatically deserialized
-  m_ui->panoramicDialog->applyConfig();
+  if (m_ui->panoramicDialog.isReady())
+    m_ui->panoramicDialog->applyConfig();
 
   // Component config in each component is kept in serialized format,
   // so we have to instruct each component to parse it every time
@@ -1273,7 +1366,9 @@ UIMediator::openSettingsDialog(Suscan::Source::Config *prof)
   if (m_ui->configDialog->guiChanged()) {
     m_appConfig->guiConfig = m_ui->configDialog->getGuiConfig();
     m_ui->spectrum->setGuiConfig(m_appConfig->guiConfig);
-    m_ui->panoramicDialog->setGuiConfig(m_appConfig->guiConfig);
+    refreshMemoryBudget();
+    if (m_ui->panoramicDialog.isReady())
+      m_ui->panoramicDialog->setGuiConfig(m_appConfig->guiConfig);
   }
 
   if (m_ui->configDialog->audioChanged()) {
@@ -1571,6 +1666,12 @@ UIMediator::onTriggerQuit(bool)
   emit uiQuit();
 }
 
+void
+UIMediator::onTriggerNewWindow(bool)
+{
+  emit newWindow();
+}
+
 void
 UIMediator::onTriggerPanoramicSpectrum(bool)
 {
@@ -1851,3 +1952,78 @@ UIMediator::onTriggerReplayFile(bool)
       break;
   } while (!attemptReplayFile(path));
 }
+
+void
+UIMediator::refreshMemoryBudget()
+{
+  ArenaPolicy policy = Arena::instance().policy();
+  quint64 budget =
+      SCAST(quint64, m_appConfig->guiConfig.memoryBudget) << 20;
+
+  policy.hugePages = SCAST(
+        ArenaHugePages,
+        qBound(
+          SCAST(int, ARENA_HUGEPAGES_NONE),
+          m_appConfig->guiConfig.hugePages,
+          SCAST(int, ARENA_HUGEPAGES_EXPLICIT)));
+  policy.numaNode  = m_appConfig->guiConfig.numaNode;
+
+  Arena::instance().setPolicy(policy);
+
+  // Idle cached blocks may take a quarter of the budget, at most
+  Arena::instance().setCacheLimit(
+        budget == SIGDIGGER_MEMORY_BUDGET_UNLIMITED
+        ? SIGDIGGER_ARENA_CACHE_LIMIT
+        : SCAST(size_t, budget / 4));
+
+  MemoryBudget::instance()->add(&Arena::instance());
+  MemoryBudget::instance()->setBudget(budget);
+
+  onMemoryUsageChanged();
+}
+
+void
+UIMediator::onMemoryUsageChanged()
+{
+  MemoryBudget *budget = MemoryBudget::instance();
+  quint64 resident = budget->resident();
+  quint64 spilled  = budget->spilled();
+  QString text, toolTip;
+
+  if (resident == 0 && spilled == 0) {
+    m_memoryLabel->hide();
+    return;
+  }
+
+  text = "Buffers: " + SuWidgetsHelpers::formatBinaryQuantity(
+        SCAST(qint64, resident));
+
+  if (budget->budget() != SIGDIGGER_MEMORY_BUDGET_UNLIMITED)
+    text += " / " + SuWidgetsHelpers::formatBinaryQuantity(
+          SCAST(qint64, budget->budget()));
+
+  if (spilled > 0)
+    text += " (" + SuWidgetsHelpers::formatBinaryQuantity(
+          SCAST(qint64, spilled)) + " on disk)";
+
+  for (auto const &p : budget->usage()) {
+    if (p.resident == 0 && p.spilled == 0)
+      continue;
+
+    if (!toolTip.isEmpty())
+      toolTip += "\n";
+
+    toolTip += p.name + ": "
+        + SuWidgetsHelpers::formatBinaryQuantity(SCAST(qint64, p.resident))
+        + " in memory";
+
+    if (p.spilled > 0)
+      toolTip += ", "
+          + SuWidgetsHelpers::formatBinaryQuantity(SCAST(qint64, p.spilled))
+          + " on disk";
+  }
+
+  m_memoryLabel->setText(text);
+  m_memoryLabel->setToolTip(toolTip);
+  m_memoryLabel->show();
+}
@@ -31,6 +31,7 @@
 #include "TLESourceConfig.h"
 #include "AudioConfig.h"
 #include "RemoteControlConfig.h"
+#include "CapturePrefetcher.h"
 
 #define SIGDIGGER_FFT_WINDOW_SIZE  4096u
 #define SIGDIGGER_FFT_REFRESH_RATE 25u
@@ -69,6 +70,7 @@ namespace SigDigger {
       int y = -1;
       qreal sidePanelRatio = .16;
       bool disableHighRateWarning = false;
+      int prefetchWindowMs = SIGDIGGER_PREFETCH_DEFAULT_WINDOW_MS;
 
       int loFreq = 0;
       unsigned int bandwidth = 0;
@@ -20,6 +20,7 @@
 #define APPUI_H
 
 #include <Suscan/Analyzer.h>
+#include <LazyWidget.h>
 
 class QMainWindow;
 class Ui_MainWindow;
@@ -30,6 +31,7 @@ namespace SigDigger {
   class ConfigDialog;
   class DeviceDialog;
   class PanoramicDialog;
+  class PanoramicDialogConfig;
   class MainSpectrum;
   class AboutDialog;
   class DataSaverUI;
@@ -43,20 +45,26 @@ namespace SigDigger {
 
   class UIMediator;
 
+  //
+  // Dialogs that are not needed until the user asks for them are built on
+  // first use. Their configuration (if any) lives outside of them, so it
+  // can be deserialized and saved without building them.
+  //
   struct AppUI {
     Ui_MainWindow *main = nullptr;
     UIMediator *uiMediator = nullptr;
-    ConfigDialog *configDialog = nullptr;
-    DeviceDialog *deviceDialog = nullptr;
-    PanoramicDialog *panoramicDialog = nullptr;
+    LazyWidget<ConfigDialog> configDialog;
+    LazyWidget<DeviceDialog> deviceDialog;
+    LazyWidget<PanoramicDialog> panoramicDialog;
+    PanoramicDialogConfig *panoramicConfig = nullptr;
     MainSpectrum *spectrum = nullptr;
-    AboutDialog *aboutDialog = nullptr;
+    LazyWidget<AboutDialog> aboutDialog;
     DataSaverUI *dataSaverUI = nullptr;
     LogDialog *logDialog = nullptr;
-    QuickConnectDialog *quickConnectDialog = nullptr;
+    LazyWidget<QuickConnectDialog> quickConnectDialog;
     BackgroundTasksDialog *backgroundTasksDialog = nullptr;
     AddBookmarkDialog *addBookmarkDialog = nullptr;
-    BookmarkManagerDialog *bookmarkManagerDialog = nullptr;
+    LazyWidget<BookmarkManagerDialog> bookmarkManagerDialog;
     QToolBar *timeToolbar;
     QTimeSlider *timeSlider = nullptr;
 
@@ -28,12 +28,14 @@
 /* Local includes */
 #include "AppConfig.h"
 #include "UIMediator.h"
+#include "CaptureIndex.h"
 
 #define SIGDIGGER_AUTOSAVE_INTERVAL_MS (1800 * 1000)
 
 namespace SigDigger {
   class Scanner;
   class FileDataSaver;
+  class CapturePrefetcher;
 
   class DeviceDetectWorker : public QObject {
       Q_OBJECT
@@ -60,6 +62,7 @@ namespace SigDigger {
     std::unique_ptr<Suscan::Analyzer> m_analyzer = nullptr;
 
     bool m_profileSelected = false;
+    bool m_primary = true;
     unsigned int m_currSampleRate;
     bool m_filterInstalled = false;
 
@@ -68,11 +71,20 @@ namespace SigDigger {
     UIMediator *m_mediator = nullptr;
     QTimer m_uiTimer;
     QElapsedTimer m_cfgTimer;
+    QElapsedTimer m_startupTimer;
     bool m_sourceInfoReceived = false;
 
     // Panoramic spectrum
     Scanner *m_scanner = nullptr;
 
+    // Page cache warm-up for file replay
+    CapturePrefetcher *m_prefetcher = nullptr;
+
+    // Receive times of the file being replayed, if it was indexed
+    CaptureIndex m_captureIndex;
+    struct timeval m_captureStart = {0, 0};
+    unsigned int m_captureRate = 0;
+
     // Rediscover devices
     QThread *m_deviceDetectThread;
     DeviceDetectWorker *m_deviceDetectWorker;
@@ -85,7 +97,12 @@ namespace SigDigger {
     void connectScanner();
 
     void hotApplyProfile(Suscan::Source::Config const *);
+    void refreshPrefetcher(Suscan::Source::Config const &);
+    void refreshCaptureIndex(Suscan::Source::Config const &);
+    struct timeval indexedSeekTime(struct timeval const &) const;
     void orderedHalt();
+    void logAnalyzerStats();
+    void logStartupStats();
 
   public:
     // Application methods
@@ -101,6 +118,9 @@ namespace SigDigger {
 
     FileDataSaver *getSaver() const;
 
+    void setPrimary(bool);
+    bool isPrimary() const;
+
     explicit Application(QWidget *parent = nullptr);
     ~Application() override;
 
@@ -115,6 +135,7 @@ namespace SigDigger {
   signals:
     void detectDevices();
     void triggerSaveConfig();
+    void newWindowRequested();
 
   public slots:
     // UI Slots
@@ -0,0 +1,156 @@
+//
+//    ArenaAllocator.h: Aligned, huge page and NUMA aware buffer arena
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef ARENAALLOCATOR_H
+#define ARENAALLOCATOR_H
+
+#include <QMutex>
+#include <QString>
+#include <MemoryBudget.h>
+#include <map>
+#include <new>
+#include <vector>
+
+// Enough for AVX-512 loads and whatever FFTW wants
+#define SIGDIGGER_ARENA_ALIGNMENT        64
+
+// Blocks at least this large are mapped directly and recycled
+#define SIGDIGGER_ARENA_LARGE_THRESHOLD  (size_t(1) << 20)
+#define SIGDIGGER_ARENA_HUGEPAGE_SIZE    (size_t(2) << 20)
+
+// Released large blocks kept around (already faulted in) for reuse. The
+// memory budget, when set, may lower this further.
+#define SIGDIGGER_ARENA_CACHE_LIMIT      (size_t(128) << 20)
+
+#define SIGDIGGER_ARENA_ANY_NODE         -1
+
+namespace SigDigger {
+  enum ArenaHugePages {
+    ARENA_HUGEPAGES_NONE,
+    ARENA_HUGEPAGES_TRANSPARENT,
+    ARENA_HUGEPAGES_EXPLICIT
+  };
+
+  struct ArenaPolicy {
+    ArenaHugePages hugePages = ARENA_HUGEPAGES_TRANSPARENT;
+    int            numaNode  = SIGDIGGER_ARENA_ANY_NODE;
+    bool           prefault  = true;
+  };
+
+  struct ArenaStats {
+    quint64 allocations  = 0;  // All of them, small ones included
+    quint64 mappings     = 0;  // Large blocks mapped from the system
+    quint64 reused       = 0;  // Large blocks served from the cache
+    quint64 hugeTLB      = 0;  // Mappings backed by explicit huge pages
+    quint64 hugeTLBFails = 0;  // Explicit huge pages requested, not got
+    quint64 bytesInUse   = 0;  // Large blocks handed out
+    quint64 bytesCached  = 0;  // Large blocks waiting for reuse
+  };
+
+  //
+  // Process-wide arena for sample and FFT buffers, safe to use from any
+  // thread. Small blocks come from the aligned heap. Large blocks are
+  // mapped directly, hinted (or backed) with huge pages, placed on the
+  // preferred NUMA node and faulted in right away, so the first pass of
+  // a transform does not pay for it page by page. Released large blocks
+  // are cached and handed out again to the next task of similar size.
+  //
+  // The cache is resident memory nobody is using, so it is charged
+  // against the memory budget and is the first thing to go when over it.
+  //
+  class Arena : public MemoryConsumer
+  {
+    mutable QMutex               m_mutex;
+    ArenaPolicy                  m_policy;
+    ArenaStats                   m_stats;
+    std::map<void *, size_t>     m_blocks;   // Large blocks in use
+    std::multimap<size_t, void *> m_cache;   // Large blocks released
+    size_t                       m_cacheLimit = SIGDIGGER_ARENA_CACHE_LIMIT;
+
+    Arena();
+
+    size_t roundUp(size_t bytes) const;
+    void *map(size_t bytes);
+    void unmap(void *ptr, size_t bytes);
+    quint64 trimUnlocked(size_t limit);
+
+  public:
+    static Arena &instance();
+
+    void setPolicy(ArenaPolicy const &);
+    ArenaPolicy policy() const;
+    void setCacheLimit(size_t bytes);
+    ArenaStats stats() const;
+
+    void *allocate(size_t bytes);
+    void release(void *ptr);
+    void trim();
+
+    // MemoryConsumer: the cache of released blocks
+    QString memoryConsumerName() const override;
+    quint64 residentBytes() const override;
+    quint64 spill() override;
+
+    // Apply the current huge page and NUMA policy to memory mapped by
+    // someone else (e.g. SampleBuffer's reserved range).
+    void advise(void *ptr, size_t bytes) const;
+  };
+
+  //
+  // Standard allocator on top of the arena, so containers can use it.
+  //
+  template <class T>
+  class ArenaAllocator
+  {
+  public:
+    typedef T value_type;
+
+    ArenaAllocator() = default;
+
+    template <class U>
+    ArenaAllocator(ArenaAllocator<U> const &) {}
+
+    T *
+    allocate(size_t n)
+    {
+      void *ptr = Arena::instance().allocate(n * sizeof(T));
+
+      if (ptr == nullptr)
+        throw std::bad_alloc();
+
+      return static_cast<T *>(ptr);
+    }
+
+    void
+    deallocate(T *ptr, size_t)
+    {
+      Arena::instance().release(ptr);
+    }
+
+    template <class U>
+    bool operator==(ArenaAllocator<U> const &) const { return true; }
+
+    template <class U>
+    bool operator!=(ArenaAllocator<U> const &) const { return false; }
+  };
+
+  template <class T>
+  using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
+
+#endif // ARENAALLOCATOR_H
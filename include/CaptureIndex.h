@@ -0,0 +1,143 @@
+//
+//    CaptureIndex.h: Seek index of baseband recordings
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef CAPTUREINDEX_H
+#define CAPTUREINDEX_H
+
+#include <QFile>
+#include <QMutex>
+#include <sigutils/types.h>
+#include <sigutils/util/compat-time.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define SIGDIGGER_CAPTURE_INDEX_SUFFIX     ".sdidx"
+#define SIGDIGGER_CAPTURE_INDEX_MAGIC      "SDCAPIDX"
+#define SIGDIGGER_CAPTURE_INDEX_VERSION    1
+#define SIGDIGGER_CAPTURE_INDEX_MIN_BLOCK  4096 // Samples
+#define SIGDIGGER_CAPTURE_INDEX_BLOCK_TIME .1   // Seconds
+#define SIGDIGGER_CAPTURE_INDEX_NAME_LEN   20
+
+struct suscan_source_metadata;
+
+namespace SigDigger {
+  //
+  // Capture indices are stored next to a raw float32 I/Q recording, with
+  // the same name plus SIGDIGGER_CAPTURE_INDEX_SUFFIX. The recording itself
+  // is left untouched, so it can still be read by any file source.
+  //
+  // The index is a fixed header followed by an append-only sequence of
+  // fixed-size records: one BLOCK record every blockSize samples (with the
+  // time at which that sample was received) and a final END record. Every
+  // record carries its own checksum, so an index left behind by a crash is
+  // read up to its last complete record.
+  //
+  // File sources place sample n at start + n / fs. When the recording
+  // dropped samples, that drifts away from the time the sample was actually
+  // received; sampleAt() undoes the drift so seeks land where they should.
+  //
+  enum CaptureIndexRecordType {
+    CAPTURE_INDEX_RECORD_BLOCK     = 1,
+    CAPTURE_INDEX_RECORD_END       = 4
+  };
+
+  struct CaptureIndexHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t format;       // suscan source format
+    double   sampleRate;
+    double   frequency;
+    int64_t  tv_sec;
+    int64_t  tv_usec;
+    uint64_t blockSize;    // Samples
+    uint32_t reserved;
+    uint32_t checksum;
+  };
+
+  struct CaptureIndexRecord {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t sample;
+    int64_t  tv_sec;
+    int64_t  tv_usec;
+    double   value;
+    char     name[SIGDIGGER_CAPTURE_INDEX_NAME_LEN];
+    uint32_t checksum;
+  };
+
+  class CaptureIndexWriter
+  {
+    QMutex         m_mutex;
+    QFile          m_file;
+    qreal          m_fs = 0;
+    SUSCOUNT       m_blockSize = SIGDIGGER_CAPTURE_INDEX_MIN_BLOCK;
+    quint64        m_written = 0;
+    quint64        m_nextBlock = 0;
+    std::string    m_lastError;
+
+    bool appendUnlocked(
+        CaptureIndexRecordType type,
+        quint64 sample,
+        struct timeval const &tv);
+
+  public:
+    CaptureIndexWriter();
+    ~CaptureIndexWriter();
+
+    bool open(std::string const &path, qreal fs, SUFREQ freq);
+    void close();
+
+    // Called from the baseband filter, once per batch of saved samples
+    void feed(SUSCOUNT len);
+
+    std::string getLastError() const;
+  };
+
+  class CaptureIndex
+  {
+    CaptureIndexHeader          m_header;
+    std::vector<struct timeval> m_blocks;
+    quint64                     m_end = 0;
+    bool                        m_complete = false;
+    bool                        m_loaded = false;
+
+  public:
+    CaptureIndex();
+
+    static std::string pathFor(std::string const &dataPath);
+    static bool guessMetadata(
+        std::string const &dataPath,
+        struct suscan_source_metadata &meta);
+
+    bool load(std::string const &path);
+
+    bool isLoaded() const;
+    bool isComplete() const;
+    qreal sampleRate() const;
+    SUFREQ initialFrequency() const;
+    struct timeval startTime() const;
+
+    // Time at which a sample was received, and its inverse. Both are
+    // clamped to the recorded range and interpolate within a block.
+    struct timeval timeAt(quint64 sample) const;
+    quint64 sampleAt(struct timeval const &tv) const;
+  };
+}
+
+#endif // CAPTUREINDEX_H
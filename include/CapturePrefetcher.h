@@ -0,0 +1,106 @@
+//
+//    CapturePrefetcher.h: Warm up the page cache around the playhead
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef CAPTUREPREFETCHER_H
+#define CAPTUREPREFETCHER_H
+
+#include <QObject>
+#include <QThread>
+#include <QFile>
+#include <sigutils/util/compat-time.h>
+#include <atomic>
+#include <vector>
+
+#define SIGDIGGER_PREFETCH_DEFAULT_WINDOW_MS 10000
+#define SIGDIGGER_PREFETCH_BEHIND_FRACTION   .25
+#define SIGDIGGER_PREFETCH_MAX_WINDOW_BYTES  (256ll << 20)
+#define SIGDIGGER_PREFETCH_CHUNK_SIZE        (1 << 20)
+
+namespace SigDigger {
+  //
+  // Lives in the reader thread. Every request carries a generation
+  // number, and requests superseded by a newer one are abandoned as soon
+  // as possible (even in the middle of a window).
+  //
+  class CapturePrefetchWorker : public QObject
+  {
+    Q_OBJECT
+
+    QFile                 m_file;
+    qint64                m_size = 0;
+    qint64                m_cachedStart = 0;
+    qint64                m_cachedEnd = 0;
+    std::atomic<quint64> &m_generation;
+    std::vector<char>     m_scratch;
+
+    bool fetch(quint64 generation, qint64 start, qint64 end);
+
+  public:
+    CapturePrefetchWorker(std::atomic<quint64> &generation);
+    ~CapturePrefetchWorker() override;
+
+  public slots:
+    void onOpen(QString path);
+    void onClose();
+    void onPrefetch(quint64 generation, qint64 start, qint64 end);
+  };
+
+  //
+  // Front end, used from the GUI thread. Translates playhead positions
+  // into byte ranges of the capture and hands them to the reader thread.
+  //
+  class CapturePrefetcher : public QObject
+  {
+    Q_OBJECT
+
+    QThread               *m_thread = nullptr;
+    CapturePrefetchWorker *m_worker = nullptr;
+    std::atomic<quint64>   m_generation;
+
+    bool                   m_open = false;
+    qint64                 m_size = 0;
+    struct timeval         m_start;
+    struct timeval         m_end;
+    qint64                 m_windowMs = SIGDIGGER_PREFETCH_DEFAULT_WINDOW_MS;
+    qint64                 m_lastStart = -1;
+    qint64                 m_lastEnd = -1;
+
+  public:
+    CapturePrefetcher(QObject *parent = nullptr);
+    ~CapturePrefetcher() override;
+
+    bool setCapture(
+        std::string const &path,
+        struct timeval const &start,
+        struct timeval const &end);
+    void clear();
+    bool isActive() const;
+
+    void setWindow(qint64 ms);
+    qint64 window() const;
+
+    void setPlayhead(struct timeval const &tv, bool seek = false);
+
+  signals:
+    void open(QString);
+    void close();
+    void prefetch(quint64, qint64, qint64);
+  };
+}
+
+#endif // CAPTUREPREFETCHER_H
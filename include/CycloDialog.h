@@ -0,0 +1,84 @@
+//
+//    include/CycloDialog.h: Cyclostationary analysis results
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef CYCLODIALOG_H
+#define CYCLODIALOG_H
+
+#include <QDialog>
+#include <QImage>
+#include <sigutils/types.h>
+#include "ColorConfig.h"
+#include "CycloSpectrumTask.h"
+
+namespace Ui {
+  class CycloDialog;
+}
+
+namespace SigDigger {
+  class CycloDialog : public QDialog
+  {
+    Q_OBJECT
+
+    std::vector<SUFLOAT>   m_map;
+    std::vector<SUCOMPLEX> m_profile;
+    std::vector<CycloPeak> m_peaks;
+    unsigned int m_mapCols = 0;
+    unsigned int m_mapRows = 0;
+    unsigned int m_channels = SIGDIGGER_CYCLO_DEFAULT_CHANNELS;
+    bool  m_conjugate = false;
+    qreal m_fs = 1;
+    qreal m_alphaMin = 0;
+    qreal m_alphaMax = 0;
+    qreal m_alphaStep = 1;
+    qreal m_profileMax = 1;
+
+    QColor m_gradient[256];
+    QImage m_image;
+
+    void connectAll(void);
+    void renderMap(void);
+    void refreshMap(void);
+    void refreshPeaks(void);
+    void zoomReset(void);
+
+  public:
+    explicit CycloDialog(QWidget *parent = nullptr);
+    ~CycloDialog() override;
+
+    void giveResult(CycloSpectrumTask *task);
+    void setPalette(const QColor *gradient);
+    void setColorConfig(ColorConfig const &);
+
+    unsigned int getChannels(void) const;
+    bool getConjugate(void) const;
+
+    void showEvent(QShowEvent *) override;
+    void resizeEvent(QResizeEvent *) override;
+
+  signals:
+    void recompute(void);
+
+  public slots:
+    void onZoomReset(void);
+
+  private:
+    Ui::CycloDialog *ui;
+  };
+}
+
+#endif // CYCLODIALOG_H
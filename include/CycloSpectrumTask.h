@@ -0,0 +1,154 @@
+//
+//    include/CycloSpectrumTask.h: Spectral correlation by FFT accumulation
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef CYCLOSPECTRUMTASK_H
+#define CYCLOSPECTRUMTASK_H
+
+#include <Suscan/CancellableTask.h>
+#include <sigutils/types.h>
+#include <ArenaAllocator.h>
+#include <vector>
+
+#define SIGDIGGER_CYCLO_DEFAULT_CHANNELS 64
+#define SIGDIGGER_CYCLO_MAX_FRAMES       4096
+#define SIGDIGGER_CYCLO_MIN_FRAMES       16
+#define SIGDIGGER_CYCLO_MAP_COLUMNS      1024
+#define SIGDIGGER_CYCLO_MAX_PEAKS        8
+
+namespace SigDigger {
+  struct CycloPeak {
+    qreal alpha;    // Cycle frequency, in Hz
+    qreal strength; // Above the median of the profile, in dB
+  };
+
+  //
+  // Estimates the spectral correlation function with the FFT accumulation
+  // method. The capture is channelized into `channels` bins with a hop of a
+  // quarter of a channel, and every pair of channels is correlated along
+  // time with a second FFT. Consecutive blocks of frames are averaged, and
+  // the channel pairs of each block are spread across all available cores.
+  //
+  // The result is a (cycle frequency, frequency) map plus a cycle frequency
+  // profile (maximum over frequency), whose strongest lines are reported
+  // as peaks. The non-conjugate correlation exposes symbol rates, the
+  // conjugate one exposes carriers of BPSK-like signals at twice their
+  // frequency.
+  //
+  class CycloSpectrumTask : public Suscan::CancellableTask {
+    Q_OBJECT
+
+    enum State {
+      PLANNING,
+      CORRELATING,
+      PICKING
+    };
+
+    struct Worker;
+
+    State                  m_state = PLANNING;
+    const SUCOMPLEX       *m_data = nullptr;
+    size_t                 m_length;
+    qreal                  m_fs;
+    bool                   m_conjugate;
+
+    unsigned int           m_channels;
+    unsigned int           m_hop;
+    unsigned int           m_frames;
+    unsigned int           m_blocks = 0;
+    unsigned int           m_block = 0;
+
+    SU_FFTW(_plan)         m_chanPlan = nullptr;
+    SU_FFTW(_plan)         m_corrPlan = nullptr;
+    SU_FFTW(_complex)     *m_chanBuf = nullptr;
+    SU_FFTW(_complex)     *m_corrBuf = nullptr;
+    ArenaVector<SUFLOAT>   m_window;
+    ArenaVector<SUCOMPLEX> m_demod;      // frames x channels
+    std::vector<Worker *>  m_workers;
+
+    // Results
+    qint64                 m_alphaMin = 0;
+    qint64                 m_alphaCount = 0;
+    unsigned int           m_mapRows = 0;
+    unsigned int           m_mapCols = SIGDIGGER_CYCLO_MAP_COLUMNS;
+    std::vector<SUFLOAT>   m_map;        // m_mapCols x m_mapRows, row major
+    std::vector<SUFLOAT>   m_profile;
+    std::vector<CycloPeak> m_peaks;
+
+    bool plan(void);
+    void channelize(unsigned int block);
+    void correlate(Worker *worker, unsigned int row);
+    void runBlock(void);
+    void pickPeaks(void);
+
+  public:
+    CycloSpectrumTask(
+        const SUCOMPLEX *data,
+        size_t length,
+        qreal fs,
+        unsigned int channels = SIGDIGGER_CYCLO_DEFAULT_CHANNELS,
+        bool conjugate = false,
+        QObject *parent = nullptr);
+    ~CycloSpectrumTask() override;
+
+    bool work(void) override;
+    void cancel(void) override;
+
+    bool
+    isConjugate(void) const
+    {
+      return m_conjugate;
+    }
+
+    unsigned int
+    channels(void) const
+    {
+      return m_channels;
+    }
+
+    qreal
+    sampleRate(void) const
+    {
+      return m_fs;
+    }
+
+    // Cycle frequency resolution, in Hz
+    qreal alphaStep(void) const;
+
+    // Cycle frequency of the first map column / profile entry, in Hz
+    qreal alphaMin(void) const;
+    qreal alphaMax(void) const;
+
+    unsigned int
+    mapColumns(void) const
+    {
+      return m_mapCols;
+    }
+
+    unsigned int
+    mapRows(void) const
+    {
+      return m_mapRows;
+    }
+
+    std::vector<SUFLOAT> &&takeMap(void);
+    std::vector<SUFLOAT> &&takeProfile(void);
+    std::vector<CycloPeak> const &getPeaks(void) const;
+  };
+}
+
+#endif // CYCLOSPECTRUMTASK_H
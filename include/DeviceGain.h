@@ -50,6 +50,24 @@ namespace SigDigger {
       return this->name;
     }
 
+    float
+    getMin(void) const
+    {
+      return this->min;
+    }
+
+    float
+    getMax(void) const
+    {
+      return this->max;
+    }
+
+    float
+    getStep(void) const
+    {
+      return this->step;
+    }
+
     void setGain(float);
     float getGain(void) const;
 
@@ -0,0 +1,137 @@
+//
+//    include/ExportSymbolsTask.h: Export symbol captures in the background
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef EXPORTSYMBOLSTASK_H
+#define EXPORTSYMBOLSTASK_H
+
+#include <Suscan/CancellableTask.h>
+#include <QElapsedTimer>
+#include <QColor>
+#include <SymView.h>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#define SIGDIGGER_SYMBOL_STORE_CHUNK 0x10000 // Symbols
+
+namespace SigDigger {
+  typedef std::shared_ptr<std::vector<Symbol>> SymbolChunk;
+
+  //
+  // Read-only view of a symbol store, as it was when taken. It shares
+  // the chunks of the store, so taking it costs one pointer per chunk.
+  //
+  class SymbolSnapshot
+  {
+      std::vector<SymbolChunk> m_chunks;
+      size_t                   m_size = 0;
+
+      friend class SymbolStore;
+
+    public:
+      size_t
+      size() const
+      {
+        return m_size;
+      }
+
+      bool
+      empty() const
+      {
+        return m_size == 0;
+      }
+
+      Symbol
+      operator[](size_t i) const
+      {
+        return (*m_chunks[i / SIGDIGGER_SYMBOL_STORE_CHUNK])
+            [i % SIGDIGGER_SYMBOL_STORE_CHUNK];
+      }
+  };
+
+  //
+  // Symbols fed to a symbol view, kept around for exporting. Symbols are
+  // stored in fixed-size chunks that snapshots share: a running export
+  // never forces a copy of the whole capture. Only the last, partially
+  // filled chunk is copied if symbols arrive while a snapshot holds it.
+  //
+  class SymbolStore
+  {
+      SymbolSnapshot m_symbols;
+
+    public:
+      void append(const Symbol *data, size_t length);
+      void clear();
+      SymbolSnapshot snapshot() const;
+  };
+
+  //
+  // ExportSymbolsTask works on a snapshot of the symbol store, so the
+  // symbol view can keep receiving symbols (or be cleared) while the export
+  // takes place. Text, binary, C and PPM outputs are streamed block by block.
+  // The rest of the image formats are rendered row by row into a QImage,
+  // which is safe to use outside the GUI thread.
+  //
+  class ExportSymbolsTask : public Suscan::CancellableTask
+  {
+      Q_OBJECT
+
+      std::ofstream        m_of;
+      QElapsedTimer        m_timer;
+      QString              m_path;
+      SymView::FileFormat  m_format;
+      SymbolSnapshot       m_data;
+      unsigned int         m_bps;
+      unsigned int         m_stride;
+      QColor               m_lo;
+      QColor               m_hi;
+
+      QString m_lastError;
+      bool    m_cancelFlag = false;
+
+      void breathe(quint64);
+      QRgb symbolToRgb(Symbol) const;
+
+      bool openStream();
+
+      bool exportToText();
+      bool exportToRaw();
+      bool exportToCArray();
+      bool exportToPPM();
+      bool exportToImage(const char *);
+
+    public:
+      ExportSymbolsTask(
+          QString const &path,
+          SymView::FileFormat format,
+          SymbolSnapshot const &data,
+          unsigned int bps,
+          unsigned int stride,
+          QColor const &lo,
+          QColor const &hi);
+      ~ExportSymbolsTask() override;
+      bool attemptOpen();
+
+      bool work() override;
+      void cancel() override;
+
+      QString getLastError() const;
+  };
+}
+
+#endif // EXPORTSYMBOLSTASK_H
@@ -0,0 +1,111 @@
+//
+//    GainController.h: Closed-loop hardware gain control
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef GAINCONTROLLER_H
+#define GAINCONTROLLER_H
+
+#include <QMutex>
+#include <QElapsedTimer>
+#include <sigutils/types.h>
+#include <sys/time.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#define SIGDIGGER_GAIN_CONTROLLER_CLIP_LEVEL      .99f
+#define SIGDIGGER_GAIN_CONTROLLER_FLOOR_BLOCK     256
+#define SIGDIGGER_GAIN_CONTROLLER_MAX_EVENTS      64
+
+namespace SigDigger {
+  //
+  // Baseband statistics, accumulated between two calls to
+  // GainController::take(). Full scale is 1 per I/Q component.
+  //
+  struct BasebandStats {
+    SUSCOUNT samples = 0;
+    SUSCOUNT clipped = 0;  // Samples with any component at the clip level
+    SUFLOAT  peak    = 0;  // Maximum |x|^2
+    SUFLOAT  energy  = 0;  // Sum of |x|^2
+    SUFLOAT  floor   = 0;  // Minimum block-averaged |x|^2
+
+    qreal clipRatio() const;
+    qreal peakDb() const;
+    qreal rmsDb() const;
+    qreal crestDb() const;
+    qreal floorDb() const;
+  };
+
+  struct GainEvent {
+    struct timeval tv;
+    std::string    name;
+    float          value;
+    bool           automatic;
+  };
+
+  struct GainControllerParams {
+    qreal maxClipRatio      = 1e-4;  // Above this, reduce gain
+    qreal targetPeakDb      = -6;    // dBFS
+    qreal hysteresisDb      = 6;     // Increase only below target - hyst.
+    qreal maxFloorDb        = -30;   // Never push the noise floor above this
+    qreal maxStepDb         = 6;
+    qint64 decreaseHoldMs   = 250;
+    qint64 increaseHoldMs   = 2000;
+    qint64 clipHoldMs       = 5000;  // No increases after clipping
+    SUSCOUNT minSamples     = 4096;
+  };
+
+  //
+  // Statistics are accumulated from the analyzer thread (feed), and
+  // collected and acted upon from the GUI thread (take, decide). The
+  // controller only suggests corrections in dB: applying them to the
+  // actual device gains is up to the caller, which then reports them back
+  // through recordEvent().
+  //
+  class GainController
+  {
+    mutable QMutex          m_mutex;
+    BasebandStats           m_acc;
+    SUFLOAT                 m_blockEnergy = 0;
+    SUSCOUNT                m_blockLen = 0;
+
+    GainControllerParams    m_params;
+    QElapsedTimer           m_lastChange;
+    QElapsedTimer           m_lastClip;
+    std::deque<GainEvent>   m_events;
+
+  public:
+    GainController();
+
+    void setParams(GainControllerParams const &);
+    GainControllerParams const &params() const;
+
+    // Analyzer thread
+    void feed(const SUCOMPLEX *samples, SUSCOUNT length);
+
+    // GUI thread
+    BasebandStats take();
+    qreal decide(BasebandStats const &stats);
+    void holdOff();
+    void reset();
+
+    void recordEvent(std::string const &name, float value, bool automatic);
+    std::vector<GainEvent> events() const;
+  };
+}
+
+#endif // GAINCONTROLLER_H
@@ -24,10 +24,12 @@
 #include <QObject>
 #include <QThread>
 #include <QMutex>
+#include <QTimer>
 #include <vector>
 #include <sigutils/types.h>
 #include <sigutils/util/compat-time.h>
 #include <stdint.h>
+#include <ArenaAllocator.h>
 
 namespace SigDigger {
   class GenericDataSaver;
@@ -40,12 +42,28 @@ namespace SigDigger {
 #define TEMPLATE_FOR_WRITE_NO_MATTER_WHAT(typename_T)       \
   virtual ssize_t write(const typename_T *data, size_t len)
 
+  // One producer chunk, as it was written to the saver. Writers that
+  // support scatter/gather I/O receive a list of these per commit.
+  struct GenericDataChunk {
+    const uint8_t *data;
+    size_t len;
+  };
+
   class GenericDataWriter {
   public:
     virtual bool prepare(void) = 0;
     virtual bool canWrite(void) const = 0;
     virtual ssize_t write(const void *data, size_t len) = 0;
 
+    // Write as many chunks as possible in one go, returning the number of
+    // bytes actually written (or < 1 on error). The default implementation
+    // falls back to one write() per chunk.
+    virtual ssize_t writeChunks(const GenericDataChunk *chunks, size_t count);
+
+    // Chunks handed to writeChunks() never exceed this size. 0 means that
+    // the writer does not care about chunk boundaries.
+    virtual size_t maxChunkSize(void) const;
+
     TEMPLATE_FOR_WRITE_NO_MATTER_WHAT(uint8_t);
     TEMPLATE_FOR_WRITE_NO_MATTER_WHAT(SUFLOAT);
     TEMPLATE_FOR_WRITE_NO_MATTER_WHAT(SUCOMPLEX);
@@ -80,7 +98,24 @@ namespace SigDigger {
   {
       Q_OBJECT
 
-      std::vector<uint8_t>buffers[2];
+    public:
+      enum FlushPolicy {
+        // Commit when half of the buffer is full (disk recordings)
+        FLUSH_THROUGHPUT,
+
+        // Commit as soon as the oldest pending chunk exceeds the latency
+        // budget (network forwarding)
+        FLUSH_LATENCY
+      };
+
+    private:
+      struct ChunkRef {
+        size_t offset;
+        size_t len;
+      };
+
+      ArenaVector<uint8_t> buffers[2];
+      std::vector<ChunkRef> chunks[2];
       QString lastError;
 
       unsigned int rateHint = 0;
@@ -97,6 +132,14 @@ namespace SigDigger {
 
       QMutex dataMutex;
 
+      FlushPolicy flushPolicy = FLUSH_THROUGHPUT;
+      quint64 maxLatency = 0;
+      size_t maxChunk = 0;
+
+      // Age of the oldest chunk not committed yet (FLUSH_LATENCY)
+      struct timeval firstPending;
+      QTimer flushTimer;
+
       struct timeval lastCommit;
       quint64 commitTime = 0;
       quint64 writeTime = 0;
@@ -104,6 +147,10 @@ namespace SigDigger {
 
       // Private methods
       void doCommit(void);
+      void pushChunk(size_t offset, size_t len);
+      quint64 pendingAge(void) const;
+      bool latencyExceeded(void) const;
+      void scheduleFlush(void);
 
     public:
       explicit GenericDataSaver(
@@ -114,7 +161,9 @@ namespace SigDigger {
       // Public methods
       void setBufferSize(unsigned int size);
       void setSampleRate(unsigned int i);
-      template<typename T> void write(const T *, size_t size);
+      void setFlushPolicy(FlushPolicy policy, quint64 maxLatencyUsec = 0);
+      // False if the data was not accepted (not ready, or swamped)
+      template<typename T> bool write(const T *, size_t size);
       QString getLastError(void) const;
       quint64 getSize(void) const;
 
@@ -130,15 +179,20 @@ namespace SigDigger {
       void swamped(void);
       void dataRate(qreal);
 
+      // Data is pending and no more may come: start the flush timer
+      void armFlush(void);
+
     public slots:
       void onPrepared(void);
       void onError(QString);
       void onWriteFinished(quint64 usec);
+      void onArmFlush(void);
+      void onFlushTimeout(void);
   };
 
-  extern template void GenericDataSaver::write<SUCOMPLEX>(const SUCOMPLEX *, size_t);
-  extern template void GenericDataSaver::write<SUFLOAT>(const SUFLOAT *, size_t);
-  extern template void GenericDataSaver::write<uint8_t>(const uint8_t *, size_t);
+  extern template bool GenericDataSaver::write<SUCOMPLEX>(const SUCOMPLEX *, size_t);
+  extern template bool GenericDataSaver::write<SUFLOAT>(const SUFLOAT *, size_t);
+  extern template bool GenericDataSaver::write<uint8_t>(const uint8_t *, size_t);
 }
 
 
@@ -42,6 +42,11 @@ namespace SigDigger {
         bool useGlInWindows;
         bool enableMsgTTL;
         unsigned int msgTTL;
+        bool adaptivePSD;
+        unsigned int targetLatency;
+        unsigned int memoryBudget;
+        int hugePages;
+        int numaNode;
         std::string infoText;
         QColor infoTextColor;
 
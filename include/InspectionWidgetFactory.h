@@ -27,7 +27,7 @@ class QColorDialog;
 
 namespace SigDigger {
   class InspectionWidgetFactory;
-  class InspectionWidget : public TabWidget {
+  class InspectionWidget : public TabWidget, public Suscan::InspectorListener {
     Q_OBJECT
 
     QColorDialog           *m_colorDialog = nullptr;
@@ -66,6 +66,8 @@ namespace SigDigger {
     // Overriden methods
     virtual void setState(int, Suscan::Analyzer *) override;
     virtual void closeRequested() override;
+    virtual void onInspectorMessage(Suscan::InspectorMessage const &) override;
+    virtual void onInspectorSamples(Suscan::SamplesMessage const &) override;
 
     public slots:
       void onNameChanged(QString name);
@@ -0,0 +1,148 @@
+//
+//    LazyWidget.h: Widgets built on first use
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef LAZYWIDGET_H
+#define LAZYWIDGET_H
+
+#include <QElapsedTimer>
+#include <functional>
+#include <list>
+#include <vector>
+
+// Set in the environment to build every lazy widget right after startup,
+// so the time laziness saves shows up in the log
+#define SIGDIGGER_LAZY_WIDGET_EAGER_ENV "SIGDIGGER_EAGER_WIDGETS"
+
+namespace SigDigger {
+  //
+  // Global bookkeeping of lazily built widgets, so the savings can be
+  // measured (see Application::logStartupStats)
+  //
+  struct LazyWidgetStats {
+    static unsigned int declared;
+    static unsigned int materialized;
+    static qint64       materializeNs;
+  };
+
+  class LazyWidgetBase
+  {
+    static std::list<LazyWidgetBase *> &instances();
+
+  protected:
+    LazyWidgetBase();
+    virtual ~LazyWidgetBase();
+
+    virtual bool materialize() = 0;
+
+  public:
+    // Builds every widget still pending, returns how many were built
+    static unsigned int materializeAll();
+  };
+
+  //
+  // Holds a widget that is only built the first time it is dereferenced
+  // through get() or ->. Code that must act on the widget once it exists
+  // (connecting signals, pushing configuration) registers a hook with
+  // whenReady(), which runs right away if the widget already exists.
+  // Code that only needs to update a widget if it exists uses peek().
+  //
+  template <class T>
+  class LazyWidget : public LazyWidgetBase
+  {
+    T                                    *m_instance = nullptr;
+    std::function<T *()>                  m_factory;
+    std::vector<std::function<void (T *)>> m_hooks;
+
+  protected:
+    bool
+    materialize() override
+    {
+      if (m_instance != nullptr || !m_factory)
+        return false;
+
+      get();
+      return true;
+    }
+
+  public:
+    LazyWidget() = default;
+    LazyWidget(LazyWidget const &) = delete;
+    LazyWidget &operator=(LazyWidget const &) = delete;
+
+    void
+    setFactory(std::function<T *()> factory)
+    {
+      if (!m_factory)
+        ++LazyWidgetStats::declared;
+
+      m_factory = factory;
+    }
+
+    void
+    whenReady(std::function<void (T *)> hook)
+    {
+      if (m_instance != nullptr)
+        hook(m_instance);
+      else
+        m_hooks.push_back(hook);
+    }
+
+    bool
+    isReady() const
+    {
+      return m_instance != nullptr;
+    }
+
+    T *
+    peek() const
+    {
+      return m_instance;
+    }
+
+    T *
+    get()
+    {
+      if (m_instance == nullptr) {
+        QElapsedTimer timer;
+        std::vector<std::function<void (T *)>> hooks;
+
+        timer.start();
+
+        m_instance = m_factory();
+
+        // Hooks may register further hooks, which then run immediately
+        hooks.swap(m_hooks);
+        for (auto &hook : hooks)
+          hook(m_instance);
+
+        ++LazyWidgetStats::materialized;
+        LazyWidgetStats::materializeNs += timer.nsecsElapsed();
+      }
+
+      return m_instance;
+    }
+
+    T *
+    operator->()
+    {
+      return get();
+    }
+  };
+}
+
+#endif // LAZYWIDGET_H
@@ -23,6 +23,7 @@
 #include <QMainWindow>
 #include <QThread>
 #include <QSplashScreen>
+#include <list>
 
 #include <Suscan/Library.h>
 
@@ -53,6 +54,10 @@ namespace SigDigger {
     // Owned pointers
     std::unique_ptr<InitThread> m_initThread; // QT wants this to be a pointer
 
+    // Secondary sessions. Each one of them owns its own analyzer, spectrum
+    // and inspectors, but shares everything held by the Suscan singleton.
+    std::list<Application *> m_sessions;
+
     // Borrowed pointers
     Application *m_app;
     Suscan::Singleton *m_suscan;
@@ -69,6 +74,8 @@ namespace SigDigger {
     void handleDone();
 
     void saveConfig();
+    void openSession();
+    void onSessionDestroyed(QObject *);
   };
 };
 
@@ -52,6 +52,7 @@ namespace Ui {
 // Does it make sense to turn this into a PersistentWidget, anyways?
 namespace SigDigger {
   class SuscanBookmarkSource;
+  class GlobalProperty;
   class MainSpectrum : public QWidget
   {
     Q_OBJECT
@@ -100,6 +101,10 @@ namespace SigDigger {
     unsigned int m_cachedFftSize = 0;
     float m_zoom = 1;
 
+    // Owned by the mediator of this window
+    GlobalProperty *m_propFftSize = nullptr;
+    GlobalProperty *m_propRBW     = nullptr;
+
     // Private methods
     void connectAll();
     void connectWf();
@@ -124,6 +129,7 @@ namespace SigDigger {
         bool looped = false);
 
     void deserializeFATs();
+    void setFFTProperties(GlobalProperty *fftSize, GlobalProperty *rbw);
 
     // Named channel API
     NamedChannelSetIterator addChannel(
@@ -0,0 +1,115 @@
+//
+//    MeasureIndex.h: Fast selection measures over a capture
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef MEASUREINDEX_H
+#define MEASUREINDEX_H
+
+#include <sigutils/types.h>
+#include <vector>
+
+// Samples summarized by each leaf. Selection edges are scanned directly,
+// so this bounds the per-query scan. Each block (512 bytes of samples)
+// costs three running sums (24 bytes) plus about 40 bytes of extrema
+// across all levels, so the index is ~1/8 of the capture size.
+#define SIGDIGGER_MEASURE_INDEX_BLOCK 64
+
+namespace SigDigger {
+  struct SelectionMeasures {
+    SUSCOUNT  length   = 0;
+    SUCOMPLEX min      = 0;    // Per component
+    SUCOMPLEX max      = 0;    // Per component
+    SUCOMPLEX mean     = 0;
+    SUFLOAT   energy   = 0;    // Sum of |x|^2
+    SUFLOAT   rms      = 0;
+    SUFLOAT   peak     = 0;    // Largest |x|
+    SUFLOAT   variance = 0;    // Mean of |x - mean|^2
+  };
+
+  //
+  // Answers min, max, mean, energy, peak and variance of any range of a
+  // capture in O(log n), so the TimeWindow can update its measures while
+  // a selection edge is being dragged.
+  //
+  // Sums are kept as prefix sums over blocks, extrema in a segment tree
+  // over the same blocks. Both only cover complete blocks: the samples of
+  // the last, partial block are read from the capture itself. This allows
+  // extend() to add samples appended to the capture without touching what
+  // was already indexed.
+  //
+  // The index keeps a pointer to the capture, which must stay valid (and
+  // unchanged) until the next rebuild() or clear().
+  //
+  class MeasureIndex
+  {
+    struct Extrema {
+      SUFLOAT minI, maxI;
+      SUFLOAT minQ, maxQ;
+      SUFLOAT peak;            // Largest |x|^2
+
+      void merge(Extrema const &);
+      void add(SUCOMPLEX);
+    };
+
+    const SUCOMPLEX *m_data = nullptr;
+    SUSCOUNT         m_size = 0;
+
+    // m_sumX[k]: sum of the first k blocks
+    std::vector<double> m_sumI;
+    std::vector<double> m_sumQ;
+    std::vector<double> m_sumE;
+
+    // m_levels[0]: one entry per complete block. m_levels[k][i] merges
+    // m_levels[k - 1][2i] and m_levels[k - 1][2i + 1].
+    std::vector<std::vector<Extrema>> m_levels;
+
+    SUSCOUNT blocks() const;
+    void updateLevels(SUSCOUNT firstBlock);
+    void scan(
+        SUSCOUNT start,
+        SUSCOUNT end,
+        double &sumI,
+        double &sumQ,
+        double &sumE,
+        Extrema &ext,
+        bool &haveExt) const;
+    void blockExtrema(
+        SUSCOUNT first,
+        SUSCOUNT last,
+        Extrema &ext,
+        bool &haveExt) const;
+
+  public:
+    MeasureIndex();
+
+    void clear();
+    void rebuild(const SUCOMPLEX *data, SUSCOUNT size);
+
+    // Same capture, more samples at the end. Anything else is a rebuild.
+    void extend(const SUCOMPLEX *data, SUSCOUNT size);
+
+    const SUCOMPLEX *data() const;
+    SUSCOUNT size() const;
+
+    // Heap used by the sums and extrema
+    quint64 memoryBytes() const;
+
+    bool measure(SUSCOUNT start, SUSCOUNT end, SelectionMeasures &) const;
+  };
+}
+
+#endif // MEASUREINDEX_H
@@ -0,0 +1,99 @@
+//
+//    MemoryBudget.h: Keep large sample buffers within a memory budget
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+
+#include <QObject>
+#include <QTimer>
+#include <QString>
+#include <list>
+#include <vector>
+
+#define SIGDIGGER_MEMORY_BUDGET_UNLIMITED   0
+#define SIGDIGGER_MEMORY_BUDGET_NOTIFY_MS   1000
+
+namespace SigDigger {
+  //
+  // Anything holding a large amount of samples. Consumers that cannot
+  // spill (e.g. fixed-size rings) are still accounted, so the budget
+  // reflects what is really resident.
+  //
+  class MemoryConsumer
+  {
+    public:
+      virtual ~MemoryConsumer();
+
+      virtual QString memoryConsumerName() const = 0;
+      virtual quint64 residentBytes() const = 0;
+      virtual quint64 spilledBytes() const;
+
+      // Move resident data to disk. Returns the number of bytes released.
+      virtual quint64 spill();
+  };
+
+  struct MemoryConsumerUsage {
+    QString name;
+    quint64 resident = 0;
+    quint64 spilled  = 0;
+  };
+
+  //
+  // Process-wide accountant, used from the GUI thread only. Consumers
+  // call touch() whenever they are used or grow. When the resident total
+  // exceeds the budget, the least recently used consumers are asked to
+  // spill until it fits again (or nothing else can be spilled).
+  //
+  class MemoryBudget : public QObject
+  {
+    Q_OBJECT
+
+    static MemoryBudget *m_instance;
+
+    std::list<MemoryConsumer *> m_consumers; // Most recently used first
+    quint64 m_budget = SIGDIGGER_MEMORY_BUDGET_UNLIMITED;
+    quint64 m_spills = 0;
+    bool    m_enforcing = false;
+    QTimer  m_notifyTimer;
+
+    MemoryBudget();
+
+    void enforce();
+    void scheduleNotify();
+
+  public:
+    static MemoryBudget *instance();
+
+    void setBudget(quint64 bytes);
+    quint64 budget() const;
+
+    void add(MemoryConsumer *);
+    void remove(MemoryConsumer *);
+    void touch(MemoryConsumer *);
+
+    quint64 resident() const;
+    quint64 spilled() const;
+    quint64 spills() const;
+    std::vector<MemoryConsumerUsage> usage() const;
+
+  signals:
+    void usageChanged();
+  };
+}
+
+#endif // MEMORYBUDGET_H
@@ -35,8 +35,15 @@ namespace SigDigger {
     WaitingSpinnerWidget *spinner = nullptr;
 
     void connectAll(void);
+    void refreshUi(void);
 
   public:
+    enum Transport {
+      TRANSPORT_UDP,
+      TRANSPORT_TCP,
+      TRANSPORT_SHM
+    };
+
     explicit NetForwarderUI(QWidget *parent = nullptr);
     ~NetForwarderUI();
 
@@ -50,6 +57,8 @@ namespace SigDigger {
     void setForwardEnabled(bool enabled);
     void setCaptureSize(quint64 size);
     void setTcp(bool);
+    void setTransport(Transport);
+    void setSegment(std::string const &name);
 
     // Getters
     std::string getHost(void) const;
@@ -57,9 +66,12 @@ namespace SigDigger {
     unsigned int getFrameLen(void) const;
     bool getForwardState(void) const;
     bool getTcp(void) const;
+    Transport getTransport(void) const;
+    std::string getSegment(void) const;
 
   public slots:
     void onForwardStartStop(void);
+    void onTransportChanged(void);
 
   signals:
     void forwardStateChanged(bool state);
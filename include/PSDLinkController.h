@@ -0,0 +1,107 @@
+//
+//    PSDLinkController.h: Adapt spectrum rate and size to the link
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef PSDLINKCONTROLLER_H
+#define PSDLINKCONTROLLER_H
+
+#include <QElapsedTimer>
+#include <sigutils/types.h>
+#include <sys/time.h>
+#include <vector>
+
+#define SIGDIGGER_PSD_LINK_MIN_RATE          1     // Spectra per second
+#define SIGDIGGER_PSD_LINK_MIN_FFT_SIZE      512
+#define SIGDIGGER_PSD_LINK_MEASURE_MS        1000
+#define SIGDIGGER_PSD_LINK_DEGRADE_HOLD_MS   2000
+#define SIGDIGGER_PSD_LINK_RECOVER_HOLD_MS   10000
+#define SIGDIGGER_PSD_LINK_LATENCY_ALPHA     SU_SPLPF_ALPHA(8)
+
+namespace SigDigger {
+  struct PSDLinkSettings {
+    unsigned int rate    = 0;  // Spectra per second
+    unsigned int fftSize = 0;
+
+    bool operator==(PSDLinkSettings const &other) const
+    {
+      return rate == other.rate && fftSize == other.fftSize;
+    }
+
+    bool operator!=(PSDLinkSettings const &other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  struct PSDLinkStats {
+    qreal latencyMs  = 0;  // Smoothed, relative to the best seen so far
+    qreal frameRate  = 0;  // Measured arrival rate
+    qreal throughput = 0;  // Spectrum payload, in bytes per second
+  };
+
+  //
+  // Everything happens in the GUI thread. feed() is called for every
+  // spectrum received from the analyzer. Once per measurement window,
+  // decide() compares the link statistics against the latency target and
+  // suggests the next settings to ask the server for: one step down when
+  // the link cannot keep up, one step back up after it has been healthy
+  // for a while.
+  //
+  // Clocks of client and server need not agree: latencies are measured
+  // against the smallest delay observed since the last reset().
+  //
+  class PSDLinkController
+  {
+    PSDLinkSettings              m_requested;
+    std::vector<PSDLinkSettings> m_steps;
+    qreal                        m_targetMs = 500;
+
+    // Measurement
+    bool                         m_haveBaseline = false;
+    qreal                        m_baseline = 0;
+    qreal                        m_latency = 0;
+    unsigned int                 m_frames = 0;
+    quint64                      m_bytes = 0;
+    QElapsedTimer                m_window;
+    PSDLinkStats                 m_stats;
+    bool                         m_haveStats = false;
+
+    QElapsedTimer                m_lastChange;
+    QElapsedTimer                m_healthySince;
+
+    PSDLinkSettings degrade(PSDLinkSettings const &) const;
+
+  public:
+    PSDLinkController();
+
+    void reset(PSDLinkSettings const &requested);
+    void setTarget(qreal ms);
+    qreal target() const;
+
+    bool feed(struct timeval const &sent, SUSCOUNT bins);
+    bool decide(PSDLinkSettings &next);
+
+    PSDLinkSettings requested() const;
+    PSDLinkSettings current() const;
+    unsigned int level() const;
+    bool isAdapted() const;
+    bool haveStats() const;
+    PSDLinkStats const &stats() const;
+  };
+}
+
+#endif // PSDLINKCONTROLLER_H
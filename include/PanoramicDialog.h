@@ -29,6 +29,7 @@
 #include "Palette.h"
 #include <AbstractWaterfall.h>
 #include <GuiConfig.h>
+#include <MemoryBudget.h>
 
 namespace Ui {
   class PanoramicDialog;
@@ -69,7 +70,8 @@ namespace SigDigger {
     Suscan::Object &&serialize() override;
   };
 
-  class PanoramicDialog : public QDialog, public PersistentObject
+  class PanoramicDialog
+      : public QDialog, public PersistentObject, public MemoryConsumer
   {
       Q_OBJECT
 
@@ -115,7 +117,11 @@ namespace SigDigger {
       static unsigned int preferredRttMs(Suscan::Source::Device const &dev);
 
     public:
-      explicit PanoramicDialog(QWidget *parent = nullptr);
+      // The dialog takes ownership of config, if given. This allows the
+      // configuration to be deserialized before the dialog exists.
+      explicit PanoramicDialog(
+          QWidget *parent = nullptr,
+          PanoramicDialogConfig *config = nullptr);
       ~PanoramicDialog() override;
 
       void feed(
@@ -152,6 +158,10 @@ namespace SigDigger {
       Suscan::Serializable *allocConfig() override;
       void applyConfig() override;
 
+      // MemoryConsumer: the last spectrum kept for export
+      QString memoryConsumerName() const override;
+      quint64 residentBytes() const override;
+
     signals:
       void detailChanged(qint64 freqMin, qint64 freqMax, bool noHop);
       void start();
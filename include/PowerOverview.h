@@ -0,0 +1,102 @@
+//
+//    PowerOverview.h: Coarse power overview of a capture file
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef POWEROVERVIEW_H
+#define POWEROVERVIEW_H
+
+#include <QMutex>
+#include <sigutils/types.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define SIGDIGGER_POWER_OVERVIEW_SUFFIX        ".sdovw"
+#define SIGDIGGER_POWER_OVERVIEW_MAGIC         "SDPWROVW"
+#define SIGDIGGER_POWER_OVERVIEW_VERSION       1
+#define SIGDIGGER_POWER_OVERVIEW_MAX_BUCKETS   2048
+#define SIGDIGGER_POWER_OVERVIEW_SPECTRUM_BINS 64
+
+namespace SigDigger {
+  //
+  // Power levels are in dBFS. min is the quietest sub-block of the bucket
+  // (a noise floor estimate), mean its average power and max its
+  // instantaneous peak.
+  //
+  struct PowerOverviewBucket {
+    float min  = -200;
+    float mean = -200;
+    float max  = -200;
+  };
+
+  struct PowerOverviewHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t buckets;
+    uint32_t bins;
+    uint32_t reserved;
+    uint64_t samples;
+    uint64_t dataSize;    // Size of the capture this overview describes
+    int64_t  dataMtime;   // Modification time of the same, in ms
+  };
+
+  //
+  // Buckets are filled in order from a background task while the GUI
+  // draws them, hence the lock.
+  //
+  class PowerOverview
+  {
+    mutable QMutex                   m_mutex;
+    std::vector<PowerOverviewBucket> m_buckets;
+    std::vector<float>               m_spectra; // BINS per bucket, dB
+    quint64                          m_samples = 0;
+    size_t                           m_filled = 0;
+    bool                             m_complete = false;
+
+  public:
+    PowerOverview();
+
+    static std::string pathFor(std::string const &dataPath);
+
+    void reset(size_t buckets, quint64 samples);
+    void clear();
+    void setBucket(
+        size_t index,
+        PowerOverviewBucket const &bucket,
+        const float *spectrum);
+    void setComplete();
+
+    size_t size() const;
+    size_t filled() const;
+    quint64 samples() const;
+    bool isComplete() const;
+
+    bool bucket(size_t index, PowerOverviewBucket &bucket) const;
+    bool spectrum(size_t index, std::vector<float> &spectrum) const;
+
+    bool save(
+        std::string const &path,
+        quint64 dataSize,
+        qint64 dataMtime) const;
+    bool load(
+        std::string const &path,
+        quint64 dataSize,
+        qint64 dataMtime);
+  };
+}
+
+#endif // POWEROVERVIEW_H
@@ -0,0 +1,115 @@
+//
+//    PowerOverviewTask.h: Compute the power overview of a capture file
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef POWEROVERVIEWTASK_H
+#define POWEROVERVIEWTASK_H
+
+#include <Suscan/CancellableTask.h>
+#include <QFile>
+#include <sigutils/types.h>
+#include <analyzer/source.h>
+#include <sndfile.h>
+#include <memory>
+#include <atomic>
+#include "PowerOverview.h"
+#include "ArenaAllocator.h"
+
+#define SIGDIGGER_POWER_OVERVIEW_CHUNK_SIZE     65536
+#define SIGDIGGER_POWER_OVERVIEW_SUBBLOCK_SIZE  1024
+#define SIGDIGGER_POWER_OVERVIEW_FFT_SIZE       256
+#define SIGDIGGER_POWER_OVERVIEW_FFT_SEGMENTS   4
+#define SIGDIGGER_POWER_OVERVIEW_SLICE_MS       50
+
+namespace SigDigger {
+  //
+  // Scans a capture once, from start to end, reducing it to at most
+  // SIGDIGGER_POWER_OVERVIEW_MAX_BUCKETS power buckets (and a coarse
+  // spectrum of the beginning of each bucket). Buckets are published to
+  // the shared overview as they are completed, and the result is cached
+  // next to the capture when the scan finishes.
+  //
+  class PowerOverviewTask : public Suscan::CancellableTask
+  {
+    Q_OBJECT
+
+    std::shared_ptr<PowerOverview> m_overview;
+    std::string               m_path;
+    enum suscan_source_format m_format;
+    bool                      m_opened = false;
+    std::atomic<bool>         m_cancelFlag{false}; // Set from the GUI thread
+
+    // Input
+    QFile                     m_file;
+    SNDFILE                  *m_sfp = nullptr;
+    int                       m_channels = 2;
+    unsigned int              m_sampleSize = sizeof(SUCOMPLEX);
+    quint64                   m_total = 0;
+    quint64                   m_pos = 0;
+    quint64                   m_dataSize = 0;
+    qint64                    m_dataMtime = 0;
+    std::vector<char>         m_raw;
+    ArenaVector<SUFLOAT>      m_iq;
+
+    // Current bucket
+    size_t                    m_buckets = 0;
+    size_t                    m_bucket = 0;
+    quint64                   m_bucketStart = 0;
+    quint64                   m_bucketEnd = 0;
+    SUFLOAT                   m_sum = 0;
+    SUFLOAT                   m_peak = 0;
+    SUFLOAT                   m_subSum = 0;
+    SUFLOAT                   m_subMin = 0;
+    SUSCOUNT                  m_subPos = 0;
+    bool                      m_haveSub = false;
+
+    // Bucket spectrum
+    SU_FFTW(_plan)            m_plan = nullptr;
+    SU_FFTW(_complex)        *m_fftBuf = nullptr;
+    std::vector<SUFLOAT>      m_window;
+    std::vector<SUFLOAT>      m_psd;
+    SUFLOAT                   m_windowEnergy = 0;
+    SUSCOUNT                  m_fftPos = 0;
+    unsigned int              m_segments = 0;
+
+    bool open();
+    size_t readChunk();
+    void processChunk(size_t samples);
+    void feedSpectrum(const SUFLOAT *iq, size_t samples);
+    void finishBucket();
+    void startBucket();
+    void finish();
+
+  public:
+    PowerOverviewTask(
+        std::string const &path,
+        enum suscan_source_format format,
+        std::shared_ptr<PowerOverview> const &overview,
+        QObject *parent = nullptr);
+    ~PowerOverviewTask() override;
+
+    static bool supports(enum suscan_source_format format);
+
+    bool work() override;
+    void cancel() override;
+
+  signals:
+    void overviewUpdated();
+  };
+}
+
+#endif // POWEROVERVIEWTASK_H
@@ -0,0 +1,78 @@
+//
+//    ProcessingThread.h: Worker thread with affinity and priority controls
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef PROCESSINGTHREAD_H
+#define PROCESSINGTHREAD_H
+
+#include <QThread>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+namespace SigDigger {
+  //
+  // Event loop thread for worker objects (moveToThread) whose CPU affinity
+  // and scheduling priority can be changed at any time, before or after it
+  // has been started. It also measures its own CPU usage, so heavy workers
+  // can be told apart from idle ones.
+  //
+  // Affinity, CPU usage and niceness are only supported on Linux. Elsewhere,
+  // the affinity is ignored, the load is reported as negative and the
+  // priority is passed to QThread::setPriority.
+  //
+  class ProcessingThread : public QThread
+  {
+    Q_OBJECT
+
+    mutable QMutex m_mutex;
+    QList<int>     m_affinity;     // Empty: any CPU
+    Priority       m_priority = InheritPriority;
+    bool           m_haveHandle = false;
+    unsigned long  m_handle = 0;    // pthread_t, set from the thread itself
+    long           m_tid = 0;       // Kernel thread id, for the nice value
+    int            m_baseNice = 0;  // Nice value the thread started with
+
+    QElapsedTimer  m_loadTimer;
+    qint64         m_lastCpuNs = -1;
+
+    bool applyAffinity();
+    bool applyPriority();
+
+  protected:
+    void run() override;
+
+  public:
+    explicit ProcessingThread(QObject *parent = nullptr);
+    ~ProcessingThread() override;
+
+    bool setAffinity(QList<int> const &cpus);
+    bool setProcessingPriority(Priority priority);
+
+    QList<int> affinity() const;
+    Priority processingPriority() const;
+
+    // Fraction of one core used since the previous call
+    qreal load();
+
+    static QList<int> parseCpuList(QString const &list, bool *ok = nullptr);
+    static QString formatCpuList(QList<int> const &cpus);
+  };
+}
+
+#endif // PROCESSINGTHREAD_H
@@ -22,8 +22,14 @@
 #include <QSlider>
 #include <QDateTime>
 #include <sigutils/util/compat-time.h>
+#include <memory>
+
+class QPainter;
 
 namespace SigDigger {
+  class PowerOverview;
+  class OverviewPreview;
+
   class QTimeSlider : public QSlider
   {
     Q_OBJECT
@@ -33,11 +39,19 @@ namespace SigDigger {
     struct timeval startTime;
     struct timeval endTime;
 
+    std::shared_ptr<PowerOverview> overview;
+    OverviewPreview *preview = nullptr;
+
     void adjustTickInterval(void);
+    void paintOverview(QPainter &);
+    int bucketAt(int x) const;
+    struct timeval bucketTime(int bucket) const;
 
     protected:
       void paintEvent(QPaintEvent *) override;
       void resizeEvent(QResizeEvent *) override;
+      void mouseMoveEvent(QMouseEvent *) override;
+      void leaveEvent(QEvent *) override;
 
     public:
       QTimeSlider(QWidget *parent = nullptr);
@@ -51,6 +65,8 @@ namespace SigDigger {
 
       void setTimeStamp(struct timeval const &);
 
+      void setOverview(std::shared_ptr<PowerOverview> const &);
+
       QDateTime getDateTime(void) const;
       struct timeval getTimeStamp(void) const;
       qint64 getSample(void) const;
@@ -0,0 +1,89 @@
+//
+//    ResamplerTask.h: Polyphase sample rate conversion
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef RESAMPLERTASK_H
+#define RESAMPLERTASK_H
+
+#include <Suscan/CancellableTask.h>
+#include <sigutils/types.h>
+#include <ArenaAllocator.h>
+#include <vector>
+
+#define SIGDIGGER_RESAMPLER_MAX_FACTOR     1024  // Max L and M
+#define SIGDIGGER_RESAMPLER_MIN_TAPS       16    // Per phase
+#define SIGDIGGER_RESAMPLER_MAX_TAPS       8192  // Per phase
+#define SIGDIGGER_RESAMPLER_MAX_PROTOTYPE  (1 << 20) // Taps times L
+#define SIGDIGGER_RESAMPLER_TRANSITION     .2    // Relative to the cutoff
+#define SIGDIGGER_RESAMPLER_PASSBAND       .45   // Max cutoff, output rate
+#define SIGDIGGER_RESAMPLER_BLOCK_MACS     (1 << 24)
+
+namespace SigDigger {
+  //
+  // Changes the sample rate of a capture by a rational factor L / M. The
+  // capture is conceptually upsampled by L, low-pass filtered and decimated
+  // by M, but only the L polyphase branches of the filter that produce
+  // output samples are ever evaluated. Arbitrary ratios are approximated by
+  // the closest fraction with L, M <= SIGDIGGER_RESAMPLER_MAX_FACTOR.
+  //
+  // Output samples are independent from each other, so every block is
+  // split in contiguous ranges that are computed by all available cores.
+  // Taps are stored duplicated and interleaved so that the inner loop is a
+  // plain dot product of float arrays, which compilers vectorize.
+  //
+  class ResamplerTask : public Suscan::CancellableTask {
+    Q_OBJECT
+
+    const SUCOMPLEX       *m_data = nullptr;
+    size_t                 m_length = 0;
+
+    unsigned int           m_interp = 1; // L
+    unsigned int           m_decim = 1;  // M
+    unsigned int           m_taps = 0;   // Per phase
+    size_t                 m_delay = 0;  // Group delay, upsampled units
+
+    ArenaVector<SUFLOAT>   m_bank;       // L x (2 * taps), reversed
+    std::vector<SUCOMPLEX> m_output;
+    size_t                 m_p = 0;
+    unsigned int           m_threads = 1;
+
+    void designFilter(SUFLOAT cutoff);
+    SUCOMPLEX computeSlow(size_t n) const;
+    void computeRange(size_t start, size_t end);
+
+  public:
+    explicit ResamplerTask(
+        const SUCOMPLEX *data,
+        size_t length,
+        qreal ratio,
+        SUFLOAT cutoff,
+        QObject *parent = nullptr);
+    virtual ~ResamplerTask() override;
+
+    static void rationalize(qreal ratio, unsigned int &L, unsigned int &M);
+
+    unsigned int getInterpolation() const;
+    unsigned int getDecimation() const;
+    qreal getRatio() const;
+    std::vector<SUCOMPLEX> &&takeOutput();
+
+    virtual bool work() override;
+    virtual void cancel() override;
+  };
+}
+
+#endif // RESAMPLERTASK_H
@@ -0,0 +1,90 @@
+//
+//    SampleBuffer.h: Growable sample buffer that can spill to disk
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef SAMPLEBUFFER_H
+#define SAMPLEBUFFER_H
+
+#include <MemoryBudget.h>
+#include <sigutils/types.h>
+#include <vector>
+
+// Address space reserved per buffer, and how much of it is committed at
+// a time as the buffer grows.
+#define SIGDIGGER_SAMPLE_BUFFER_RESERVE \
+  (sizeof(void *) >= 8 ? (size_t(64) << 30) : (size_t(256) << 20))
+#define SIGDIGGER_SAMPLE_BUFFER_GROWTH  (size_t(4) << 20)
+
+namespace SigDigger {
+  //
+  // Append-only replacement for the std::vector<SUCOMPLEX> used to hold
+  // captures. The buffer reserves a large range of address space up front
+  // and commits it as it grows, so data() never moves and may be handed
+  // out to widgets (e.g. a TimeWindow) for as long as the buffer lives.
+  // Clearing it drops the contents but keeps the addresses mapped, as
+  // tasks started on the previous capture may still be reading them.
+  //
+  // When the memory budget asks for it, the contents are written to an
+  // unlinked temporary file that is mapped over the very same addresses.
+  // The data stays accessible through the same pointer, but it is now
+  // backed by the page cache, which the kernel may reclaim at will.
+  //
+  // Platforms without mmap() get a plain vector that never spills.
+  //
+  class SampleBuffer : public MemoryConsumer
+  {
+    QString                m_name;
+    SUCOMPLEX             *m_base = nullptr;
+    size_t                 m_reserved = 0;
+    size_t                 m_committed = 0;
+    SUSCOUNT               m_size = 0;
+    int                    m_fd = -1;
+    bool                   m_noReserve = false;
+    std::vector<SUCOMPLEX> m_fallback;
+
+    bool reserve();
+    bool commit(size_t bytes);
+    void decommit();
+    void unmap();
+
+  public:
+    SampleBuffer(QString const &name);
+    ~SampleBuffer() override;
+
+    SampleBuffer(SampleBuffer const &) = delete;
+    SampleBuffer &operator=(SampleBuffer const &) = delete;
+
+    const SUCOMPLEX *data() const;
+    SUSCOUNT size() const;
+    bool empty() const;
+    bool isSpilled() const;
+
+    bool append(const SUCOMPLEX *data, SUSCOUNT len);
+    void clear();
+
+    // Tell the memory budget the buffer is in use
+    void markUsed();
+
+    // MemoryConsumer
+    QString memoryConsumerName() const override;
+    quint64 residentBytes() const override;
+    quint64 spilledBytes() const override;
+    quint64 spill() override;
+  };
+}
+
+#endif // SAMPLEBUFFER_H
@@ -0,0 +1,129 @@
+//
+//    include/SampleHistory.h: Indexed, random-access sample history
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef SAMPLEHISTORY_H
+#define SAMPLEHISTORY_H
+
+#include <QMutex>
+#include <QString>
+#include <deque>
+#include <vector>
+#include <sigutils/types.h>
+#include <sigutils/util/compat-time.h>
+#include <MemoryBudget.h>
+
+#define SIGDIGGER_SAMPLE_HISTORY_DEFAULT_BLOCK_SIZE 4096
+
+namespace SigDigger {
+  //
+  // SampleHistory is a ring of baseband samples with a coarse time index.
+  // Samples are addressed by their absolute position since the history was
+  // allocated, which makes positions stable while the ring wraps around.
+  //
+  // Whenever the platform allows it, the ring is mapped twice in a row in
+  // virtual memory, so any retained span is contiguous and can be handed
+  // out as a plain pointer (e.g. to a TimeWindow) without copying it. The
+  // history must be frozen while such a pointer is in use.
+  //
+  // The ring is accounted in the memory budget, but never spilled: its
+  // size and backing are chosen explicitly by the user.
+  //
+  class SampleHistory : public MemoryConsumer
+  {
+    public:
+      enum Backing {
+        HISTORY_BACKING_HEAP,
+        HISTORY_BACKING_HUGEPAGES,
+        HISTORY_BACKING_FILE
+      };
+
+    private:
+      struct IndexEntry {
+        quint64 sample;
+        struct timeval tv;
+      };
+
+      mutable QMutex         m_mutex;
+      SUCOMPLEX             *m_buffer = nullptr;
+      SUSCOUNT               m_capacity = 0;
+      size_t                 m_mapSize = 0;
+      bool                   m_mirrored = false;
+      std::vector<SUCOMPLEX> m_fallback;
+
+      Backing                m_backing = HISTORY_BACKING_HEAP;
+      qreal                  m_fs = 1;
+      SUSCOUNT               m_blockSize = SIGDIGGER_SAMPLE_HISTORY_DEFAULT_BLOCK_SIZE;
+      quint64                m_written = 0;
+      quint64                m_dropped = 0;
+      bool                   m_frozen = false;
+      std::deque<IndexEntry> m_index;
+      QString                m_lastError;
+
+      bool allocateMirrored(size_t bytes, Backing backing, bool hugeTLB);
+      void releaseUnlocked();
+      void expireIndex();
+      quint64 firstUnlocked() const;
+
+    public:
+      SampleHistory();
+      ~SampleHistory() override;
+
+      bool allocate(SUSCOUNT samples, Backing backing);
+      void release();
+      void clear();
+      void feed(const SUCOMPLEX *data, SUSCOUNT len);
+
+      void setSampleRate(qreal fs);
+      void setFrozen(bool);
+
+      bool isAllocated() const;
+      bool isFrozen() const;
+      bool isMirrored() const;
+      Backing backing() const;
+      qreal sampleRate() const;
+      SUSCOUNT capacity() const;
+      quint64 dropped() const;
+      QString getLastError() const;
+
+      // Absolute positions of the oldest retained sample and one past the
+      // newest one.
+      quint64 first() const;
+      quint64 end() const;
+
+      // Time index lookups, O(log n) in the number of index blocks
+      struct timeval timeAt(quint64 sample) const;
+      quint64 sampleAt(struct timeval const &tv) const;
+
+      // Zero-copy access. Returns nullptr if the span is not retained or
+      // the ring could not be mirrored and the span wraps around.
+      const SUCOMPLEX *span(quint64 start, SUSCOUNT len) const;
+
+      // Always works for retained spans, at the cost of a copy
+      bool copySpan(
+          quint64 start,
+          SUSCOUNT len,
+          std::vector<SUCOMPLEX> &dest) const;
+
+      // MemoryConsumer
+      QString memoryConsumerName() const override;
+      quint64 residentBytes() const override;
+      quint64 spilledBytes() const override;
+  };
+}
+
+#endif // SAMPLEHISTORY_H
@@ -22,6 +22,7 @@
 #include <QDialog>
 #include "WaveSampler.h"
 #include "ColorConfig.h"
+#include "ExportSymbolsTask.h"
 
 namespace Ui {
   class SamplerDialog;
@@ -44,6 +45,10 @@ namespace SigDigger {
     bool m_scrolling = false;
     bool m_autoScroll = true;
 
+    SymbolStore m_symbols;
+    QColor m_loColor = Qt::black;
+    QColor m_hiColor = Qt::white;
+
     void connectAll(void);
     void refreshUi(void);
 
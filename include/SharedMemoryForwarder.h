@@ -0,0 +1,50 @@
+//
+//    include/SharedMemoryForwarder.h: Forward data through shared memory
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef SHAREDMEMORYFORWARDER_H
+#define SHAREDMEMORYFORWARDER_H
+
+#include "GenericDataSaver.h"
+
+#define SIGDIGGER_SHMFORWARDER_DEFAULT_CAPACITY     (16 << 20)
+#define SIGDIGGER_SHMFORWARDER_DEFAULT_MAX_LATENCY_US 500
+
+namespace SigDigger {
+  class SharedMemoryDataWriter;
+
+  //
+  // Local alternative to SocketForwarder. Data is published in a POSIX
+  // shared memory ring (see ShmRing.h for the layout and a reader), so
+  // decoders running on the same host get it without going through the
+  // network stack.
+  //
+  class SharedMemoryForwarder : public GenericDataSaver {
+    Q_OBJECT
+
+    SharedMemoryDataWriter *writer = nullptr;
+
+  public:
+    SharedMemoryForwarder(
+        std::string const &name,
+        unsigned int rate,
+        size_t capacity = SIGDIGGER_SHMFORWARDER_DEFAULT_CAPACITY,
+        QObject *parent = nullptr);
+  };
+}
+
+#endif // SHAREDMEMORYFORWARDER_H
@@ -0,0 +1,366 @@
+//
+//    include/ShmRing.h: Shared memory ring layout and reader
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef SHMRING_H
+#define SHMRING_H
+
+//
+// This header only depends on the C library, so it can be copied as-is
+// into external decoders that want to consume inspector output forwarded
+// through shared memory.
+//
+// The segment is a single-producer, single-consumer byte ring. It starts
+// with a ShmRingHeader, followed by the data area at dataOffset. head and
+// tail are free-running byte counters: the producer only writes head, the
+// consumer only writes tail, and head - tail is the amount of pending data.
+// If the consumer falls behind, the producer discards every write that does
+// not fit as a whole and accounts it in dropped, it never blocks. A write
+// may merge several batches of samples, but it always holds a whole number
+// of them, so the ring never ends in the middle of a sample.
+//
+// Every time the producer publishes data it increments doorbell. On Linux,
+// a consumer waiting for data sleeps on doorbell as a futex word, and the
+// producer only issues the wake-up syscall if waiters is non-zero. Both
+// sides put a full fence between their store and the load of the other
+// side's word. Otherwise the producer could miss a waiter that is about
+// to sleep, and that waiter could miss the data that would wake it up.
+//
+
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <string>
+
+#ifndef _WIN32
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <time.h>
+#endif // _WIN32
+
+#ifdef __linux__
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <climits>
+#endif // __linux__
+
+#define SIGDIGGER_SHM_RING_MAGIC       0x53444752 // "RGDS"
+#define SIGDIGGER_SHM_RING_VERSION     1
+#define SIGDIGGER_SHM_RING_FLAG_CLOSED 1
+
+namespace SigDigger {
+  struct ShmRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;    // Size of the data area, power of two
+    uint64_t dataOffset;  // From the beginning of the segment
+    uint32_t sampleRate;  // Items per second, as a hint
+    uint32_t flags;
+    uint64_t dropped;     // Bytes discarded by the producer
+
+    alignas(64) uint64_t head;
+    alignas(64) uint64_t tail;
+    alignas(64) uint32_t doorbell;
+    uint32_t waiters;
+  };
+
+  static inline void
+  shmRingWake(ShmRingHeader *hdr)
+  {
+    __atomic_add_fetch(&hdr->doorbell, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+#ifdef __linux__
+    if (__atomic_load_n(&hdr->waiters, __ATOMIC_SEQ_CST) > 0)
+      (void) syscall(
+            SYS_futex,
+            &hdr->doorbell,
+            FUTEX_WAKE,
+            INT_MAX,
+            nullptr,
+            nullptr,
+            0);
+#endif // __linux__
+  }
+
+  class ShmRingReader {
+#ifndef _WIN32
+    ShmRingHeader *m_hdr = nullptr;
+    uint8_t *m_data = nullptr;
+    size_t m_size = 0;
+#endif // _WIN32
+    std::string m_lastError;
+
+  public:
+    ShmRingReader() = default;
+    ShmRingReader(ShmRingReader const &) = delete;
+    ShmRingReader &operator=(ShmRingReader const &) = delete;
+
+    ~ShmRingReader()
+    {
+      this->close();
+    }
+
+    bool
+    open(std::string const &name)
+    {
+#ifdef _WIN32
+      (void) name;
+      this->m_lastError = "Shared memory rings are not supported on Windows";
+      return false;
+#else
+      std::string path = name.size() > 0 && name[0] == '/' ? name : "/" + name;
+      struct stat sbuf;
+      void *map;
+      int fd;
+
+      this->close();
+
+      if ((fd = shm_open(path.c_str(), O_RDWR, 0)) == -1) {
+        this->m_lastError = "Cannot open " + path + ": " + strerror(errno);
+        return false;
+      }
+
+      if (fstat(fd, &sbuf) == -1
+          || static_cast<size_t>(sbuf.st_size) < sizeof(ShmRingHeader)) {
+        this->m_lastError = "Segment " + path + " is too small";
+        ::close(fd);
+        return false;
+      }
+
+      map = mmap(
+            nullptr,
+            static_cast<size_t>(sbuf.st_size),
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            fd,
+            0);
+      ::close(fd);
+
+      if (map == MAP_FAILED) {
+        this->m_lastError = "Cannot map " + path + ": " + strerror(errno);
+        return false;
+      }
+
+      this->m_hdr  = static_cast<ShmRingHeader *>(map);
+      this->m_size = static_cast<size_t>(sbuf.st_size);
+
+      if (__atomic_load_n(&this->m_hdr->magic, __ATOMIC_ACQUIRE)
+            != SIGDIGGER_SHM_RING_MAGIC
+          || this->m_hdr->version != SIGDIGGER_SHM_RING_VERSION
+          || this->m_hdr->dataOffset + this->m_hdr->capacity > this->m_size) {
+        this->m_lastError = "Segment " + path + " is not a SigDigger ring";
+        this->close();
+        return false;
+      }
+
+      this->m_data = static_cast<uint8_t *>(map) + this->m_hdr->dataOffset;
+
+      // Start from whatever the producer is writing now
+      __atomic_store_n(
+            &this->m_hdr->tail,
+            __atomic_load_n(&this->m_hdr->head, __ATOMIC_ACQUIRE),
+            __ATOMIC_RELEASE);
+
+      return true;
+#endif // _WIN32
+    }
+
+    void
+    close()
+    {
+#ifndef _WIN32
+      if (this->m_hdr != nullptr)
+        (void) munmap(this->m_hdr, this->m_size);
+
+      this->m_hdr  = nullptr;
+      this->m_data = nullptr;
+      this->m_size = 0;
+#endif // _WIN32
+    }
+
+    bool
+    isOpen() const
+    {
+#ifdef _WIN32
+      return false;
+#else
+      return this->m_hdr != nullptr;
+#endif // _WIN32
+    }
+
+    // True once the producer is gone. Pending data can still be read.
+    bool
+    isClosed() const
+    {
+#ifdef _WIN32
+      return true;
+#else
+      return (__atomic_load_n(&this->m_hdr->flags, __ATOMIC_ACQUIRE)
+          & SIGDIGGER_SHM_RING_FLAG_CLOSED) != 0;
+#endif // _WIN32
+    }
+
+    uint32_t
+    sampleRate() const
+    {
+#ifdef _WIN32
+      return 0;
+#else
+      return this->m_hdr->sampleRate;
+#endif // _WIN32
+    }
+
+    uint64_t
+    dropped() const
+    {
+#ifdef _WIN32
+      return 0;
+#else
+      return __atomic_load_n(&this->m_hdr->dropped, __ATOMIC_RELAXED);
+#endif // _WIN32
+    }
+
+    size_t
+    available() const
+    {
+#ifdef _WIN32
+      return 0;
+#else
+      return static_cast<size_t>(
+            __atomic_load_n(&this->m_hdr->head, __ATOMIC_ACQUIRE)
+            - this->m_hdr->tail);
+#endif // _WIN32
+    }
+
+    // Zero-copy access: returns the contiguous part of the pending data.
+    // Call consume() once done with it.
+    const uint8_t *
+    peek(size_t &len) const
+    {
+#ifdef _WIN32
+      len = 0;
+      return nullptr;
+#else
+      uint64_t mask = this->m_hdr->capacity - 1;
+      uint64_t tail = this->m_hdr->tail;
+      size_t   pos  = static_cast<size_t>(tail & mask);
+      size_t   avail = this->available();
+
+      len = avail < this->m_hdr->capacity - pos
+          ? avail
+          : static_cast<size_t>(this->m_hdr->capacity - pos);
+
+      return this->m_data + pos;
+#endif // _WIN32
+    }
+
+    void
+    consume(size_t len)
+    {
+#ifndef _WIN32
+      __atomic_store_n(
+            &this->m_hdr->tail,
+            this->m_hdr->tail + len,
+            __ATOMIC_RELEASE);
+#else
+      (void) len;
+#endif // _WIN32
+    }
+
+    size_t
+    read(void *dest, size_t len)
+    {
+      uint8_t *out = static_cast<uint8_t *>(dest);
+      size_t total = 0;
+
+      while (total < len) {
+        size_t chunk;
+        const uint8_t *data = this->peek(chunk);
+
+        if (chunk == 0)
+          break;
+
+        if (chunk > len - total)
+          chunk = len - total;
+
+        memcpy(out + total, data, chunk);
+        this->consume(chunk);
+        total += chunk;
+      }
+
+      return total;
+    }
+
+    // Sleep until there is something to read, the producer goes away or
+    // the timeout (in milliseconds, negative waits forever) expires.
+    bool
+    wait(int timeoutMs)
+    {
+#ifdef _WIN32
+      (void) timeoutMs;
+      return false;
+#else
+      uint32_t bell;
+
+      if (this->available() > 0)
+        return true;
+
+      __atomic_add_fetch(&this->m_hdr->waiters, 1, __ATOMIC_SEQ_CST);
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+      bell = __atomic_load_n(&this->m_hdr->doorbell, __ATOMIC_SEQ_CST);
+
+      if (this->available() == 0 && !this->isClosed()) {
+#  ifdef __linux__
+        struct timespec ts;
+        ts.tv_sec  = timeoutMs / 1000;
+        ts.tv_nsec = (timeoutMs % 1000) * 1000000l;
+
+        (void) syscall(
+              SYS_futex,
+              &this->m_hdr->doorbell,
+              FUTEX_WAIT,
+              bell,
+              timeoutMs < 0 ? nullptr : &ts,
+              nullptr,
+              0);
+#  else
+        // No portable cross-process doorbell here. Poll, but politely.
+        (void) bell;
+        usleep(
+              static_cast<useconds_t>(
+                timeoutMs < 0 || timeoutMs > 1 ? 1000 : timeoutMs * 1000));
+#  endif // __linux__
+      }
+
+      __atomic_sub_fetch(&this->m_hdr->waiters, 1, __ATOMIC_ACQ_REL);
+
+      return this->available() > 0;
+#endif // _WIN32
+    }
+
+    std::string
+    getLastError() const
+    {
+      return this->m_lastError;
+    }
+  };
+}
+
+#endif // SHMRING_H
@@ -24,6 +24,8 @@
 #include <Suscan/Library.h>
 #include <Suscan/Source.h>
 #include <Palette.h>
+#include <SymView.h>
+#include <ExportSymbolsTask.h>
 #include <QStyledItemDelegate>
 #include <QItemDelegate>
 #include <list>
@@ -90,6 +92,15 @@ namespace SigDigger {
         int end,
         Suscan::MultitaskController *);
 
+    static void openSaveSymbolsDialog(
+        QWidget *root,
+        SymbolSnapshot const &symbols,
+        unsigned int bps,
+        unsigned int stride,
+        QColor const &lo,
+        QColor const &hi,
+        Suscan::MultitaskController *);
+
     static SigDiggerHelpers *instance();
     int getPaletteIndex(std::string const &) const;
     const Palette *getPalette(std::string const &) const;
@@ -25,6 +25,8 @@
 #define SIGDIGGER_UDPFORWARDER_MAX_UDP_SAMPLES \
   (SIGDIGGER_UDPFORWARDER_MAX_UDP_PAYLOAD_SIZE / static_cast<ssize_t>(sizeof(float _Complex)))
 
+#define SIGDIGGER_SOCKETFORWARDER_DEFAULT_MAX_LATENCY_US 20000
+
 namespace SigDigger {
   class SocketDataWriter;
 
@@ -0,0 +1,89 @@
+//
+//    StdinPipe.h: Size and watch the pipe the stdin source reads from
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef STDINPIPE_H
+#define STDINPIPE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QString>
+#include <cstdint>
+
+#define SIGDIGGER_STDIN_PIPE_POLL_MS       100
+#define SIGDIGGER_STDIN_PIPE_DEFAULT_MIB   16
+#define SIGDIGGER_STDIN_PIPE_PEEK_SIZE     (64 << 10)
+#define SIGDIGGER_STDIN_PIPE_MIN_GUESS     4096
+
+namespace SigDigger {
+  struct StdinPipeStats {
+    int     capacity = -1;     // Pipe buffer size, -1 if not a pipe
+    int     queued   = 0;      // Bytes written by the producer, not read yet
+    int     peak     = 0;      // Largest queued seen since start()
+    quint64 stalls   = 0;      // Times the pipe was found full
+  };
+
+  //
+  // The stdin source of the analyzer reads from file descriptor 0 of this
+  // very process. Whatever pipes samples into SigDigger can only write as
+  // fast as the pipe buffer lets it: with the default 64 KiB, a hiccup of
+  // a millisecond in the analyzer is enough to block (or make drop) a
+  // producer running at tens of Msps.
+  //
+  // This class grows that buffer, watches how full it gets while the
+  // source is running, and may peek at queued data without consuming it
+  // (Linux tee()) to guess its sample format. Elsewhere, only isPipe() is
+  // meaningful.
+  //
+  class StdinPipe : public QObject
+  {
+    Q_OBJECT
+
+    QTimer         m_timer;
+    StdinPipeStats m_stats;
+    bool           m_full = false;
+
+  public:
+    explicit StdinPipe(QObject *parent = nullptr);
+
+    static bool isPipe();
+    static int capacity();
+    static int queued();
+
+    // Never shrinks. Returns the resulting capacity, or -1.
+    static int grow(int bytes);
+
+    // Copy up to len queued bytes, leaving them in the pipe
+    static qint64 peek(void *buf, size_t len);
+
+    // Source format name ("complex_signed16", etc), or empty if unsure
+    static QString guessFormat(const uint8_t *data, size_t len);
+
+    void start();
+    void stop();
+    bool isRunning() const;
+    StdinPipeStats const &stats() const;
+
+  signals:
+    void statsChanged();
+
+  private slots:
+    void onPoll();
+  };
+}
+
+#endif // STDINPIPE_H
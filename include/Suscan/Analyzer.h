@@ -22,6 +22,12 @@
 
 #include <QObject>
 #include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include <Suscan/Compat.h>
 #include <Suscan/Source.h>
@@ -40,6 +46,16 @@
 
 #include <analyzer/analyzer.h>
 
+// Maximum rate (in commands per second) at which tuning and gain changes
+// are sent to the analyzer. Intermediate values are coalesced.
+#define SUSCAN_ANALYZER_COMMAND_RATE 25
+
+// A seek is considered complete when the first PSD from the new position
+// arrives. Spectra whose timestamp falls outside of this window around the
+// target are leftovers from before the seek and are dropped.
+#define SUSCAN_ANALYZER_SEEK_TOLERANCE_MS    2000
+#define SUSCAN_ANALYZER_SEEK_TIMEOUT_MS      500
+
 namespace Suscan {
   struct Orbit;
 
@@ -253,6 +269,19 @@ namespace Suscan {
     }
   };
 
+  //
+  // Receives the messages of specific inspectors, as registered through
+  // Analyzer::subscribeInspector. Unlike the inspector_message and
+  // samples_message signals, which reach every connected object, messages
+  // are only delivered to the listeners of their inspector ID.
+  //
+  class InspectorListener {
+  public:
+    virtual ~InspectorListener();
+    virtual void onInspectorMessage(InspectorMessage const &);
+    virtual void onInspectorSamples(SamplesMessage const &);
+  };
+
   class Analyzer: public QObject {
     Q_OBJECT
 
@@ -278,6 +307,64 @@ namespace Suscan {
     SUFREQ lastLnbFreq = 0;
     MQ mq;
 
+    // Latest-wins command queue. Only the newest value of every
+    // (command, handle, name) key is kept while waiting to be flushed.
+    enum CommandType {
+      COMMAND_FREQUENCY,
+      COMMAND_GAIN,
+      COMMAND_INSPECTOR_FREQ,
+      COMMAND_INSPECTOR_BANDWIDTH
+    };
+
+    struct PendingCommand {
+      CommandType type;
+      Handle      handle = -1;
+      std::string name;
+      SUFREQ      value = 0;
+      SUFREQ      lnb = 0;
+    };
+
+    typedef std::tuple<int, Handle, std::string> CommandKey;
+
+    std::map<CommandKey, PendingCommand> pendingCommands;
+    QTimer *commandTimer = nullptr;
+    QElapsedTimer lastFlush;
+    quint64 skippedCommands = 0;
+
+    // Per-inspector routing. Lists are tiny (usually one listener).
+    // Listeners removed while a message is being delivered are only
+    // nulled out, and swept once delivery is over.
+    std::unordered_map<InspectorId, std::vector<InspectorListener *>>
+        listeners;
+    unsigned int dispatching = 0;
+    bool listenersDirty = false;
+
+    // Seek coalescing. Only one seek is in flight at a time, and only the
+    // latest of those requested meanwhile is sent after it.
+    bool seekInFlight = false;
+    bool seekPending = false;
+    struct timeval inFlightSeek = {0, 0};
+    struct timeval pendingSeek = {0, 0};
+    QTimer *seekTimer = nullptr;
+    quint64 skippedSeeks = 0;
+    quint64 droppedPSDs = 0;
+
+    void sendSeek(struct timeval const &);
+    void completeSeek();
+    bool isStalePSD(struct timeval const &) const;
+
+    void enqueueCommand(PendingCommand const &);
+    void sendCommand(PendingCommand const &);
+    void flushPendingCommands();
+    void dropCommands(Handle handle);
+
+    template <class T>
+    void dispatch(
+        InspectorId,
+        T const &,
+        void (InspectorListener::*)(T const &));
+    void sweepListeners();
+
     static bool registered;
     static void assertTypeRegistration();
 
@@ -295,10 +382,18 @@ namespace Suscan {
   public slots:
     void captureMessage(quint32 type, void *data);
 
+  private slots:
+    void onCommandTimeout();
+    void onSeekTimeout();
+
   public:
     uint32_t allocateRequestId();
     uint32_t allocateInspectorId();
 
+    void subscribeInspector(InspectorId, InspectorListener *);
+    void unsubscribeInspector(InspectorId, InspectorListener *);
+    void unsubscribeInspector(InspectorListener *);
+
     SUSCOUNT getSampleRate() const;
     SUSCOUNT getMeasuredSampleRate() const;
     SUFREQ   getFrequency() const;
@@ -315,6 +410,9 @@ namespace Suscan {
     void setFrequency(SUFREQ freq);
     void setGain(std::string const &name, SUFLOAT val);
     void seek(struct timeval const &tv);
+    bool isSeeking() const;
+    quint64 getSkippedSeeks() const;
+    quint64 getDroppedPSDs() const;
     void setHistorySize(SUSCOUNT);
     void replay(bool);
     void setSweepStrategy(SweepStrategy);
@@ -332,6 +430,10 @@ namespace Suscan {
     void setBufferingSize(SUSCOUNT len);
     void halt();
 
+    // Command coalescing
+    quint64 getSkippedCommands() const;
+    void flushCommands();
+
     // Analyzer asynchronous requests
     void open(std::string const &inspClass, Channel const &ch, RequestId id = 0);
     void openPrecise(std::string const &inspClass, Channel const &ch, RequestId id = 0);
@@ -25,6 +25,7 @@
 #include <Suscan/Channel.h>
 #include <QVariant>
 #include <QMap>
+#include <vector>
 
 namespace Suscan {
   class Analyzer;
@@ -38,6 +39,8 @@ namespace Suscan {
     bool        precise = false;
     Handle      parent = -1;
     QVariant    data;
+    uint32_t    batchId = 0;    // 0 if not part of a batch
+    unsigned    batchIndex = 0; // Index of the channel in the batch
 
     // Request state
     bool opened = false;
@@ -67,10 +70,20 @@ namespace Suscan {
 
     Analyzer *m_analyzer = nullptr;
 
+    struct Batch {
+      unsigned pending = 0;
+      unsigned opened = 0;
+      unsigned failed = 0;
+    };
+
     QMap<uint32_t, AnalyzerRequest> m_pendingRequests;
+    QMap<uint32_t, Batch> m_batches;
+    uint32_t m_lastBatchId = 0;
 
     bool executeOpenRequest(AnalyzerRequest const &);
     bool executeSetInspectorId(AnalyzerRequest const &);
+    void resolveBatch(AnalyzerRequest const &, bool ok);
+    void failRequest(uint32_t requestId, std::string const &);
 
   public:
     bool requestOpen(
@@ -79,6 +92,11 @@ namespace Suscan {
         QVariant v = QVariant(),
         bool precise = true,
         Handle parent = -1);
+    uint32_t requestOpenBatch(
+        std::string const &inspClass,
+        std::vector<Channel> const &channels,
+        QVariant v = QVariant(),
+        Handle parent = -1);
     void setAnalyzer(Analyzer *);
     void cancelAll();
 
@@ -90,6 +108,7 @@ namespace Suscan {
     void opened(Suscan::AnalyzerRequest const &);
     void cancelled(Suscan::AnalyzerRequest const &);
     void error(Suscan::AnalyzerRequest const &, const std::string &);
+    void batchCompleted(quint32 batchId, unsigned opened, unsigned failed);
 
   public slots:
     void onInspectorMessage(const Suscan::InspectorMessage &message);
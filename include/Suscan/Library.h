@@ -295,6 +295,7 @@ namespace Suscan {
     bool estimators_initd;
     bool spectrum_sources_initd;
     bool inspectors_initd;
+    bool plugins_initd;
     bool have_qth;
 
     Singleton();
@@ -0,0 +1,104 @@
+//
+//    WatermarkController.h: Adaptive inspector watermark
+//    Copyright (C) 2024 Gonzalo José Carracedo Carballal
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as
+//    published by the Free Software Foundation, either version 3 of the
+//    License, or (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful, but
+//    WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU Lesser General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public
+//    License along with this program.  If not, see
+//    <http://www.gnu.org/licenses/>
+//
+#ifndef SUSCAN_WATERMARKCONTROLLER_H
+#define SUSCAN_WATERMARKCONTROLLER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <Suscan/Analyzer.h>
+
+#define SUSCAN_WATERMARK_EVAL_INTERVAL_MS 500
+#define SUSCAN_WATERMARK_HIGH_LOAD        .5  // Consumer busy fraction
+#define SUSCAN_WATERMARK_LOW_LOAD         .2
+#define SUSCAN_WATERMARK_BACKLOG_RATIO    1.25
+#define SUSCAN_WATERMARK_HYSTERESIS       .2  // Relative change to apply
+#define SUSCAN_WATERMARK_RATE_ALPHA       .25
+
+namespace Suscan {
+  enum WatermarkProfile {
+    WATERMARK_PROFILE_AUDIO,
+    WATERMARK_PROFILE_CONSTELLATION,
+    WATERMARK_PROFILE_RECORDING,
+    WATERMARK_PROFILE_FORWARDING
+  };
+
+  struct WatermarkPolicy {
+    qreal minLatency = 10e-3; // s
+    qreal maxLatency = 100e-3; // s
+    qreal maxMsgRate = 60;     // Messages per second
+
+    static WatermarkPolicy fromProfile(WatermarkProfile);
+  };
+
+  //
+  // Tunes the watermark of a single inspector. Consumers wrap the processing
+  // of every samples message between beginBatch() and endBatch(), and the
+  // controller periodically compares the time spent there (and the amount
+  // of samples that arrived) against the wall clock. Overloaded consumers,
+  // consumers catching up with a backlog or consumers receiving more
+  // messages than they can use get larger batches. Idle consumers get
+  // smaller ones, as latency is preferred whenever it is cheap.
+  //
+  class WatermarkController : public QObject {
+    Q_OBJECT
+
+    Analyzer       *m_analyzer = nullptr;
+    Handle          m_handle = -1;
+    WatermarkPolicy m_policy;
+
+    qreal           m_rateHint = 0; // Nominal output rate, if known
+    qreal           m_rate = 0;     // Measured output rate
+    SUSCOUNT        m_watermark = 0;
+
+    // Current measurement window
+    QElapsedTimer   m_window;
+    QElapsedTimer   m_batch;
+    qint64          m_busyNs = 0;
+    unsigned int    m_messages = 0;
+    SUSCOUNT        m_samples = 0;
+
+    SUSCOUNT clamp(qreal) const;
+    void apply(SUSCOUNT);
+    void evaluate();
+
+  public:
+    WatermarkController(QObject *parent = nullptr);
+    ~WatermarkController() override;
+
+    void setAnalyzer(Analyzer *);
+    void setInspector(Handle, qreal rateHint = 0, SUSCOUNT initial = 0);
+    void setRateHint(qreal);
+    void setProfile(WatermarkProfile);
+    void setPolicy(WatermarkPolicy const &);
+    void setLatencyBounds(qreal min, qreal max);
+    void reset();
+
+    void beginBatch();
+    void endBatch(SUSCOUNT count);
+
+    WatermarkPolicy const &getPolicy() const;
+    SUSCOUNT getWatermark() const;
+    qreal getLatency() const;
+
+  signals:
+    void watermarkChanged(quint64 watermark, qreal latency);
+  };
+}
+
+#endif // SUSCAN_WATERMARKCONTROLLER_H
@@ -28,6 +28,9 @@
 #include "HistogramDialog.h"
 #include "SamplerDialog.h"
 #include "DopplerDialog.h"
+#include "CycloDialog.h"
+#include "MeasureIndex.h"
+#include "MemoryBudget.h"
 
 #include "WaveSampler.h"
 
@@ -41,7 +44,7 @@ namespace Ui {
 }
 
 namespace SigDigger {
-  class TimeWindow : public QMainWindow
+  class TimeWindow : public QMainWindow, public MemoryConsumer
   {
     Q_OBJECT
 
@@ -49,6 +52,7 @@ namespace SigDigger {
     HistogramDialog *m_histogramDialog = nullptr;
     SamplerDialog *m_samplerDialog = nullptr;
     DopplerDialog *m_dopplerDialog = nullptr;
+    CycloDialog *m_cycloDialog = nullptr;
 
     Ui::TimeWindow *ui = nullptr;
 
@@ -64,9 +68,11 @@ namespace SigDigger {
     size_t           m_roDataLength = 0;
 
     std::vector<SUCOMPLEX> m_processedData;
+    std::vector<SUCOMPLEX> m_resampledData;
 
     const SUCOMPLEX *m_displayDataPtr = nullptr;
     size_t           m_displayDataLength = 0;
+    MeasureIndex     m_measures;
 
     SUFREQ    m_centerFreq;
 
@@ -134,6 +140,11 @@ namespace SigDigger {
         size_t size,
         qreal fs,
         qreal bw);
+    void extendData(
+        const SUCOMPLEX *data,
+        size_t size,
+        qreal fs,
+        qreal bw);
     void refresh();
     void setPalette(std::string const &);
     void setPaletteOffset(unsigned int);
@@ -148,6 +159,11 @@ namespace SigDigger {
 
     void showEvent(QShowEvent *event) override;
 
+    // MemoryConsumer: transformed and resampled copies, and the measure
+    // index. The capture itself belongs to whoever opened the window.
+    QString memoryConsumerName() const override;
+    quint64 residentBytes() const override;
+
   signals:
     void configChanged();
     void closed();
@@ -210,6 +226,8 @@ namespace SigDigger {
     void onQuadDemod();
     void onAGC();
     void onLPF();
+    void onRateConversion();
+    void onRateConversionChanged();
     void onDelayedConjugate();
 
     void onAGCRateChanged();
@@ -20,15 +20,22 @@
 #define APPLICATIONUI_H
 
 #include <QMainWindow>
+#include <QVariant>
 #include <Suscan/Messages/PSDMessage.h>
 #include <Suscan/AnalyzerRequestTracker.h>
 #include <Suscan/Library.h>
 #include <map>
 #include <AppConfig.h>
 #include <QMessageBox>
+#include <QPointer>
+#include <QLabel>
 #include <WFHelpers.h>
 #include <PersistentWidget.h>
 #include <Averager.h>
+#include <PSDLinkController.h>
+#include <MemoryBudget.h>
+#include <ArenaAllocator.h>
+#include <memory>
 #include <QMessageBox>
 
 #define SIGDIGGER_UI_MEDIATOR_DEFAULT_MIN_FREQ  0
@@ -47,6 +54,8 @@ namespace SigDigger {
   class FloatingTabWindow;
   class RemoteControlServer;
   class GlobalProperty;
+  class PowerOverview;
+  class PowerOverviewTask;
 
   class UIMediator : public PersistentWidget {
     Q_OBJECT
@@ -70,12 +79,16 @@ namespace SigDigger {
     RemoteControlServer *m_remoteControl = nullptr;
 
     QMessageBox *m_laggedMsgBox = nullptr;
+    QLabel *m_linkBudgetLabel = nullptr;
+    QLabel *m_memoryLabel = nullptr;
     std::map<std::string, QAction *> m_bandPlanMap;
 
     // Cached members
     struct timeval m_profileStart;
     struct timeval m_profileEnd;
     Suscan::Source::Device m_remoteDevice;
+    std::shared_ptr<PowerOverview> m_overview;
+    QPointer<PowerOverviewTask> m_overviewTask;
 
     GlobalProperty *m_propSampRate  = nullptr;
     GlobalProperty *m_propFftSize   = nullptr;
@@ -105,14 +118,19 @@ namespace SigDigger {
     bool m_haveRtDelta = false;
     unsigned int m_rtCalibrations = 0;
     qreal m_rtDeltaReal = 0;
+    PSDLinkController m_psdLink;
 
     // Private methods
+    GlobalProperty *makeProperty(
+        QString const &name,
+        QString const &desc,
+        QVariant const &value);
     void connectMainWindow();
     void connectTimeSlider();
     void connectSpectrum();
+    void connectConfigDialog();
     void connectDeviceDialog();
     void connectPanoramicDialog();
-    void connectAnalyzer();
     void connectRequestTracker();
 
     // Behavioral methods
@@ -121,8 +139,18 @@ namespace SigDigger {
     void refreshQthProperties();
     void refreshProfile(bool updateFreqs = true);
     void refreshTimeToolbarState();
+    void refreshOverview();
     void setCurrentAutoGain();
 
+    // Remote spectrum link adaptation
+    bool psdLinkEnabled() const;
+    void feedPSDLink(Suscan::PSDMessage const &);
+    void applyPSDLinkSettings(PSDLinkSettings const &);
+    void refreshLinkBudget();
+
+    // Sample buffer memory budget and allocation policy
+    void refreshMemoryBudget();
+
     // Other setters
     void setSourceTimeStart(struct timeval const &);
     void setSourceTimeEnd(struct timeval const &);
@@ -138,7 +166,6 @@ namespace SigDigger {
 
     Suscan::AnalyzerRequestTracker    *m_requestTracker = nullptr;
     QList<InspectionWidget *>          m_inspectors;
-    QMap<uint32_t, InspectionWidget *> m_inspTable;
 
     // Refactored methods
     void initSidePanel();
@@ -254,6 +281,7 @@ namespace SigDigger {
     void seek(struct timeval tv);
     void refreshDevices();
     void uiQuit();
+    void newWindow();
     void recentSelected(QString);
     void recentCleared();
     void profileChanged(bool);
@@ -286,6 +314,7 @@ namespace SigDigger {
     void onTriggerExport(bool);
     void onTriggerDevices(bool);
     void onTriggerQuit(bool);
+    void onTriggerNewWindow(bool);
     void onTriggerClear(bool);
     void onTriggerRecent(bool);
     void onTriggerPanoramicSpectrum(bool);
@@ -300,6 +329,10 @@ namespace SigDigger {
 
     // Time Slider slots
     void onTimeStampChanged();
+    void onOverviewUpdated();
+
+    // Memory budget
+    void onMemoryUsageChanged();
 
     // Spectrum slots
     void onSpectrumBandwidthChanged();
@@ -323,8 +356,6 @@ namespace SigDigger {
     void onTabRename(QString);
 
     // Inspector handling
-    void onInspectorMessage(Suscan::InspectorMessage const &);
-    void onInspectorSamples(Suscan::SamplesMessage const &);
     void onOpened(Suscan::AnalyzerRequest const &);
     void onCancelled(Suscan::AnalyzerRequest const &);
     void onError(Suscan::AnalyzerRequest const &, std::string const &);